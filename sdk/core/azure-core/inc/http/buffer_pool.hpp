@@ -0,0 +1,166 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace Azure { namespace Core { namespace Http {
+
+  namespace Details {
+    // Buffers up to this size are rounded up to the next power of two, larger buffers are rounded
+    // up to a multiple of it.
+    constexpr int64_t c_BufferPoolPowerOfTwoLimit = 1024 * 1024;
+    constexpr int64_t c_BufferPoolMinimumBufferSize = 4 * 1024;
+    // Buffers are aligned to the page size, which satisfies the alignment of direct I/O.
+    constexpr std::size_t c_BufferPoolAlignment = 4 * 1024;
+    constexpr int64_t c_BufferPoolDefaultMaxCachedBytes = 256 * 1024 * 1024;
+  } // namespace Details
+
+  class BufferPool;
+
+  /**
+   * @brief A buffer leased from a BufferPool. The memory goes back to the pool when the lease is
+   * destroyed or released.
+   */
+  class PooledBuffer {
+  public:
+    PooledBuffer() = default;
+    PooledBuffer(const PooledBuffer&) = delete;
+    PooledBuffer& operator=(const PooledBuffer&) = delete;
+    PooledBuffer(PooledBuffer&& other) noexcept { *this = std::move(other); }
+    PooledBuffer& operator=(PooledBuffer&& other) noexcept;
+    ~PooledBuffer() { Release(); }
+
+    /**
+     * @brief Returns the beginning of the leased memory, or nullptr for an empty lease.
+     */
+    uint8_t* Data() const { return m_data; }
+
+    /**
+     * @brief Returns the size that was requested when the buffer was acquired.
+     */
+    int64_t Size() const { return m_size; }
+
+    /**
+     * @brief Returns the size of the underlying allocation, which is at least Size().
+     */
+    int64_t Capacity() const { return m_capacity; }
+
+    explicit operator bool() const { return m_data != nullptr; }
+
+    /**
+     * @brief Returns the memory to the pool ahead of destruction.
+     */
+    void Release();
+
+  private:
+    friend class BufferPool;
+
+    BufferPool* m_pool = nullptr;
+    uint8_t* m_data = nullptr;
+    int64_t m_size = 0;
+    int64_t m_capacity = 0;
+  };
+
+  /**
+   * @brief A thread-safe, size-classed pool of transfer buffers.
+   *
+   * Released buffers are cached and handed out again to later requests of the same size class, so
+   * that chunked transfers do not allocate and free large blocks for every chunk. The pool also
+   * enforces a memory limit covering both leased and cached buffers: when the limit is reached,
+   * Acquire blocks until other leases are released, which applies backpressure to the callers.
+   */
+  class BufferPool {
+  public:
+    /**
+     * @brief Constructs a buffer pool.
+     *
+     * @param memoryLimit Maximum number of bytes the pool may have allocated at once.
+     * @param maxCachedBytes Maximum number of bytes kept around for reuse when buffers are idle.
+     */
+    explicit BufferPool(
+        int64_t memoryLimit = std::numeric_limits<int64_t>::max(),
+        int64_t maxCachedBytes = Details::c_BufferPoolDefaultMaxCachedBytes);
+
+    BufferPool(const BufferPool&) = delete;
+    BufferPool& operator=(const BufferPool&) = delete;
+
+    /**
+     * @brief Destroys the pool. All leases must have been released.
+     */
+    ~BufferPool();
+
+    /**
+     * @brief Leases a buffer of at least size bytes, blocking while the memory limit is
+     * exceeded.
+     *
+     * @remark A request is always granted if nothing else is leased from the pool, so that a
+     * single buffer larger than the limit cannot block forever.
+     */
+    PooledBuffer Acquire(int64_t size);
+
+    /**
+     * @brief Leases a buffer of at least size bytes, or returns an empty lease if doing so would
+     * exceed the memory limit.
+     */
+    PooledBuffer TryAcquire(int64_t size);
+
+    /**
+     * @brief Changes the memory limit. Waiting callers are re-evaluated against the new limit.
+     */
+    void SetMemoryLimit(int64_t memoryLimit);
+
+    int64_t GetMemoryLimit() const;
+
+    /**
+     * @brief Returns the number of bytes currently leased out.
+     */
+    int64_t GetLeasedBytes() const;
+
+    /**
+     * @brief Returns the number of bytes held idle for reuse.
+     */
+    int64_t GetCachedBytes() const;
+
+    /**
+     * @brief Frees all idle buffers.
+     */
+    void Trim();
+
+    /**
+     * @brief Returns the process-wide pool shared by the HTTP transport and the transfer helpers.
+     * It has no memory limit unless one is set with SetMemoryLimit.
+     */
+    static BufferPool& Default();
+
+    /**
+     * @brief Returns the capacity of the size class a request of size bytes is served from.
+     */
+    static int64_t GetSizeClass(int64_t size);
+
+  private:
+    friend class PooledBuffer;
+
+    PooledBuffer AcquireImpl(int64_t size, bool wait);
+    void Release(uint8_t* data, int64_t capacity);
+    bool CanGrant(int64_t capacity) const;
+    void EvictCachedLocked(int64_t bytesNeeded);
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::map<int64_t, std::vector<uint8_t*>> m_freeLists;
+    int64_t m_memoryLimit;
+    int64_t m_maxCachedBytes;
+    int64_t m_leasedBytes = 0;
+    int64_t m_cachedBytes = 0;
+  };
+
+}}} // namespace Azure::Core::Http
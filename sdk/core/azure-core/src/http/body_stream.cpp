@@ -47,6 +47,12 @@ std::vector<uint8_t> BodyStream::ReadToEnd(Context const& context, BodyStream& b
 {
   constexpr int64_t chunkSize = 1024 * 8;
   auto buffer = std::vector<uint8_t>();
+  // When the length is known up front, allocate once instead of growing chunk by chunk
+  auto const length = body.Length();
+  if (length > 0)
+  {
+    buffer.reserve(static_cast<size_t>(length) + chunkSize);
+  }
 
   for (auto chunkNumber = 0;; chunkNumber++)
   {
@@ -0,0 +1,226 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include "http/buffer_pool.hpp"
+
+#include <cstdlib>
+#include <new>
+#include <stdexcept>
+
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+using namespace Azure::Core::Http;
+
+namespace {
+uint8_t* AllocateBuffer(int64_t capacity)
+{
+  void* data = nullptr;
+#ifdef _WIN32
+  data = _aligned_malloc(static_cast<size_t>(capacity), Details::c_BufferPoolAlignment);
+#else
+  if (posix_memalign(&data, Details::c_BufferPoolAlignment, static_cast<size_t>(capacity)) != 0)
+  {
+    data = nullptr;
+  }
+#endif
+  if (data == nullptr)
+  {
+    throw std::bad_alloc();
+  }
+  return static_cast<uint8_t*>(data);
+}
+
+void FreeBuffer(uint8_t* data)
+{
+#ifdef _WIN32
+  _aligned_free(data);
+#else
+  std::free(data);
+#endif
+}
+} // namespace
+
+PooledBuffer& PooledBuffer::operator=(PooledBuffer&& other) noexcept
+{
+  if (this != &other)
+  {
+    Release();
+    m_pool = other.m_pool;
+    m_data = other.m_data;
+    m_size = other.m_size;
+    m_capacity = other.m_capacity;
+    other.m_pool = nullptr;
+    other.m_data = nullptr;
+    other.m_size = 0;
+    other.m_capacity = 0;
+  }
+  return *this;
+}
+
+void PooledBuffer::Release()
+{
+  if (m_data != nullptr)
+  {
+    m_pool->Release(m_data, m_capacity);
+  }
+  m_pool = nullptr;
+  m_data = nullptr;
+  m_size = 0;
+  m_capacity = 0;
+}
+
+BufferPool::BufferPool(int64_t memoryLimit, int64_t maxCachedBytes)
+    : m_memoryLimit(memoryLimit), m_maxCachedBytes(maxCachedBytes)
+{
+}
+
+BufferPool::~BufferPool() { Trim(); }
+
+int64_t BufferPool::GetSizeClass(int64_t size)
+{
+  if (size <= Details::c_BufferPoolMinimumBufferSize)
+  {
+    return Details::c_BufferPoolMinimumBufferSize;
+  }
+  if (size <= Details::c_BufferPoolPowerOfTwoLimit)
+  {
+    int64_t sizeClass = Details::c_BufferPoolMinimumBufferSize;
+    while (sizeClass < size)
+    {
+      sizeClass *= 2;
+    }
+    return sizeClass;
+  }
+  return (size + Details::c_BufferPoolPowerOfTwoLimit - 1) / Details::c_BufferPoolPowerOfTwoLimit
+      * Details::c_BufferPoolPowerOfTwoLimit;
+}
+
+PooledBuffer BufferPool::Acquire(int64_t size) { return AcquireImpl(size, true); }
+
+PooledBuffer BufferPool::TryAcquire(int64_t size) { return AcquireImpl(size, false); }
+
+bool BufferPool::CanGrant(int64_t capacity) const
+{
+  return m_leasedBytes == 0 || m_leasedBytes + capacity <= m_memoryLimit;
+}
+
+void BufferPool::EvictCachedLocked(int64_t bytesNeeded)
+{
+  for (auto i = m_freeLists.begin(); i != m_freeLists.end() && bytesNeeded > 0;)
+  {
+    auto& freeList = i->second;
+    while (!freeList.empty() && bytesNeeded > 0)
+    {
+      FreeBuffer(freeList.back());
+      freeList.pop_back();
+      m_cachedBytes -= i->first;
+      bytesNeeded -= i->first;
+    }
+    i = freeList.empty() ? m_freeLists.erase(i) : std::next(i);
+  }
+}
+
+PooledBuffer BufferPool::AcquireImpl(int64_t size, bool wait)
+{
+  if (size < 0)
+  {
+    throw std::invalid_argument("buffer size cannot be negative");
+  }
+  const int64_t capacity = GetSizeClass(size);
+
+  std::unique_lock<std::mutex> guard(m_mutex);
+  if (!CanGrant(capacity))
+  {
+    if (!wait)
+    {
+      return PooledBuffer();
+    }
+    m_cv.wait(guard, [this, capacity]() { return CanGrant(capacity); });
+  }
+
+  uint8_t* data = nullptr;
+  auto freeList = m_freeLists.find(capacity);
+  if (freeList != m_freeLists.end() && !freeList->second.empty())
+  {
+    data = freeList->second.back();
+    freeList->second.pop_back();
+    m_cachedBytes -= capacity;
+  }
+  else
+  {
+    // Make room for the new allocation by dropping idle buffers of other size classes.
+    EvictCachedLocked(m_leasedBytes + m_cachedBytes + capacity - m_memoryLimit);
+    data = AllocateBuffer(capacity);
+  }
+  m_leasedBytes += capacity;
+  guard.unlock();
+
+  PooledBuffer buffer;
+  buffer.m_pool = this;
+  buffer.m_data = data;
+  buffer.m_size = size;
+  buffer.m_capacity = capacity;
+  return buffer;
+}
+
+void BufferPool::Release(uint8_t* data, int64_t capacity)
+{
+  {
+    std::lock_guard<std::mutex> guard(m_mutex);
+    m_leasedBytes -= capacity;
+    if (m_cachedBytes + capacity <= m_maxCachedBytes
+        && m_leasedBytes + m_cachedBytes + capacity <= m_memoryLimit)
+    {
+      m_freeLists[capacity].push_back(data);
+      m_cachedBytes += capacity;
+      data = nullptr;
+    }
+  }
+  if (data != nullptr)
+  {
+    FreeBuffer(data);
+  }
+  m_cv.notify_all();
+}
+
+void BufferPool::SetMemoryLimit(int64_t memoryLimit)
+{
+  {
+    std::lock_guard<std::mutex> guard(m_mutex);
+    m_memoryLimit = memoryLimit;
+    EvictCachedLocked(m_leasedBytes + m_cachedBytes - m_memoryLimit);
+  }
+  m_cv.notify_all();
+}
+
+int64_t BufferPool::GetMemoryLimit() const
+{
+  std::lock_guard<std::mutex> guard(m_mutex);
+  return m_memoryLimit;
+}
+
+int64_t BufferPool::GetLeasedBytes() const
+{
+  std::lock_guard<std::mutex> guard(m_mutex);
+  return m_leasedBytes;
+}
+
+int64_t BufferPool::GetCachedBytes() const
+{
+  std::lock_guard<std::mutex> guard(m_mutex);
+  return m_cachedBytes;
+}
+
+void BufferPool::Trim()
+{
+  std::lock_guard<std::mutex> guard(m_mutex);
+  EvictCachedLocked(m_cachedBytes);
+}
+
+BufferPool& BufferPool::Default()
+{
+  static BufferPool pool;
+  return pool;
+}
@@ -2,6 +2,7 @@
 #include "http/curl/curl.hpp"
 
 #include "azure.hpp"
+#include "http/buffer_pool.hpp"
 #include "http/http.hpp"
 
 #include <string>
@@ -263,16 +264,25 @@ CURLcode CurlSession::UploadBody(Context const& context)
     // use default size
     uploadChunkSize = Details::c_UploadDefaultChunkSize;
   }
-  auto unique_buffer = std::make_unique<uint8_t[]>(static_cast<size_t>(uploadChunkSize));
+  // Reuse a pooled buffer when available. Never wait for one here, the caller may already be
+  // holding leases from the same pool.
+  auto pooledBuffer = BufferPool::Default().TryAcquire(uploadChunkSize);
+  std::unique_ptr<uint8_t[]> unique_buffer;
+  uint8_t* buffer = pooledBuffer.Data();
+  if (buffer == nullptr)
+  {
+    unique_buffer = std::make_unique<uint8_t[]>(static_cast<size_t>(uploadChunkSize));
+    buffer = unique_buffer.get();
+  }
 
   while (true)
   {
-    auto rawRequestLen = streamBody->Read(context, unique_buffer.get(), uploadChunkSize);
+    auto rawRequestLen = streamBody->Read(context, buffer, uploadChunkSize);
     if (rawRequestLen == 0)
     {
       break;
     }
-    sendResult = SendBuffer(unique_buffer.get(), static_cast<size_t>(rawRequestLen));
+    sendResult = SendBuffer(buffer, static_cast<size_t>(rawRequestLen));
     if (sendResult != CURLE_OK)
     {
       return sendResult;
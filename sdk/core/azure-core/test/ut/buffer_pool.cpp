@@ -0,0 +1,84 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include "gtest/gtest.h"
+#include <http/buffer_pool.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+using namespace Azure::Core::Http;
+
+TEST(BufferPool, SizeClass)
+{
+  EXPECT_EQ(BufferPool::GetSizeClass(0), 4 * 1024);
+  EXPECT_EQ(BufferPool::GetSizeClass(1), 4 * 1024);
+  EXPECT_EQ(BufferPool::GetSizeClass(4 * 1024 + 1), 8 * 1024);
+  EXPECT_EQ(BufferPool::GetSizeClass(64 * 1024), 64 * 1024);
+  EXPECT_EQ(BufferPool::GetSizeClass(1024 * 1024), 1024 * 1024);
+  EXPECT_EQ(BufferPool::GetSizeClass(1024 * 1024 + 1), 2 * 1024 * 1024);
+  EXPECT_EQ(BufferPool::GetSizeClass(8 * 1024 * 1024 + 4096), 9 * 1024 * 1024);
+}
+
+TEST(BufferPool, Alignment)
+{
+  BufferPool pool;
+  for (int64_t size : {int64_t(0), int64_t(1), int64_t(5000), int64_t(3 * 1024 * 1024)})
+  {
+    auto buffer = pool.Acquire(size);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(buffer.Data()) % Details::c_BufferPoolAlignment, 0U);
+  }
+}
+
+TEST(BufferPool, Reuse)
+{
+  BufferPool pool;
+  uint8_t* first = nullptr;
+  {
+    auto buffer = pool.Acquire(100 * 1024);
+    ASSERT_TRUE(buffer);
+    EXPECT_EQ(buffer.Size(), 100 * 1024);
+    EXPECT_EQ(buffer.Capacity(), 128 * 1024);
+    EXPECT_EQ(pool.GetLeasedBytes(), 128 * 1024);
+    first = buffer.Data();
+  }
+  EXPECT_EQ(pool.GetLeasedBytes(), 0);
+  EXPECT_EQ(pool.GetCachedBytes(), 128 * 1024);
+
+  auto buffer = pool.Acquire(128 * 1024);
+  EXPECT_EQ(buffer.Data(), first);
+  EXPECT_EQ(pool.GetCachedBytes(), 0);
+
+  auto moved = std::move(buffer);
+  EXPECT_FALSE(buffer);
+  EXPECT_EQ(moved.Data(), first);
+  moved.Release();
+  pool.Trim();
+  EXPECT_EQ(pool.GetCachedBytes(), 0);
+}
+
+TEST(BufferPool, MemoryLimit)
+{
+  BufferPool pool(64 * 1024);
+  auto first = pool.Acquire(32 * 1024);
+  auto second = pool.Acquire(32 * 1024);
+  EXPECT_FALSE(pool.TryAcquire(4 * 1024));
+
+  std::atomic<bool> acquired{false};
+  std::thread waiter([&]() {
+    auto third = pool.Acquire(32 * 1024);
+    acquired = true;
+  });
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  EXPECT_FALSE(acquired);
+  first.Release();
+  waiter.join();
+  EXPECT_TRUE(acquired);
+  EXPECT_LE(pool.GetLeasedBytes() + pool.GetCachedBytes(), 64 * 1024);
+
+  // A single oversized request is still granted when nothing else is leased.
+  second.Release();
+  auto oversized = pool.Acquire(1024 * 1024);
+  EXPECT_TRUE(oversized);
+}
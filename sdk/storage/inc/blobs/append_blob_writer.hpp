@@ -0,0 +1,110 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include "blob_options.hpp"
+#include "blobs/append_blob_client.hpp"
+#include "common/crypt.hpp"
+#include "http/buffer_pool.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace Azure { namespace Storage { namespace Blobs {
+
+  /**
+   * @brief Buffers small writes into full blocks appended to an existing append blob in the
+   * background, so that the caller fills and hashes the next blocks while the previous ones are
+   * in flight.
+   *
+   * Every append is conditioned on the position it expects the blob to end at, which keeps the
+   * data in order if someone else appends to the blob, and keeps a retried append from being
+   * applied twice. Up to Concurrency appends are in flight at once, and the service applies them
+   * in the order they arrive: an append that arrives ahead of the block before it fails on its
+   * position, and the blocks are sent again in order from the first one missing in the blob. A
+   * block is held until it's known to be in the blob.
+   *
+   * Write and Flush must not be called concurrently.
+   */
+  class AppendBlobWriter {
+  public:
+    /**
+     * @brief Starts appending to the end of the blob, which must exist.
+     */
+    explicit AppendBlobWriter(
+        AppendBlobClient appendBlobClient,
+        const AppendBlobWriterOptions& options = AppendBlobWriterOptions());
+
+    /**
+     * @brief Appends whatever is still buffered and waits for it. Errors are ignored, call Flush
+     * before to get them.
+     */
+    ~AppendBlobWriter();
+
+    AppendBlobWriter(const AppendBlobWriter&) = delete;
+    AppendBlobWriter& operator=(const AppendBlobWriter&) = delete;
+
+    /**
+     * @brief Buffers length bytes of buffer to append them. Blocks while Concurrency full blocks
+     * wait for the ones in flight. Throws the error of an append that failed, after which nothing
+     * more is appended.
+     */
+    void Write(const uint8_t* buffer, std::size_t length);
+
+    /**
+     * @brief Appends whatever is buffered and waits until everything written so far is in the
+     * blob. Throws the error of an append that failed.
+     */
+    void Flush();
+
+    /**
+     * @brief Returns the size of the blob once everything written so far is appended.
+     */
+    int64_t GetPosition() const;
+
+  private:
+    struct Block
+    {
+      Azure::Core::Http::PooledBuffer Buffer;
+      int64_t Length = 0;
+      int64_t Position = 0;
+      std::unique_ptr<Details::ContentHasher> Hasher;
+      std::string Hash;
+      bool Sending = false;
+      bool Appended = false;
+    };
+
+    void SealCurrentBlock(std::unique_lock<std::mutex>& lock);
+    void ThrowIfFailed() const;
+    void SendLoop();
+    void Append(const Block& block);
+    void ReleaseBlocks();
+
+    AppendBlobClient m_appendBlobClient;
+    AppendBlobWriterOptions m_options;
+    int64_t m_blockSize;
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_cv;
+    Block m_currentBlock;
+    std::chrono::steady_clock::time_point m_currentBlockStart;
+    // where the current block starts in the blob
+    int64_t m_position = 0;
+    // The sealed blocks that aren't known to be in the blob yet, in order. Blocks are sent while
+    // others are in the list, which doesn't move them.
+    std::list<Block> m_blocks;
+    bool m_stop = false;
+    std::exception_ptr m_error;
+    std::vector<std::thread> m_sendThreads;
+  };
+
+}}} // namespace Azure::Storage::Blobs
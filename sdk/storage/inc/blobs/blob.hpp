@@ -4,6 +4,8 @@
 #pragma once
 
 #include "blobs/append_blob_client.hpp"
+#include "blobs/append_blob_writer.hpp"
+#include "blobs/blob_batch_client.hpp"
 #include "blobs/blob_client.hpp"
 #include "blobs/blob_container_client.hpp"
 #include "blobs/blob_service_client.hpp"
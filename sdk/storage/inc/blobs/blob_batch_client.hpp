@@ -0,0 +1,167 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include "blob_options.hpp"
+#include "blob_responses.hpp"
+#include "common/storage_credential.hpp"
+#include "common/storage_uri_builder.hpp"
+#include "credentials/credentials.hpp"
+#include "http/pipeline.hpp"
+#include "protocol/blob_rest_client.hpp"
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Azure { namespace Storage { namespace Blobs {
+
+  /**
+   * @brief A list of blob operations, submitted together by BlobBatchClient::SubmitBatch. The
+   * Context of the options of an operation is ignored, the one of the submission applies.
+   */
+  class BlobBatch {
+  public:
+    /**
+     * @brief Adds the deletion of a blob to the batch.
+     * @param containerName The name of the container of the blob.
+     * @param blobName The name of the blob.
+     * @param options Optional parameters to execute this operation.
+     * @return The index of the operation in the batch, which is also the index of its result.
+     */
+    std::size_t DeleteBlob(
+        const std::string& containerName,
+        const std::string& blobName,
+        const DeleteBlobOptions& options = DeleteBlobOptions());
+
+    /**
+     * @brief Adds setting the access tier of a blob to the batch.
+     * @param containerName The name of the container of the blob.
+     * @param blobName The name of the blob.
+     * @param tier Indicates the tier to be set on the blob.
+     * @param options Optional parameters to execute this operation.
+     * @return The index of the operation in the batch, which is also the index of its result.
+     */
+    std::size_t SetBlobAccessTier(
+        const std::string& containerName,
+        const std::string& blobName,
+        AccessTier tier,
+        const SetAccessTierOptions& options = SetAccessTierOptions());
+
+    /**
+     * @brief Returns the number of operations in the batch.
+     */
+    std::size_t Size() const { return m_subrequests.size(); }
+
+  private:
+    struct Subrequest
+    {
+      Azure::Core::Http::HttpMethod Method;
+      std::string ContainerName;
+      std::string BlobName;
+      std::map<std::string, std::string> Query;
+      std::map<std::string, std::string> Headers;
+    };
+
+    std::vector<Subrequest> m_subrequests;
+
+    friend class BlobBatchClient;
+  };
+
+  /**
+   * @brief Submits the operations of a BlobBatch to the service, packed into as few multipart
+   * requests as possible instead of a request per operation.
+   */
+  class BlobBatchClient {
+  public:
+    /**
+     * @brief Initialize a new instance of BlobBatchClient.
+     *
+     * @param connectionString A connection string includes the authentication information
+     * required for your application to access data in an Azure Storage account at runtime.
+     * @param options Optional client options that define the transport pipeline policies for
+     * authentication, retries, etc., that are applied to every request.
+     * @return A new BlobBatchClient instance.
+     */
+    static BlobBatchClient CreateFromConnectionString(
+        const std::string& connectionString,
+        const BlobBatchClientOptions& options = BlobBatchClientOptions());
+
+    /**
+     * @brief Initialize a new instance of BlobBatchClient.
+     *
+     * @param serviceUri A uri referencing the blob service that includes the name of the account.
+     * @param credential The shared key credential used to sign the batch requests and every
+     * operation in them.
+     * @param options Optional client options that define the transport pipeline policies for
+     * authentication, retries, etc., that are applied to every request.
+     */
+    explicit BlobBatchClient(
+        const std::string& serviceUri,
+        std::shared_ptr<SharedKeyCredential> credential,
+        const BlobBatchClientOptions& options = BlobBatchClientOptions());
+
+    /**
+     * @brief Initialize a new instance of BlobBatchClient.
+     *
+     * @param serviceUri A uri referencing the blob service that includes the name of the account.
+     * @param credential The token credential used to authorize the batch requests and every
+     * operation in them.
+     * @param options Optional client options that define the transport pipeline policies for
+     * authentication, retries, etc., that are applied to every request.
+     */
+    explicit BlobBatchClient(
+        const std::string& serviceUri,
+        std::shared_ptr<Core::Credentials::TokenCredential> credential,
+        const BlobBatchClientOptions& options = BlobBatchClientOptions());
+
+    /**
+     * @brief Initialize a new instance of BlobBatchClient.
+     *
+     * @param serviceUri A uri referencing the blob service that includes the name of the account,
+     * and possibly also a SAS token, which authorizes every operation too.
+     * @param options Optional client options that define the transport pipeline policies for
+     * authentication, retries, etc., that are applied to every request.
+     */
+    explicit BlobBatchClient(
+        const std::string& serviceUri,
+        const BlobBatchClientOptions& options = BlobBatchClientOptions());
+
+    /**
+     * @brief Gets the blob service's primary uri endpoint.
+     *
+     * @return The blob service's primary uri endpoint.
+     */
+    std::string GetUri() const { return m_serviceUrl.ToString(); }
+
+    /**
+     * @brief Submits the operations of a batch, at most 256 of them per request. A batch with
+     * more operations is split into several requests, sent concurrently. An operation that fails
+     * doesn't fail the others, its status is in its result.
+     *
+     * @param batch The operations to submit.
+     * @param options Optional parameters to execute this function.
+     * @return The result of every operation of the batch.
+     */
+    SubmitBlobBatchResult SubmitBatch(
+        const BlobBatch& batch,
+        const SubmitBlobBatchOptions& options = SubmitBlobBatchOptions()) const;
+
+  private:
+    void SubmitBatchRequest(
+        const BlobBatch& batch,
+        std::size_t begin,
+        std::size_t end,
+        Azure::Core::Context context,
+        std::vector<BlobBatchSubResponse>& subResponses) const;
+
+    UriBuilder m_serviceUrl;
+    std::shared_ptr<Azure::Core::Http::HttpPipeline> m_pipeline;
+    // Signs an operation of a batch and returns it serialized, rather than sending it.
+    std::shared_ptr<Azure::Core::Http::HttpPipeline> m_subrequestPipeline;
+  };
+
+}}} // namespace Azure::Storage::Blobs
@@ -10,6 +10,7 @@
 #include "credentials/credentials.hpp"
 #include "protocol/blob_rest_client.hpp"
 
+#include <functional>
 #include <map>
 #include <memory>
 #include <string>
@@ -251,6 +252,20 @@ namespace Azure { namespace Storage { namespace Blobs {
         const std::string& file,
         const DownloadBlobToFileOptions& options = DownloadBlobToFileOptions()) const;
 
+    /**
+     * @brief Downloads a blob or a blob range from the service using parallel requests, and
+     * passes the content to a sink as it arrives, without holding the whole range in memory.
+     *
+     * @param sink Receives the content in pieces, with the offset of each piece from the beginning
+     * of the blob range. Unless options.ReorderWindowSize is set, pieces may be passed out of
+     * order and from several threads at once.
+     * @param options Optional parameters to execute this function.
+     * @return A BlobDownloadInfo describing the downloaded blob.
+     */
+    Azure::Core::Response<BlobDownloadInfo> DownloadTo(
+        const std::function<void(const uint8_t* data, std::size_t length, int64_t offset)>& sink,
+        const DownloadBlobToOptions& options = DownloadBlobToOptions()) const;
+
     /**
      * @brief Creates a read-only snapshot of a blob.
      *
@@ -5,14 +5,18 @@
 
 #include "blob_options.hpp"
 #include "blobs/blob_client.hpp"
+#include "blobs/compact_blob_items.hpp"
+#include "common/segment_pager.hpp"
 #include "common/storage_credential.hpp"
 #include "common/storage_uri_builder.hpp"
 #include "credentials/credentials.hpp"
 #include "protocol/blob_rest_client.hpp"
 
+#include <functional>
 #include <map>
 #include <memory>
 #include <string>
+#include <vector>
 
 namespace Azure { namespace Storage { namespace Blobs {
 
@@ -186,6 +190,17 @@ namespace Azure { namespace Storage { namespace Blobs {
     Azure::Core::Response<BlobsFlatSegment> ListBlobsFlat(
         const ListBlobsOptions& options = ListBlobsOptions()) const;
 
+    /**
+     * @brief Returns the same segment of blobs as ListBlobsFlat, in a compact representation
+     * that holds the strings of all the blobs in a single buffer. Suited to enumerations that
+     * keep many blobs in memory.
+     *
+     * @param options Optional parameters to execute this function.
+     * @return A CompactBlobsFlatSegment describing a segment of the blobs in the container.
+     */
+    Azure::Core::Response<CompactBlobsFlatSegment> ListBlobsFlatCompact(
+        const ListBlobsOptions& options = ListBlobsOptions()) const;
+
     /**
      * @brief Returns a single segment of blobs in this container, starting from the
      * specified Marker, Use an empty Marker to start enumeration from the beginning and the
@@ -203,6 +218,49 @@ namespace Azure { namespace Storage { namespace Blobs {
         const std::string& delimiter,
         const ListBlobsOptions& options = ListBlobsOptions()) const;
 
+    /**
+     * @brief Returns a pager over all the segments of blobs in this container, starting from the
+     * specified Marker. The next segments are fetched in the background while the current one is
+     * processed, so that the enumeration isn't paced by the round trip of every segment.
+     *
+     * @param options Optional parameters to execute this function.
+     * @param prefetchDepth The maximum number of segments fetched ahead of the one being
+     * processed.
+     * @return A SegmentPager returning the BlobsFlatSegment of the container in order.
+     */
+    SegmentPager<BlobsFlatSegment> ListBlobsFlatPages(
+        const ListBlobsOptions& options = ListBlobsOptions(),
+        int prefetchDepth = 1) const;
+
+    /**
+     * @brief Returns a pager over all the segments of blobs in this container by hierarchy,
+     * starting from the specified Marker. The next segments are fetched in the background while
+     * the current one is processed.
+     *
+     * @param delimiter This can be used to to traverse a virtual hierarchy of blobs as though it
+     * were a file system. The delimiter may be a single character or a string.
+     * @param options Optional parameters to execute this function.
+     * @param prefetchDepth The maximum number of segments fetched ahead of the one being
+     * processed.
+     * @return A SegmentPager returning the BlobsHierarchySegment of the container in order.
+     */
+    SegmentPager<BlobsHierarchySegment> ListBlobsByHierarchyPages(
+        const std::string& delimiter,
+        const ListBlobsOptions& options = ListBlobsOptions(),
+        int prefetchDepth = 1) const;
+
+    /**
+     * @brief Lists the blobs in this container by splitting the key space into prefix shards,
+     * listed concurrently, so that the enumeration of a huge container isn't limited by a single
+     * chain of markers.
+     *
+     * @param sink Receives the blobs a segment at a time. Calls to the sink never overlap.
+     * @param options Optional parameters to execute this function.
+     */
+    void ListBlobsParallel(
+        const std::function<void(std::vector<BlobItem> items)>& sink,
+        const ListBlobsParallelOptions& options = ListBlobsParallelOptions()) const;
+
     /**
      * @brief Gets the permissions for this container. The permissions indicate whether
      * container data may be accessed publicly.
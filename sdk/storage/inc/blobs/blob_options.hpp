@@ -4,8 +4,11 @@
 #pragma once
 
 #include "common/access_conditions.hpp"
+#include "common/crypt.hpp"
+#include "common/transfer_tuner.hpp"
 #include "protocol/blob_rest_client.hpp"
 
+#include <chrono>
 #include <limits>
 #include <string>
 #include <utility>
@@ -89,6 +92,24 @@ namespace Azure { namespace Storage { namespace Blobs {
     std::vector<std::unique_ptr<Azure::Core::Http::HttpPolicy>> PerRetryPolicies;
   };
 
+  /**
+   * @brief Blob batch client options used to initalize BlobBatchClient.
+   */
+  struct BlobBatchClientOptions
+  {
+    /**
+     * @brief Transport pipeline policies for authentication, additional HTTP headers, etc., that
+     * are applied to every request.
+     */
+    std::vector<std::unique_ptr<Azure::Core::Http::HttpPolicy>> PerOperationPolicies;
+
+    /**
+     * @brief Transport pipeline policies for authentication, additional HTTP headers, etc., that
+     * are applied to every retrial.
+     */
+    std::vector<std::unique_ptr<Azure::Core::Http::HttpPolicy>> PerRetryPolicies;
+  };
+
   /**
    * @brief Optional parameters for BlobServiceClient::ListBlobContainers.
    */
@@ -306,6 +327,56 @@ namespace Azure { namespace Storage { namespace Blobs {
     ListBlobsIncludeItem Include = ListBlobsIncludeItem::None;
   };
 
+  /**
+   * @brief Optional parameters for BlobContainerClient::ListBlobsParallel.
+   */
+  struct ListBlobsParallelOptions
+  {
+    /**
+     * @brief Context for cancelling long running operations.
+     */
+    Azure::Core::Context Context;
+
+    /**
+     * @brief Specifies a string that filters the results to return only blobs whose
+     * name begins with the specified prefix. Ignored when ShardPrefixes is set.
+     */
+    Azure::Core::Nullable<std::string> Prefix;
+
+    /**
+     * @brief The prefixes of the shards of the key space listed concurrently. Only the blobs
+     * under these prefixes are listed, a prefix beginning with another one is dropped. When
+     * empty, the shards are discovered by listing the virtual directories under Prefix.
+     */
+    std::vector<std::string> ShardPrefixes;
+
+    /**
+     * @brief The delimiter of the virtual directories used as shards when they're discovered.
+     */
+    std::string Delimiter = "/";
+
+    /**
+     * @brief The maximum number of shards listed at the same time.
+     */
+    int Concurrency = 1;
+
+    /**
+     * @brief Specifies the maximum number of blobs to return by a single request.
+     */
+    Azure::Core::Nullable<int32_t> MaxResults;
+
+    /**
+     * @brief Specifies one or more datasets to include in the response.
+     */
+    ListBlobsIncludeItem Include = ListBlobsIncludeItem::None;
+
+    /**
+     * @brief Passes the blobs to the sink in lexicographical order. The blobs of the shards listed
+     * ahead of the earliest unfinished one are held in memory until it finishes.
+     */
+    bool Sorted = false;
+  };
+
   /**
    * @brief Optional parameters for BlobContainerClient::GetAccessPolicy.
    */
@@ -534,6 +605,13 @@ namespace Azure { namespace Storage { namespace Blobs {
      */
     Azure::Core::Nullable<int64_t> Length;
 
+    /**
+     * @brief Asks the service for a hash of the range with this algorithm, and validates the
+     * content against it while it's read from the body stream. Offset and Length must be set, and
+     * the range can be at most 4MiB long.
+     */
+    Azure::Core::Nullable<HashAlgorithm> TransactionalHashAlgorithm;
+
     /**
      * @brief Optional conditions that must be met to perform this operation.
      */
@@ -577,12 +655,79 @@ namespace Azure { namespace Storage { namespace Blobs {
      * @brief The maximum number of threads that may be used in a parallel transfer.
      */
     int Concurrency = 1;
+
+    /**
+     * @brief Adjusts the chunk size and the number of concurrent chunks of the download at
+     * runtime within these bounds, to reach the maximum throughput. When set, ChunkSize and
+     * Concurrency are ignored for the chunks after the initial one.
+     */
+    Azure::Core::Nullable<TransferTuningOptions> AutoTune;
+
+    /**
+     * @brief Validates every chunk against a hash the service computes with this algorithm, as the
+     * chunk is received. Chunks are limited to 4MiB when set.
+     */
+    Azure::Core::Nullable<HashAlgorithm> TransactionalHashAlgorithm;
   };
 
   /**
    * @brief Optional parameters for BlobClient::DownloadToFile.
    */
-  using DownloadBlobToFileOptions = DownloadBlobToBufferOptions;
+  struct DownloadBlobToFileOptions : public DownloadBlobToBufferOptions
+  {
+    DownloadBlobToFileOptions() = default;
+
+    // The options of DownloadToBuffer can be used for DownloadToFile as well.
+    DownloadBlobToFileOptions(const DownloadBlobToBufferOptions& options)
+        : DownloadBlobToBufferOptions(options)
+    {
+    }
+
+    /**
+     * @brief Path of a journal of the chunks downloaded so far. A download that fails can be
+     * retried with the same journal to only download the missing chunks, as long as the blob
+     * hasn't changed, and the journal is deleted when the download completes. Every chunk is
+     * requested with a fixed size and on the ETag of the blob, so AutoTune is ignored.
+     */
+    Azure::Core::Nullable<std::string> CheckpointFile;
+
+    /**
+     * @brief Writes the file bypassing the page cache where supported, which is O_DIRECT on
+     * Linux, so that a large download doesn't evict other data from memory. InitialChunkSize and
+     * ChunkSize are rounded up to a multiple of 4KiB when set.
+     */
+    bool DirectIo = false;
+
+    /**
+     * @brief Flushes the file to the disk as it's written, holding at most about this many bytes
+     * of it in the page cache, so that a large download doesn't fill the memory with dirty pages.
+     * Only supported on Linux, and has no effect together with DirectIo. Null leaves flushing to
+     * the operating system.
+     */
+    Azure::Core::Nullable<int64_t> WriteBackInterval;
+
+    /**
+     * @brief Writes the file asynchronously, with io_uring on Linux, while the next part of the
+     * chunk is received, so that disk latency doesn't hold up the transfer. Writes are synchronous
+     * where asynchronous file I/O isn't available.
+     */
+    bool AsyncFileIo = false;
+  };
+
+  /**
+   * @brief Optional parameters for BlobClient::DownloadTo.
+   */
+  struct DownloadBlobToOptions : public DownloadBlobToBufferOptions
+  {
+    /**
+     * @brief Delivers the content to the sink in order, from one thread at a time. Chunks that
+     * arrive early are held until the content before them has been delivered, and a chunk is only
+     * requested once it ends within this many bytes of the delivered content, which bounds the
+     * memory held. Null means every chunk is delivered as soon as it arrives, possibly out of
+     * order and from several threads at once.
+     */
+    Azure::Core::Nullable<int64_t> ReorderWindowSize;
+  };
 
   /**
    * @brief Optional parameters for BlobClient::CreateSnapshot.
@@ -721,6 +866,37 @@ namespace Azure { namespace Storage { namespace Blobs {
      * @brief The maximum number of threads that may be used in a parallel transfer.
      */
     int Concurrency = 1;
+
+    /**
+     * @brief Adjusts the block size and the number of concurrent blocks of the upload at runtime
+     * within these bounds, to reach the maximum throughput. When set, ChunkSize and Concurrency
+     * are ignored, except that UploadFromFile with a CheckpointFile or AsyncFileIo splits the file
+     * into blocks of ChunkSize in advance, and then only tunes the number of concurrent blocks.
+     */
+    Azure::Core::Nullable<TransferTuningOptions> AutoTune;
+
+    /**
+     * @brief Sends a hash of every block computed with this algorithm, so that the service rejects
+     * blocks that were corrupted in transit.
+     */
+    Azure::Core::Nullable<HashAlgorithm> TransactionalHashAlgorithm;
+
+    /**
+     * @brief Only used by UploadFromFile. Path of a journal of the blocks staged so far. An upload
+     * that fails can be retried with the same journal to only stage the missing blocks, as long
+     * as the file hasn't changed, and the journal is deleted once the blocks are committed. The
+     * blocks have a fixed size, so AutoTune only tunes the number of concurrent blocks.
+     */
+    Azure::Core::Nullable<std::string> CheckpointFile;
+
+    /**
+     * @brief Only used by UploadFromFile. Reads blocks into memory ahead of their upload,
+     * asynchronously with io_uring on Linux, so that disk reads overlap the network transfers.
+     * Reads are synchronous where asynchronous file I/O isn't available. The blocks are split in
+     * advance, so AutoTune only tunes the number of concurrent blocks, which also bounds the blocks
+     * read ahead. Ignored for blocks larger than 100MiB.
+     */
+    bool AsyncFileIo = false;
   };
 
   /**
@@ -747,6 +923,13 @@ namespace Azure { namespace Storage { namespace Blobs {
      */
     Azure::Core::Nullable<std::string> ContentCrc64;
 
+    /**
+     * @brief Computes the hash of the content with this algorithm and sends it, so that the
+     * service rejects content that was corrupted in transit. The content is read into memory once
+     * to be hashed before it's sent. Overrides ContentMd5 or ContentCrc64.
+     */
+    Azure::Core::Nullable<HashAlgorithm> TransactionalHashAlgorithm;
+
     /**
      * @brief Optional conditions that must be met to perform this operation.
      */
@@ -902,12 +1085,65 @@ namespace Azure { namespace Storage { namespace Blobs {
      */
     Azure::Core::Nullable<std::string> ContentCrc64;
 
+    /**
+     * @brief Computes the hash of the content with this algorithm and sends it, so that the
+     * service rejects content that was corrupted in transit. The content is read into memory once
+     * to be hashed before it's sent. Overrides ContentMd5 or ContentCrc64.
+     */
+    Azure::Core::Nullable<HashAlgorithm> TransactionalHashAlgorithm;
+
     /**
      * @brief Optional conditions that must be met to perform this operation.
      */
     AppendBlobAccessConditions AccessConditions;
   };
 
+  /**
+   * @brief Optional parameters for AppendBlobWriter.
+   */
+  struct AppendBlobWriterOptions
+  {
+    /**
+     * @brief Context for cancelling long running operations.
+     */
+    Azure::Core::Context Context;
+
+    /**
+     * @brief Writes are buffered into blocks of this size before they're appended, at most 4MiB.
+     * Defaults to 4MiB.
+     */
+    Azure::Core::Nullable<int64_t> BlockSize;
+
+    /**
+     * @brief Appends a partial block once its first byte has been buffered for this long, so
+     * that a slow writer doesn't hold data back. By default, a partial block is only appended by
+     * Flush.
+     */
+    Azure::Core::Nullable<std::chrono::milliseconds> FlushInterval;
+
+    /**
+     * @brief The maximum number of appends in flight at the same time. As many full blocks wait
+     * for them before writes block.
+     */
+    int Concurrency = 1;
+
+    /**
+     * @brief Sends a hash of every block computed with this algorithm, so that the service rejects
+     * blocks that were corrupted in transit. The hash is computed as the block is buffered.
+     */
+    Azure::Core::Nullable<HashAlgorithm> TransactionalHashAlgorithm;
+
+    /**
+     * @brief Fails the appends that would grow the blob beyond this size.
+     */
+    Azure::Core::Nullable<int64_t> MaxSize;
+
+    /**
+     * @brief The lease that must be active on the blob, if any.
+     */
+    Azure::Core::Nullable<std::string> LeaseId;
+  };
+
   /**
    * @brief Optional parameters for AppendBlobClient::AppendBlockFromUri.
    */
@@ -986,6 +1222,49 @@ namespace Azure { namespace Storage { namespace Blobs {
     BlobAccessConditions AccessConditions;
   };
 
+  /**
+   * @brief Optional parameters for PageBlobClient::UploadFromFile.
+   */
+  struct UploadPageBlobFromFileOptions
+  {
+    /**
+     * @brief Context for cancelling long running operations.
+     */
+    Azure::Core::Context Context;
+
+    /**
+     * @brief The standard HTTP header system properties to set.
+     */
+    BlobHttpHeaders HttpHeaders;
+
+    /**
+     * @brief Name-value pairs associated with the blob as metadata.
+     */
+    std::map<std::string, std::string> Metadata;
+
+    /**
+     * @brief Indicates the tier to be set on blob.
+     */
+    Azure::Core::Nullable<AccessTier> Tier;
+
+    /**
+     * @brief The size of the ranges of the file scanned and uploaded by a single thread, which
+     * must be a multiple of 512 and at most 4MiB.
+     */
+    Azure::Core::Nullable<int64_t> ChunkSize;
+
+    /**
+     * @brief The maximum number of threads that may be used in a parallel transfer.
+     */
+    int Concurrency = 1;
+
+    /**
+     * @brief Sends a hash of every range of pages computed with this algorithm, so that the
+     * service rejects pages that were corrupted in transit.
+     */
+    Azure::Core::Nullable<HashAlgorithm> TransactionalHashAlgorithm;
+  };
+
   /**
    * @brief Optional parameters for PageBlobClient::UploadPages.
    */
@@ -1010,6 +1289,13 @@ namespace Azure { namespace Storage { namespace Blobs {
      */
     Azure::Core::Nullable<std::string> ContentCrc64;
 
+    /**
+     * @brief Computes the hash of the content with this algorithm and sends it, so that the
+     * service rejects content that was corrupted in transit. The content is read into memory once
+     * to be hashed before it's sent. Overrides ContentMd5 or ContentCrc64.
+     */
+    Azure::Core::Nullable<HashAlgorithm> TransactionalHashAlgorithm;
+
     /**
      * @brief Optional conditions that must be met to perform this operation.
      */
@@ -1138,4 +1424,21 @@ namespace Azure { namespace Storage { namespace Blobs {
     BlobAccessConditions AccessConditions;
   };
 
+  /**
+   * @brief Optional parameters for BlobBatchClient::SubmitBatch.
+   */
+  struct SubmitBlobBatchOptions
+  {
+    /**
+     * @brief Context for cancelling long running operations.
+     */
+    Azure::Core::Context Context;
+
+    /**
+     * @brief The maximum number of batch requests sent at the same time, when the batch has more
+     * operations than fit in a single request.
+     */
+    int Concurrency = 1;
+  };
+
 }}} // namespace Azure::Storage::Blobs
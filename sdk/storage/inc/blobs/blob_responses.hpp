@@ -38,4 +38,17 @@ namespace Azure { namespace Storage { namespace Blobs {
     std::vector<PageRange> ClearRanges;
   };
 
+  struct BlobBatchSubResponse
+  {
+    Azure::Core::Http::HttpStatusCode StatusCode = Azure::Core::Http::HttpStatusCode::None;
+    // empty if the operation succeeded
+    std::string ErrorCode;
+  };
+
+  struct SubmitBlobBatchResult
+  {
+    // in the order the operations were added to the batch
+    std::vector<BlobBatchSubResponse> SubResponses;
+  };
+
 }}} // namespace Azure::Storage::Blobs
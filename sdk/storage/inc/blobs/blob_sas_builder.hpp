@@ -4,6 +4,7 @@
 #pragma once
 
 #include <string>
+#include <vector>
 
 #include "blobs/protocol/blob_rest_client.hpp"
 #include "common/account_sas_builder.hpp"
@@ -311,7 +312,43 @@ namespace Azure { namespace Storage { namespace Blobs {
         const UserDelegationKey& userDelegationKey,
         const std::string& accountName);
 
+    /**
+     * @brief Uses the SharedKeyCredential to sign a shared access signature for each of many
+     * blobs in ContainerName, with all other fields of this builder in common. The signing key is
+     * set up once and the signatures are computed in parallel.
+     *
+     * @param credential The storage account's shared key credential.
+     * @param blobNames The names of the blobs, used in place of BlobName.
+     * @return The SAS query parameters of each blob, in the order of blobNames.
+     * @remark Resource must be Blob or BlobSnapshot.
+     */
+    std::vector<std::string> ToSasQueryParameters(
+        const SharedKeyCredential& credential,
+        const std::vector<std::string>& blobNames) const;
+
+    /**
+     * @brief Uses an account's user delegation key to sign a shared access signature for each of
+     * many blobs in ContainerName, with all other fields of this builder in common. The signing
+     * key is set up once and the signatures are computed in parallel.
+     *
+     * @param userDelegationKey UserDelegationKey returned from
+     * BlobServiceClient.GetUserDelegationKey.
+     * @param accountName The name of the storage account.
+     * @param blobNames The names of the blobs, used in place of BlobName.
+     * @return The SAS query parameters of each blob, in the order of blobNames.
+     * @remark Resource must be Blob or BlobSnapshot.
+     */
+    std::vector<std::string> ToSasQueryParameters(
+        const UserDelegationKey& userDelegationKey,
+        const std::string& accountName,
+        const std::vector<std::string>& blobNames) const;
+
   private:
+    struct SasTemplate;
+    SasTemplate GetSasTemplate(
+        const std::string& accountName,
+        const UserDelegationKey* userDelegationKey) const;
+
     std::string Permissions;
   };
 
@@ -144,6 +144,23 @@ namespace Azure { namespace Storage { namespace Blobs {
         const std::string& file,
         const UploadBlobOptions& options = UploadBlobOptions()) const;
 
+    /**
+     * @brief Creates a new block blob, or updates the content of an existing block blob, from a
+     * stream whose length is not known in advance. Updating an existing block blob overwrites any
+     * existing metadata on the blob.
+     *
+     * @param content A BodyStream containing the content to upload. It is read sequentially
+     * until it returns 0 and never rewound.
+     * @param options Optional parameters to execute this function.
+     * @return A BlobContentInfo describing the state of the updated block blob.
+     * @remark The content is staged in blocks of ChunkSize bytes, at most 4000MiB, with at most
+     * Concurrency blocks buffered at a time. The upload fails once the stream goes past 50000
+     * blocks, the maximum number of blocks in a blob. AutoTune is ignored.
+     */
+    Azure::Core::Response<BlobContentInfo> UploadFromStream(
+        Azure::Core::Http::BodyStream* content,
+        const UploadBlobOptions& options = UploadBlobOptions()) const;
+
     /**
      * @brief Creates a new block as part of a block blob's staging area to be eventually
      * committed via the CommitBlockList operation.
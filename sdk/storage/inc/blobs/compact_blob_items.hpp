@@ -0,0 +1,131 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include "common/xml_wrapper.hpp"
+#include "protocol/blob_rest_client.hpp"
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace Azure { namespace Storage { namespace Blobs {
+
+  /**
+   * @brief The properties of a blob in CompactBlobItems. The strings are owned by the
+   * CompactBlobItems, and an absent value is an empty string.
+   */
+  struct CompactBlobItem
+  {
+    const char* Name;
+    bool Deleted;
+    const char* Snapshot;
+    const char* ContentType;
+    const char* ContentEncoding;
+    const char* ContentLanguage;
+    const char* ContentMd5;
+    const char* CacheControl;
+    const char* ContentDisposition;
+    const char* CreationTime;
+    const char* LastModified;
+    const char* ETag;
+    int64_t ContentLength;
+    Blobs::BlobType BlobType;
+    AccessTier Tier;
+    bool AccessTierInferred;
+    BlobLeaseStatus LeaseStatus;
+    BlobLeaseState LeaseState;
+    const char* LeaseDuration;
+    Azure::Core::Nullable<bool> ServerEncrypted;
+    const char* EncryptionKeySha256;
+  };
+
+  /**
+   * @brief The blobs of a list segment, stored column by column with all the strings in a single
+   * buffer, instead of a BlobItem per blob. Values repeated across blobs, such as content types,
+   * are stored once.
+   */
+  class CompactBlobItems {
+  public:
+    std::size_t Size() const { return m_names.size(); }
+    bool Empty() const { return m_names.empty(); }
+
+    CompactBlobItem operator[](std::size_t index) const;
+
+    /**
+     * @brief Returns the metadata of a blob, as pairs of name and value.
+     */
+    std::vector<std::pair<const char*, const char*>> GetMetadata(std::size_t index) const;
+
+    /**
+     * @brief Copies a blob into a BlobItem.
+     */
+    BlobItem ToBlobItem(std::size_t index) const;
+
+  private:
+    // A few distinct values of a column, looked up before a value is appended to the buffer.
+    struct InternedValues
+    {
+      std::vector<uint32_t> Offsets;
+      std::size_t NextSlot = 0;
+    };
+
+    uint32_t Append(const XmlStringView& value);
+    uint32_t Intern(const XmlStringView& value, InternedValues& values);
+    const char* GetString(uint32_t offset) const { return m_strings.data() + offset; }
+
+    friend struct CompactBlobItemsBuilder;
+
+    // every string is null-terminated, offset 0 is the empty string
+    std::string m_strings = std::string(1, '\0');
+    std::vector<uint32_t> m_names;
+    std::vector<uint32_t> m_snapshots;
+    std::vector<uint32_t> m_contentTypes;
+    std::vector<uint32_t> m_contentEncodings;
+    std::vector<uint32_t> m_contentLanguages;
+    std::vector<uint32_t> m_contentMd5s;
+    std::vector<uint32_t> m_cacheControls;
+    std::vector<uint32_t> m_contentDispositions;
+    std::vector<uint32_t> m_creationTimes;
+    std::vector<uint32_t> m_lastModifiedTimes;
+    std::vector<uint32_t> m_eTags;
+    std::vector<uint32_t> m_leaseDurations;
+    std::vector<uint32_t> m_encryptionKeySha256s;
+    std::vector<int64_t> m_contentLengths;
+    std::vector<Blobs::BlobType> m_blobTypes;
+    std::vector<AccessTier> m_tiers;
+    std::vector<BlobLeaseStatus> m_leaseStatuses;
+    std::vector<BlobLeaseState> m_leaseStates;
+    // bit 0: Deleted, bit 1: AccessTierInferred, bit 2: ServerEncrypted is set, bit 3: its value
+    std::vector<uint8_t> m_flags;
+    // the metadata of blob i is in [m_metadataBegins[i], m_metadataBegins[i + 1])
+    std::vector<uint32_t> m_metadataBegins = std::vector<uint32_t>(1, 0);
+    std::vector<std::pair<uint32_t, uint32_t>> m_metadata;
+    InternedValues m_internedContentTypes;
+    InternedValues m_internedContentEncodings;
+    InternedValues m_internedContentLanguages;
+    InternedValues m_internedCacheControls;
+    InternedValues m_internedContentDispositions;
+    InternedValues m_internedLeaseDurations;
+    InternedValues m_internedMetadataNames;
+  };
+
+  struct CompactBlobsFlatSegment
+  {
+    std::string ServiceEndpoint;
+    std::string Container;
+    std::string Prefix;
+    std::string Marker;
+    std::string NextMarker;
+    CompactBlobItems Items;
+  };
+
+}}} // namespace Azure::Storage::Blobs
+
+namespace Azure { namespace Storage { namespace Details {
+
+  Blobs::CompactBlobsFlatSegment CompactBlobsFlatSegmentFromXml(XmlPullReader& reader);
+
+}}} // namespace Azure::Storage::Details
@@ -128,6 +128,20 @@ namespace Azure { namespace Storage { namespace Blobs {
         int64_t offset,
         const UploadPagesOptions& options = UploadPagesOptions());
 
+    /**
+     * @brief Creates a new page blob with the content of a file, in parallel. Pages that are all
+     * zeros are skipped, since a new page blob reads as zeros, so sparse files such as disk images
+     * only send the pages that hold data.
+     *
+     * @param file A file containing the content to upload, the size of which must be a multiple of
+     * 512.
+     * @param options Optional parameters to execute this function.
+     * @return A BlobContentInfo describing the newly created page blob.
+     */
+    Azure::Core::Response<BlobContentInfo> UploadFromFile(
+        const std::string& file,
+        const UploadPageBlobFromFileOptions& options = UploadPageBlobFromFileOptions());
+
     /**
      * @brief Writes a range of pages to a page blob where the contents are read from a
      * uri.
@@ -15,6 +15,7 @@
 #include <cstring>
 #include <limits>
 #include <map>
+#include <memory>
 #include <set>
 #include <stdexcept>
 #include <string>
@@ -1318,7 +1319,7 @@ namespace Azure { namespace Storage { namespace Blobs {
         }
         {
           const auto& httpResponseBody = httpResponse.GetBody();
-          XmlReader reader(
+          XmlPullReader reader(
               reinterpret_cast<const char*>(httpResponseBody.data()), httpResponseBody.size());
           response = ListContainersSegmentFromXml(reader);
         }
@@ -1729,7 +1730,7 @@ namespace Azure { namespace Storage { namespace Blobs {
         return ret;
       }
 
-      static ListContainersSegment ListContainersSegmentFromXml(XmlReader& reader)
+      static ListContainersSegment ListContainersSegmentFromXml(XmlPullReader& reader)
       {
         ListContainersSegment ret;
         enum class XmlTagName
@@ -1763,27 +1764,27 @@ namespace Azure { namespace Storage { namespace Blobs {
           }
           else if (node.Type == XmlNodeType::StartTag)
           {
-            if (std::strcmp(node.Name, "EnumerationResults") == 0)
+            if (node.Name == "EnumerationResults")
             {
               path.emplace_back(XmlTagName::k_EnumerationResults);
             }
-            else if (std::strcmp(node.Name, "Prefix") == 0)
+            else if (node.Name == "Prefix")
             {
               path.emplace_back(XmlTagName::k_Prefix);
             }
-            else if (std::strcmp(node.Name, "Marker") == 0)
+            else if (node.Name == "Marker")
             {
               path.emplace_back(XmlTagName::k_Marker);
             }
-            else if (std::strcmp(node.Name, "NextMarker") == 0)
+            else if (node.Name == "NextMarker")
             {
               path.emplace_back(XmlTagName::k_NextMarker);
             }
-            else if (std::strcmp(node.Name, "Containers") == 0)
+            else if (node.Name == "Containers")
             {
               path.emplace_back(XmlTagName::k_Containers);
             }
-            else if (std::strcmp(node.Name, "Container") == 0)
+            else if (node.Name == "Container")
             {
               path.emplace_back(XmlTagName::k_Container);
             }
@@ -1803,27 +1804,27 @@ namespace Azure { namespace Storage { namespace Blobs {
             if (path.size() == 2 && path[0] == XmlTagName::k_EnumerationResults
                 && path[1] == XmlTagName::k_Prefix)
             {
-              ret.Prefix = node.Value;
+              ret.Prefix = node.Value.ToString();
             }
             else if (
                 path.size() == 2 && path[0] == XmlTagName::k_EnumerationResults
                 && path[1] == XmlTagName::k_Marker)
             {
-              ret.Marker = node.Value;
+              ret.Marker = node.Value.ToString();
             }
             else if (
                 path.size() == 2 && path[0] == XmlTagName::k_EnumerationResults
                 && path[1] == XmlTagName::k_NextMarker)
             {
-              ret.NextMarker = node.Value;
+              ret.NextMarker = node.Value.ToString();
             }
           }
           else if (node.Type == XmlNodeType::Attribute)
           {
             if (path.size() == 1 && path[0] == XmlTagName::k_EnumerationResults
-                && std::strcmp(node.Name, "ServiceEndpoint") == 0)
+                && node.Name == "ServiceEndpoint")
             {
-              ret.ServiceEndpoint = node.Value;
+              ret.ServiceEndpoint = node.Value.ToString();
             }
           }
         }
@@ -2037,7 +2038,7 @@ namespace Azure { namespace Storage { namespace Blobs {
         return ret;
       }
 
-      static BlobContainerItem BlobContainerItemFromXml(XmlReader& reader)
+      static BlobContainerItem BlobContainerItemFromXml(XmlPullReader& reader)
       {
         BlobContainerItem ret;
         enum class XmlTagName
@@ -2076,47 +2077,47 @@ namespace Azure { namespace Storage { namespace Blobs {
           }
           else if (node.Type == XmlNodeType::StartTag)
           {
-            if (std::strcmp(node.Name, "Name") == 0)
+            if (node.Name == "Name")
             {
               path.emplace_back(XmlTagName::k_Name);
             }
-            else if (std::strcmp(node.Name, "Properties") == 0)
+            else if (node.Name == "Properties")
             {
               path.emplace_back(XmlTagName::k_Properties);
             }
-            else if (std::strcmp(node.Name, "Etag") == 0)
+            else if (node.Name == "Etag")
             {
               path.emplace_back(XmlTagName::k_Etag);
             }
-            else if (std::strcmp(node.Name, "Last-Modified") == 0)
+            else if (node.Name == "Last-Modified")
             {
               path.emplace_back(XmlTagName::k_LastModified);
             }
-            else if (std::strcmp(node.Name, "PublicAccess") == 0)
+            else if (node.Name == "PublicAccess")
             {
               path.emplace_back(XmlTagName::k_PublicAccess);
             }
-            else if (std::strcmp(node.Name, "HasImmutabilityPolicy") == 0)
+            else if (node.Name == "HasImmutabilityPolicy")
             {
               path.emplace_back(XmlTagName::k_HasImmutabilityPolicy);
             }
-            else if (std::strcmp(node.Name, "HasLegalHold") == 0)
+            else if (node.Name == "HasLegalHold")
             {
               path.emplace_back(XmlTagName::k_HasLegalHold);
             }
-            else if (std::strcmp(node.Name, "LeaseStatus") == 0)
+            else if (node.Name == "LeaseStatus")
             {
               path.emplace_back(XmlTagName::k_LeaseStatus);
             }
-            else if (std::strcmp(node.Name, "LeaseState") == 0)
+            else if (node.Name == "LeaseState")
             {
               path.emplace_back(XmlTagName::k_LeaseState);
             }
-            else if (std::strcmp(node.Name, "LeaseDuration") == 0)
+            else if (node.Name == "LeaseDuration")
             {
               path.emplace_back(XmlTagName::k_LeaseDuration);
             }
-            else if (std::strcmp(node.Name, "Metadata") == 0)
+            else if (node.Name == "Metadata")
             {
               path.emplace_back(XmlTagName::k_Metadata);
             }
@@ -2134,55 +2135,55 @@ namespace Azure { namespace Storage { namespace Blobs {
           {
             if (path.size() == 1 && path[0] == XmlTagName::k_Name)
             {
-              ret.Name = node.Value;
+              ret.Name = node.Value.ToString();
             }
             else if (
                 path.size() == 2 && path[0] == XmlTagName::k_Properties
                 && path[1] == XmlTagName::k_Etag)
             {
-              ret.ETag = node.Value;
+              ret.ETag = node.Value.ToString();
             }
             else if (
                 path.size() == 2 && path[0] == XmlTagName::k_Properties
                 && path[1] == XmlTagName::k_LastModified)
             {
-              ret.LastModified = node.Value;
+              ret.LastModified = node.Value.ToString();
             }
             else if (
                 path.size() == 2 && path[0] == XmlTagName::k_Properties
                 && path[1] == XmlTagName::k_PublicAccess)
             {
-              ret.AccessType = PublicAccessTypeFromString(node.Value);
+              ret.AccessType = PublicAccessTypeFromString(node.Value.ToString());
             }
             else if (
                 path.size() == 2 && path[0] == XmlTagName::k_Properties
                 && path[1] == XmlTagName::k_HasImmutabilityPolicy)
             {
-              ret.HasImmutabilityPolicy = std::strcmp(node.Value, "true") == 0;
+              ret.HasImmutabilityPolicy = node.Value == "true";
             }
             else if (
                 path.size() == 2 && path[0] == XmlTagName::k_Properties
                 && path[1] == XmlTagName::k_HasLegalHold)
             {
-              ret.HasLegalHold = std::strcmp(node.Value, "true") == 0;
+              ret.HasLegalHold = node.Value == "true";
             }
             else if (
                 path.size() == 2 && path[0] == XmlTagName::k_Properties
                 && path[1] == XmlTagName::k_LeaseStatus)
             {
-              ret.LeaseStatus = BlobLeaseStatusFromString(node.Value);
+              ret.LeaseStatus = BlobLeaseStatusFromString(node.Value.ToString());
             }
             else if (
                 path.size() == 2 && path[0] == XmlTagName::k_Properties
                 && path[1] == XmlTagName::k_LeaseState)
             {
-              ret.LeaseState = BlobLeaseStateFromString(node.Value);
+              ret.LeaseState = BlobLeaseStateFromString(node.Value.ToString());
             }
             else if (
                 path.size() == 2 && path[0] == XmlTagName::k_Properties
                 && path[1] == XmlTagName::k_LeaseDuration)
             {
-              ret.LeaseDuration = node.Value;
+              ret.LeaseDuration = node.Value.ToString();
             }
           }
         }
@@ -2543,7 +2544,7 @@ namespace Azure { namespace Storage { namespace Blobs {
         return ret;
       }
 
-      static std::map<std::string, std::string> MetadataFromXml(XmlReader& reader)
+      static std::map<std::string, std::string> MetadataFromXml(XmlPullReader& reader)
       {
         std::map<std::string, std::string> ret;
         int depth = 0;
@@ -2559,7 +2560,7 @@ namespace Azure { namespace Storage { namespace Blobs {
           {
             if (depth++ == 0)
             {
-              key = node.Name;
+              key = node.Name.ToString();
             }
           }
           else if (node.Type == XmlNodeType::EndTag)
@@ -2571,7 +2572,7 @@ namespace Azure { namespace Storage { namespace Blobs {
           }
           else if (depth == 1 && node.Type == XmlNodeType::Text)
           {
-            ret.emplace(std::move(key), std::string(node.Value));
+            ret.emplace(std::move(key), node.Value.ToString());
           }
         }
         return ret;
@@ -2996,6 +2997,27 @@ namespace Azure { namespace Storage { namespace Blobs {
           Azure::Core::Http::HttpPipeline& pipeline,
           const std::string& url,
           const ListBlobsFlatOptions& options)
+      {
+        auto pHttpResponse = SendListBlobsFlat(context, pipeline, url, options);
+        Azure::Core::Http::RawResponse& httpResponse = *pHttpResponse;
+        BlobsFlatSegment response;
+        {
+          const auto& httpResponseBody = httpResponse.GetBody();
+          XmlPullReader reader(
+              reinterpret_cast<const char*>(httpResponseBody.data()), httpResponseBody.size());
+          response = BlobsFlatSegmentFromXml(reader);
+        }
+        return Azure::Core::Response<BlobsFlatSegment>(
+            std::move(response), std::move(pHttpResponse));
+      }
+
+      // Sends a ListBlobsFlat request and returns the successful response, left for the caller to
+      // deserialize.
+      static std::unique_ptr<Azure::Core::Http::RawResponse> SendListBlobsFlat(
+          Azure::Core::Context context,
+          Azure::Core::Http::HttpPipeline& pipeline,
+          const std::string& url,
+          const ListBlobsFlatOptions& options)
       {
         unused(options);
         auto request = Azure::Core::Http::Request(Azure::Core::Http::HttpMethod::Get, url);
@@ -3024,23 +3046,14 @@ namespace Azure { namespace Storage { namespace Blobs {
           request.AddQueryParameter("include", list_blobs_include_item);
         }
         auto pHttpResponse = pipeline.Send(context, request);
-        Azure::Core::Http::RawResponse& httpResponse = *pHttpResponse;
-        BlobsFlatSegment response;
         auto http_status_code
             = static_cast<std::underlying_type<Azure::Core::Http::HttpStatusCode>::type>(
-                httpResponse.GetStatusCode());
+                pHttpResponse->GetStatusCode());
         if (!(http_status_code == 200))
         {
           throw StorageError::CreateFromResponse(context, std::move(pHttpResponse));
         }
-        {
-          const auto& httpResponseBody = httpResponse.GetBody();
-          XmlReader reader(
-              reinterpret_cast<const char*>(httpResponseBody.data()), httpResponseBody.size());
-          response = BlobsFlatSegmentFromXml(reader);
-        }
-        return Azure::Core::Response<BlobsFlatSegment>(
-            std::move(response), std::move(pHttpResponse));
+        return pHttpResponse;
       }
 
       struct ListBlobsByHierarchyOptions
@@ -3101,7 +3114,7 @@ namespace Azure { namespace Storage { namespace Blobs {
         }
         {
           const auto& httpResponseBody = httpResponse.GetBody();
-          XmlReader reader(
+          XmlPullReader reader(
               reinterpret_cast<const char*>(httpResponseBody.data()), httpResponseBody.size());
           response = BlobsHierarchySegmentFromXml(reader);
         }
@@ -3280,7 +3293,7 @@ namespace Azure { namespace Storage { namespace Blobs {
         return ret;
       }
 
-      static BlobsFlatSegment BlobsFlatSegmentFromXml(XmlReader& reader)
+      static BlobsFlatSegment BlobsFlatSegmentFromXml(XmlPullReader& reader)
       {
         BlobsFlatSegment ret;
         enum class XmlTagName
@@ -3314,27 +3327,27 @@ namespace Azure { namespace Storage { namespace Blobs {
           }
           else if (node.Type == XmlNodeType::StartTag)
           {
-            if (std::strcmp(node.Name, "EnumerationResults") == 0)
+            if (node.Name == "EnumerationResults")
             {
               path.emplace_back(XmlTagName::k_EnumerationResults);
             }
-            else if (std::strcmp(node.Name, "Prefix") == 0)
+            else if (node.Name == "Prefix")
             {
               path.emplace_back(XmlTagName::k_Prefix);
             }
-            else if (std::strcmp(node.Name, "Marker") == 0)
+            else if (node.Name == "Marker")
             {
               path.emplace_back(XmlTagName::k_Marker);
             }
-            else if (std::strcmp(node.Name, "NextMarker") == 0)
+            else if (node.Name == "NextMarker")
             {
               path.emplace_back(XmlTagName::k_NextMarker);
             }
-            else if (std::strcmp(node.Name, "Blobs") == 0)
+            else if (node.Name == "Blobs")
             {
               path.emplace_back(XmlTagName::k_Blobs);
             }
-            else if (std::strcmp(node.Name, "Blob") == 0)
+            else if (node.Name == "Blob")
             {
               path.emplace_back(XmlTagName::k_Blob);
             }
@@ -3354,40 +3367,40 @@ namespace Azure { namespace Storage { namespace Blobs {
             if (path.size() == 2 && path[0] == XmlTagName::k_EnumerationResults
                 && path[1] == XmlTagName::k_Prefix)
             {
-              ret.Prefix = node.Value;
+              ret.Prefix = node.Value.ToString();
             }
             else if (
                 path.size() == 2 && path[0] == XmlTagName::k_EnumerationResults
                 && path[1] == XmlTagName::k_Marker)
             {
-              ret.Marker = node.Value;
+              ret.Marker = node.Value.ToString();
             }
             else if (
                 path.size() == 2 && path[0] == XmlTagName::k_EnumerationResults
                 && path[1] == XmlTagName::k_NextMarker)
             {
-              ret.NextMarker = node.Value;
+              ret.NextMarker = node.Value.ToString();
             }
           }
           else if (node.Type == XmlNodeType::Attribute)
           {
             if (path.size() == 1 && path[0] == XmlTagName::k_EnumerationResults
-                && std::strcmp(node.Name, "ServiceEndpoint") == 0)
+                && node.Name == "ServiceEndpoint")
             {
-              ret.ServiceEndpoint = node.Value;
+              ret.ServiceEndpoint = node.Value.ToString();
             }
             else if (
                 path.size() == 1 && path[0] == XmlTagName::k_EnumerationResults
-                && std::strcmp(node.Name, "ContainerName") == 0)
+                && node.Name == "ContainerName")
             {
-              ret.Container = node.Value;
+              ret.Container = node.Value.ToString();
             }
           }
         }
         return ret;
       }
 
-      static BlobsHierarchySegment BlobsHierarchySegmentFromXml(XmlReader& reader)
+      static BlobsHierarchySegment BlobsHierarchySegmentFromXml(XmlPullReader& reader)
       {
         BlobsHierarchySegment ret;
         enum class XmlTagName
@@ -3423,35 +3436,35 @@ namespace Azure { namespace Storage { namespace Blobs {
           }
           else if (node.Type == XmlNodeType::StartTag)
           {
-            if (std::strcmp(node.Name, "EnumerationResults") == 0)
+            if (node.Name == "EnumerationResults")
             {
               path.emplace_back(XmlTagName::k_EnumerationResults);
             }
-            else if (std::strcmp(node.Name, "Prefix") == 0)
+            else if (node.Name == "Prefix")
             {
               path.emplace_back(XmlTagName::k_Prefix);
             }
-            else if (std::strcmp(node.Name, "Delimiter") == 0)
+            else if (node.Name == "Delimiter")
             {
               path.emplace_back(XmlTagName::k_Delimiter);
             }
-            else if (std::strcmp(node.Name, "Marker") == 0)
+            else if (node.Name == "Marker")
             {
               path.emplace_back(XmlTagName::k_Marker);
             }
-            else if (std::strcmp(node.Name, "NextMarker") == 0)
+            else if (node.Name == "NextMarker")
             {
               path.emplace_back(XmlTagName::k_NextMarker);
             }
-            else if (std::strcmp(node.Name, "Blobs") == 0)
+            else if (node.Name == "Blobs")
             {
               path.emplace_back(XmlTagName::k_Blobs);
             }
-            else if (std::strcmp(node.Name, "Blob") == 0)
+            else if (node.Name == "Blob")
             {
               path.emplace_back(XmlTagName::k_Blob);
             }
-            else if (std::strcmp(node.Name, "BlobPrefix") == 0)
+            else if (node.Name == "BlobPrefix")
             {
               path.emplace_back(XmlTagName::k_BlobPrefix);
             }
@@ -3478,46 +3491,46 @@ namespace Azure { namespace Storage { namespace Blobs {
             if (path.size() == 2 && path[0] == XmlTagName::k_EnumerationResults
                 && path[1] == XmlTagName::k_Prefix)
             {
-              ret.Prefix = node.Value;
+              ret.Prefix = node.Value.ToString();
             }
             else if (
                 path.size() == 2 && path[0] == XmlTagName::k_EnumerationResults
                 && path[1] == XmlTagName::k_Delimiter)
             {
-              ret.Delimiter = node.Value;
+              ret.Delimiter = node.Value.ToString();
             }
             else if (
                 path.size() == 2 && path[0] == XmlTagName::k_EnumerationResults
                 && path[1] == XmlTagName::k_Marker)
             {
-              ret.Marker = node.Value;
+              ret.Marker = node.Value.ToString();
             }
             else if (
                 path.size() == 2 && path[0] == XmlTagName::k_EnumerationResults
                 && path[1] == XmlTagName::k_NextMarker)
             {
-              ret.NextMarker = node.Value;
+              ret.NextMarker = node.Value.ToString();
             }
           }
           else if (node.Type == XmlNodeType::Attribute)
           {
             if (path.size() == 1 && path[0] == XmlTagName::k_EnumerationResults
-                && std::strcmp(node.Name, "ServiceEndpoint") == 0)
+                && node.Name == "ServiceEndpoint")
             {
-              ret.ServiceEndpoint = node.Value;
+              ret.ServiceEndpoint = node.Value.ToString();
             }
             else if (
                 path.size() == 1 && path[0] == XmlTagName::k_EnumerationResults
-                && std::strcmp(node.Name, "ContainerName") == 0)
+                && node.Name == "ContainerName")
             {
-              ret.Container = node.Value;
+              ret.Container = node.Value.ToString();
             }
           }
         }
         return ret;
       }
 
-      static BlobItem BlobItemFromXml(XmlReader& reader)
+      static BlobItem BlobItemFromXml(XmlPullReader& reader)
       {
         BlobItem ret;
         enum class XmlTagName
@@ -3568,95 +3581,95 @@ namespace Azure { namespace Storage { namespace Blobs {
           }
           else if (node.Type == XmlNodeType::StartTag)
           {
-            if (std::strcmp(node.Name, "Name") == 0)
+            if (node.Name == "Name")
             {
               path.emplace_back(XmlTagName::k_Name);
             }
-            else if (std::strcmp(node.Name, "Deleted") == 0)
+            else if (node.Name == "Deleted")
             {
               path.emplace_back(XmlTagName::k_Deleted);
             }
-            else if (std::strcmp(node.Name, "Snapshot") == 0)
+            else if (node.Name == "Snapshot")
             {
               path.emplace_back(XmlTagName::k_Snapshot);
             }
-            else if (std::strcmp(node.Name, "Properties") == 0)
+            else if (node.Name == "Properties")
             {
               path.emplace_back(XmlTagName::k_Properties);
             }
-            else if (std::strcmp(node.Name, "Content-Type") == 0)
+            else if (node.Name == "Content-Type")
             {
               path.emplace_back(XmlTagName::k_ContentType);
             }
-            else if (std::strcmp(node.Name, "Content-Encoding") == 0)
+            else if (node.Name == "Content-Encoding")
             {
               path.emplace_back(XmlTagName::k_ContentEncoding);
             }
-            else if (std::strcmp(node.Name, "Content-Language") == 0)
+            else if (node.Name == "Content-Language")
             {
               path.emplace_back(XmlTagName::k_ContentLanguage);
             }
-            else if (std::strcmp(node.Name, "Content-MD5") == 0)
+            else if (node.Name == "Content-MD5")
             {
               path.emplace_back(XmlTagName::k_ContentMD5);
             }
-            else if (std::strcmp(node.Name, "Cache-Control") == 0)
+            else if (node.Name == "Cache-Control")
             {
               path.emplace_back(XmlTagName::k_CacheControl);
             }
-            else if (std::strcmp(node.Name, "Content-Disposition") == 0)
+            else if (node.Name == "Content-Disposition")
             {
               path.emplace_back(XmlTagName::k_ContentDisposition);
             }
-            else if (std::strcmp(node.Name, "Creation-Time") == 0)
+            else if (node.Name == "Creation-Time")
             {
               path.emplace_back(XmlTagName::k_CreationTime);
             }
-            else if (std::strcmp(node.Name, "Last-Modified") == 0)
+            else if (node.Name == "Last-Modified")
             {
               path.emplace_back(XmlTagName::k_LastModified);
             }
-            else if (std::strcmp(node.Name, "Etag") == 0)
+            else if (node.Name == "Etag")
             {
               path.emplace_back(XmlTagName::k_Etag);
             }
-            else if (std::strcmp(node.Name, "Content-Length") == 0)
+            else if (node.Name == "Content-Length")
             {
               path.emplace_back(XmlTagName::k_ContentLength);
             }
-            else if (std::strcmp(node.Name, "BlobType") == 0)
+            else if (node.Name == "BlobType")
             {
               path.emplace_back(XmlTagName::k_BlobType);
             }
-            else if (std::strcmp(node.Name, "AccessTier") == 0)
+            else if (node.Name == "AccessTier")
             {
               path.emplace_back(XmlTagName::k_AccessTier);
             }
-            else if (std::strcmp(node.Name, "AccessTierInferred") == 0)
+            else if (node.Name == "AccessTierInferred")
             {
               path.emplace_back(XmlTagName::k_AccessTierInferred);
             }
-            else if (std::strcmp(node.Name, "LeaseStatus") == 0)
+            else if (node.Name == "LeaseStatus")
             {
               path.emplace_back(XmlTagName::k_LeaseStatus);
             }
-            else if (std::strcmp(node.Name, "LeaseState") == 0)
+            else if (node.Name == "LeaseState")
             {
               path.emplace_back(XmlTagName::k_LeaseState);
             }
-            else if (std::strcmp(node.Name, "LeaseDuration") == 0)
+            else if (node.Name == "LeaseDuration")
             {
               path.emplace_back(XmlTagName::k_LeaseDuration);
             }
-            else if (std::strcmp(node.Name, "ServerEncrypted") == 0)
+            else if (node.Name == "ServerEncrypted")
             {
               path.emplace_back(XmlTagName::k_ServerEncrypted);
             }
-            else if (std::strcmp(node.Name, "EncryptionKeySHA256") == 0)
+            else if (node.Name == "EncryptionKeySHA256")
             {
               path.emplace_back(XmlTagName::k_EncryptionKeySHA256);
             }
-            else if (std::strcmp(node.Name, "Metadata") == 0)
+            else if (node.Name == "Metadata")
             {
               path.emplace_back(XmlTagName::k_Metadata);
             }
@@ -3674,130 +3687,130 @@ namespace Azure { namespace Storage { namespace Blobs {
           {
             if (path.size() == 1 && path[0] == XmlTagName::k_Name)
             {
-              ret.Name = node.Value;
+              ret.Name = node.Value.ToString();
             }
             else if (path.size() == 1 && path[0] == XmlTagName::k_Deleted)
             {
-              ret.Deleted = std::strcmp(node.Value, "true") == 0;
+              ret.Deleted = node.Value == "true";
             }
             else if (path.size() == 1 && path[0] == XmlTagName::k_Snapshot)
             {
-              ret.Snapshot = node.Value;
+              ret.Snapshot = node.Value.ToString();
             }
             else if (
                 path.size() == 2 && path[0] == XmlTagName::k_Properties
                 && path[1] == XmlTagName::k_ContentType)
             {
-              ret.HttpHeaders.ContentType = node.Value;
+              ret.HttpHeaders.ContentType = node.Value.ToString();
             }
             else if (
                 path.size() == 2 && path[0] == XmlTagName::k_Properties
                 && path[1] == XmlTagName::k_ContentEncoding)
             {
-              ret.HttpHeaders.ContentEncoding = node.Value;
+              ret.HttpHeaders.ContentEncoding = node.Value.ToString();
             }
             else if (
                 path.size() == 2 && path[0] == XmlTagName::k_Properties
                 && path[1] == XmlTagName::k_ContentLanguage)
             {
-              ret.HttpHeaders.ContentLanguage = node.Value;
+              ret.HttpHeaders.ContentLanguage = node.Value.ToString();
             }
             else if (
                 path.size() == 2 && path[0] == XmlTagName::k_Properties
                 && path[1] == XmlTagName::k_ContentMD5)
             {
-              ret.HttpHeaders.ContentMd5 = node.Value;
+              ret.HttpHeaders.ContentMd5 = node.Value.ToString();
             }
             else if (
                 path.size() == 2 && path[0] == XmlTagName::k_Properties
                 && path[1] == XmlTagName::k_CacheControl)
             {
-              ret.HttpHeaders.CacheControl = node.Value;
+              ret.HttpHeaders.CacheControl = node.Value.ToString();
             }
             else if (
                 path.size() == 2 && path[0] == XmlTagName::k_Properties
                 && path[1] == XmlTagName::k_ContentDisposition)
             {
-              ret.HttpHeaders.ContentDisposition = node.Value;
+              ret.HttpHeaders.ContentDisposition = node.Value.ToString();
             }
             else if (
                 path.size() == 2 && path[0] == XmlTagName::k_Properties
                 && path[1] == XmlTagName::k_CreationTime)
             {
-              ret.CreationTime = node.Value;
+              ret.CreationTime = node.Value.ToString();
             }
             else if (
                 path.size() == 2 && path[0] == XmlTagName::k_Properties
                 && path[1] == XmlTagName::k_LastModified)
             {
-              ret.LastModified = node.Value;
+              ret.LastModified = node.Value.ToString();
             }
             else if (
                 path.size() == 2 && path[0] == XmlTagName::k_Properties
                 && path[1] == XmlTagName::k_Etag)
             {
-              ret.ETag = node.Value;
+              ret.ETag = node.Value.ToString();
             }
             else if (
                 path.size() == 2 && path[0] == XmlTagName::k_Properties
                 && path[1] == XmlTagName::k_ContentLength)
             {
-              ret.ContentLength = std::stoll(node.Value);
+              ret.ContentLength = std::stoll(node.Value.ToString());
             }
             else if (
                 path.size() == 2 && path[0] == XmlTagName::k_Properties
                 && path[1] == XmlTagName::k_BlobType)
             {
-              ret.BlobType = BlobTypeFromString(node.Value);
+              ret.BlobType = BlobTypeFromString(node.Value.ToString());
             }
             else if (
                 path.size() == 2 && path[0] == XmlTagName::k_Properties
                 && path[1] == XmlTagName::k_AccessTier)
             {
-              ret.Tier = AccessTierFromString(node.Value);
+              ret.Tier = AccessTierFromString(node.Value.ToString());
             }
             else if (
                 path.size() == 2 && path[0] == XmlTagName::k_Properties
                 && path[1] == XmlTagName::k_AccessTierInferred)
             {
-              ret.AccessTierInferred = std::strcmp(node.Value, "true") == 0;
+              ret.AccessTierInferred = node.Value == "true";
             }
             else if (
                 path.size() == 2 && path[0] == XmlTagName::k_Properties
                 && path[1] == XmlTagName::k_LeaseStatus)
             {
-              ret.LeaseStatus = BlobLeaseStatusFromString(node.Value);
+              ret.LeaseStatus = BlobLeaseStatusFromString(node.Value.ToString());
             }
             else if (
                 path.size() == 2 && path[0] == XmlTagName::k_Properties
                 && path[1] == XmlTagName::k_LeaseState)
             {
-              ret.LeaseState = BlobLeaseStateFromString(node.Value);
+              ret.LeaseState = BlobLeaseStateFromString(node.Value.ToString());
             }
             else if (
                 path.size() == 2 && path[0] == XmlTagName::k_Properties
                 && path[1] == XmlTagName::k_LeaseDuration)
             {
-              ret.LeaseDuration = node.Value;
+              ret.LeaseDuration = node.Value.ToString();
             }
             else if (
                 path.size() == 2 && path[0] == XmlTagName::k_Properties
                 && path[1] == XmlTagName::k_ServerEncrypted)
             {
-              ret.ServerEncrypted = std::strcmp(node.Value, "true") == 0;
+              ret.ServerEncrypted = node.Value == "true";
             }
             else if (
                 path.size() == 2 && path[0] == XmlTagName::k_Properties
                 && path[1] == XmlTagName::k_EncryptionKeySHA256)
             {
-              ret.EncryptionKeySha256 = node.Value;
+              ret.EncryptionKeySha256 = node.Value.ToString();
             }
           }
         }
         return ret;
       }
 
-      static BlobPrefix BlobPrefixFromXml(XmlReader& reader)
+      static BlobPrefix BlobPrefixFromXml(XmlPullReader& reader)
       {
         BlobPrefix ret;
         enum class XmlTagName
@@ -3826,7 +3839,7 @@ namespace Azure { namespace Storage { namespace Blobs {
           }
           else if (node.Type == XmlNodeType::StartTag)
           {
-            if (std::strcmp(node.Name, "Name") == 0)
+            if (node.Name == "Name")
             {
               path.emplace_back(XmlTagName::k_Name);
             }
@@ -3839,7 +3852,7 @@ namespace Azure { namespace Storage { namespace Blobs {
           {
             if (path.size() == 1 && path[0] == XmlTagName::k_Name)
             {
-              ret.Name = node.Value;
+              ret.Name = node.Value.ToString();
             }
           }
         }
@@ -3933,7 +3946,7 @@ namespace Azure { namespace Storage { namespace Blobs {
         return ret;
       }
 
-      static std::map<std::string, std::string> MetadataFromXml(XmlReader& reader)
+      static std::map<std::string, std::string> MetadataFromXml(XmlPullReader& reader)
       {
         std::map<std::string, std::string> ret;
         int depth = 0;
@@ -3949,7 +3962,7 @@ namespace Azure { namespace Storage { namespace Blobs {
           {
             if (depth++ == 0)
             {
-              key = node.Name;
+              key = node.Name.ToString();
             }
           }
           else if (node.Type == XmlNodeType::EndTag)
@@ -3961,7 +3974,7 @@ namespace Azure { namespace Storage { namespace Blobs {
           }
           else if (depth == 1 && node.Type == XmlNodeType::Text)
           {
-            ret.emplace(std::move(key), std::string(node.Value));
+            ret.emplace(std::move(key), node.Value.ToString());
           }
         }
         return ret;
@@ -4007,6 +4020,8 @@ namespace Azure { namespace Storage { namespace Blobs {
       {
         Azure::Core::Nullable<int32_t> Timeout;
         Azure::Core::Nullable<std::pair<int64_t, int64_t>> Range;
+        Azure::Core::Nullable<bool> RangeGetContentMd5;
+        Azure::Core::Nullable<bool> RangeGetContentCrc64;
         Azure::Core::Nullable<std::string> EncryptionKey;
         Azure::Core::Nullable<std::string> EncryptionKeySha256;
         Azure::Core::Nullable<std::string> EncryptionAlgorithm;
@@ -4045,6 +4060,18 @@ namespace Azure { namespace Storage { namespace Blobs {
             request.AddHeader("x-ms-range", "bytes=" + std::to_string(startOffset) + "-");
           }
         }
+        if (options.RangeGetContentMd5.HasValue())
+        {
+          request.AddHeader(
+              "x-ms-range-get-content-md5",
+              options.RangeGetContentMd5.GetValue() ? "true" : "false");
+        }
+        if (options.RangeGetContentCrc64.HasValue())
+        {
+          request.AddHeader(
+              "x-ms-range-get-content-crc64",
+              options.RangeGetContentCrc64.GetValue() ? "true" : "false");
+        }
         if (options.EncryptionKey.HasValue())
         {
           request.AddHeader("x-ms-encryption-key", options.EncryptionKey.GetValue());
@@ -0,0 +1,148 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include "common/storage_error.hpp"
+#include "common/transfer_governor.hpp"
+#include "http/buffer_pool.hpp"
+#include "nullable.hpp"
+#include "response.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <utility>
+
+namespace Azure { namespace Storage { namespace Details {
+
+  constexpr int64_t c_defaultDownloadChunkSize = 4 * 1024 * 1024;
+
+  /**
+   * @brief The first chunk of a download in chunks, which tells the size of the range.
+   */
+  template <class T> struct FirstDownloadChunk
+  {
+    Azure::Core::Response<T> Chunk;
+    // Held until the body of the chunk is read.
+    TransferGovernor::Permit Permit;
+    // Empty unless a transfer buffer was asked for.
+    Azure::Core::Http::PooledBuffer Buffer;
+    int64_t Length;
+    int64_t RangeSize;
+  };
+
+  /**
+   * @brief Returns the size of a blob or file from the Content-Range of a ranged download.
+   */
+  inline int64_t GetSizeFromContentRange(const std::string& contentRange)
+  {
+    return std::stoll(contentRange.substr(contentRange.find('/') + 1));
+  }
+
+  /**
+   * @brief Downloads the first chunk of a range of a blob or file. If it's small, that's the whole
+   * range in one shot, otherwise the response tells the size of the range, and the rest can be
+   * downloaded in chunks.
+   *
+   * @param offset The offset of the range, null for the beginning.
+   * @param length The length of the range, null up to the end.
+   * @param firstChunkLength The maximum length of the first chunk.
+   * @param ranged Whether the first chunk is requested as a range even without an offset. Such a
+   * request fails on an empty blob or file, and is then sent again without a range.
+   * @param download Downloads a range, or everything for a null offset.
+   * @param getSize Returns the size of the blob or file from a ranged response, or the length of
+   * the content otherwise.
+   * @param maxBufferSize If positive, a transfer buffer of up to this size is taken from the pool
+   * after the permit and before the request, like for the other chunks.
+   */
+  template <class T>
+  FirstDownloadChunk<T> DownloadFirstChunk(
+      const Azure::Core::Nullable<int64_t>& offset,
+      const Azure::Core::Nullable<int64_t>& length,
+      int64_t firstChunkLength,
+      bool ranged,
+      const std::function<Azure::Core::Response<T>(
+          const Azure::Core::Nullable<int64_t>&,
+          const Azure::Core::Nullable<int64_t>&)>& download,
+      const std::function<int64_t(const T&, bool)>& getSize,
+      int64_t maxBufferSize = 0)
+  {
+    const int64_t rangeOffset = offset.HasValue() ? offset.GetValue() : 0;
+    if (length.HasValue())
+    {
+      firstChunkLength = std::min(firstChunkLength, length.GetValue());
+    }
+    Azure::Core::Nullable<int64_t> chunkOffset = offset;
+    if (ranged)
+    {
+      chunkOffset = rangeOffset;
+    }
+    Azure::Core::Nullable<int64_t> chunkLength;
+    if (chunkOffset.HasValue())
+    {
+      chunkLength = firstChunkLength;
+    }
+
+    auto permit = TransferGovernor::Default().Acquire(firstChunkLength);
+    Azure::Core::Http::PooledBuffer buffer;
+    if (maxBufferSize > 0)
+    {
+      buffer = Azure::Core::Http::BufferPool::Default().Acquire(
+          std::min(std::max(firstChunkLength, int64_t(1)), maxBufferSize));
+    }
+    auto downloadFirstChunk = [&]() {
+      try
+      {
+        return download(chunkOffset, chunkLength);
+      }
+      catch (StorageError& e)
+      {
+        // An empty blob or file has no range to download.
+        if (offset.HasValue() || !chunkOffset.HasValue()
+            || e.StatusCode != Azure::Core::Http::HttpStatusCode::RangeNotSatisfiable)
+        {
+          throw;
+        }
+      }
+      chunkOffset.Reset();
+      chunkLength.Reset();
+      return download(chunkOffset, chunkLength);
+    };
+    auto chunk = downloadFirstChunk();
+
+    int64_t rangeSize = getSize(*chunk, chunkOffset.HasValue());
+    if (chunkOffset.HasValue())
+    {
+      rangeSize -= rangeOffset;
+      if (length.HasValue())
+      {
+        rangeSize = std::min(rangeSize, length.GetValue());
+      }
+    }
+    firstChunkLength = std::min(firstChunkLength, rangeSize);
+    return FirstDownloadChunk<T>{
+        std::move(chunk), std::move(permit), std::move(buffer), firstChunkLength, rangeSize};
+  }
+
+  /**
+   * @brief Returns the size of the chunks after the first one. Unless given, it's the remaining
+   * size split between the workers, in multiples of 4KiB and at most 4MiB.
+   */
+  inline int64_t GetDownloadChunkSize(
+      const Azure::Core::Nullable<int64_t>& chunkSize,
+      int64_t remainingSize,
+      int concurrency)
+  {
+    if (chunkSize.HasValue())
+    {
+      return chunkSize.GetValue();
+    }
+    constexpr int64_t c_grainSize = 4 * 1024;
+    int64_t size = remainingSize / concurrency;
+    size = (std::max(size, int64_t(1)) + c_grainSize - 1) / c_grainSize * c_grainSize;
+    return std::min(size, c_defaultDownloadChunkSize);
+  }
+
+}}} // namespace Azure::Storage::Details
@@ -3,10 +3,18 @@
 
 #pragma once
 
+#include "common/transfer_executor.hpp"
+#include "common/transfer_governor.hpp"
+#include "common/transfer_tuner.hpp"
+
+#include <algorithm>
 #include <atomic>
+#include <chrono>
 #include <cstdlib>
 #include <functional>
-#include <future>
+#include <mutex>
+#include <utility>
+#include <vector>
 
 namespace Azure { namespace Storage { namespace Details {
 
@@ -16,55 +24,138 @@ namespace Azure { namespace Storage { namespace Details {
       int64_t chunkSize,
       int concurrency,
       // offset, length, chunk id, number of chunks
-      std::function<void(int64_t, int64_t, int64_t, int64_t)> transferFunc)
+      std::function<void(int64_t, int64_t, int64_t, int64_t)> transferFunc,
+      // offset, length, called once a chunk is picked and before it takes a permit
+      std::function<void(int64_t, int64_t)> waitForChunk = nullptr)
   {
-    std::atomic<int> numWorkingThreads{concurrency};
-    std::atomic<int> nextChunkId{0};
-    std::atomic<bool> failed{false};
+    std::atomic<int64_t> nextChunkId{0};
 
     const auto numChunks = (length + chunkSize - 1) / chunkSize;
 
-    auto threadFunc = [&]() {
-      while (true)
+    auto chunkFunc = [&]() {
+      int64_t chunkId = nextChunkId.fetch_add(1);
+      if (chunkId >= numChunks)
       {
-        int chunkId = nextChunkId.fetch_add(1);
-        if (chunkId >= numChunks || failed)
-        {
-          break;
-        }
-        int64_t chunkOffset = offset + chunkSize * chunkId;
-        int64_t chunkLength = std::min(length - chunkSize * chunkId, chunkSize);
-        try
+        return false;
+      }
+      int64_t chunkOffset = offset + chunkSize * chunkId;
+      int64_t chunkLength = std::min(length - chunkSize * chunkId, chunkSize);
+      if (waitForChunk)
+      {
+        waitForChunk(chunkOffset, chunkLength);
+      }
+      auto permit = TransferGovernor::Default().Acquire(chunkLength);
+      transferFunc(chunkOffset, chunkLength, chunkId, numChunks);
+      return chunkId + 1 < numChunks;
+    };
+
+    TransferExecutor::Default().Run(concurrency, chunkFunc);
+  }
+
+  inline void ConcurrentTransfer(
+      // offset and length of every chunk to transfer
+      const std::vector<std::pair<int64_t, int64_t>>& chunks,
+      int concurrency,
+      // offset, length, index of the chunk in chunks, number of chunks
+      std::function<void(int64_t, int64_t, int64_t, int64_t)> transferFunc)
+  {
+    std::atomic<int64_t> nextChunkId{0};
+
+    const auto numChunks = static_cast<int64_t>(chunks.size());
+
+    auto chunkFunc = [&]() {
+      int64_t chunkId = nextChunkId.fetch_add(1);
+      if (chunkId >= numChunks)
+      {
+        return false;
+      }
+      const auto& chunk = chunks[static_cast<std::size_t>(chunkId)];
+      auto permit = TransferGovernor::Default().Acquire(chunk.second);
+      transferFunc(chunk.first, chunk.second, chunkId, numChunks);
+      return chunkId + 1 < numChunks;
+    };
+
+    TransferExecutor::Default().Run(concurrency, chunkFunc);
+  }
+
+  inline void ConcurrentTransfer(
+      // offset and length of every chunk to transfer
+      const std::vector<std::pair<int64_t, int64_t>>& chunks,
+      // Only the concurrency is tuned, the chunks have their given size.
+      TransferTuner& tuner,
+      // offset, length, index of the chunk in chunks, number of chunks
+      std::function<void(int64_t, int64_t, int64_t, int64_t)> transferFunc)
+  {
+    std::atomic<int64_t> nextChunkId{0};
+
+    const auto numChunks = static_cast<int64_t>(chunks.size());
+
+    auto chunkFunc = [&]() {
+      int64_t chunkId = nextChunkId.fetch_add(1);
+      if (chunkId >= numChunks)
+      {
+        return false;
+      }
+      const auto& chunk = chunks[static_cast<std::size_t>(chunkId)];
+      auto permit = TransferGovernor::Default().Acquire(chunk.second);
+      auto timerStart = std::chrono::steady_clock::now();
+      transferFunc(chunk.first, chunk.second, chunkId, numChunks);
+      tuner.OnChunkCompleted(chunk.second, std::chrono::steady_clock::now() - timerStart);
+      return chunkId + 1 < numChunks;
+    };
+
+    TransferExecutor::Default().Run(
+        tuner.GetMaxConcurrency(), [&tuner]() { return tuner.GetConcurrency(); }, chunkFunc);
+  }
+
+  inline void ConcurrentTransfer(
+      int64_t offset,
+      int64_t length,
+      TransferTuner& tuner,
+      // offset, length, chunk id, number of chunks
+      // The number of chunks is only known once the last chunk is issued, earlier chunks get 0.
+      std::function<void(int64_t, int64_t, int64_t, int64_t)> transferFunc,
+      // offset, length, called once a chunk is picked and before it takes a permit
+      std::function<void(int64_t, int64_t)> waitForChunk = nullptr)
+  {
+    std::mutex mutex;
+    int64_t nextOffset = offset;
+    int64_t nextChunkId = 0;
+    const int64_t endOffset = offset + length;
+
+    auto chunkFunc = [&]() {
+      int64_t chunkOffset;
+      int64_t chunkLength;
+      int64_t chunkId;
+      int64_t numChunks = 0;
+      {
+        std::lock_guard<std::mutex> guard(mutex);
+        if (nextOffset >= endOffset)
         {
-          transferFunc(chunkOffset, chunkLength, chunkId, numChunks);
+          return false;
         }
-        catch (std::exception&)
+        chunkOffset = nextOffset;
+        chunkLength = std::min(tuner.GetChunkSize(), endOffset - nextOffset);
+        chunkId = nextChunkId++;
+        nextOffset += chunkLength;
+        if (nextOffset == endOffset)
         {
-          if (failed.exchange(true) == false)
-          {
-            numWorkingThreads.fetch_sub(1);
-            throw;
-          }
+          numChunks = nextChunkId;
         }
       }
-      numWorkingThreads.fetch_sub(1);
+      if (waitForChunk)
+      {
+        waitForChunk(chunkOffset, chunkLength);
+      }
+      auto permit = TransferGovernor::Default().Acquire(chunkLength);
+      auto timerStart = std::chrono::steady_clock::now();
+      transferFunc(chunkOffset, chunkLength, chunkId, numChunks);
+      tuner.OnChunkCompleted(chunkLength, std::chrono::steady_clock::now() - timerStart);
+      return numChunks == 0;
     };
 
-    std::vector<std::future<void>> threadHandles;
-    for (int i = 0; i < concurrency - 1; ++i)
-    {
-      threadHandles.emplace_back(std::async(std::launch::async, threadFunc));
-    }
-    threadFunc();
-    for (auto& handle : threadHandles)
-    {
-      handle.get();
-    }
-
-    if (numWorkingThreads != 0)
-    {
-      std::abort();
-    }
+    TransferExecutor::Default().Run(
+        tuner.GetMaxConcurrency(), [&tuner]() { return tuner.GetConcurrency(); }, chunkFunc);
   }
 
 }}} // namespace Azure::Storage::Details
@@ -0,0 +1,113 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include "common/crypt.hpp"
+#include "context.hpp"
+#include "http/body_stream.hpp"
+#include "http/buffer_pool.hpp"
+#include "nullable.hpp"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Azure { namespace Storage {
+
+  /**
+   * @brief Decorates a body stream by hashing the content as it's read, and comparing the hash
+   * with the one the service sent once the end of the stream is reached. This validates a download
+   * without another pass over the data.
+   *
+   * @remark Read throws std::runtime_error if the hashes don't match.
+   */
+  class HashValidatingStream : public Azure::Core::Http::BodyStream {
+  public:
+    explicit HashValidatingStream(
+        std::unique_ptr<Azure::Core::Http::BodyStream> inner,
+        HashAlgorithm algorithm,
+        std::string expectedHash)
+        : m_inner(std::move(inner)), m_hasher(algorithm), m_expectedHash(std::move(expectedHash))
+    {
+    }
+
+    int64_t Length() const override { return this->m_inner->Length(); }
+    void Rewind() override
+    {
+      this->m_inner->Rewind();
+      this->m_hasher = Details::ContentHasher(this->m_hasher.GetAlgorithm());
+      this->m_bytesRead = 0;
+      this->m_validated = false;
+    }
+    int64_t Read(Azure::Core::Context const& context, uint8_t* buffer, int64_t count) override;
+
+  private:
+    void Validate();
+
+    std::unique_ptr<Azure::Core::Http::BodyStream> m_inner;
+    Details::ContentHasher m_hasher;
+    std::string m_expectedHash;
+    int64_t m_bytesRead = 0;
+    bool m_validated = false;
+  };
+
+  /**
+   * @brief A body stream holding the whole content of another stream in a pooled buffer, hashed
+   * while it was copied. The hash of a request must be sent ahead of its content, so this lets
+   * the content be read from its source only once. A stream of unknown length is read until it
+   * ends, into a buffer growing outside the pool, since the pool couldn't bound it anyway.
+   */
+  class HashedBufferStream : public Azure::Core::Http::BodyStream {
+  public:
+    explicit HashedBufferStream(
+        Azure::Core::Context const& context,
+        Azure::Core::Http::BodyStream& inner,
+        HashAlgorithm algorithm);
+
+    const std::string& GetHash() const { return this->m_hash; }
+
+    int64_t Length() const override { return this->m_length; }
+    void Rewind() override { this->m_offset = 0; }
+    int64_t Read(Azure::Core::Context const& context, uint8_t* buffer, int64_t count) override;
+
+  private:
+    Azure::Core::Http::PooledBuffer m_buffer;
+    std::vector<uint8_t> m_growingBuffer;
+    const uint8_t* m_data = nullptr;
+    int64_t m_length = 0;
+    int64_t m_offset = 0;
+    std::string m_hash;
+  };
+
+  namespace Details {
+    // Sets the hash into the option field of the header its algorithm is sent in.
+    template <class T> void SetContentHash(T& options, HashAlgorithm algorithm, std::string hash)
+    {
+      switch (algorithm)
+      {
+        case HashAlgorithm::Md5:
+          options.ContentMd5 = std::move(hash);
+          break;
+        case HashAlgorithm::Crc64:
+          options.ContentCrc64 = std::move(hash);
+          break;
+      }
+    }
+
+    // Returns the hash of the given algorithm from a response, if the service sent it.
+    template <class T>
+    Azure::Core::Nullable<std::string> GetContentHash(const T& response, HashAlgorithm algorithm)
+    {
+      switch (algorithm)
+      {
+        case HashAlgorithm::Md5:
+          return response.ContentMd5;
+        case HashAlgorithm::Crc64:
+          return response.ContentCrc64;
+      }
+      return Azure::Core::Nullable<std::string>();
+    }
+  } // namespace Details
+
+}} // namespace Azure::Storage
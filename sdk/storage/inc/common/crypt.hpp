@@ -3,6 +3,9 @@
 
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+#include <memory>
 #include <string>
 
 namespace Azure { namespace Storage {
@@ -11,4 +14,142 @@ namespace Azure { namespace Storage {
   std::string Base64Encode(const std::string& text);
   std::string Base64Decode(const std::string& text);
 
+  /**
+   * @brief An HMAC-SHA256 context keyed once and reused for any number of messages, which saves
+   * setting the key up again for every signature.
+   */
+  class HmacSha256 {
+  public:
+    explicit HmacSha256(const std::string& key);
+    ~HmacSha256();
+
+    HmacSha256(const HmacSha256&) = delete;
+    HmacSha256& operator=(const HmacSha256&) = delete;
+
+    /**
+     * @brief Returns the binary HMAC-SHA256 of text. Can be called concurrently from multiple
+     * threads.
+     */
+    std::string Sign(const char* text, std::size_t length) const;
+
+    std::string Sign(const std::string& text) const { return Sign(text.data(), text.length()); }
+
+  private:
+    struct Context;
+    std::unique_ptr<Context> m_context;
+  };
+
+  /**
+   * @brief Algorithms of the hash that the service validates the content of a request or a
+   * response against, to detect corruption in transit.
+   */
+  enum class HashAlgorithm
+  {
+    Md5,
+    Crc64,
+  };
+
+  /**
+   * @brief Computes an MD5 hash incrementally, in the format of the Content-MD5 header.
+   */
+  class Md5 {
+  public:
+    Md5();
+    ~Md5();
+
+    Md5(Md5&& other) noexcept;
+    Md5& operator=(Md5&& other) noexcept;
+
+    /**
+     * @brief Adds the next bytes of the content.
+     */
+    void Update(const uint8_t* data, std::size_t length);
+
+    /**
+     * @brief Returns the base64 encoded MD5 of the content. No more content can be added
+     * afterwards.
+     */
+    std::string Final();
+
+  private:
+    struct Context;
+    std::unique_ptr<Context> m_context;
+  };
+
+  /**
+   * @brief Computes incrementally the CRC64 that storage services use for the x-ms-content-crc64
+   * header.
+   */
+  class Crc64 {
+  public:
+    /**
+     * @brief Adds the next bytes of the content.
+     */
+    void Update(const uint8_t* data, std::size_t length);
+
+    /**
+     * @brief Adds the content hashed by other, as if it directly followed the content hashed so
+     * far. This lets chunks that are hashed in parallel be combined without hashing them again.
+     */
+    void Concatenate(const Crc64& other);
+
+    uint64_t GetValue() const { return m_value; }
+
+    int64_t GetLength() const { return m_length; }
+
+    /**
+     * @brief Returns the base64 encoded CRC64, in the format of the x-ms-content-crc64 header.
+     */
+    std::string Final() const;
+
+  private:
+    uint64_t m_value = 0;
+    int64_t m_length = 0;
+  };
+
+  namespace Details {
+    constexpr std::size_t Base64EncodedLength(std::size_t length) { return (length + 2) / 3 * 4; }
+
+    constexpr std::size_t Base64DecodedMaxLength(std::size_t length)
+    {
+      return (length + 3) / 4 * 3;
+    }
+
+    // Writes the padded base64 encoding of data to output, which must have room for
+    // Base64EncodedLength(length) characters. Returns the number of characters written.
+    std::size_t Base64Encode(const uint8_t* data, std::size_t length, char* output);
+
+    // Writes the bytes encoded by text to output, which must have room for
+    // Base64DecodedMaxLength(length) bytes. Padding is optional. Returns the number of bytes
+    // written, or throws if text is not valid base64.
+    std::size_t Base64Decode(const char* text, std::size_t length, uint8_t* output);
+
+    /**
+     * @brief Hashes content with an algorithm chosen at runtime.
+     */
+    class ContentHasher {
+    public:
+      explicit ContentHasher(HashAlgorithm algorithm);
+
+      HashAlgorithm GetAlgorithm() const { return m_algorithm; }
+
+      void Update(const uint8_t* data, std::size_t length);
+
+      /**
+       * @brief Returns the base64 encoded hash. No more content can be added afterwards.
+       */
+      std::string Final();
+
+    private:
+      HashAlgorithm m_algorithm;
+      Crc64 m_crc64;
+      std::unique_ptr<Md5> m_md5;
+    };
+
+    uint64_t Crc64Update(uint64_t crc, const uint8_t* data, std::size_t length);
+    // Returns the CRC64 of the content of crc1 followed by the content of crc2, which is length2
+    // bytes long.
+    uint64_t Crc64Combine(uint64_t crc1, uint64_t crc2, int64_t length2);
+  } // namespace Details
+
 }} // namespace Azure::Storage
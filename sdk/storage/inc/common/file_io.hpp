@@ -3,21 +3,17 @@
 
 #pragma once
 
-#ifdef _WIN32
-#include <Windows.h>
-#endif
+#include "common/file_io_engine.hpp"
 
 #include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <utility>
 
 namespace Azure { namespace Storage { namespace Details {
 
-#ifdef _WIN32
-  using FileHandle = HANDLE;
-#else
-  using FileHandle = int;
-#endif
-
   class FileReader {
   public:
     FileReader(const std::string& filename);
@@ -28,14 +24,38 @@ namespace Azure { namespace Storage { namespace Details {
 
     int64_t GetFileSize() const { return m_fileSize; }
 
+    // Returns an opaque timestamp of the last modification of the file, which only tells whether
+    // the file has been modified since it was last read.
+    int64_t GetLastModified() const;
+
   private:
     FileHandle m_handle;
     int64_t m_fileSize;
   };
 
+  // Direct I/O needs the memory, the offset and the length of a write aligned to the logical
+  // block size of the device, which is at most the page size in practice.
+  constexpr int64_t c_directIoAlignment = 4 * 1024;
+
+  struct FileWriterOptions
+  {
+    // Existing content is kept when false, so that an interrupted download can be resumed.
+    bool Truncate = true;
+
+    // Writes aligned to c_directIoAlignment bypass the page cache. Other writes, typically the
+    // tail of the file, still go through it. Only supported on Linux, ignored elsewhere.
+    bool DirectIo = false;
+
+    // Starts writing back each write as soon as it's done, and once more than this many bytes
+    // haven't been waited for, waits for the oldest ones and drops them from the page cache. This
+    // bounds the memory a large download holds in the page cache. 0 leaves write back to the OS.
+    // Only supported on Linux, ignored elsewhere.
+    int64_t WriteBackInterval = 0;
+  };
+
   class FileWriter {
   public:
-    FileWriter(const std::string& filename);
+    FileWriter(const std::string& filename, const FileWriterOptions& options = FileWriterOptions());
 
     ~FileWriter();
 
@@ -43,8 +63,36 @@ namespace Azure { namespace Storage { namespace Details {
 
     void Write(const uint8_t* buffer, int64_t length, int64_t offset);
 
+    // Starts writing through engine. The buffer must stay valid until WaitWrite returns.
+    std::shared_ptr<FileIoOperation> WriteAsync(
+        FileIoEngine& engine,
+        const uint8_t* buffer,
+        int64_t length,
+        int64_t offset);
+
+    // Waits for a write started with WriteAsync, throws if it failed.
+    void WaitWrite(FileIoOperation& operation);
+
+    void SetFileSize(int64_t size);
+
+    // Reserves disk space for the first size bytes of the file, so that chunks written out of
+    // order don't fragment it. The file is extended to size bytes where supported. Does nothing if
+    // the file system can't preallocate.
+    void Preallocate(int64_t size);
+
   private:
+    // Returns the handle to write the range through, the direct one if the write is aligned.
+    FileHandle GetWriteHandle(const uint8_t* buffer, int64_t length, int64_t offset) const;
+    void WriteBack(int64_t offset, int64_t length);
+
     FileHandle m_handle;
+    // A second handle on the file opened for direct I/O, if requested and supported.
+    FileHandle m_directHandle;
+    int64_t m_writeBackInterval = 0;
+    std::mutex m_writeBackMutex;
+    // offset and length of the writes that haven't been waited for yet, oldest first
+    std::deque<std::pair<int64_t, int64_t>> m_pendingWriteBacks;
+    int64_t m_pendingWriteBackBytes = 0;
   };
 
 }}} // namespace Azure::Storage::Details
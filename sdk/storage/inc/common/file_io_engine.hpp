@@ -0,0 +1,177 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#ifdef _WIN32
+#include <Windows.h>
+#endif
+
+#include "http/buffer_pool.hpp"
+
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace Azure { namespace Storage { namespace Details {
+
+#ifdef _WIN32
+  using FileHandle = HANDLE;
+#else
+  using FileHandle = int;
+#endif
+
+  class FileIoEngine;
+
+  /**
+   * @brief A positional read or write submitted to a FileIoEngine.
+   */
+  class FileIoOperation {
+  public:
+    /**
+     * @brief Waits for the operation to complete, and transfers synchronously whatever the engine
+     * left out. Throws if the operation failed, or if a read hit the end of the file.
+     */
+    void Wait();
+
+    FileHandle GetHandle() const { return m_handle; }
+    int64_t GetOffset() const { return m_offset; }
+    int64_t GetLength() const { return m_length; }
+
+  private:
+    friend class FileIoEngine;
+
+    void Complete(int64_t result);
+
+    FileHandle m_handle;
+    uint8_t* m_buffer = nullptr;
+    int64_t m_length = 0;
+    int64_t m_offset = 0;
+    bool m_isWrite = false;
+
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    bool m_completed = false;
+    bool m_waited = false;
+    // bytes transferred, or a negated errno
+    int64_t m_result = 0;
+    // Keeps the operation alive while the kernel owns it.
+    std::shared_ptr<FileIoOperation> m_self;
+    // The io_uring submission refers to this rather than to the buffer directly.
+    struct IoVector
+    {
+      void* Base;
+      std::size_t Length;
+    } m_ioVector;
+  };
+
+  /**
+   * @brief Runs file reads and writes asynchronously through io_uring where the kernel allows it,
+   * so that a few transfer threads can keep many disk operations in flight. Elsewhere, and when
+   * io_uring can't be set up, operations run synchronously with pread and pwrite when they're
+   * submitted. Thread safe.
+   */
+  class FileIoEngine {
+  public:
+    /**
+     * @brief Sets up an engine with room for queueDepth operations in flight, which uses io_uring
+     * if useIoUring is true and it's available.
+     */
+    explicit FileIoEngine(bool useIoUring = true, unsigned queueDepth = 64);
+    ~FileIoEngine();
+
+    FileIoEngine(const FileIoEngine&) = delete;
+    FileIoEngine& operator=(const FileIoEngine&) = delete;
+
+    /**
+     * @brief Returns the engine shared by the transfers of the process.
+     */
+    static FileIoEngine& Default();
+
+    /**
+     * @brief Returns whether operations run asynchronously.
+     */
+    bool IsAsync() const { return m_ring != nullptr; }
+
+    /**
+     * @brief Starts reading length bytes at offset into buffer, which must stay valid until the
+     * operation completes.
+     */
+    std::shared_ptr<FileIoOperation> Read(
+        FileHandle handle,
+        uint8_t* buffer,
+        int64_t length,
+        int64_t offset);
+
+    /**
+     * @brief Starts writing length bytes of buffer at offset, the buffer must stay valid until the
+     * operation completes.
+     */
+    std::shared_ptr<FileIoOperation> Write(
+        FileHandle handle,
+        const uint8_t* buffer,
+        int64_t length,
+        int64_t offset);
+
+  private:
+    std::shared_ptr<FileIoOperation> Submit(
+        FileHandle handle,
+        uint8_t* buffer,
+        int64_t length,
+        int64_t offset,
+        bool isWrite);
+    void ReapCompletions();
+
+    struct Ring;
+    std::unique_ptr<Ring> m_ring;
+  };
+
+  /**
+   * @brief Reads chunks of a file ahead of the transfers that consume them, through a
+   * FileIoEngine, so that the disk reads of later chunks overlap the network transfer of earlier
+   * ones. Chunks are read in the order they're listed, which should be the order they're
+   * requested in.
+   */
+  class FileReadAhead {
+  public:
+    /**
+     * @brief Keeps at most depth chunks read ahead of the last one requested. Chunks are only read
+     * ahead while the buffer pool has memory to spare.
+     */
+    FileReadAhead(
+        FileIoEngine& engine,
+        FileHandle handle,
+        std::vector<std::pair<int64_t, int64_t>> chunks,
+        int depth);
+
+    ~FileReadAhead();
+
+    FileReadAhead(const FileReadAhead&) = delete;
+    FileReadAhead& operator=(const FileReadAhead&) = delete;
+
+    /**
+     * @brief Returns the content of the chunk at index, which can be requested only once. Thread
+     * safe.
+     */
+    Azure::Core::Http::PooledBuffer Get(std::size_t index);
+
+  private:
+    struct Slot
+    {
+      Azure::Core::Http::PooledBuffer Buffer;
+      std::shared_ptr<FileIoOperation> Operation;
+    };
+
+    FileIoEngine& m_engine;
+    FileHandle m_handle;
+    std::vector<std::pair<int64_t, int64_t>> m_chunks;
+    std::size_t m_depth;
+    std::mutex m_mutex;
+    std::vector<Slot> m_slots;
+    std::size_t m_nextRead = 0;
+  };
+
+}}} // namespace Azure::Storage::Details
@@ -0,0 +1,153 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include "nullable.hpp"
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+namespace Azure { namespace Storage {
+
+  /**
+   * @brief Walks the segments of a listing operation, following NextMarker, with the next
+   * segments fetched in the background while the caller processes the current one. At most
+   * prefetchDepth segments are fetched ahead of the caller.
+   *
+   * @remark Segment must have a std::string NextMarker member, empty for the last segment.
+   */
+  template <class Segment> class SegmentPager {
+  public:
+    /**
+     * @brief Returns the segment starting at a marker, or at the beginning for a null marker.
+     */
+    using FetchFunction = std::function<Segment(const Azure::Core::Nullable<std::string>&)>;
+
+    SegmentPager(
+        FetchFunction fetchFunction,
+        Azure::Core::Nullable<std::string> marker,
+        int prefetchDepth)
+        : m_state(std::make_unique<State>())
+    {
+      m_state->Fetch = std::move(fetchFunction);
+      m_state->PrefetchDepth = static_cast<std::size_t>(std::max(prefetchDepth, 1));
+      State* state = m_state.get();
+      m_state->FetchThread = std::thread([state, marker]() { state->FetchLoop(marker); });
+    }
+
+    SegmentPager(SegmentPager&&) = default;
+    SegmentPager& operator=(SegmentPager&&) = delete;
+
+    /**
+     * @brief Waits for an ongoing fetch to complete.
+     */
+    ~SegmentPager()
+    {
+      if (m_state)
+      {
+        {
+          std::lock_guard<std::mutex> guard(m_state->Mutex);
+          m_state->Stop = true;
+        }
+        m_state->Cv.notify_all();
+        m_state->FetchThread.join();
+      }
+    }
+
+    /**
+     * @brief Returns whether NextSegment has another segment, or an error, to return. Blocks
+     * until that's known.
+     */
+    bool HasMoreSegments()
+    {
+      std::unique_lock<std::mutex> lock(m_state->Mutex);
+      m_state->WaitForSegment(lock);
+      return !m_state->Segments.empty() || m_state->Error;
+    }
+
+    /**
+     * @brief Returns the next segment, blocking until it's fetched. Throws the error of the fetch
+     * that failed.
+     */
+    Segment NextSegment()
+    {
+      std::unique_lock<std::mutex> lock(m_state->Mutex);
+      m_state->WaitForSegment(lock);
+      if (m_state->Segments.empty())
+      {
+        if (m_state->Error)
+        {
+          std::rethrow_exception(m_state->Error);
+        }
+        throw std::out_of_range("no more segments");
+      }
+      Segment segment = std::move(m_state->Segments.front());
+      m_state->Segments.pop_front();
+      m_state->Cv.notify_all();
+      return segment;
+    }
+
+  private:
+    struct State
+    {
+      FetchFunction Fetch;
+      std::size_t PrefetchDepth = 1;
+      std::mutex Mutex;
+      std::condition_variable Cv;
+      std::deque<Segment> Segments;
+      bool Done = false;
+      bool Stop = false;
+      std::exception_ptr Error;
+      std::thread FetchThread;
+
+      void WaitForSegment(std::unique_lock<std::mutex>& lock)
+      {
+        Cv.wait(lock, [&]() { return !Segments.empty() || Done || Error; });
+      }
+
+      void FetchLoop(Azure::Core::Nullable<std::string> marker)
+      {
+        std::unique_lock<std::mutex> lock(Mutex);
+        while (true)
+        {
+          Cv.wait(lock, [&]() { return Stop || Segments.size() < PrefetchDepth; });
+          if (Stop)
+          {
+            break;
+          }
+          lock.unlock();
+          try
+          {
+            Segment segment = Fetch(marker);
+            marker = segment.NextMarker;
+            lock.lock();
+            Segments.push_back(std::move(segment));
+            Done = marker.GetValue().empty();
+          }
+          catch (std::exception&)
+          {
+            lock.lock();
+            Error = std::current_exception();
+          }
+          Cv.notify_all();
+          if (Done || Error)
+          {
+            break;
+          }
+        }
+      }
+    };
+
+    std::unique_ptr<State> m_state;
+  };
+
+}} // namespace Azure::Storage
@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include "common/crypt.hpp"
 #include "common/storage_uri_builder.hpp"
 
 #include <map>
@@ -28,6 +29,7 @@ namespace Azure { namespace Storage {
     {
       std::lock_guard<std::mutex> guard(m_mutex);
       m_accountKey = std::move(accountKey);
+      m_signingKey.reset();
     }
 
     const std::string AccountName;
@@ -36,14 +38,21 @@ namespace Azure { namespace Storage {
     friend class SharedKeyPolicy;
     friend struct Blobs::BlobSasBuilder;
     friend struct AccountSasBuilder;
-    std::string GetAccountKey() const
+    // The decoded account key, set up for signing on first use. Kept alive by the callers that
+    // are still signing with it when the account key is changed.
+    std::shared_ptr<const HmacSha256> GetSigningKey() const
     {
       std::lock_guard<std::mutex> guard(m_mutex);
-      return m_accountKey;
+      if (!m_signingKey)
+      {
+        m_signingKey = std::make_shared<const HmacSha256>(Base64Decode(m_accountKey));
+      }
+      return m_signingKey;
     }
 
     mutable std::mutex m_mutex;
     std::string m_accountKey;
+    mutable std::shared_ptr<const HmacSha256> m_signingKey;
   };
 
   namespace Details {
@@ -0,0 +1,87 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace Azure { namespace Storage { namespace Details {
+
+  /**
+   * @brief A journal of the chunks of a parallel transfer that have completed, persisted to a
+   * file as they complete, so that a transfer that failed or whose process was killed can resume
+   * with only the missing chunks.
+   *
+   * The journal starts with a header line describing the transfer, and is discarded when a new
+   * transfer doesn't have the same header, e.g. because the source changed in between. Every
+   * completed chunk is appended as one line and flushed, but not synced to the disk, so it
+   * survives the failure of the process but not the loss of power of the machine.
+   */
+  class TransferCheckpoint {
+  public:
+    struct Chunk
+    {
+      int64_t Offset = 0;
+      int64_t Length = 0;
+      // Identifies what was transferred, e.g. the id of the staged block.
+      std::string Id;
+    };
+
+    /**
+     * @brief Opens the journal at path, keeping the chunks recorded in it if it was written for
+     * a transfer with the same header. header must not contain line breaks.
+     */
+    TransferCheckpoint(std::string path, std::string header);
+
+    ~TransferCheckpoint();
+
+    TransferCheckpoint(const TransferCheckpoint&) = delete;
+    TransferCheckpoint& operator=(const TransferCheckpoint&) = delete;
+
+    /**
+     * @brief Returns the chunks recorded before this transfer started.
+     */
+    const std::vector<Chunk>& GetCompletedChunks() const { return m_completedChunks; }
+
+    /**
+     * @brief Replaces the recorded chunks, e.g. with those that are still valid. Not thread safe.
+     */
+    void Reset(std::vector<Chunk> chunks);
+
+    /**
+     * @brief Appends a completed chunk to the journal. Thread safe.
+     */
+    void Record(const Chunk& chunk);
+
+    /**
+     * @brief Deletes the journal once the transfer has completed.
+     */
+    void Remove();
+
+  private:
+    void Rewrite();
+
+    std::string m_path;
+    std::string m_header;
+    std::vector<Chunk> m_completedChunks;
+    std::mutex m_mutex;
+    std::FILE* m_file = nullptr;
+  };
+
+  /**
+   * @brief Returns the (offset, length) of the chunks of [offset, offset + length) that no
+   * completed chunk covers, each at most chunkSize long and starting at a multiple of chunkSize
+   * from offset.
+   */
+  std::vector<std::pair<int64_t, int64_t>> GetMissingChunks(
+      int64_t offset,
+      int64_t length,
+      int64_t chunkSize,
+      const std::vector<TransferCheckpoint::Chunk>& completedChunks);
+
+}}} // namespace Azure::Storage::Details
@@ -0,0 +1,102 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Azure { namespace Storage {
+
+  /**
+   * @brief A process-wide pool of worker threads that runs the chunks of parallel transfers.
+   *
+   * Each parallel operation submits a task that transfers one chunk per call. The calling thread
+   * always works on its own operation, and idle workers pick up chunks from the active operations
+   * in round-robin order, so that every operation progresses at a similar pace no matter how many
+   * run at once. The number of chunks the workers run simultaneously is bounded by a global limit,
+   * instead of every operation creating its own threads.
+   */
+  class TransferExecutor {
+  public:
+    /**
+     * @brief Constructs an executor.
+     *
+     * @param maxConcurrency Maximum number of worker threads running chunks at the same time.
+     */
+    explicit TransferExecutor(int maxConcurrency);
+
+    TransferExecutor(const TransferExecutor&) = delete;
+    TransferExecutor& operator=(const TransferExecutor&) = delete;
+
+    ~TransferExecutor();
+
+    /**
+     * @brief Runs task repeatedly on the calling thread and on up to parallelism - 1 workers
+     * until it returns false, then waits for all in-flight calls to finish.
+     *
+     * @param parallelism Maximum number of concurrent calls to task, including the calling thread.
+     * @param task Transfers one chunk and returns whether there might be more to transfer.
+     * @remark If task throws, no further calls are started and the first exception is rethrown
+     * on the calling thread.
+     */
+    void Run(int parallelism, std::function<bool()> task);
+
+    /**
+     * @brief Like Run, but the number of concurrent calls to task is re-evaluated with
+     * currentParallelism whenever a call completes.
+     *
+     * @param maxParallelism Upper bound of currentParallelism, used to size the worker pool.
+     * @param currentParallelism Returns the number of concurrent calls currently allowed.
+     * @param task Transfers one chunk and returns whether there might be more to transfer.
+     */
+    void Run(
+        int maxParallelism,
+        std::function<int()> currentParallelism,
+        std::function<bool()> task);
+
+    /**
+     * @brief Changes the maximum number of worker threads running chunks at the same time.
+     */
+    void SetMaxConcurrency(int maxConcurrency);
+
+    int GetMaxConcurrency() const;
+
+    /**
+     * @brief Returns the executor shared by all storage clients.
+     */
+    static TransferExecutor& Default();
+
+  private:
+    struct Job
+    {
+      std::function<bool()> Task;
+      std::function<int()> Parallelism;
+      int Active = 0;
+      bool Done = false;
+      std::exception_ptr Error;
+    };
+
+    std::shared_ptr<Job> PickJob();
+    void Execute(std::unique_lock<std::mutex>& lock, Job& job);
+    void WorkerLoop();
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_workerCv;
+    std::condition_variable m_jobCv;
+    std::deque<std::shared_ptr<Job>> m_jobs;
+    std::vector<std::thread> m_threads;
+    int m_maxConcurrency;
+    int m_runningWorkers = 0;
+    int m_idleWorkers = 0;
+    bool m_stop = false;
+  };
+
+}} // namespace Azure::Storage
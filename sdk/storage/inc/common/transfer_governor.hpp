@@ -0,0 +1,108 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <utility>
+
+namespace Azure { namespace Storage {
+
+  /**
+   * @brief Process-wide limits applied to the chunks of parallel transfers.
+   */
+  struct TransferLimits
+  {
+    /**
+     * @brief Maximum number of chunk requests in flight at the same time.
+     */
+    int64_t MaxConcurrentRequests = std::numeric_limits<int64_t>::max();
+
+    /**
+     * @brief Maximum total size in bytes of the chunks in flight at the same time.
+     */
+    int64_t MaxBufferedBytes = std::numeric_limits<int64_t>::max();
+
+    /**
+     * @brief Maximum aggregated transfer rate in bytes per second. 0 means unlimited.
+     */
+    int64_t MaxBytesPerSecond = 0;
+  };
+
+  /**
+   * @brief Governs the chunks issued by all parallel transfers of the process, such as
+   * BlockBlobClient::UploadFromFile or BlobClient::DownloadToFile.
+   *
+   * Every chunk acquires a permit for its size before its request is sent, and holds it until the
+   * chunk has been transferred. When a limit is reached, further chunks wait for permits to be
+   * returned, so that bulk transfers cannot exhaust the sockets, memory or bandwidth of the
+   * machine. Single-shot operations such as StageBlock or AppendBlock are not governed.
+   */
+  class TransferGovernor {
+  public:
+    /**
+     * @brief Permission to transfer one chunk. Returned to the governor when destroyed.
+     */
+    class Permit {
+    public:
+      Permit() = default;
+      Permit(const Permit&) = delete;
+      Permit& operator=(const Permit&) = delete;
+      Permit(Permit&& other) noexcept { *this = std::move(other); }
+      Permit& operator=(Permit&& other) noexcept;
+      ~Permit() { Release(); }
+
+      void Release();
+
+    private:
+      friend class TransferGovernor;
+
+      TransferGovernor* m_governor = nullptr;
+      int64_t m_bytes = 0;
+    };
+
+    explicit TransferGovernor(TransferLimits limits = TransferLimits()) : m_limits(limits) {}
+
+    TransferGovernor(const TransferGovernor&) = delete;
+    TransferGovernor& operator=(const TransferGovernor&) = delete;
+
+    /**
+     * @brief Waits until a chunk of the given size may be transferred.
+     *
+     * @remark A chunk is always admitted when nothing else is in flight, so that a chunk larger
+     * than MaxBufferedBytes cannot wait forever.
+     */
+    Permit Acquire(int64_t bytes);
+
+    void SetLimits(const TransferLimits& limits);
+
+    TransferLimits GetLimits() const;
+
+    int64_t GetInFlightRequests() const;
+
+    int64_t GetInFlightBytes() const;
+
+    /**
+     * @brief Returns the governor shared by all storage clients. It has no limits unless set
+     * with SetLimits.
+     */
+    static TransferGovernor& Default();
+
+  private:
+    void Release(int64_t bytes);
+    bool CanAdmit(int64_t bytes) const;
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_cv;
+    TransferLimits m_limits;
+    int64_t m_inFlightRequests = 0;
+    int64_t m_inFlightBytes = 0;
+    // Earliest time the next chunk may start if the rate is limited.
+    std::chrono::steady_clock::time_point m_nextSlot;
+  };
+
+}} // namespace Azure::Storage
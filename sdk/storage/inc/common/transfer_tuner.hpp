@@ -0,0 +1,94 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+
+namespace Azure { namespace Storage {
+
+  /**
+   * @brief Bounds for automatically tuned parallel transfers.
+   */
+  struct TransferTuningOptions
+  {
+    /**
+     * @brief Chunk size the transfer starts with, and the smallest it shrinks to.
+     */
+    int64_t MinChunkSize = 1 * 1024 * 1024;
+
+    /**
+     * @brief Largest chunk size the transfer grows to.
+     */
+    int64_t MaxChunkSize = 64 * 1024 * 1024;
+
+    /**
+     * @brief Largest number of chunks transferred at the same time.
+     */
+    int MaxConcurrency = 32;
+  };
+
+  /**
+   * @brief Adjusts the chunk size and concurrency of a parallel transfer from the throughput it
+   * measures at runtime.
+   *
+   * Like TCP slow start, the tuner begins with one chunk of MinChunkSize in flight and doubles the
+   * concurrency after every measurement round that improved the throughput. Once doubling stops
+   * paying off, it falls back to the best concurrency seen and doubles the chunk size the same
+   * way. It then holds the best setting, and starts probing again if the throughput drops
+   * noticeably, for example because the network conditions changed.
+   */
+  class TransferTuner {
+  public:
+    explicit TransferTuner(const TransferTuningOptions& options);
+
+    /**
+     * @brief Returns the size the next chunk should have.
+     */
+    int64_t GetChunkSize() const;
+
+    /**
+     * @brief Returns how many chunks should be in flight at the same time.
+     */
+    int GetConcurrency() const;
+
+    int GetMaxConcurrency() const { return m_options.MaxConcurrency; }
+
+    /**
+     * @brief Records a completed chunk.
+     *
+     * @param bytes Size of the chunk.
+     * @param latency Time from issuing the chunk until it completed.
+     */
+    void OnChunkCompleted(int64_t bytes, std::chrono::steady_clock::duration latency);
+
+  private:
+    enum class Phase
+    {
+      GrowConcurrency,
+      GrowChunkSize,
+      Steady,
+    };
+
+    void OnRoundCompleted(double throughput, double averageLatency);
+
+    mutable std::mutex m_mutex;
+    TransferTuningOptions m_options;
+    Phase m_phase = Phase::GrowConcurrency;
+    int64_t m_chunkSize;
+    int m_concurrency = 1;
+
+    std::chrono::steady_clock::time_point m_roundStart;
+    int64_t m_roundBytes = 0;
+    int m_roundChunks = 0;
+    double m_roundLatency = 0.0;
+
+    double m_bestThroughput = 0.0;
+    double m_bestLatency = 0.0;
+    int64_t m_bestChunkSize;
+    int m_bestConcurrency = 1;
+  };
+
+}} // namespace Azure::Storage
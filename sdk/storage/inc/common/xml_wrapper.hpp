@@ -3,8 +3,10 @@
 
 #pragma once
 
+#include <cstring>
 #include <functional>
 #include <string>
+#include <vector>
 
 struct _xmlTextReader;
 struct _xmlTextWriter;
@@ -45,6 +47,64 @@ namespace Azure { namespace Storage {
     bool m_readingAttributes = false;
   };
 
+  /**
+   * @brief A string not owned by the XmlPullReader node it's part of.
+   */
+  struct XmlStringView
+  {
+    const char* Data = nullptr;
+    std::size_t Length = 0;
+
+    bool operator==(const char* other) const
+    {
+      return std::strlen(other) == Length && std::memcmp(Data, other, Length) == 0;
+    }
+
+    std::string ToString() const { return std::string(Data, Length); }
+  };
+
+  struct XmlPullNode
+  {
+    XmlNodeType Type;
+    XmlStringView Name;
+    XmlStringView Value;
+  };
+
+  /**
+   * @brief Reads the nodes of an XML document one at a time, in the same order as XmlReader.
+   * Names point into the document, and so do values unless they contain entities, in which case
+   * they point to a buffer overwritten by the next Read. The document must outlive the reader.
+   *
+   * Only the subset of XML used by the service responses is supported: there's no DTD, and
+   * namespace prefixes are part of the names.
+   */
+  class XmlPullReader {
+  public:
+    explicit XmlPullReader(const char* data, std::size_t length)
+        : m_cursor(data), m_end(data + length)
+    {
+      // the service prefixes its responses with a UTF-8 byte order mark
+      if (length >= 3 && std::memcmp(data, "\xEF\xBB\xBF", 3) == 0)
+      {
+        m_cursor += 3;
+      }
+    }
+
+    XmlPullNode Read();
+
+  private:
+    XmlPullNode ReadAttribute();
+    XmlStringView Decode(const char* begin, const char* end);
+
+    const char* m_cursor;
+    const char* m_end;
+    // the attributes of the last start tag that haven't been read yet
+    const char* m_attributeCursor = nullptr;
+    const char* m_attributeEnd = nullptr;
+    std::vector<XmlStringView> m_openTags;
+    std::string m_decoded;
+  };
+
   class XmlWriter {
   public:
     explicit XmlWriter();
@@ -5,9 +5,11 @@
 
 #include "blobs/blob_options.hpp"
 #include "common/access_conditions.hpp"
+#include "datalake_responses.hpp"
 #include "nullable.hpp"
 #include "protocol/datalake_rest_client.hpp"
 
+#include <functional>
 #include <map>
 #include <memory>
 #include <string>
@@ -647,6 +649,83 @@ namespace Azure { namespace Storage { namespace Files { namespace DataLake {
     PathAccessConditions AccessConditions;
   };
 
+  /**
+   * @brief Optional parameters for DirectoryClient::ListPaths
+   */
+  struct DirectoryListPathsOptions
+  {
+    /**
+     * @brief Context for cancelling long running operations.
+     */
+    Azure::Core::Context Context;
+
+    /**
+     * @brief If "true", the user identity values returned in the owner and group fields of each
+     *        list entry will be transformed from Azure Active Directory Object IDs to User
+     *        Principal Names.
+     */
+    Azure::Core::Nullable<bool> UserPrincipalName;
+
+    /**
+     * @brief The maximum number of paths returned by each listing request.
+     */
+    Azure::Core::Nullable<int32_t> MaxResults;
+
+    /**
+     * @brief The maximum number of directories listed at the same time.
+     */
+    int Concurrency = 1;
+  };
+
+  /**
+   * @brief Optional parameters for DirectoryClient::SetAccessControlRecursive
+   */
+  struct DirectorySetAccessControlRecursiveOptions
+  {
+    /**
+     * @brief Context for cancelling long running operations.
+     */
+    Azure::Core::Context Context;
+
+    /**
+     * @brief The maximum number of requests sent at the same time.
+     */
+    int Concurrency = 1;
+
+    /**
+     * @brief The maximum number of paths changed by each request. If omitted or greater than
+     *        2,000, each request changes up to 2,000 paths.
+     */
+    Azure::Core::Nullable<int32_t> BatchSize;
+
+    /**
+     * @brief Called after each batch, one call at a time.
+     */
+    std::function<void(const AccessControlRecursiveProgress&)> ProgressHandler;
+
+    /**
+     * @brief The shards to change, to resume a change from the pending shards of a previous one,
+     *        or from its progress. If empty, the whole directory is changed.
+     */
+    std::vector<AccessControlRecursiveShard> ResumeShards;
+  };
+
+  /**
+   * @brief Optional parameters for DirectoryClient::CopyTo
+   */
+  struct DirectoryCopyOptions
+  {
+    /**
+     * @brief Context for cancelling long running operations.
+     */
+    Azure::Core::Context Context;
+
+    /**
+     * @brief The maximum number of directories listed and files copied at the same time.
+     */
+    int Concurrency = 1;
+  };
+
   using FileCreateOptions = PathCreateOptions;
   using DirectoryCreateOptions = PathCreateOptions;
 
@@ -679,6 +758,13 @@ namespace Azure { namespace Storage { namespace Files { namespace DataLake {
      * @brief The maximum number of threads that may be used in a parallel transfer.
      */
     int Concurrency = 1;
+
+    /**
+     * @brief If true, the file is created, its chunks are appended at their positions in
+     *        parallel and then flushed at once through the dfs endpoint, instead of uploaded as a
+     *        block blob through the blob endpoint.
+     */
+    bool UseDfsEndpoint = false;
   };
 
   /**
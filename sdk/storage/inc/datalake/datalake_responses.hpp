@@ -171,4 +171,71 @@ namespace Azure { namespace Storage { namespace Files { namespace DataLake {
   using DirectoryInfo = PathInfo;
   using DirectoryDeleteInfo = PathDeleteResponse;
 
+  /**
+   * @brief A part of a recursive access control change, which can be passed back to resume it.
+   */
+  struct AccessControlRecursiveShard
+  {
+    /**
+     * @brief The path of a file or directory, relative to the file system.
+     */
+    std::string Path;
+
+    /**
+     * @brief Where to resume the change of a recursive shard, null to start from the beginning.
+     */
+    Azure::Core::Nullable<std::string> Continuation;
+
+    /**
+     * @brief Whether the change applies to everything beneath the path, or to the path only.
+     */
+    bool Recursive = true;
+  };
+
+  /**
+   * @brief The outcome of a batch of a recursive access control change.
+   */
+  struct AccessControlRecursiveProgress
+  {
+    /**
+     * @brief The shard the batch belongs to, with the continuation it resumes from. The
+     * continuation is null once the shard is complete.
+     */
+    AccessControlRecursiveShard Shard;
+    int32_t DirectoriesSuccessful = 0;
+    int32_t FilesSuccessful = 0;
+    int32_t FailureCount = 0;
+    std::vector<AclFailedEntry> FailedEntries;
+  };
+
+  struct DirectorySetAccessControlRecursiveResult
+  {
+    int64_t DirectoriesSuccessful = 0;
+    int64_t FilesSuccessful = 0;
+    int64_t FailureCount = 0;
+
+    /**
+     * @brief The paths the service failed to change. Each one also has a non-recursive shard in
+     * PendingShards, so that resuming retries them.
+     */
+    std::vector<AclFailedEntry> FailedEntries;
+
+    /**
+     * @brief The shards a request failed for, with the continuation they stopped at, and a
+     * non-recursive shard for each of FailedEntries. Empty once the change is complete.
+     */
+    std::vector<AccessControlRecursiveShard> PendingShards;
+
+    /**
+     * @brief The error of the first request that failed.
+     */
+    std::string ErrorMessage;
+  };
+
+  struct DirectoryCopyResult
+  {
+    int64_t DirectoriesCopied = 0;
+    int64_t FilesCopied = 0;
+  };
+
 }}}} // namespace Azure::Storage::Files::DataLake
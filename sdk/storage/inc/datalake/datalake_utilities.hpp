@@ -20,4 +20,7 @@ namespace Azure { namespace Storage { namespace Files { namespace DataLake { nam
       const std::string& string,
       std::string::const_iterator& cur);
 
+  // Decodes the percent-encoded octets of a uri path.
+  std::string DecodePath(const std::string& path);
+
 }}}}} // namespace Azure::Storage::Files::DataLake::Details
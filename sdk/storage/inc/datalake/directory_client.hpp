@@ -13,8 +13,10 @@
 #include "protocol/datalake_rest_client.hpp"
 #include "response.hpp"
 
+#include <functional>
 #include <memory>
 #include <string>
+#include <vector>
 
 namespace Azure { namespace Storage { namespace Files { namespace DataLake {
 
@@ -128,6 +130,65 @@ namespace Azure { namespace Storage { namespace Files { namespace DataLake {
         bool Recursive,
         const DirectoryDeleteOptions& options = DirectoryDeleteOptions()) const;
 
+    /**
+     * @brief Renames a directory, following the continuations of the rename until all the paths
+     *        beneath it are renamed.
+     * @param destinationDirectoryPath The destinationPath this current directory is renaming to.
+     * @param options Optional parameters to rename a resource to the resource the destination
+     * directory points to.
+     * @return Azure::Core::Response<DirectoryRenameInfo> of the last rename request.
+     * @remark This request is sent to dfs endpoint.
+     */
+    Azure::Core::Response<DirectoryRenameInfo> MoveTo(
+        const std::string& destinationDirectoryPath,
+        const DirectoryRenameOptions& options = DirectoryRenameOptions()) const;
+
+    /**
+     * @brief Copies the directory and all the paths beneath it to another directory of the file
+     *        system, which is created or overwritten. Directories are listed concurrently, and
+     *        their files are copied by the service with a copy blob operation, each waited for
+     *        until it completes.
+     * @param destinationDirectoryPath The path of the destination directory within the file
+     * system.
+     * @param options Optional parameters to copy the directory.
+     * @return DirectoryCopyResult
+     * @remark Only the data and properties of the files are copied, not the access control of the
+     *         paths.
+     */
+    DirectoryCopyResult CopyTo(
+        const std::string& destinationDirectoryPath,
+        const DirectoryCopyOptions& options = DirectoryCopyOptions()) const;
+
+    /**
+     * @brief Lists all the paths beneath the directory, with up to Concurrency directories listed
+     *        at the same time. The paths are passed to sink a page at a time, in no particular
+     *        order, and sink is never called concurrently.
+     * @param sink Called with each page of paths. The names are relative to the file system.
+     * @param options Optional parameters to list the paths.
+     * @remark This request is sent to dfs endpoint.
+     */
+    void ListPaths(
+        const std::function<void(std::vector<Path> paths)>& sink,
+        const DirectoryListPathsOptions& options = DirectoryListPathsOptions()) const;
+
+    /**
+     * @brief Sets, modifies or removes the access control of the directory and all the paths
+     *        beneath it. The tree is split into shards, such as the subdirectories of the first
+     *        levels, whose batches are sent by up to Concurrency requests at the same time.
+     * @param mode Whether acls replace, are merged into or are removed from the access control
+     * of each path.
+     * @param acls The access control list entries to set, modify or remove.
+     * @param options Optional parameters to change the access control.
+     * @return DirectorySetAccessControlRecursiveResult. A request that fails doesn't stop the
+     *         other shards, its shard is returned in PendingShards instead to be resumed.
+     * @remark This request is sent to dfs endpoint.
+     */
+    DirectorySetAccessControlRecursiveResult SetAccessControlRecursive(
+        PathSetAccessControlRecursiveMode mode,
+        std::vector<Acl> acls,
+        const DirectorySetAccessControlRecursiveOptions& options
+        = DirectorySetAccessControlRecursiveOptions()) const;
+
   private:
     explicit DirectoryClient(
         UriBuilder dfsUri,
@@ -136,6 +197,18 @@ namespace Azure { namespace Storage { namespace Files { namespace DataLake {
         : PathClient(std::move(dfsUri), std::move(blobClient), pipeline)
     {
     }
+
+    // Returns a client of another path of the file system.
+    DirectoryClient GetFileSystemPathClient(const std::string& path) const;
+
+    Azure::Core::Response<FileSystemListPathsResponse> ListFileSystemPaths(
+        DataLakeRestClient::FileSystem::ListPathsOptions protocolLayerOptions,
+        const Azure::Core::Context& context) const;
+
+    std::vector<AccessControlRecursiveShard> DiscoverAccessControlShards(
+        int concurrency,
+        const Azure::Core::Context& context) const;
+
     friend class FileSystemClient;
   };
 }}}} // namespace Azure::Storage::Files::DataLake
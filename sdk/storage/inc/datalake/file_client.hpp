@@ -14,6 +14,7 @@
 #include "protocol/datalake_rest_client.hpp"
 #include "response.hpp"
 
+#include <functional>
 #include <memory>
 #include <string>
 
@@ -173,7 +174,8 @@ namespace Azure { namespace Storage { namespace Files { namespace DataLake {
      * @param bufferSize Size of the memory buffer.
      * @param options Optional parameters to execute this function.
      * @return Azure::Core::Response<FileContentInfo>
-     * @remark This request is sent to blob endpoint.
+     * @remark This request is sent to blob endpoint, or to dfs endpoint with
+     *         UploadFileOptions::UseDfsEndpoint.
      */
     Azure::Core::Response<FileContentInfo> UploadFromBuffer(
         const uint8_t* buffer,
@@ -186,7 +188,8 @@ namespace Azure { namespace Storage { namespace Files { namespace DataLake {
      * @param file A file containing the content to upload.
      * @param options Optional parameters to execute this function.
      * @return Azure::Core::Response<FileContentInfo>
-     * @remark This request is sent to blob endpoint.
+     * @remark This request is sent to blob endpoint, or to dfs endpoint with
+     *         UploadFileOptions::UseDfsEndpoint.
      */
     Azure::Core::Response<FileContentInfo> UploadFromFile(
         const std::string& file,
@@ -222,6 +225,13 @@ namespace Azure { namespace Storage { namespace Files { namespace DataLake {
   private:
     Blobs::BlockBlobClient m_blockBlobClient;
 
+    // Creates the file, appends size bytes of content in parallel and flushes them.
+    Azure::Core::Response<FileContentInfo> UploadThroughDfs(
+        int64_t size,
+        const std::function<std::unique_ptr<Azure::Core::Http::BodyStream>(int64_t, int64_t)>&
+            getContent,
+        const UploadFileOptions& options) const;
+
     explicit FileClient(
         UriBuilder dfsUri,
         Blobs::BlobClient blobClient,
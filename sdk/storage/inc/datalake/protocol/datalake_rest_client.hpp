@@ -101,6 +101,126 @@ namespace Azure { namespace Storage { namespace Files { namespace DataLake {
     constexpr static const char* c_HeaderXMsGroup = "x-ms-group";
     constexpr static const char* c_HeaderXMsPermissions = "x-ms-permissions";
     constexpr static const char* c_HeaderXMsAcl = "x-ms-acl";
+
+    // Reads a JSON object of scalar fields holding an array of objects of scalar fields, the
+    // shape of the list responses, through the SAX interface of nlohmann::json so that no DOM is
+    // built. Numbers and booleans are passed as strings, nested values are skipped.
+    template <class FieldFunction, class ItemFunction, class ItemFieldFunction>
+    class JsonListSaxHandler {
+    public:
+      JsonListSaxHandler(
+          const char* listKey,
+          FieldFunction onField,
+          ItemFunction onItem,
+          ItemFieldFunction onItemField)
+          : m_listKey(listKey), m_onField(std::move(onField)), m_onItem(std::move(onItem)),
+            m_onItemField(std::move(onItemField))
+      {
+      }
+
+      bool null() { return true; }
+      bool boolean(bool value)
+      {
+        std::string text = value ? "true" : "false";
+        return Scalar(text);
+      }
+      bool number_integer(nlohmann::json::number_integer_t value)
+      {
+        std::string text = std::to_string(value);
+        return Scalar(text);
+      }
+      bool number_unsigned(nlohmann::json::number_unsigned_t value)
+      {
+        std::string text = std::to_string(value);
+        return Scalar(text);
+      }
+      bool number_float(nlohmann::json::number_float_t, const std::string& value)
+      {
+        std::string text = value;
+        return Scalar(text);
+      }
+      bool string(std::string& value) { return Scalar(value); }
+      bool binary(nlohmann::json::binary_t&) { return true; }
+
+      bool start_object(std::size_t)
+      {
+        if (++m_depth == 3 && m_inList)
+        {
+          m_onItem();
+        }
+        return true;
+      }
+      bool end_object()
+      {
+        --m_depth;
+        return true;
+      }
+      bool start_array(std::size_t)
+      {
+        if (++m_depth == 2 && m_key == m_listKey)
+        {
+          m_inList = true;
+        }
+        return true;
+      }
+      bool end_array()
+      {
+        if (m_depth-- == 2)
+        {
+          m_inList = false;
+        }
+        return true;
+      }
+      bool key(std::string& key)
+      {
+        m_key.assign(key);
+        return true;
+      }
+
+      template <class Exception>
+      bool parse_error(std::size_t, const std::string&, const Exception& exception)
+      {
+        throw exception;
+      }
+
+    private:
+      bool Scalar(std::string& value)
+      {
+        if (m_depth == 1)
+        {
+          m_onField(m_key, value);
+        }
+        else if (m_depth == 3 && m_inList)
+        {
+          m_onItemField(m_key, value);
+        }
+        return true;
+      }
+
+      const char* m_listKey;
+      FieldFunction m_onField;
+      ItemFunction m_onItem;
+      ItemFieldFunction m_onItemField;
+      int m_depth = 0;
+      bool m_inList = false;
+      std::string m_key;
+    };
+
+    // onField(key, value) is called for the fields of the top-level object, onItem() for every
+    // object of the array at listKey, then onItemField(key, value) for its fields. The values may
+    // be moved from.
+    template <class FieldFunction, class ItemFunction, class ItemFieldFunction>
+    inline void ParseJsonList(
+        const std::vector<uint8_t>& bodyBuffer,
+        const char* listKey,
+        FieldFunction onField,
+        ItemFunction onItem,
+        ItemFieldFunction onItemField)
+    {
+      JsonListSaxHandler<FieldFunction, ItemFunction, ItemFieldFunction> handler(
+          listKey, std::move(onField), std::move(onItem), std::move(onItemField));
+      nlohmann::json::sax_parse(bodyBuffer.begin(), bodyBuffer.end(), &handler);
+    }
   } // namespace Details
   struct DataLakeHttpHeaders
   {
@@ -192,6 +312,45 @@ namespace Azure { namespace Storage { namespace Files { namespace DataLake {
       }
       return result;
     }
+
+    static SetAccessControlRecursiveResponse CreateFromJson(const std::vector<uint8_t>& bodyBuffer)
+    {
+      SetAccessControlRecursiveResponse result;
+      Details::ParseJsonList(
+          bodyBuffer,
+          "failedEntries",
+          [&](const std::string& key, std::string& value) {
+            if (key == "directoriesSuccessful")
+            {
+              result.DirectoriesSuccessful = std::stoi(value);
+            }
+            else if (key == "filesSuccessful")
+            {
+              result.FilesSuccessful = std::stoi(value);
+            }
+            else if (key == "failureCount")
+            {
+              result.FailureCount = std::stoi(value);
+            }
+          },
+          [&]() { result.FailedEntries.emplace_back(); },
+          [&](const std::string& key, std::string& value) {
+            AclFailedEntry& entry = result.FailedEntries.back();
+            if (key == "name")
+            {
+              entry.Name = std::move(value);
+            }
+            else if (key == "type")
+            {
+              entry.Type = std::move(value);
+            }
+            else if (key == "errorMessage")
+            {
+              entry.ErrorMessage = std::move(value);
+            }
+          });
+      return result;
+    }
   };
 
   struct Path
@@ -239,6 +398,52 @@ namespace Azure { namespace Storage { namespace Files { namespace DataLake {
       }
       return result;
     }
+
+    static PathList CreateFromJson(const std::vector<uint8_t>& bodyBuffer)
+    {
+      PathList result;
+      Details::ParseJsonList(
+          bodyBuffer,
+          "paths",
+          [](const std::string&, std::string&) {},
+          [&]() { result.Paths.emplace_back(); },
+          [&](const std::string& key, std::string& value) {
+            Path& path = result.Paths.back();
+            if (key == "name")
+            {
+              path.Name = std::move(value);
+            }
+            else if (key == "isDirectory")
+            {
+              path.IsDirectory = (value == "true");
+            }
+            else if (key == "lastModified")
+            {
+              path.LastModified = std::move(value);
+            }
+            else if (key == "etag")
+            {
+              path.ETag = std::move(value);
+            }
+            else if (key == "contentLength")
+            {
+              path.ContentLength = std::stoll(value);
+            }
+            else if (key == "owner")
+            {
+              path.Owner = std::move(value);
+            }
+            else if (key == "group")
+            {
+              path.Group = std::move(value);
+            }
+            else if (key == "permissions")
+            {
+              path.Permissions = std::move(value);
+            }
+          });
+      return result;
+    }
   };
 
   struct FileSystem
@@ -270,6 +475,32 @@ namespace Azure { namespace Storage { namespace Files { namespace DataLake {
       }
       return result;
     }
+
+    static FileSystemList CreateFromJson(const std::vector<uint8_t>& bodyBuffer)
+    {
+      FileSystemList result;
+      Details::ParseJsonList(
+          bodyBuffer,
+          "filesystems",
+          [](const std::string&, std::string&) {},
+          [&]() { result.Filesystems.emplace_back(); },
+          [&](const std::string& key, std::string& value) {
+            FileSystem& fileSystem = result.Filesystems.back();
+            if (key == "name")
+            {
+              fileSystem.Name = std::move(value);
+            }
+            else if (key == "lastModified")
+            {
+              fileSystem.LastModified = std::move(value);
+            }
+            else if (key == "etag")
+            {
+              fileSystem.ETag = std::move(value);
+            }
+          });
+      return result;
+    }
   };
 
   struct StorageError
@@ -873,7 +1104,7 @@ namespace Azure { namespace Storage { namespace Files { namespace DataLake {
           ServiceListFileSystemsResponse result = bodyBuffer.empty()
               ? ServiceListFileSystemsResponse()
               : ServiceListFileSystemsResponse::ServiceListFileSystemsResponseFromFileSystemList(
-                  FileSystemList::CreateFromJson(nlohmann::json::parse(bodyBuffer)));
+                  FileSystemList::CreateFromJson(bodyBuffer));
           if (response.GetHeaders().find(Details::c_HeaderXMsContinuation)
               != response.GetHeaders().end())
           {
@@ -1282,7 +1513,7 @@ namespace Azure { namespace Storage { namespace Files { namespace DataLake {
           FileSystemListPathsResponse result = bodyBuffer.empty()
               ? FileSystemListPathsResponse()
               : FileSystemListPathsResponse::FileSystemListPathsResponseFromPathList(
-                  PathList::CreateFromJson(nlohmann::json::parse(bodyBuffer)));
+                  PathList::CreateFromJson(bodyBuffer));
           if (response.GetHeaders().find(Details::c_HeaderXMsContinuation)
               != response.GetHeaders().end())
           {
@@ -2688,8 +2919,7 @@ namespace Azure { namespace Storage { namespace Files { namespace DataLake {
           PathUpdateResponse result = bodyBuffer.empty()
               ? PathUpdateResponse()
               : PathUpdateResponse::PathUpdateResponseFromSetAccessControlRecursiveResponse(
-                  SetAccessControlRecursiveResponse::CreateFromJson(
-                      nlohmann::json::parse(bodyBuffer)));
+                  SetAccessControlRecursiveResponse::CreateFromJson(bodyBuffer));
           result.ETag = response.GetHeaders().at(Details::c_HeaderETag);
           result.LastModified = response.GetHeaders().at(Details::c_HeaderLastModified);
           if (response.GetHeaders().find(Details::c_HeaderAcceptRanges)
@@ -3116,8 +3346,7 @@ namespace Azure { namespace Storage { namespace Files { namespace DataLake {
               ? PathSetAccessControlRecursiveResponse()
               : PathSetAccessControlRecursiveResponse::
                   PathSetAccessControlRecursiveResponseFromSetAccessControlRecursiveResponse(
-                      SetAccessControlRecursiveResponse::CreateFromJson(
-                          nlohmann::json::parse(bodyBuffer)));
+                      SetAccessControlRecursiveResponse::CreateFromJson(bodyBuffer));
           if (response.GetHeaders().find(Details::c_HeaderXMsContinuation)
               != response.GetHeaders().end())
           {
@@ -0,0 +1,149 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include "common/segment_pager.hpp"
+#include "common/storage_credential.hpp"
+#include "common/storage_uri_builder.hpp"
+#include "credentials/credentials.hpp"
+#include "http/pipeline.hpp"
+#include "protocol/share_rest_client.hpp"
+#include "response.hpp"
+#include "share_options.hpp"
+#include "share_responses.hpp"
+#include "shares/file_client.hpp"
+
+#include <memory>
+#include <string>
+
+namespace Azure { namespace Storage { namespace Files { namespace Shares {
+
+  class ShareClient;
+
+  class DirectoryClient {
+  public:
+    /**
+     * @brief Create from connection string
+     * @param connectionString Azure Storage connection string.
+     * @param shareName The name of a file share.
+     * @param directoryPath The path of a directory in the share.
+     * @param options Optional parameters used to initialize the client.
+     * @return DirectoryClient The client that can be used to manage a directory resource.
+     */
+    static DirectoryClient CreateFromConnectionString(
+        const std::string& connectionString,
+        const std::string& shareName,
+        const std::string& directoryPath,
+        const DirectoryClientOptions& options = DirectoryClientOptions());
+
+    /**
+     * @brief Shared key authentication client.
+     * @param directoryUri The URI of the directory this client's request targets.
+     * @param credential The shared key credential used to initialize the client.
+     * @param options Optional parameters used to initialize the client.
+     */
+    explicit DirectoryClient(
+        const std::string& directoryUri,
+        std::shared_ptr<SharedKeyCredential> credential,
+        const DirectoryClientOptions& options = DirectoryClientOptions());
+
+    /**
+     * @brief Bearer token authentication client.
+     * @param directoryUri The URI of the directory this client's request targets.
+     * @param credential The token credential used to initialize the client.
+     * @param options Optional parameters used to initialize the client.
+     */
+    explicit DirectoryClient(
+        const std::string& directoryUri,
+        std::shared_ptr<Core::Credentials::TokenCredential> credential,
+        const DirectoryClientOptions& options = DirectoryClientOptions());
+
+    /**
+     * @brief Anonymous/SAS/customized pipeline auth.
+     * @param directoryUri The URI of the directory this client's request targets.
+     * @param options Optional parameters used to initialize the client.
+     */
+    explicit DirectoryClient(
+        const std::string& directoryUri,
+        const DirectoryClientOptions& options = DirectoryClientOptions());
+
+    /**
+     * @brief Gets the directory's primary uri endpoint.
+     *
+     * @return The directory's primary uri endpoint.
+     */
+    std::string GetUri() const { return m_directoryUri.ToString(); }
+
+    /**
+     * @brief Create a DirectoryClient from this one for a subdirectory. The new client shares the
+     * pipeline of this one.
+     * @param subdirectoryName The name of the subdirectory.
+     * @return DirectoryClient The client for the subdirectory.
+     */
+    DirectoryClient GetSubdirectoryClient(const std::string& subdirectoryName) const;
+
+    /**
+     * @brief Create a FileClient from this one for a file in this directory. The new client
+     * shares the pipeline of this one.
+     * @param fileName The name of the file.
+     * @return FileClient The client for the file.
+     */
+    FileClient GetFileClient(const std::string& fileName) const;
+
+    /**
+     * @brief Creates the directory.
+     * @param options Optional parameters to create this directory.
+     * @return Azure::Core::Response<DirectoryInfo> The information of the created directory.
+     */
+    Azure::Core::Response<DirectoryInfo> Create(
+        const CreateDirectoryOptions& options = CreateDirectoryOptions()) const;
+
+    /**
+     * @brief Deletes the directory, which must be empty.
+     * @param options Optional parameters to delete this directory.
+     * @return Azure::Core::Response<DirectoryDeleteInfo> Currently empty and reserved for future
+     * usage.
+     */
+    Azure::Core::Response<DirectoryDeleteInfo> Delete(
+        const DeleteDirectoryOptions& options = DeleteDirectoryOptions()) const;
+
+    /**
+     * @brief Returns a single segment of the files and subdirectories in this directory, starting
+     * from the specified Marker.
+     * @param options Optional parameters to execute this function.
+     * @return Azure::Core::Response<ListFilesAndDirectoriesSegmentResult> The files and
+     * directories of the segment, and the marker of the next one.
+     */
+    Azure::Core::Response<ListFilesAndDirectoriesSegmentResult> ListFilesAndDirectoriesSegment(
+        const ListFilesAndDirectoriesSegmentOptions& options
+        = ListFilesAndDirectoriesSegmentOptions()) const;
+
+    /**
+     * @brief Returns a pager over all the segments of files and subdirectories in this directory,
+     * starting from the specified Marker. The next segments are fetched in the background while
+     * the current one is processed.
+     * @param options Optional parameters to execute this function.
+     * @param prefetchDepth The maximum number of segments fetched ahead of the one being
+     * processed.
+     * @return A SegmentPager returning the ListFilesAndDirectoriesSegmentResult of the directory
+     * in order.
+     */
+    SegmentPager<ListFilesAndDirectoriesSegmentResult> ListFilesAndDirectoriesPages(
+        const ListFilesAndDirectoriesSegmentOptions& options
+        = ListFilesAndDirectoriesSegmentOptions(),
+        int prefetchDepth = 1) const;
+
+  private:
+    UriBuilder m_directoryUri;
+    std::shared_ptr<Azure::Core::Http::HttpPipeline> m_pipeline;
+
+    explicit DirectoryClient(
+        UriBuilder directoryUri,
+        std::shared_ptr<Azure::Core::Http::HttpPipeline> pipeline)
+        : m_directoryUri(std::move(directoryUri)), m_pipeline(std::move(pipeline))
+    {
+    }
+    friend class ShareClient;
+  };
+}}}} // namespace Azure::Storage::Files::Shares
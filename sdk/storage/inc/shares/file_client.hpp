@@ -0,0 +1,208 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include "common/storage_credential.hpp"
+#include "common/storage_uri_builder.hpp"
+#include "credentials/credentials.hpp"
+#include "http/body_stream.hpp"
+#include "http/buffer_pool.hpp"
+#include "http/pipeline.hpp"
+#include "protocol/share_rest_client.hpp"
+#include "response.hpp"
+#include "share_options.hpp"
+#include "share_responses.hpp"
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+
+namespace Azure { namespace Storage { namespace Files { namespace Shares {
+
+  class ShareClient;
+  class DirectoryClient;
+
+  class FileClient {
+  public:
+    /**
+     * @brief Create from connection string
+     * @param connectionString Azure Storage connection string.
+     * @param shareName The name of a file share.
+     * @param filePath The path of a file in the share.
+     * @param options Optional parameters used to initialize the client.
+     * @return FileClient The client that can be used to manage a file resource.
+     */
+    static FileClient CreateFromConnectionString(
+        const std::string& connectionString,
+        const std::string& shareName,
+        const std::string& filePath,
+        const FileClientOptions& options = FileClientOptions());
+
+    /**
+     * @brief Shared key authentication client.
+     * @param fileUri The URI of the file this client's request targets.
+     * @param credential The shared key credential used to initialize the client.
+     * @param options Optional parameters used to initialize the client.
+     */
+    explicit FileClient(
+        const std::string& fileUri,
+        std::shared_ptr<SharedKeyCredential> credential,
+        const FileClientOptions& options = FileClientOptions());
+
+    /**
+     * @brief Bearer token authentication client.
+     * @param fileUri The URI of the file this client's request targets.
+     * @param credential The token credential used to initialize the client.
+     * @param options Optional parameters used to initialize the client.
+     */
+    explicit FileClient(
+        const std::string& fileUri,
+        std::shared_ptr<Core::Credentials::TokenCredential> credential,
+        const FileClientOptions& options = FileClientOptions());
+
+    /**
+     * @brief Anonymous/SAS/customized pipeline auth.
+     * @param fileUri The URI of the file this client's request targets.
+     * @param options Optional parameters used to initialize the client.
+     */
+    explicit FileClient(
+        const std::string& fileUri,
+        const FileClientOptions& options = FileClientOptions());
+
+    /**
+     * @brief Gets the file's primary uri endpoint.
+     *
+     * @return The file's primary uri endpoint.
+     */
+    std::string GetUri() const { return m_fileUri.ToString(); }
+
+    /**
+     * @brief Creates the file, or replaces an existing one, with the given size. The content of
+     * the file is zeroes until ranges are uploaded.
+     * @param fileSize The size of the file in bytes.
+     * @param options Optional parameters to create this file.
+     * @return Azure::Core::Response<FileInfo> The information of the created file.
+     */
+    Azure::Core::Response<FileInfo> Create(
+        int64_t fileSize,
+        const CreateFileOptions& options = CreateFileOptions()) const;
+
+    /**
+     * @brief Deletes the file.
+     * @param options Optional parameters to delete this file.
+     * @return Azure::Core::Response<FileDeleteInfo> Currently empty and reserved for future usage.
+     */
+    Azure::Core::Response<FileDeleteInfo> Delete(
+        const DeleteFileOptions& options = DeleteFileOptions()) const;
+
+    /**
+     * @brief Returns the properties and metadata of the file.
+     * @param options Optional parameters to execute this function.
+     * @return Azure::Core::Response<FileProperties> The properties of the file.
+     */
+    Azure::Core::Response<FileProperties> GetProperties(
+        const GetFilePropertiesOptions& options = GetFilePropertiesOptions()) const;
+
+    /**
+     * @brief Downloads the file, or a range of it.
+     * @param options Optional parameters to execute this function.
+     * @return Azure::Core::Response<FileDownloadResponse> The content of the file in BodyStream,
+     * and its properties.
+     */
+    Azure::Core::Response<FileDownloadResponse> Download(
+        const DownloadFileOptions& options = DownloadFileOptions()) const;
+
+    /**
+     * @brief Writes a range of at most 4MiB of the file.
+     * @param offset The offset in the file the range starts at.
+     * @param content The content of the range. The range is as long as the stream.
+     * @param options Optional parameters to execute this function.
+     * @return Azure::Core::Response<FileUploadRangeInfo> The ETag and last modified time of the
+     * file after the write.
+     */
+    Azure::Core::Response<FileUploadRangeInfo> UploadRange(
+        int64_t offset,
+        Azure::Core::Http::BodyStream* content,
+        const UploadFileRangeOptions& options = UploadFileRangeOptions()) const;
+
+    /**
+     * @brief Creates a file with the content of a buffer, uploaded in ranges in parallel.
+     * @param buffer A memory buffer containing the content to upload.
+     * @param bufferSize Size of the memory buffer.
+     * @param options Optional parameters to execute this function.
+     * @return Azure::Core::Response<FileUploadInfo> The information of the uploaded file.
+     */
+    Azure::Core::Response<FileUploadInfo> UploadFromBuffer(
+        const uint8_t* buffer,
+        std::size_t bufferSize,
+        const UploadFileOptions& options = UploadFileOptions()) const;
+
+    /**
+     * @brief Creates a file with the content of a local file, uploaded in ranges in parallel.
+     * @param file A file containing the content to upload.
+     * @param options Optional parameters to execute this function.
+     * @return Azure::Core::Response<FileUploadInfo> The information of the uploaded file.
+     */
+    Azure::Core::Response<FileUploadInfo> UploadFromFile(
+        const std::string& file,
+        const UploadFileOptions& options = UploadFileOptions()) const;
+
+    /**
+     * @brief Downloads the file or a range of it to a buffer, in ranges in parallel.
+     * @param buffer A memory buffer to write the content to.
+     * @param bufferSize Size of the memory buffer. Size must be larger or equal to size of the
+     * file or file range.
+     * @param options Optional parameters to execute this function.
+     * @return Azure::Core::Response<FileDownloadInfo> The properties of the downloaded file.
+     */
+    Azure::Core::Response<FileDownloadInfo> DownloadToBuffer(
+        uint8_t* buffer,
+        std::size_t bufferSize,
+        const DownloadFileToBufferOptions& options = DownloadFileToBufferOptions()) const;
+
+    /**
+     * @brief Downloads the file or a range of it to a local file, in ranges in parallel.
+     * @param file A file path to write the downloaded content to.
+     * @param options Optional parameters to execute this function.
+     * @return Azure::Core::Response<FileDownloadInfo> The properties of the downloaded file.
+     */
+    Azure::Core::Response<FileDownloadInfo> DownloadToFile(
+        const std::string& file,
+        const DownloadFileToFileOptions& options = DownloadFileToFileOptions()) const;
+
+  private:
+    UriBuilder m_fileUri;
+    std::shared_ptr<Azure::Core::Http::HttpPipeline> m_pipeline;
+
+    explicit FileClient(
+        UriBuilder fileUri,
+        std::shared_ptr<Azure::Core::Http::HttpPipeline> pipeline)
+        : m_fileUri(std::move(fileUri)), m_pipeline(std::move(pipeline))
+    {
+    }
+
+    Azure::Core::Response<FileUploadInfo> UploadRanges(
+        int64_t size,
+        const std::function<std::unique_ptr<Azure::Core::Http::BodyStream>(int64_t, int64_t)>&
+            getContent,
+        const UploadFileOptions& options) const;
+
+    Azure::Core::Response<FileDownloadInfo> DownloadRanges(
+        // offset in the file, length, body stream of the range, transfer buffer
+        const std::function<void(
+            int64_t,
+            int64_t,
+            Azure::Core::Http::BodyStream&,
+            Azure::Core::Http::PooledBuffer&)>& sink,
+        // the size of the range to download, which fails if it's too big
+        const std::function<void(int64_t)>& checkSize,
+        // whether the sink needs a transfer buffer from the pool, it gets an empty one otherwise
+        bool bufferedSink,
+        const DownloadFileToBufferOptions& options) const;
+
+    friend class ShareClient;
+    friend class DirectoryClient;
+  };
+}}}} // namespace Azure::Storage::Files::Shares
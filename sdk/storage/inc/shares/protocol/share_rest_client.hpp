@@ -4948,12 +4948,13 @@ namespace Azure { namespace Storage { namespace Files { namespace Shares {
 
       static Azure::Core::Response<FileUploadRangeResponse> UploadRange(
           std::string url,
+          Azure::Core::Http::BodyStream& bodyStream,
           Azure::Core::Http::HttpPipeline& pipeline,
           Azure::Core::Context context,
           const UploadRangeOptions& uploadRangeOptions)
       {
-        Azure::Core::Http::Request request(Azure::Core::Http::HttpMethod::Put, url);
-        request.AddHeader(Details::c_HeaderContentLength, "0");
+        Azure::Core::Http::Request request(
+            Azure::Core::Http::HttpMethod::Put, std::move(url), &bodyStream);
         request.AddQueryParameter(Details::c_QueryComp, "range");
         if (uploadRangeOptions.Timeout.HasValue())
         {
@@ -5448,49 +5449,152 @@ namespace Azure { namespace Storage { namespace Files { namespace Shares {
           FileDownloadResponse result;
           result.BodyStream = response.GetBodyStream();
           result.LastModified = response.GetHeaders().at(Details::c_HeaderLastModified);
-          result.Metadata = response.GetHeaders().at(Details::c_HeaderMetadata);
+          if (response.GetHeaders().find(Details::c_HeaderMetadata) != response.GetHeaders().end())
+          {
+            result.Metadata = response.GetHeaders().at(Details::c_HeaderMetadata);
+          }
           result.ContentLength
               = std::stoll(response.GetHeaders().at(Details::c_HeaderContentLength));
-          result.HttpHeaders.ContentType = response.GetHeaders().at(Details::c_HeaderContentType);
-          result.ContentRange = response.GetHeaders().at(Details::c_HeaderContentRange);
+          if (response.GetHeaders().find(Details::c_HeaderContentType)
+              != response.GetHeaders().end())
+          {
+            result.HttpHeaders.ContentType = response.GetHeaders().at(Details::c_HeaderContentType);
+          }
+          if (response.GetHeaders().find(Details::c_HeaderContentRange)
+              != response.GetHeaders().end())
+          {
+            result.ContentRange = response.GetHeaders().at(Details::c_HeaderContentRange);
+          }
           result.ETag = response.GetHeaders().at(Details::c_HeaderETag);
           if (response.GetHeaders().find(Details::c_HeaderContentMD5)
               != response.GetHeaders().end())
           {
             result.ContentMD5 = response.GetHeaders().at(Details::c_HeaderContentMD5);
           }
-          result.HttpHeaders.ContentEncoding
-              = response.GetHeaders().at(Details::c_HeaderContentEncoding);
-          result.HttpHeaders.CacheControl = response.GetHeaders().at(Details::c_HeaderCacheControl);
-          result.HttpHeaders.ContentDisposition
-              = response.GetHeaders().at(Details::c_HeaderContentDisposition);
-          result.HttpHeaders.ContentLanguage
-              = response.GetHeaders().at(Details::c_HeaderContentLanguage);
-          result.AcceptRanges = response.GetHeaders().at(Details::c_HeaderAcceptRanges);
-          result.CopyCompletionTime = response.GetHeaders().at(Details::c_HeaderCopyCompletionTime);
-          result.CopyStatusDescription
-              = response.GetHeaders().at(Details::c_HeaderCopyStatusDescription);
-          result.CopyId = response.GetHeaders().at(Details::c_HeaderCopyId);
-          result.CopyProgress = response.GetHeaders().at(Details::c_HeaderCopyProgress);
-          result.CopySource = response.GetHeaders().at(Details::c_HeaderCopySource);
-          result.CopyStatus
-              = CopyStatusTypeFromString(response.GetHeaders().at(Details::c_HeaderCopyStatus));
-          result.FileContentMD5 = response.GetHeaders().at(Details::c_HeaderFileContentMD5);
-          result.IsServerEncrypted
-              = response.GetHeaders().at(Details::c_HeaderIsServerEncrypted) == "true";
-          result.FileAttributes = response.GetHeaders().at(Details::c_HeaderFileAttributes);
-          result.FileCreationTime = response.GetHeaders().at(Details::c_HeaderFileCreationTime);
-          result.FileLastWriteTime = response.GetHeaders().at(Details::c_HeaderFileLastWriteTime);
-          result.FileChangeTime = response.GetHeaders().at(Details::c_HeaderFileChangeTime);
-          result.FilePermissionKey = response.GetHeaders().at(Details::c_HeaderFilePermissionKey);
-          result.FileId = response.GetHeaders().at(Details::c_HeaderFileId);
-          result.FileParentId = response.GetHeaders().at(Details::c_HeaderFileParentId);
-          result.LeaseDuration = LeaseDurationTypeFromString(
-              response.GetHeaders().at(Details::c_HeaderLeaseDuration));
-          result.LeaseState
-              = LeaseStateTypeFromString(response.GetHeaders().at(Details::c_HeaderLeaseState));
-          result.LeaseStatus
-              = LeaseStatusTypeFromString(response.GetHeaders().at(Details::c_HeaderLeaseStatus));
+          if (response.GetHeaders().find(Details::c_HeaderContentEncoding)
+              != response.GetHeaders().end())
+          {
+            result.HttpHeaders.ContentEncoding
+                = response.GetHeaders().at(Details::c_HeaderContentEncoding);
+          }
+          if (response.GetHeaders().find(Details::c_HeaderCacheControl)
+              != response.GetHeaders().end())
+          {
+            result.HttpHeaders.CacheControl
+                = response.GetHeaders().at(Details::c_HeaderCacheControl);
+          }
+          if (response.GetHeaders().find(Details::c_HeaderContentDisposition)
+              != response.GetHeaders().end())
+          {
+            result.HttpHeaders.ContentDisposition
+                = response.GetHeaders().at(Details::c_HeaderContentDisposition);
+          }
+          if (response.GetHeaders().find(Details::c_HeaderContentLanguage)
+              != response.GetHeaders().end())
+          {
+            result.HttpHeaders.ContentLanguage
+                = response.GetHeaders().at(Details::c_HeaderContentLanguage);
+          }
+          if (response.GetHeaders().find(Details::c_HeaderAcceptRanges)
+              != response.GetHeaders().end())
+          {
+            result.AcceptRanges = response.GetHeaders().at(Details::c_HeaderAcceptRanges);
+          }
+          if (response.GetHeaders().find(Details::c_HeaderCopyCompletionTime)
+              != response.GetHeaders().end())
+          {
+            result.CopyCompletionTime
+                = response.GetHeaders().at(Details::c_HeaderCopyCompletionTime);
+          }
+          if (response.GetHeaders().find(Details::c_HeaderCopyStatusDescription)
+              != response.GetHeaders().end())
+          {
+            result.CopyStatusDescription
+                = response.GetHeaders().at(Details::c_HeaderCopyStatusDescription);
+          }
+          if (response.GetHeaders().find(Details::c_HeaderCopyId) != response.GetHeaders().end())
+          {
+            result.CopyId = response.GetHeaders().at(Details::c_HeaderCopyId);
+          }
+          if (response.GetHeaders().find(Details::c_HeaderCopyProgress)
+              != response.GetHeaders().end())
+          {
+            result.CopyProgress = response.GetHeaders().at(Details::c_HeaderCopyProgress);
+          }
+          if (response.GetHeaders().find(Details::c_HeaderCopySource)
+              != response.GetHeaders().end())
+          {
+            result.CopySource = response.GetHeaders().at(Details::c_HeaderCopySource);
+          }
+          if (response.GetHeaders().find(Details::c_HeaderCopyStatus)
+              != response.GetHeaders().end())
+          {
+            result.CopyStatus
+                = CopyStatusTypeFromString(response.GetHeaders().at(Details::c_HeaderCopyStatus));
+          }
+          if (response.GetHeaders().find(Details::c_HeaderFileContentMD5)
+              != response.GetHeaders().end())
+          {
+            result.FileContentMD5 = response.GetHeaders().at(Details::c_HeaderFileContentMD5);
+          }
+          if (response.GetHeaders().find(Details::c_HeaderIsServerEncrypted)
+              != response.GetHeaders().end())
+          {
+            result.IsServerEncrypted
+                = response.GetHeaders().at(Details::c_HeaderIsServerEncrypted) == "true";
+          }
+          if (response.GetHeaders().find(Details::c_HeaderFileAttributes)
+              != response.GetHeaders().end())
+          {
+            result.FileAttributes = response.GetHeaders().at(Details::c_HeaderFileAttributes);
+          }
+          if (response.GetHeaders().find(Details::c_HeaderFileCreationTime)
+              != response.GetHeaders().end())
+          {
+            result.FileCreationTime = response.GetHeaders().at(Details::c_HeaderFileCreationTime);
+          }
+          if (response.GetHeaders().find(Details::c_HeaderFileLastWriteTime)
+              != response.GetHeaders().end())
+          {
+            result.FileLastWriteTime = response.GetHeaders().at(Details::c_HeaderFileLastWriteTime);
+          }
+          if (response.GetHeaders().find(Details::c_HeaderFileChangeTime)
+              != response.GetHeaders().end())
+          {
+            result.FileChangeTime = response.GetHeaders().at(Details::c_HeaderFileChangeTime);
+          }
+          if (response.GetHeaders().find(Details::c_HeaderFilePermissionKey)
+              != response.GetHeaders().end())
+          {
+            result.FilePermissionKey = response.GetHeaders().at(Details::c_HeaderFilePermissionKey);
+          }
+          if (response.GetHeaders().find(Details::c_HeaderFileId) != response.GetHeaders().end())
+          {
+            result.FileId = response.GetHeaders().at(Details::c_HeaderFileId);
+          }
+          if (response.GetHeaders().find(Details::c_HeaderFileParentId)
+              != response.GetHeaders().end())
+          {
+            result.FileParentId = response.GetHeaders().at(Details::c_HeaderFileParentId);
+          }
+          if (response.GetHeaders().find(Details::c_HeaderLeaseDuration)
+              != response.GetHeaders().end())
+          {
+            result.LeaseDuration = LeaseDurationTypeFromString(
+                response.GetHeaders().at(Details::c_HeaderLeaseDuration));
+          }
+          if (response.GetHeaders().find(Details::c_HeaderLeaseState)
+              != response.GetHeaders().end())
+          {
+            result.LeaseState
+                = LeaseStateTypeFromString(response.GetHeaders().at(Details::c_HeaderLeaseState));
+          }
+          if (response.GetHeaders().find(Details::c_HeaderLeaseStatus)
+              != response.GetHeaders().end())
+          {
+            result.LeaseStatus
+                = LeaseStatusTypeFromString(response.GetHeaders().at(Details::c_HeaderLeaseStatus));
+          }
           return Azure::Core::Response<FileDownloadResponse>(
               std::move(result), std::move(responsePtr));
         }
@@ -5500,49 +5604,152 @@ namespace Azure { namespace Storage { namespace Files { namespace Shares {
           FileDownloadResponse result;
           result.BodyStream = response.GetBodyStream();
           result.LastModified = response.GetHeaders().at(Details::c_HeaderLastModified);
-          result.Metadata = response.GetHeaders().at(Details::c_HeaderMetadata);
+          if (response.GetHeaders().find(Details::c_HeaderMetadata) != response.GetHeaders().end())
+          {
+            result.Metadata = response.GetHeaders().at(Details::c_HeaderMetadata);
+          }
           result.ContentLength
               = std::stoll(response.GetHeaders().at(Details::c_HeaderContentLength));
-          result.HttpHeaders.ContentType = response.GetHeaders().at(Details::c_HeaderContentType);
-          result.ContentRange = response.GetHeaders().at(Details::c_HeaderContentRange);
+          if (response.GetHeaders().find(Details::c_HeaderContentType)
+              != response.GetHeaders().end())
+          {
+            result.HttpHeaders.ContentType = response.GetHeaders().at(Details::c_HeaderContentType);
+          }
+          if (response.GetHeaders().find(Details::c_HeaderContentRange)
+              != response.GetHeaders().end())
+          {
+            result.ContentRange = response.GetHeaders().at(Details::c_HeaderContentRange);
+          }
           result.ETag = response.GetHeaders().at(Details::c_HeaderETag);
           if (response.GetHeaders().find(Details::c_HeaderContentMD5)
               != response.GetHeaders().end())
           {
             result.ContentMD5 = response.GetHeaders().at(Details::c_HeaderContentMD5);
           }
-          result.HttpHeaders.ContentEncoding
-              = response.GetHeaders().at(Details::c_HeaderContentEncoding);
-          result.HttpHeaders.CacheControl = response.GetHeaders().at(Details::c_HeaderCacheControl);
-          result.HttpHeaders.ContentDisposition
-              = response.GetHeaders().at(Details::c_HeaderContentDisposition);
-          result.HttpHeaders.ContentLanguage
-              = response.GetHeaders().at(Details::c_HeaderContentLanguage);
-          result.AcceptRanges = response.GetHeaders().at(Details::c_HeaderAcceptRanges);
-          result.CopyCompletionTime = response.GetHeaders().at(Details::c_HeaderCopyCompletionTime);
-          result.CopyStatusDescription
-              = response.GetHeaders().at(Details::c_HeaderCopyStatusDescription);
-          result.CopyId = response.GetHeaders().at(Details::c_HeaderCopyId);
-          result.CopyProgress = response.GetHeaders().at(Details::c_HeaderCopyProgress);
-          result.CopySource = response.GetHeaders().at(Details::c_HeaderCopySource);
-          result.CopyStatus
-              = CopyStatusTypeFromString(response.GetHeaders().at(Details::c_HeaderCopyStatus));
-          result.FileContentMD5 = response.GetHeaders().at(Details::c_HeaderFileContentMD5);
-          result.IsServerEncrypted
-              = response.GetHeaders().at(Details::c_HeaderIsServerEncrypted) == "true";
-          result.FileAttributes = response.GetHeaders().at(Details::c_HeaderFileAttributes);
-          result.FileCreationTime = response.GetHeaders().at(Details::c_HeaderFileCreationTime);
-          result.FileLastWriteTime = response.GetHeaders().at(Details::c_HeaderFileLastWriteTime);
-          result.FileChangeTime = response.GetHeaders().at(Details::c_HeaderFileChangeTime);
-          result.FilePermissionKey = response.GetHeaders().at(Details::c_HeaderFilePermissionKey);
-          result.FileId = response.GetHeaders().at(Details::c_HeaderFileId);
-          result.FileParentId = response.GetHeaders().at(Details::c_HeaderFileParentId);
-          result.LeaseDuration = LeaseDurationTypeFromString(
-              response.GetHeaders().at(Details::c_HeaderLeaseDuration));
-          result.LeaseState
-              = LeaseStateTypeFromString(response.GetHeaders().at(Details::c_HeaderLeaseState));
-          result.LeaseStatus
-              = LeaseStatusTypeFromString(response.GetHeaders().at(Details::c_HeaderLeaseStatus));
+          if (response.GetHeaders().find(Details::c_HeaderContentEncoding)
+              != response.GetHeaders().end())
+          {
+            result.HttpHeaders.ContentEncoding
+                = response.GetHeaders().at(Details::c_HeaderContentEncoding);
+          }
+          if (response.GetHeaders().find(Details::c_HeaderCacheControl)
+              != response.GetHeaders().end())
+          {
+            result.HttpHeaders.CacheControl
+                = response.GetHeaders().at(Details::c_HeaderCacheControl);
+          }
+          if (response.GetHeaders().find(Details::c_HeaderContentDisposition)
+              != response.GetHeaders().end())
+          {
+            result.HttpHeaders.ContentDisposition
+                = response.GetHeaders().at(Details::c_HeaderContentDisposition);
+          }
+          if (response.GetHeaders().find(Details::c_HeaderContentLanguage)
+              != response.GetHeaders().end())
+          {
+            result.HttpHeaders.ContentLanguage
+                = response.GetHeaders().at(Details::c_HeaderContentLanguage);
+          }
+          if (response.GetHeaders().find(Details::c_HeaderAcceptRanges)
+              != response.GetHeaders().end())
+          {
+            result.AcceptRanges = response.GetHeaders().at(Details::c_HeaderAcceptRanges);
+          }
+          if (response.GetHeaders().find(Details::c_HeaderCopyCompletionTime)
+              != response.GetHeaders().end())
+          {
+            result.CopyCompletionTime
+                = response.GetHeaders().at(Details::c_HeaderCopyCompletionTime);
+          }
+          if (response.GetHeaders().find(Details::c_HeaderCopyStatusDescription)
+              != response.GetHeaders().end())
+          {
+            result.CopyStatusDescription
+                = response.GetHeaders().at(Details::c_HeaderCopyStatusDescription);
+          }
+          if (response.GetHeaders().find(Details::c_HeaderCopyId) != response.GetHeaders().end())
+          {
+            result.CopyId = response.GetHeaders().at(Details::c_HeaderCopyId);
+          }
+          if (response.GetHeaders().find(Details::c_HeaderCopyProgress)
+              != response.GetHeaders().end())
+          {
+            result.CopyProgress = response.GetHeaders().at(Details::c_HeaderCopyProgress);
+          }
+          if (response.GetHeaders().find(Details::c_HeaderCopySource)
+              != response.GetHeaders().end())
+          {
+            result.CopySource = response.GetHeaders().at(Details::c_HeaderCopySource);
+          }
+          if (response.GetHeaders().find(Details::c_HeaderCopyStatus)
+              != response.GetHeaders().end())
+          {
+            result.CopyStatus
+                = CopyStatusTypeFromString(response.GetHeaders().at(Details::c_HeaderCopyStatus));
+          }
+          if (response.GetHeaders().find(Details::c_HeaderFileContentMD5)
+              != response.GetHeaders().end())
+          {
+            result.FileContentMD5 = response.GetHeaders().at(Details::c_HeaderFileContentMD5);
+          }
+          if (response.GetHeaders().find(Details::c_HeaderIsServerEncrypted)
+              != response.GetHeaders().end())
+          {
+            result.IsServerEncrypted
+                = response.GetHeaders().at(Details::c_HeaderIsServerEncrypted) == "true";
+          }
+          if (response.GetHeaders().find(Details::c_HeaderFileAttributes)
+              != response.GetHeaders().end())
+          {
+            result.FileAttributes = response.GetHeaders().at(Details::c_HeaderFileAttributes);
+          }
+          if (response.GetHeaders().find(Details::c_HeaderFileCreationTime)
+              != response.GetHeaders().end())
+          {
+            result.FileCreationTime = response.GetHeaders().at(Details::c_HeaderFileCreationTime);
+          }
+          if (response.GetHeaders().find(Details::c_HeaderFileLastWriteTime)
+              != response.GetHeaders().end())
+          {
+            result.FileLastWriteTime = response.GetHeaders().at(Details::c_HeaderFileLastWriteTime);
+          }
+          if (response.GetHeaders().find(Details::c_HeaderFileChangeTime)
+              != response.GetHeaders().end())
+          {
+            result.FileChangeTime = response.GetHeaders().at(Details::c_HeaderFileChangeTime);
+          }
+          if (response.GetHeaders().find(Details::c_HeaderFilePermissionKey)
+              != response.GetHeaders().end())
+          {
+            result.FilePermissionKey = response.GetHeaders().at(Details::c_HeaderFilePermissionKey);
+          }
+          if (response.GetHeaders().find(Details::c_HeaderFileId) != response.GetHeaders().end())
+          {
+            result.FileId = response.GetHeaders().at(Details::c_HeaderFileId);
+          }
+          if (response.GetHeaders().find(Details::c_HeaderFileParentId)
+              != response.GetHeaders().end())
+          {
+            result.FileParentId = response.GetHeaders().at(Details::c_HeaderFileParentId);
+          }
+          if (response.GetHeaders().find(Details::c_HeaderLeaseDuration)
+              != response.GetHeaders().end())
+          {
+            result.LeaseDuration = LeaseDurationTypeFromString(
+                response.GetHeaders().at(Details::c_HeaderLeaseDuration));
+          }
+          if (response.GetHeaders().find(Details::c_HeaderLeaseState)
+              != response.GetHeaders().end())
+          {
+            result.LeaseState
+                = LeaseStateTypeFromString(response.GetHeaders().at(Details::c_HeaderLeaseState));
+          }
+          if (response.GetHeaders().find(Details::c_HeaderLeaseStatus)
+              != response.GetHeaders().end())
+          {
+            result.LeaseStatus
+                = LeaseStatusTypeFromString(response.GetHeaders().at(Details::c_HeaderLeaseStatus));
+          }
           return Azure::Core::Response<FileDownloadResponse>(
               std::move(result), std::move(responsePtr));
         }
@@ -5562,47 +5769,141 @@ namespace Azure { namespace Storage { namespace Files { namespace Shares {
           // Success.
           FileGetPropertiesResponse result;
           result.LastModified = response.GetHeaders().at(Details::c_HeaderLastModified);
-          result.Metadata = response.GetHeaders().at(Details::c_HeaderMetadata);
-          result.FileType = response.GetHeaders().at(Details::c_HeaderFileType);
+          if (response.GetHeaders().find(Details::c_HeaderMetadata) != response.GetHeaders().end())
+          {
+            result.Metadata = response.GetHeaders().at(Details::c_HeaderMetadata);
+          }
+          if (response.GetHeaders().find(Details::c_HeaderFileType) != response.GetHeaders().end())
+          {
+            result.FileType = response.GetHeaders().at(Details::c_HeaderFileType);
+          }
           result.ContentLength
               = std::stoll(response.GetHeaders().at(Details::c_HeaderContentLength));
-          result.HttpHeaders.ContentType = response.GetHeaders().at(Details::c_HeaderContentType);
+          if (response.GetHeaders().find(Details::c_HeaderContentType)
+              != response.GetHeaders().end())
+          {
+            result.HttpHeaders.ContentType = response.GetHeaders().at(Details::c_HeaderContentType);
+          }
           result.ETag = response.GetHeaders().at(Details::c_HeaderETag);
           if (response.GetHeaders().find(Details::c_HeaderContentMD5)
               != response.GetHeaders().end())
           {
             result.ContentMD5 = response.GetHeaders().at(Details::c_HeaderContentMD5);
           }
-          result.HttpHeaders.ContentEncoding
-              = response.GetHeaders().at(Details::c_HeaderContentEncoding);
-          result.HttpHeaders.CacheControl = response.GetHeaders().at(Details::c_HeaderCacheControl);
-          result.HttpHeaders.ContentDisposition
-              = response.GetHeaders().at(Details::c_HeaderContentDisposition);
-          result.HttpHeaders.ContentLanguage
-              = response.GetHeaders().at(Details::c_HeaderContentLanguage);
-          result.CopyCompletionTime = response.GetHeaders().at(Details::c_HeaderCopyCompletionTime);
-          result.CopyStatusDescription
-              = response.GetHeaders().at(Details::c_HeaderCopyStatusDescription);
-          result.CopyId = response.GetHeaders().at(Details::c_HeaderCopyId);
-          result.CopyProgress = response.GetHeaders().at(Details::c_HeaderCopyProgress);
-          result.CopySource = response.GetHeaders().at(Details::c_HeaderCopySource);
-          result.CopyStatus
-              = CopyStatusTypeFromString(response.GetHeaders().at(Details::c_HeaderCopyStatus));
-          result.IsServerEncrypted
-              = response.GetHeaders().at(Details::c_HeaderIsServerEncrypted) == "true";
-          result.FileAttributes = response.GetHeaders().at(Details::c_HeaderFileAttributes);
-          result.FileCreationTime = response.GetHeaders().at(Details::c_HeaderFileCreationTime);
-          result.FileLastWriteTime = response.GetHeaders().at(Details::c_HeaderFileLastWriteTime);
-          result.FileChangeTime = response.GetHeaders().at(Details::c_HeaderFileChangeTime);
-          result.FilePermissionKey = response.GetHeaders().at(Details::c_HeaderFilePermissionKey);
-          result.FileId = response.GetHeaders().at(Details::c_HeaderFileId);
-          result.FileParentId = response.GetHeaders().at(Details::c_HeaderFileParentId);
-          result.LeaseDuration = LeaseDurationTypeFromString(
-              response.GetHeaders().at(Details::c_HeaderLeaseDuration));
-          result.LeaseState
-              = LeaseStateTypeFromString(response.GetHeaders().at(Details::c_HeaderLeaseState));
-          result.LeaseStatus
-              = LeaseStatusTypeFromString(response.GetHeaders().at(Details::c_HeaderLeaseStatus));
+          if (response.GetHeaders().find(Details::c_HeaderContentEncoding)
+              != response.GetHeaders().end())
+          {
+            result.HttpHeaders.ContentEncoding
+                = response.GetHeaders().at(Details::c_HeaderContentEncoding);
+          }
+          if (response.GetHeaders().find(Details::c_HeaderCacheControl)
+              != response.GetHeaders().end())
+          {
+            result.HttpHeaders.CacheControl
+                = response.GetHeaders().at(Details::c_HeaderCacheControl);
+          }
+          if (response.GetHeaders().find(Details::c_HeaderContentDisposition)
+              != response.GetHeaders().end())
+          {
+            result.HttpHeaders.ContentDisposition
+                = response.GetHeaders().at(Details::c_HeaderContentDisposition);
+          }
+          if (response.GetHeaders().find(Details::c_HeaderContentLanguage)
+              != response.GetHeaders().end())
+          {
+            result.HttpHeaders.ContentLanguage
+                = response.GetHeaders().at(Details::c_HeaderContentLanguage);
+          }
+          if (response.GetHeaders().find(Details::c_HeaderCopyCompletionTime)
+              != response.GetHeaders().end())
+          {
+            result.CopyCompletionTime
+                = response.GetHeaders().at(Details::c_HeaderCopyCompletionTime);
+          }
+          if (response.GetHeaders().find(Details::c_HeaderCopyStatusDescription)
+              != response.GetHeaders().end())
+          {
+            result.CopyStatusDescription
+                = response.GetHeaders().at(Details::c_HeaderCopyStatusDescription);
+          }
+          if (response.GetHeaders().find(Details::c_HeaderCopyId) != response.GetHeaders().end())
+          {
+            result.CopyId = response.GetHeaders().at(Details::c_HeaderCopyId);
+          }
+          if (response.GetHeaders().find(Details::c_HeaderCopyProgress)
+              != response.GetHeaders().end())
+          {
+            result.CopyProgress = response.GetHeaders().at(Details::c_HeaderCopyProgress);
+          }
+          if (response.GetHeaders().find(Details::c_HeaderCopySource)
+              != response.GetHeaders().end())
+          {
+            result.CopySource = response.GetHeaders().at(Details::c_HeaderCopySource);
+          }
+          if (response.GetHeaders().find(Details::c_HeaderCopyStatus)
+              != response.GetHeaders().end())
+          {
+            result.CopyStatus
+                = CopyStatusTypeFromString(response.GetHeaders().at(Details::c_HeaderCopyStatus));
+          }
+          if (response.GetHeaders().find(Details::c_HeaderIsServerEncrypted)
+              != response.GetHeaders().end())
+          {
+            result.IsServerEncrypted
+                = response.GetHeaders().at(Details::c_HeaderIsServerEncrypted) == "true";
+          }
+          if (response.GetHeaders().find(Details::c_HeaderFileAttributes)
+              != response.GetHeaders().end())
+          {
+            result.FileAttributes = response.GetHeaders().at(Details::c_HeaderFileAttributes);
+          }
+          if (response.GetHeaders().find(Details::c_HeaderFileCreationTime)
+              != response.GetHeaders().end())
+          {
+            result.FileCreationTime = response.GetHeaders().at(Details::c_HeaderFileCreationTime);
+          }
+          if (response.GetHeaders().find(Details::c_HeaderFileLastWriteTime)
+              != response.GetHeaders().end())
+          {
+            result.FileLastWriteTime = response.GetHeaders().at(Details::c_HeaderFileLastWriteTime);
+          }
+          if (response.GetHeaders().find(Details::c_HeaderFileChangeTime)
+              != response.GetHeaders().end())
+          {
+            result.FileChangeTime = response.GetHeaders().at(Details::c_HeaderFileChangeTime);
+          }
+          if (response.GetHeaders().find(Details::c_HeaderFilePermissionKey)
+              != response.GetHeaders().end())
+          {
+            result.FilePermissionKey = response.GetHeaders().at(Details::c_HeaderFilePermissionKey);
+          }
+          if (response.GetHeaders().find(Details::c_HeaderFileId) != response.GetHeaders().end())
+          {
+            result.FileId = response.GetHeaders().at(Details::c_HeaderFileId);
+          }
+          if (response.GetHeaders().find(Details::c_HeaderFileParentId)
+              != response.GetHeaders().end())
+          {
+            result.FileParentId = response.GetHeaders().at(Details::c_HeaderFileParentId);
+          }
+          if (response.GetHeaders().find(Details::c_HeaderLeaseDuration)
+              != response.GetHeaders().end())
+          {
+            result.LeaseDuration = LeaseDurationTypeFromString(
+                response.GetHeaders().at(Details::c_HeaderLeaseDuration));
+          }
+          if (response.GetHeaders().find(Details::c_HeaderLeaseState)
+              != response.GetHeaders().end())
+          {
+            result.LeaseState
+                = LeaseStateTypeFromString(response.GetHeaders().at(Details::c_HeaderLeaseState));
+          }
+          if (response.GetHeaders().find(Details::c_HeaderLeaseStatus)
+              != response.GetHeaders().end())
+          {
+            result.LeaseStatus
+                = LeaseStatusTypeFromString(response.GetHeaders().at(Details::c_HeaderLeaseStatus));
+          }
           return Azure::Core::Response<FileGetPropertiesResponse>(
               std::move(result), std::move(responsePtr));
         }
@@ -11,6 +11,8 @@
 #include "response.hpp"
 #include "share_options.hpp"
 #include "share_responses.hpp"
+#include "shares/directory_client.hpp"
+#include "shares/file_client.hpp"
 #include "shares/service_client.hpp"
 
 #include <memory>
@@ -70,6 +72,23 @@ namespace Azure { namespace Storage { namespace Files { namespace Shares {
      */
     std::string GetUri() const { return m_shareUri.ToString(); }
 
+    /**
+     * @brief Create a DirectoryClient from this one for a directory in the share. The new client
+     * shares the pipeline of this one.
+     * @param directoryPath The path of the directory, relative to the root of the share. An empty
+     * path is the root directory.
+     * @return DirectoryClient The client for the directory.
+     */
+    DirectoryClient GetDirectoryClient(const std::string& directoryPath) const;
+
+    /**
+     * @brief Create a FileClient from this one for a file in the share. The new client shares the
+     * pipeline of this one.
+     * @param filePath The path of the file, relative to the root of the share.
+     * @return FileClient The client for the file.
+     */
+    FileClient GetFileClient(const std::string& filePath) const;
+
     /**
      * @brief Creates the file share.
      * @param options Optional parameters to create this file share.
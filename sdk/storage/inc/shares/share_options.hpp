@@ -7,6 +7,7 @@
 #include "nullable.hpp"
 #include "protocol/share_rest_client.hpp"
 
+#include <cstdint>
 #include <map>
 #include <memory>
 #include <string>
@@ -32,6 +33,24 @@ namespace Azure { namespace Storage { namespace Files { namespace Shares {
     std::vector<std::unique_ptr<Azure::Core::Http::HttpPolicy>> PerRetryPolicies;
   };
 
+  /**
+   * @brief Directory client options used to initalize DirectoryClient.
+   */
+  struct DirectoryClientOptions
+  {
+    std::vector<std::unique_ptr<Azure::Core::Http::HttpPolicy>> PerOperationPolicies;
+    std::vector<std::unique_ptr<Azure::Core::Http::HttpPolicy>> PerRetryPolicies;
+  };
+
+  /**
+   * @brief File client options used to initalize FileClient.
+   */
+  struct FileClientOptions
+  {
+    std::vector<std::unique_ptr<Azure::Core::Http::HttpPolicy>> PerOperationPolicies;
+    std::vector<std::unique_ptr<Azure::Core::Http::HttpPolicy>> PerRetryPolicies;
+  };
+
   struct ListSharesOptions
   {
     /**
@@ -119,4 +138,234 @@ namespace Azure { namespace Storage { namespace Files { namespace Shares {
     Azure::Core::Nullable<bool> IncludeSnapshots;
   };
 
+  struct CreateDirectoryOptions
+  {
+    /**
+     * @brief Context for cancelling long running operations.
+     */
+    Azure::Core::Context Context;
+
+    /**
+     * @brief A name-value pair to associate with a file storage object.
+     */
+    std::map<std::string, std::string> Metadata;
+
+    /**
+     * @brief The permission (security descriptor) of the directory, in SDDL. The directory
+     * inherits the permission of its parent if it's not specified.
+     */
+    Azure::Core::Nullable<std::string> FilePermission;
+  };
+
+  struct DeleteDirectoryOptions
+  {
+    /**
+     * @brief Context for cancelling long running operations.
+     */
+    Azure::Core::Context Context;
+  };
+
+  struct ListFilesAndDirectoriesSegmentOptions
+  {
+    /**
+     * @brief Context for cancelling long running operations.
+     */
+    Azure::Core::Context Context;
+
+    /**
+     * @brief Filters the results to return only entries whose name begins with the specified
+     * prefix.
+     */
+    Azure::Core::Nullable<std::string> Prefix;
+
+    /**
+     * @brief A string value that identifies the portion of the list to be returned with the next
+     * list operation. The operation returns a marker value within the response body if the list
+     * returned was not complete. The marker value may then be used in a subsequent call to request
+     * the next set of list items. The marker value is opaque to the client.
+     */
+    Azure::Core::Nullable<std::string> Marker;
+
+    /**
+     * @brief Specifies the maximum number of entries to return. If the request does not specify
+     * maxresults, or specifies a value greater than 5,000, the server will return up to 5,000
+     * items.
+     */
+    Azure::Core::Nullable<int32_t> MaxResults;
+  };
+
+  struct CreateFileOptions
+  {
+    /**
+     * @brief Context for cancelling long running operations.
+     */
+    Azure::Core::Context Context;
+
+    /**
+     * @brief The standard HTTP header system properties to set.
+     */
+    FileShareHttpHeaders HttpHeaders;
+
+    /**
+     * @brief A name-value pair to associate with a file storage object.
+     */
+    std::map<std::string, std::string> Metadata;
+
+    /**
+     * @brief The permission (security descriptor) of the file, in SDDL. The file inherits the
+     * permission of its directory if it's not specified.
+     */
+    Azure::Core::Nullable<std::string> FilePermission;
+
+    /**
+     * @brief If specified, the operation only succeeds if the file's lease is active and matches
+     * this ID.
+     */
+    Azure::Core::Nullable<std::string> LeaseId;
+  };
+
+  struct DeleteFileOptions
+  {
+    /**
+     * @brief Context for cancelling long running operations.
+     */
+    Azure::Core::Context Context;
+
+    /**
+     * @brief If specified, the operation only succeeds if the file's lease is active and matches
+     * this ID.
+     */
+    Azure::Core::Nullable<std::string> LeaseId;
+  };
+
+  struct GetFilePropertiesOptions
+  {
+    /**
+     * @brief Context for cancelling long running operations.
+     */
+    Azure::Core::Context Context;
+
+    /**
+     * @brief If specified, the operation only succeeds if the file's lease is active and matches
+     * this ID.
+     */
+    Azure::Core::Nullable<std::string> LeaseId;
+  };
+
+  struct DownloadFileOptions
+  {
+    /**
+     * @brief Context for cancelling long running operations.
+     */
+    Azure::Core::Context Context;
+
+    /**
+     * @brief Downloads only the bytes of the file from this offset.
+     */
+    Azure::Core::Nullable<int64_t> Offset;
+
+    /**
+     * @brief Returns at most this number of bytes of the file from the offset. Requires Offset to
+     * be set.
+     */
+    Azure::Core::Nullable<int64_t> Length;
+
+    /**
+     * @brief If specified, the operation only succeeds if the file's lease is active and matches
+     * this ID.
+     */
+    Azure::Core::Nullable<std::string> LeaseId;
+  };
+
+  struct UploadFileRangeOptions
+  {
+    /**
+     * @brief Context for cancelling long running operations.
+     */
+    Azure::Core::Context Context;
+
+    /**
+     * @brief The base64 encoded MD5 hash of the range, verified by the service.
+     */
+    Azure::Core::Nullable<std::string> ContentMD5;
+
+    /**
+     * @brief If specified, the operation only succeeds if the file's lease is active and matches
+     * this ID.
+     */
+    Azure::Core::Nullable<std::string> LeaseId;
+  };
+
+  struct UploadFileOptions
+  {
+    /**
+     * @brief Context for cancelling long running operations.
+     */
+    Azure::Core::Context Context;
+
+    /**
+     * @brief The size of the ranges the file is uploaded in, at most 4MiB.
+     */
+    Azure::Core::Nullable<int64_t> ChunkSize;
+
+    /**
+     * @brief The maximum number of threads that may be used in a parallel transfer.
+     */
+    int Concurrency = 1;
+
+    /**
+     * @brief The standard HTTP header system properties to set.
+     */
+    FileShareHttpHeaders HttpHeaders;
+
+    /**
+     * @brief A name-value pair to associate with a file storage object.
+     */
+    std::map<std::string, std::string> Metadata;
+
+    /**
+     * @brief The permission (security descriptor) of the file, in SDDL. The file inherits the
+     * permission of its directory if it's not specified.
+     */
+    Azure::Core::Nullable<std::string> FilePermission;
+  };
+
+  struct DownloadFileToBufferOptions
+  {
+    /**
+     * @brief Context for cancelling long running operations.
+     */
+    Azure::Core::Context Context;
+
+    /**
+     * @brief Downloads only the bytes of the file from this offset.
+     */
+    Azure::Core::Nullable<int64_t> Offset;
+
+    /**
+     * @brief Returns at most this number of bytes of the file from the offset. Requires Offset to
+     * be set.
+     */
+    Azure::Core::Nullable<int64_t> Length;
+
+    /**
+     * @brief The size of the first range request in bytes. Files smaller than this limit will be
+     * downloaded in a single request. Files larger than this limit will continue being downloaded
+     * in chunks of size ChunkSize.
+     */
+    Azure::Core::Nullable<int64_t> InitialChunkSize;
+
+    /**
+     * @brief The maximum number of bytes in a single request.
+     */
+    Azure::Core::Nullable<int64_t> ChunkSize;
+
+    /**
+     * @brief The maximum number of threads that may be used in a parallel transfer.
+     */
+    int Concurrency = 1;
+  };
+
+  using DownloadFileToFileOptions = DownloadFileToBufferOptions;
+
 }}}} // namespace Azure::Storage::Files::Shares
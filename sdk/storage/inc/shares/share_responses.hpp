@@ -5,6 +5,9 @@
 
 #include "protocol/share_rest_client.hpp"
 
+#include <cstdint>
+#include <string>
+
 namespace Azure { namespace Storage { namespace Files { namespace Shares {
 
   // ServiceClient models:
@@ -16,4 +19,29 @@ namespace Azure { namespace Storage { namespace Files { namespace Shares {
   using ShareInfo = ShareCreateResponse;
   using ShareDeleteInfo = ShareDeleteResponse;
 
+  // DirectoryClient models:
+  using DirectoryInfo = DirectoryCreateResponse;
+  using DirectoryDeleteInfo = DirectoryDeleteResponse;
+  using ListFilesAndDirectoriesSegmentResult = DirectoryListFilesAndDirectoriesSegmentResponse;
+
+  // FileClient models:
+  using FileInfo = FileCreateResponse;
+  using FileDeleteInfo = FileDeleteResponse;
+  using FileProperties = FileGetPropertiesResponse;
+  using FileUploadRangeInfo = FileUploadRangeResponse;
+
+  struct FileUploadInfo
+  {
+    bool IsServerEncrypted = bool();
+  };
+
+  struct FileDownloadInfo
+  {
+    std::string ETag;
+    std::string LastModified;
+    int64_t ContentLength = int64_t();
+    FileShareHttpHeaders HttpHeaders;
+    bool IsServerEncrypted = bool();
+  };
+
 }}}} // namespace Azure::Storage::Files::Shares
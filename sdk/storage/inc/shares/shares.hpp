@@ -3,5 +3,7 @@
 
 #pragma once
 
+#include "directory_client.hpp"
+#include "file_client.hpp"
 #include "service_client.hpp"
 #include "share_client.hpp"
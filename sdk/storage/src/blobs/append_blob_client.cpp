@@ -4,6 +4,7 @@
 #include "blobs/append_blob_client.hpp"
 
 #include "common/constants.hpp"
+#include "common/content_hash.hpp"
 #include "common/storage_common.hpp"
 
 namespace Azure { namespace Storage { namespace Blobs {
@@ -87,6 +88,19 @@ namespace Azure { namespace Storage { namespace Blobs {
     protocolLayerOptions.IfUnmodifiedSince = options.AccessConditions.IfUnmodifiedSince;
     protocolLayerOptions.IfMatch = options.AccessConditions.IfMatch;
     protocolLayerOptions.IfNoneMatch = options.AccessConditions.IfNoneMatch;
+    std::unique_ptr<HashedBufferStream> hashedContent;
+    if (options.TransactionalHashAlgorithm.HasValue())
+    {
+      hashedContent = std::make_unique<HashedBufferStream>(
+          options.Context, *content, options.TransactionalHashAlgorithm.GetValue());
+      protocolLayerOptions.ContentMd5.Reset();
+      protocolLayerOptions.ContentCrc64.Reset();
+      Details::SetContentHash(
+          protocolLayerOptions,
+          options.TransactionalHashAlgorithm.GetValue(),
+          hashedContent->GetHash());
+      content = hashedContent.get();
+    }
     return BlobRestClient::AppendBlob::AppendBlock(
         options.Context, *m_pipeline, m_blobUrl.ToString(), content, protocolLayerOptions);
   }
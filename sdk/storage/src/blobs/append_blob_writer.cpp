@@ -0,0 +1,329 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include "blobs/append_blob_writer.hpp"
+
+#include "common/content_hash.hpp"
+#include "common/storage_error.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace Azure { namespace Storage { namespace Blobs {
+
+  namespace {
+    constexpr int64_t c_maximumAppendBlockSize = 4 * 1024 * 1024;
+  } // namespace
+
+  AppendBlobWriter::AppendBlobWriter(
+      AppendBlobClient appendBlobClient,
+      const AppendBlobWriterOptions& options)
+      : m_appendBlobClient(std::move(appendBlobClient)), m_options(options)
+  {
+    m_blockSize = m_options.BlockSize.HasValue() ? m_options.BlockSize.GetValue()
+                                                 : c_maximumAppendBlockSize;
+    if (m_blockSize <= 0 || m_blockSize > c_maximumAppendBlockSize)
+    {
+      throw std::runtime_error("block size must be positive and at most 4MiB");
+    }
+    GetBlobPropertiesOptions getPropertiesOptions;
+    getPropertiesOptions.Context = m_options.Context;
+    getPropertiesOptions.AccessConditions.LeaseId = m_options.LeaseId;
+    m_position = m_appendBlobClient.GetProperties(getPropertiesOptions)->ContentLength;
+    for (int i = 0; i < std::max(m_options.Concurrency, 1); ++i)
+    {
+      m_sendThreads.emplace_back(&AppendBlobWriter::SendLoop, this);
+    }
+  }
+
+  AppendBlobWriter::~AppendBlobWriter()
+  {
+    try
+    {
+      Flush();
+    }
+    catch (std::exception&)
+    {
+    }
+    {
+      std::lock_guard<std::mutex> guard(m_mutex);
+      m_stop = true;
+    }
+    m_cv.notify_all();
+    for (auto& sendThread : m_sendThreads)
+    {
+      sendThread.join();
+    }
+  }
+
+  void AppendBlobWriter::Write(const uint8_t* buffer, std::size_t length)
+  {
+    while (length > 0)
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      ThrowIfFailed();
+      if (!m_currentBlock.Buffer)
+      {
+        // The pool may block until another block is released, which mustn't hold up the send
+        // threads.
+        lock.unlock();
+        auto blockBuffer = Azure::Core::Http::BufferPool::Default().Acquire(m_blockSize);
+        lock.lock();
+        m_currentBlock.Buffer = std::move(blockBuffer);
+        m_currentBlock.Length = 0;
+        if (m_options.TransactionalHashAlgorithm.HasValue())
+        {
+          m_currentBlock.Hasher = std::make_unique<Details::ContentHasher>(
+              m_options.TransactionalHashAlgorithm.GetValue());
+        }
+        m_currentBlockStart = std::chrono::steady_clock::now();
+        m_cv.notify_all();
+      }
+
+      std::size_t copyLength = static_cast<std::size_t>(
+          std::min(static_cast<int64_t>(length), m_blockSize - m_currentBlock.Length));
+      uint8_t* destination = m_currentBlock.Buffer.Data() + m_currentBlock.Length;
+      std::memcpy(destination, buffer, copyLength);
+      if (m_currentBlock.Hasher)
+      {
+        m_currentBlock.Hasher->Update(destination, copyLength);
+      }
+      m_currentBlock.Length += static_cast<int64_t>(copyLength);
+      buffer += copyLength;
+      length -= copyLength;
+
+      if (m_currentBlock.Length == m_blockSize)
+      {
+        SealCurrentBlock(lock);
+      }
+    }
+  }
+
+  void AppendBlobWriter::Flush()
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    ThrowIfFailed();
+    if (m_currentBlock.Length != 0)
+    {
+      SealCurrentBlock(lock);
+    }
+    m_cv.wait(lock, [&]() { return m_error || m_blocks.empty(); });
+    ThrowIfFailed();
+  }
+
+  int64_t AppendBlobWriter::GetPosition() const
+  {
+    std::lock_guard<std::mutex> guard(m_mutex);
+    return m_position + m_currentBlock.Length;
+  }
+
+  void AppendBlobWriter::SealCurrentBlock(std::unique_lock<std::mutex>& lock)
+  {
+    // The current block stays in place while waiting, so a send thread may seal it first when
+    // the flush interval expires. Blocks are held until they're in the blob, so the limit covers
+    // the blocks in flight and as many waiting for them.
+    const std::size_t maximumBlocks
+        = static_cast<std::size_t>(std::max(m_options.Concurrency, 1)) * 2;
+    m_cv.wait(lock, [&]() {
+      return m_error || m_currentBlock.Length == 0 || m_blocks.size() < maximumBlocks;
+    });
+    ThrowIfFailed();
+    if (m_currentBlock.Length == 0)
+    {
+      return;
+    }
+    if (m_currentBlock.Hasher)
+    {
+      m_currentBlock.Hash = m_currentBlock.Hasher->Final();
+      m_currentBlock.Hasher.reset();
+    }
+    m_currentBlock.Position = m_position;
+    m_position += m_currentBlock.Length;
+    m_blocks.push_back(std::move(m_currentBlock));
+    m_currentBlock = Block();
+    m_cv.notify_all();
+  }
+
+  void AppendBlobWriter::ThrowIfFailed() const
+  {
+    if (m_error)
+    {
+      std::rethrow_exception(m_error);
+    }
+  }
+
+  void AppendBlobWriter::SendLoop()
+  {
+    const std::size_t maximumBlocks
+        = static_cast<std::size_t>(std::max(m_options.Concurrency, 1)) * 2;
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true)
+    {
+      // The first block not in the blob nor in flight. After an append failed on its position,
+      // that's where the blocks are sent again from, in order.
+      auto block = m_blocks.end();
+      bool first = true;
+      for (auto b = m_blocks.begin(); !m_error && b != m_blocks.end(); ++b)
+      {
+        if (b->Appended)
+        {
+          continue;
+        }
+        if (!b->Sending)
+        {
+          block = b;
+          break;
+        }
+        first = false;
+      }
+      if (block == m_blocks.end())
+      {
+        if (m_stop)
+        {
+          break;
+        }
+        // A partial block is only sealed from here when it wouldn't wait for room.
+        if (m_options.FlushInterval.HasValue() && m_currentBlock.Length != 0 && !m_error
+            && m_blocks.size() < maximumBlocks)
+        {
+          auto deadline = m_currentBlockStart + m_options.FlushInterval.GetValue();
+          if (std::chrono::steady_clock::now() >= deadline)
+          {
+            SealCurrentBlock(lock);
+            continue;
+          }
+          m_cv.wait_until(lock, deadline);
+        }
+        else
+        {
+          m_cv.wait(lock);
+        }
+        continue;
+      }
+
+      block->Sending = true;
+      // whether the blob was known to end where the block starts when it was sent
+      const bool sentFirst = first;
+      lock.unlock();
+      std::exception_ptr error;
+      bool positionFailed = false;
+      try
+      {
+        Append(*block);
+      }
+      catch (StorageError& e)
+      {
+        error = std::current_exception();
+        positionFailed = e.ErrorCode == "AppendPositionConditionNotMet";
+      }
+      catch (std::exception&)
+      {
+        error = std::current_exception();
+      }
+      lock.lock();
+
+      int64_t appendedPosition = block->Position + block->Length;
+      if (positionFailed)
+      {
+        if (!sentFirst)
+        {
+          // It may have arrived ahead of a block before it.
+          error = nullptr;
+          appendedPosition = -1;
+        }
+        else
+        {
+          // Either the append was retried after the service applied it, or someone else appended
+          // to the blob. Only the size of the blob tells.
+          lock.unlock();
+          int64_t blobSize = -1;
+          try
+          {
+            GetBlobPropertiesOptions getPropertiesOptions;
+            getPropertiesOptions.Context = m_options.Context;
+            getPropertiesOptions.AccessConditions.LeaseId = m_options.LeaseId;
+            blobSize = m_appendBlobClient.GetProperties(getPropertiesOptions)->ContentLength;
+          }
+          catch (std::exception&)
+          {
+            error = std::current_exception();
+          }
+          lock.lock();
+          auto end = std::find_if(block, m_blocks.end(), [&](const Block& b) {
+            return b.Position + b.Length == blobSize;
+          });
+          if (blobSize == block->Position)
+          {
+            // The block before it was applied in between.
+            error = nullptr;
+            appendedPosition = -1;
+          }
+          else if (end != m_blocks.end())
+          {
+            error = nullptr;
+            appendedPosition = blobSize;
+          }
+        }
+      }
+      block->Sending = false;
+      if (error)
+      {
+        // Later blocks would leave a gap in the blob, they're dropped.
+        if (!m_error)
+        {
+          m_error = error;
+        }
+      }
+      else
+      {
+        // An append succeeds only if the blocks before it are in the blob.
+        for (auto& b : m_blocks)
+        {
+          if (b.Position + b.Length <= appendedPosition)
+          {
+            b.Appended = true;
+          }
+        }
+      }
+      // The buffers go back to the pool before a writer waiting for them is woken.
+      ReleaseBlocks();
+      m_cv.notify_all();
+    }
+  }
+
+  void AppendBlobWriter::ReleaseBlocks()
+  {
+    for (auto b = m_blocks.begin(); b != m_blocks.end();)
+    {
+      bool inBlob = b->Appended && b == m_blocks.begin();
+      if (!b->Sending && (inBlob || m_error))
+      {
+        b = m_blocks.erase(b);
+        continue;
+      }
+      if (!m_error)
+      {
+        break;
+      }
+      ++b;
+    }
+  }
+
+  void AppendBlobWriter::Append(const Block& block)
+  {
+    Azure::Core::Http::MemoryBodyStream contentStream(block.Buffer.Data(), block.Length);
+    AppendBlockOptions appendOptions;
+    appendOptions.Context = m_options.Context;
+    if (m_options.TransactionalHashAlgorithm.HasValue())
+    {
+      Details::SetContentHash(
+          appendOptions, m_options.TransactionalHashAlgorithm.GetValue(), block.Hash);
+    }
+    appendOptions.AccessConditions.AppendPosition = block.Position;
+    appendOptions.AccessConditions.MaxSize = m_options.MaxSize;
+    appendOptions.AccessConditions.LeaseId = m_options.LeaseId;
+    m_appendBlobClient.AppendBlock(&contentStream, appendOptions);
+  }
+
+}}} // namespace Azure::Storage::Blobs
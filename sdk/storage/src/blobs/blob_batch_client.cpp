@@ -0,0 +1,488 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include "blobs/blob_batch_client.hpp"
+
+#include "common/common_headers_request_policy.hpp"
+#include "common/constants.hpp"
+#include "common/shared_key_policy.hpp"
+#include "common/storage_common.hpp"
+#include "common/storage_error.hpp"
+#include "common/storage_version.hpp"
+#include "common/transfer_executor.hpp"
+#include "credentials/policy/policies.hpp"
+#include "http/curl/curl.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cstdio>
+#include <map>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace Azure { namespace Storage { namespace Blobs {
+
+  namespace {
+    constexpr std::size_t c_maximumBatchSize = 256;
+    const char* const c_newLine = "\r\n";
+
+    /**
+     * The last policy of the pipeline of the operations of a batch. Instead of sending the signed
+     * request, returns it serialized as a part of a multipart batch request in the body of a
+     * dummy response.
+     */
+    class SerializeSubrequestPolicy : public Azure::Core::Http::HttpPolicy {
+    public:
+      ~SerializeSubrequestPolicy() override {}
+
+      std::unique_ptr<HttpPolicy> Clone() const override
+      {
+        return std::make_unique<SerializeSubrequestPolicy>(*this);
+      }
+
+      std::unique_ptr<Azure::Core::Http::RawResponse> Send(
+          Azure::Core::Context const&,
+          Azure::Core::Http::Request& request,
+          Azure::Core::Http::NextHttpPolicy) const override
+      {
+        // The request target is the path and query of the url, without the host.
+        const std::string url = request.GetEncodedUrl();
+        std::size_t pos = url.find("://");
+        pos = pos == std::string::npos ? 0 : pos + 3;
+        pos = url.find_first_of("/?", pos);
+        std::string target = pos == std::string::npos ? std::string("/") : url.substr(pos);
+        if (target[0] == '?')
+        {
+          target.insert(0, 1, '/');
+        }
+
+        std::string serialized = Azure::Core::Http::HttpMethodToString(request.GetMethod()) + " "
+            + target + " HTTP/1.1" + c_newLine;
+        for (const auto& header : request.GetHeaders())
+        {
+          serialized += header.first + ": " + header.second + c_newLine;
+        }
+        serialized += c_newLine;
+
+        auto response = std::make_unique<Azure::Core::Http::RawResponse>(
+            1, 1, Azure::Core::Http::HttpStatusCode::Ok, "OK");
+        response->SetBody(std::vector<uint8_t>(serialized.begin(), serialized.end()));
+        return response;
+      }
+    };
+
+    std::string CreateBoundary()
+    {
+      thread_local std::mt19937_64 random(std::random_device{}());
+      char buffer[40];
+      std::snprintf(
+          buffer,
+          sizeof(buffer),
+          "%016llx%016llx",
+          static_cast<unsigned long long>(random()),
+          static_cast<unsigned long long>(random()));
+      return std::string("batch_") + buffer;
+    }
+
+    // Parses the header lines in [begin, end) of text into name and value pairs, the names
+    // lowercased.
+    std::map<std::string, std::string> ParseHeaderLines(
+        const std::string& text,
+        std::size_t begin,
+        std::size_t end)
+    {
+      std::map<std::string, std::string> headers;
+      while (begin < end)
+      {
+        std::size_t lineEnd = std::min(text.find(c_newLine, begin), end);
+        std::size_t colon = text.find(':', begin);
+        if (colon < lineEnd)
+        {
+          std::string name = text.substr(begin, colon - begin);
+          std::transform(name.begin(), name.end(), name.begin(), [](char c) {
+            return static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+          });
+          std::size_t valueBegin = text.find_first_not_of(' ', colon + 1);
+          valueBegin = std::min(valueBegin, lineEnd);
+          headers[name] = text.substr(valueBegin, lineEnd - valueBegin);
+        }
+        begin = lineEnd + 2;
+      }
+      return headers;
+    }
+
+    struct BatchPart
+    {
+      // -1 if the part has no Content-ID
+      int64_t ContentId = -1;
+      BlobBatchSubResponse SubResponse;
+    };
+
+    // Splits a multipart/mixed batch response into the responses of the operations.
+    std::vector<BatchPart> ParseBatchResponse(const std::string& body, const std::string& boundary)
+    {
+      const std::string delimiter = "--" + boundary;
+      std::vector<BatchPart> parts;
+      std::size_t pos = body.find(delimiter);
+      while (pos != std::string::npos)
+      {
+        pos += delimiter.length();
+        if (body.compare(pos, 2, "--") == 0)
+        {
+          break;
+        }
+        std::size_t partEnd = body.find(delimiter, pos);
+        if (partEnd == std::string::npos)
+        {
+          throw std::runtime_error("failed to parse the batch response, unterminated part");
+        }
+        pos = body.find(c_newLine, pos) + 2;
+
+        // the headers of the part, then the response of the operation
+        std::size_t partHeadersEnd = body.find("\r\n\r\n", pos);
+        if (partHeadersEnd == std::string::npos || partHeadersEnd > partEnd)
+        {
+          throw std::runtime_error("failed to parse the batch response, malformed part");
+        }
+        BatchPart part;
+        auto partHeaders = ParseHeaderLines(body, pos, partHeadersEnd);
+        auto contentId = partHeaders.find("content-id");
+        if (contentId != partHeaders.end())
+        {
+          part.ContentId = std::stoll(contentId->second);
+        }
+
+        // HTTP/1.1 <status code> <reason phrase>
+        std::size_t statusLineBegin = partHeadersEnd + 4;
+        std::size_t statusLineEnd = body.find(c_newLine, statusLineBegin);
+        std::size_t statusCodeBegin = body.find(' ', statusLineBegin);
+        if (statusLineEnd > partEnd || statusCodeBegin > statusLineEnd)
+        {
+          throw std::runtime_error("failed to parse the batch response, malformed status line");
+        }
+        part.SubResponse.StatusCode = static_cast<Azure::Core::Http::HttpStatusCode>(
+            std::stoi(body.substr(statusCodeBegin + 1, 3)));
+        std::size_t headersEnd = std::min(body.find("\r\n\r\n", statusLineEnd), partEnd);
+        auto headers = ParseHeaderLines(body, statusLineEnd + 2, headersEnd);
+        auto errorCode = headers.find("x-ms-error-code");
+        if (errorCode != headers.end())
+        {
+          part.SubResponse.ErrorCode = errorCode->second;
+        }
+        parts.push_back(std::move(part));
+        pos = partEnd;
+      }
+      return parts;
+    }
+  } // namespace
+
+  std::size_t BlobBatch::DeleteBlob(
+      const std::string& containerName,
+      const std::string& blobName,
+      const DeleteBlobOptions& options)
+  {
+    Subrequest subrequest;
+    subrequest.Method = Azure::Core::Http::HttpMethod::Delete;
+    subrequest.ContainerName = containerName;
+    subrequest.BlobName = blobName;
+    if (options.DeleteSnapshots.HasValue())
+    {
+      subrequest.Headers["x-ms-delete-snapshots"]
+          = DeleteSnapshotsOptionToString(options.DeleteSnapshots.GetValue());
+    }
+    if (options.AccessConditions.LeaseId.HasValue())
+    {
+      subrequest.Headers["x-ms-lease-id"] = options.AccessConditions.LeaseId.GetValue();
+    }
+    if (options.AccessConditions.IfModifiedSince.HasValue())
+    {
+      subrequest.Headers["If-Modified-Since"] = options.AccessConditions.IfModifiedSince.GetValue();
+    }
+    if (options.AccessConditions.IfUnmodifiedSince.HasValue())
+    {
+      subrequest.Headers["If-Unmodified-Since"]
+          = options.AccessConditions.IfUnmodifiedSince.GetValue();
+    }
+    if (options.AccessConditions.IfMatch.HasValue())
+    {
+      subrequest.Headers["If-Match"] = options.AccessConditions.IfMatch.GetValue();
+    }
+    if (options.AccessConditions.IfNoneMatch.HasValue())
+    {
+      subrequest.Headers["If-None-Match"] = options.AccessConditions.IfNoneMatch.GetValue();
+    }
+    m_subrequests.push_back(std::move(subrequest));
+    return m_subrequests.size() - 1;
+  }
+
+  std::size_t BlobBatch::SetBlobAccessTier(
+      const std::string& containerName,
+      const std::string& blobName,
+      AccessTier tier,
+      const SetAccessTierOptions& options)
+  {
+    Subrequest subrequest;
+    subrequest.Method = Azure::Core::Http::HttpMethod::Put;
+    subrequest.ContainerName = containerName;
+    subrequest.BlobName = blobName;
+    subrequest.Query["comp"] = "tier";
+    subrequest.Headers["x-ms-access-tier"] = AccessTierToString(tier);
+    if (options.RehydratePriority.HasValue())
+    {
+      subrequest.Headers["x-ms-rehydrate-priority"]
+          = RehydratePriorityToString(options.RehydratePriority.GetValue());
+    }
+    m_subrequests.push_back(std::move(subrequest));
+    return m_subrequests.size() - 1;
+  }
+
+  BlobBatchClient BlobBatchClient::CreateFromConnectionString(
+      const std::string& connectionString,
+      const BlobBatchClientOptions& options)
+  {
+    auto parsedConnectionString = Details::ParseConnectionString(connectionString);
+    auto serviceUri = std::move(parsedConnectionString.BlobServiceUri);
+
+    if (parsedConnectionString.KeyCredential)
+    {
+      return BlobBatchClient(serviceUri.ToString(), parsedConnectionString.KeyCredential, options);
+    }
+    else
+    {
+      return BlobBatchClient(serviceUri.ToString(), options);
+    }
+  }
+
+  BlobBatchClient::BlobBatchClient(
+      const std::string& serviceUri,
+      std::shared_ptr<SharedKeyCredential> credential,
+      const BlobBatchClientOptions& options)
+      : m_serviceUrl(serviceUri)
+  {
+    std::vector<std::unique_ptr<Azure::Core::Http::HttpPolicy>> policies;
+    policies.emplace_back(std::make_unique<Azure::Core::Http::TelemetryPolicy>(
+        Details::c_BlobServicePackageName, BlobServiceVersion));
+    for (const auto& p : options.PerOperationPolicies)
+    {
+      policies.emplace_back(p->Clone());
+    }
+    policies.emplace_back(
+        std::make_unique<Azure::Core::Http::RetryPolicy>(Azure::Core::Http::RetryOptions()));
+    for (const auto& p : options.PerRetryPolicies)
+    {
+      policies.emplace_back(p->Clone());
+    }
+    policies.emplace_back(std::make_unique<CommonHeadersRequestPolicy>());
+    policies.emplace_back(std::make_unique<SharedKeyPolicy>(credential));
+    policies.emplace_back(std::make_unique<Azure::Core::Http::TransportPolicy>(
+        std::make_shared<Azure::Core::Http::CurlTransport>()));
+    m_pipeline = std::make_shared<Azure::Core::Http::HttpPipeline>(policies);
+
+    std::vector<std::unique_ptr<Azure::Core::Http::HttpPolicy>> subrequestPolicies;
+    subrequestPolicies.emplace_back(std::make_unique<CommonHeadersRequestPolicy>());
+    subrequestPolicies.emplace_back(std::make_unique<SharedKeyPolicy>(credential));
+    subrequestPolicies.emplace_back(std::make_unique<SerializeSubrequestPolicy>());
+    m_subrequestPipeline = std::make_shared<Azure::Core::Http::HttpPipeline>(subrequestPolicies);
+  }
+
+  BlobBatchClient::BlobBatchClient(
+      const std::string& serviceUri,
+      std::shared_ptr<Core::Credentials::TokenCredential> credential,
+      const BlobBatchClientOptions& options)
+      : m_serviceUrl(serviceUri)
+  {
+    std::vector<std::unique_ptr<Azure::Core::Http::HttpPolicy>> policies;
+    policies.emplace_back(std::make_unique<Azure::Core::Http::TelemetryPolicy>(
+        Details::c_BlobServicePackageName, BlobServiceVersion));
+    for (const auto& p : options.PerOperationPolicies)
+    {
+      policies.emplace_back(p->Clone());
+    }
+    policies.emplace_back(
+        std::make_unique<Azure::Core::Http::RetryPolicy>(Azure::Core::Http::RetryOptions()));
+    for (const auto& p : options.PerRetryPolicies)
+    {
+      policies.emplace_back(p->Clone());
+    }
+    policies.emplace_back(std::make_unique<CommonHeadersRequestPolicy>());
+    policies.emplace_back(
+        std::make_unique<Core::Credentials::Policy::BearerTokenAuthenticationPolicy>(
+            credential, Details::c_StorageScope));
+    policies.emplace_back(std::make_unique<Azure::Core::Http::TransportPolicy>(
+        std::make_shared<Azure::Core::Http::CurlTransport>()));
+    m_pipeline = std::make_shared<Azure::Core::Http::HttpPipeline>(policies);
+
+    std::vector<std::unique_ptr<Azure::Core::Http::HttpPolicy>> subrequestPolicies;
+    subrequestPolicies.emplace_back(std::make_unique<CommonHeadersRequestPolicy>());
+    subrequestPolicies.emplace_back(
+        std::make_unique<Core::Credentials::Policy::BearerTokenAuthenticationPolicy>(
+            credential, Details::c_StorageScope));
+    subrequestPolicies.emplace_back(std::make_unique<SerializeSubrequestPolicy>());
+    m_subrequestPipeline = std::make_shared<Azure::Core::Http::HttpPipeline>(subrequestPolicies);
+  }
+
+  BlobBatchClient::BlobBatchClient(
+      const std::string& serviceUri,
+      const BlobBatchClientOptions& options)
+      : m_serviceUrl(serviceUri)
+  {
+    std::vector<std::unique_ptr<Azure::Core::Http::HttpPolicy>> policies;
+    policies.emplace_back(std::make_unique<Azure::Core::Http::TelemetryPolicy>(
+        Details::c_BlobServicePackageName, BlobServiceVersion));
+    for (const auto& p : options.PerOperationPolicies)
+    {
+      policies.emplace_back(p->Clone());
+    }
+    policies.emplace_back(
+        std::make_unique<Azure::Core::Http::RetryPolicy>(Azure::Core::Http::RetryOptions()));
+    for (const auto& p : options.PerRetryPolicies)
+    {
+      policies.emplace_back(p->Clone());
+    }
+    policies.emplace_back(std::make_unique<CommonHeadersRequestPolicy>());
+    policies.emplace_back(std::make_unique<Azure::Core::Http::TransportPolicy>(
+        std::make_shared<Azure::Core::Http::CurlTransport>()));
+    m_pipeline = std::make_shared<Azure::Core::Http::HttpPipeline>(policies);
+
+    // The operations carry the SAS token of the service uri, if any.
+    std::vector<std::unique_ptr<Azure::Core::Http::HttpPolicy>> subrequestPolicies;
+    subrequestPolicies.emplace_back(std::make_unique<CommonHeadersRequestPolicy>());
+    subrequestPolicies.emplace_back(std::make_unique<SerializeSubrequestPolicy>());
+    m_subrequestPipeline = std::make_shared<Azure::Core::Http::HttpPipeline>(subrequestPolicies);
+  }
+
+  SubmitBlobBatchResult BlobBatchClient::SubmitBatch(
+      const BlobBatch& batch,
+      const SubmitBlobBatchOptions& options) const
+  {
+    SubmitBlobBatchResult ret;
+    ret.SubResponses.resize(batch.Size());
+    const std::size_t numRequests = (batch.Size() + c_maximumBatchSize - 1) / c_maximumBatchSize;
+    // The requests fill disjoint ranges of the results, so they need no synchronization.
+    std::atomic<std::size_t> nextRequest{0};
+    auto submitFunc = [&]() {
+      std::size_t request = nextRequest.fetch_add(1);
+      if (request >= numRequests)
+      {
+        return false;
+      }
+      std::size_t begin = request * c_maximumBatchSize;
+      std::size_t end = std::min(begin + c_maximumBatchSize, batch.Size());
+      SubmitBatchRequest(batch, begin, end, options.Context, ret.SubResponses);
+      return request + 1 < numRequests;
+    };
+    TransferExecutor::Default().Run(options.Concurrency, submitFunc);
+    return ret;
+  }
+
+  void BlobBatchClient::SubmitBatchRequest(
+      const BlobBatch& batch,
+      std::size_t begin,
+      std::size_t end,
+      Azure::Core::Context context,
+      std::vector<BlobBatchSubResponse>& subResponses) const
+  {
+    const std::string boundary = CreateBoundary();
+    std::string body;
+    for (std::size_t i = begin; i < end; ++i)
+    {
+      const auto& subrequest = batch.m_subrequests[i];
+      auto url = m_serviceUrl;
+      url.AppendPath(subrequest.ContainerName, true);
+      url.AppendPath(subrequest.BlobName, true);
+      Azure::Core::Http::Request request(subrequest.Method, url.ToString());
+      for (const auto& parameter : subrequest.Query)
+      {
+        request.AddQueryParameter(parameter.first, parameter.second);
+      }
+      for (const auto& header : subrequest.Headers)
+      {
+        request.AddHeader(header.first, header.second);
+      }
+      request.AddHeader("Content-Length", "0");
+      auto serialized = m_subrequestPipeline->Send(context, request);
+
+      // The Content-ID of an operation is its index in the request, which the service echoes in
+      // the part of its response.
+      body += "--" + boundary + c_newLine;
+      body += std::string("Content-Type: application/http") + c_newLine;
+      body += std::string("Content-Transfer-Encoding: binary") + c_newLine;
+      body += "Content-ID: " + std::to_string(i - begin) + c_newLine;
+      body += c_newLine;
+      body.append(serialized->GetBody().begin(), serialized->GetBody().end());
+    }
+    body += "--" + boundary + "--" + c_newLine;
+
+    Azure::Core::Http::MemoryBodyStream bodyStream(
+        reinterpret_cast<const uint8_t*>(body.data()), body.length());
+    auto url = m_serviceUrl;
+    if (url.GetPath().empty())
+    {
+      url.SetPath("/");
+    }
+    Azure::Core::Http::Request request(
+        Azure::Core::Http::HttpMethod::Post, url.ToString(), &bodyStream);
+    request.AddQueryParameter("comp", "batch");
+    request.AddHeader("Content-Type", "multipart/mixed; boundary=" + boundary);
+    request.AddHeader("Content-Length", std::to_string(body.length()));
+    request.AddHeader("x-ms-version", c_ApiVersion);
+    auto response = m_pipeline->Send(context, request);
+    if (response->GetStatusCode() != Azure::Core::Http::HttpStatusCode::Accepted)
+    {
+      throw StorageError::CreateFromResponse(context, std::move(response));
+    }
+
+    const auto& headers = response->GetHeaders();
+    auto contentType = headers.find("content-type");
+    const std::string c_boundaryParameter = "boundary=";
+    std::size_t boundaryPos = contentType == headers.end()
+        ? std::string::npos
+        : contentType->second.find(c_boundaryParameter);
+    if (boundaryPos == std::string::npos)
+    {
+      throw std::runtime_error("failed to parse the batch response, no multipart boundary");
+    }
+    std::string responseBoundary = contentType->second.substr(
+        boundaryPos + c_boundaryParameter.length(),
+        contentType->second.find(';', boundaryPos) - boundaryPos - c_boundaryParameter.length());
+    const auto& responseBody = response->GetBody();
+    auto parts = ParseBatchResponse(
+        std::string(responseBody.begin(), responseBody.end()), responseBoundary);
+
+    // A request the service can't process as a batch, such as one with a malformed operation, is
+    // answered with a single part without a Content-ID.
+    if (parts.size() == 1 && parts[0].ContentId == -1 && end - begin != 1)
+    {
+      StorageError error(
+          "batch request failed with "
+          + std::to_string(static_cast<int>(parts[0].SubResponse.StatusCode)) + " "
+          + parts[0].SubResponse.ErrorCode);
+      error.StatusCode = parts[0].SubResponse.StatusCode;
+      error.ErrorCode = parts[0].SubResponse.ErrorCode;
+      error.RawResponse = std::move(response);
+      throw error;
+    }
+    std::size_t numParts = 0;
+    for (auto& part : parts)
+    {
+      std::size_t index
+          = part.ContentId == -1 ? numParts : static_cast<std::size_t>(part.ContentId);
+      if (index >= end - begin)
+      {
+        throw std::runtime_error("failed to parse the batch response, unexpected Content-ID");
+      }
+      subResponses[begin + index] = std::move(part.SubResponse);
+      ++numParts;
+    }
+    if (numParts != end - begin)
+    {
+      throw std::runtime_error(
+          "failed to parse the batch response, " + std::to_string(numParts) + " of "
+          + std::to_string(end - begin) + " operations answered");
+    }
+  }
+
+}}} // namespace Azure::Storage::Blobs
@@ -6,18 +6,148 @@
 #include "blobs/append_blob_client.hpp"
 #include "blobs/block_blob_client.hpp"
 #include "blobs/page_blob_client.hpp"
+#include "common/chunked_download.hpp"
 #include "common/common_headers_request_policy.hpp"
 #include "common/concurrent_transfer.hpp"
 #include "common/constants.hpp"
 #include "common/file_io.hpp"
+#include "common/content_hash.hpp"
 #include "common/shared_key_policy.hpp"
 #include "common/storage_common.hpp"
 #include "common/storage_version.hpp"
+#include "common/transfer_checkpoint.hpp"
+#include "common/transfer_governor.hpp"
 #include "credentials/policy/policies.hpp"
+#include "http/buffer_pool.hpp"
 #include "http/curl/curl.hpp"
 
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
+
 namespace Azure { namespace Storage { namespace Blobs {
 
+  namespace {
+    constexpr int64_t c_maxHashedRangeSize = 4 * 1024 * 1024;
+    // Transfer buffers of downloads that don't write to a caller's buffer are at most this size,
+    // larger chunks are read through them in pieces.
+    constexpr int64_t c_maxTransferBufferSize = 4 * 1024 * 1024;
+
+    int64_t AlignUp(int64_t size, int64_t alignment)
+    {
+      return (size + alignment - 1) / alignment * alignment;
+    }
+
+    Azure::Core::Response<BlobDownloadInfo> ToBlobDownloadInfo(
+        Azure::Core::Response<BlobDownloadResponse>& response)
+    {
+      BlobDownloadInfo ret;
+      ret.ETag = std::move(response->ETag);
+      ret.LastModified = std::move(response->LastModified);
+      ret.HttpHeaders = std::move(response->HttpHeaders);
+      ret.Metadata = std::move(response->Metadata);
+      ret.BlobType = response->BlobType;
+      ret.ServerEncrypted = response->ServerEncrypted;
+      ret.EncryptionKeySha256 = std::move(response->EncryptionKeySha256);
+      return Azure::Core::Response<BlobDownloadInfo>(
+          std::move(ret),
+          std::make_unique<Azure::Core::Http::RawResponse>(std::move(response.GetRawResponse())));
+    }
+
+    // The first chunk of a parallel download. The service only hashes explicit ranges, so a
+    // hashed chunk is always requested as a range. Chunk sizes are rounded up to the alignment.
+    // With a positive maxBufferSize, a transfer buffer is taken before the request.
+    Details::FirstDownloadChunk<BlobDownloadResponse> DownloadFirstBlobChunk(
+        const BlobClient& client,
+        const DownloadBlobToBufferOptions& options,
+        bool ranged,
+        int64_t alignment,
+        int64_t maxBufferSize = 0)
+    {
+      int64_t firstChunkLength = options.InitialChunkSize.HasValue()
+          ? AlignUp(options.InitialChunkSize.GetValue(), alignment)
+          : Details::c_defaultDownloadChunkSize;
+      if (options.TransactionalHashAlgorithm.HasValue())
+      {
+        firstChunkLength = std::min(firstChunkLength, c_maxHashedRangeSize);
+        ranged = true;
+      }
+      return Details::DownloadFirstChunk<BlobDownloadResponse>(
+          options.Offset,
+          options.Length,
+          firstChunkLength,
+          ranged,
+          [&](const Azure::Core::Nullable<int64_t>& offset,
+              const Azure::Core::Nullable<int64_t>& length) {
+            DownloadBlobOptions chunkOptions;
+            chunkOptions.Context = options.Context;
+            chunkOptions.Offset = offset;
+            chunkOptions.Length = length;
+            if (offset.HasValue())
+            {
+              chunkOptions.TransactionalHashAlgorithm = options.TransactionalHashAlgorithm;
+            }
+            return client.Download(chunkOptions);
+          },
+          [](const BlobDownloadResponse& response, bool ranged) {
+            return ranged ? Details::GetSizeFromContentRange(response.ContentRange.GetValue())
+                          : response.BodyStream->Length();
+          },
+          maxBufferSize);
+    }
+
+    int64_t GetBlobChunkSize(
+        const DownloadBlobToBufferOptions& options,
+        int64_t remainingSize,
+        int64_t alignment)
+    {
+      int64_t chunkSize = AlignUp(
+          Details::GetDownloadChunkSize(options.ChunkSize, remainingSize, options.Concurrency),
+          alignment);
+      if (options.TransactionalHashAlgorithm.HasValue())
+      {
+        chunkSize = std::min(chunkSize, c_maxHashedRangeSize);
+      }
+      return chunkSize;
+    }
+
+    // Downloads the chunks after the first one in parallel, in chunks of chunkSize unless the
+    // chunk size is tuned.
+    void DownloadRemainingChunks(
+        const DownloadBlobToBufferOptions& options,
+        int64_t offset,
+        int64_t length,
+        int64_t chunkSize,
+        std::function<void(int64_t, int64_t, int64_t, int64_t)> downloadChunkFunc,
+        std::function<void(int64_t, int64_t)> waitForChunk = nullptr)
+    {
+      if (options.AutoTune.HasValue())
+      {
+        auto tuningOptions = options.AutoTune.GetValue();
+        if (options.TransactionalHashAlgorithm.HasValue())
+        {
+          tuningOptions.MaxChunkSize = std::min(tuningOptions.MaxChunkSize, c_maxHashedRangeSize);
+          tuningOptions.MinChunkSize = std::min(tuningOptions.MinChunkSize, c_maxHashedRangeSize);
+        }
+        TransferTuner tuner(tuningOptions);
+        Details::ConcurrentTransfer(
+            offset, length, tuner, std::move(downloadChunkFunc), std::move(waitForChunk));
+      }
+      else
+      {
+        Details::ConcurrentTransfer(
+            offset,
+            length,
+            chunkSize,
+            options.Concurrency,
+            std::move(downloadChunkFunc),
+            std::move(waitForChunk));
+      }
+    }
+  } // namespace
+
   BlobClient BlobClient::CreateFromConnectionString(
       const std::string& connectionString,
       const std::string& containerName,
@@ -138,6 +268,15 @@ namespace Azure { namespace Storage { namespace Blobs {
   Azure::Core::Response<BlobDownloadResponse> BlobClient::Download(
       const DownloadBlobOptions& options) const
   {
+    // The service only hashes ranges of at most 4MiB, and fails the request otherwise.
+    if (options.TransactionalHashAlgorithm.HasValue()
+        && (!options.Offset.HasValue() || !options.Length.HasValue()
+            || options.Length.GetValue() <= 0 || options.Length.GetValue() > c_maxHashedRangeSize))
+    {
+      throw std::runtime_error(
+          "transactional hash requires an Offset and a Length of at most 4MiB");
+    }
+
     BlobRestClient::Blob::DownloadOptions protocolLayerOptions;
     if (options.Offset.HasValue() && options.Length.HasValue())
     {
@@ -155,9 +294,35 @@ namespace Azure { namespace Storage { namespace Blobs {
     protocolLayerOptions.IfUnmodifiedSince = options.AccessConditions.IfUnmodifiedSince;
     protocolLayerOptions.IfMatch = options.AccessConditions.IfMatch;
     protocolLayerOptions.IfNoneMatch = options.AccessConditions.IfNoneMatch;
+    if (options.TransactionalHashAlgorithm.HasValue())
+    {
+      switch (options.TransactionalHashAlgorithm.GetValue())
+      {
+        case HashAlgorithm::Md5:
+          protocolLayerOptions.RangeGetContentMd5 = true;
+          break;
+        case HashAlgorithm::Crc64:
+          protocolLayerOptions.RangeGetContentCrc64 = true;
+          break;
+      }
+    }
 
-    return BlobRestClient::Blob::Download(
+    auto response = BlobRestClient::Blob::Download(
         options.Context, *m_pipeline, m_blobUrl.ToString(), protocolLayerOptions);
+    if (options.TransactionalHashAlgorithm.HasValue())
+    {
+      auto expectedHash
+          = Details::GetContentHash(*response, options.TransactionalHashAlgorithm.GetValue());
+      if (!expectedHash.HasValue())
+      {
+        throw std::runtime_error("content hash is missing in the response");
+      }
+      response->BodyStream = std::make_unique<HashValidatingStream>(
+          std::move(response->BodyStream),
+          options.TransactionalHashAlgorithm.GetValue(),
+          expectedHash.GetValue());
+    }
+    return response;
   }
 
   Azure::Core::Response<BlobDownloadInfo> BlobClient::DownloadToBuffer(
@@ -165,50 +330,9 @@ namespace Azure { namespace Storage { namespace Blobs {
       std::size_t bufferSize,
       const DownloadBlobToBufferOptions& options) const
   {
-    constexpr int64_t c_defaultChunkSize = 4 * 1024 * 1024;
-
-    // Just start downloading using an initial chunk. If it's a small blob, we'll get the whole
-    // thing in one shot. If it's a large blob, we'll get its full size in Content-Range and can
-    // keep downloading it in chunks.
     int64_t firstChunkOffset = options.Offset.HasValue() ? options.Offset.GetValue() : 0;
-    int64_t firstChunkLength = c_defaultChunkSize;
-    if (options.InitialChunkSize.HasValue())
-    {
-      firstChunkLength = options.InitialChunkSize.GetValue();
-    }
-    if (options.Length.HasValue())
-    {
-      firstChunkLength = std::min(firstChunkLength, options.Length.GetValue());
-    }
-
-    DownloadBlobOptions firstChunkOptions;
-    firstChunkOptions.Context = options.Context;
-    firstChunkOptions.Offset = options.Offset;
-    if (firstChunkOptions.Offset.HasValue())
-    {
-      firstChunkOptions.Length = firstChunkLength;
-    }
-
-    auto firstChunk = Download(firstChunkOptions);
-
-    int64_t blobSize;
-    int64_t blobRangeSize;
-    if (firstChunkOptions.Offset.HasValue())
-    {
-      blobSize = std::stoll(firstChunk->ContentRange.GetValue().substr(
-          firstChunk->ContentRange.GetValue().find('/') + 1));
-      blobRangeSize = blobSize - firstChunkOffset;
-      if (options.Length.HasValue())
-      {
-        blobRangeSize = std::min(blobRangeSize, options.Length.GetValue());
-      }
-    }
-    else
-    {
-      blobSize = firstChunk->BodyStream->Length();
-      blobRangeSize = blobSize;
-    }
-    firstChunkLength = std::min(firstChunkLength, blobRangeSize);
+    auto firstChunk = DownloadFirstBlobChunk(*this, options, false, 1);
+    const int64_t blobRangeSize = firstChunk.RangeSize;
 
     if (static_cast<std::size_t>(blobRangeSize) > bufferSize)
     {
@@ -217,27 +341,15 @@ namespace Azure { namespace Storage { namespace Blobs {
     }
 
     int64_t bytesRead = Azure::Core::Http::BodyStream::ReadToCount(
-        firstChunkOptions.Context, *(firstChunk->BodyStream), buffer, firstChunkLength);
-    if (bytesRead != firstChunkLength)
+        options.Context, *(firstChunk.Chunk->BodyStream), buffer, firstChunk.Length);
+    if (bytesRead != firstChunk.Length)
     {
       throw std::runtime_error("error when reading body stream");
     }
-    firstChunk->BodyStream.reset();
+    firstChunk.Chunk->BodyStream.reset();
+    firstChunk.Permit.Release();
 
-    auto returnTypeConverter = [](Azure::Core::Response<BlobDownloadResponse>& response) {
-      BlobDownloadInfo ret;
-      ret.ETag = std::move(response->ETag);
-      ret.LastModified = std::move(response->LastModified);
-      ret.HttpHeaders = std::move(response->HttpHeaders);
-      ret.Metadata = std::move(response->Metadata);
-      ret.BlobType = response->BlobType;
-      ret.ServerEncrypted = response->ServerEncrypted;
-      ret.EncryptionKeySha256 = std::move(response->EncryptionKeySha256);
-      return Azure::Core::Response<BlobDownloadInfo>(
-          std::move(ret),
-          std::make_unique<Azure::Core::Http::RawResponse>(std::move(response.GetRawResponse())));
-    };
-    auto ret = returnTypeConverter(firstChunk);
+    auto ret = ToBlobDownloadInfo(firstChunk.Chunk);
 
     // Keep downloading the remaining in parallel
     auto downloadChunkFunc
@@ -246,6 +358,7 @@ namespace Azure { namespace Storage { namespace Blobs {
             chunkOptions.Context = options.Context;
             chunkOptions.Offset = offset;
             chunkOptions.Length = length;
+            chunkOptions.TransactionalHashAlgorithm = options.TransactionalHashAlgorithm;
             auto chunk = Download(chunkOptions);
             int64_t bytesRead = Azure::Core::Http::BodyStream::ReadToCount(
                 chunkOptions.Context,
@@ -259,27 +372,18 @@ namespace Azure { namespace Storage { namespace Blobs {
 
             if (chunkId == numChunks - 1)
             {
-              ret = returnTypeConverter(chunk);
+              ret = ToBlobDownloadInfo(chunk);
             }
           };
 
-    int64_t remainingOffset = firstChunkOffset + firstChunkLength;
-    int64_t remainingSize = blobRangeSize - firstChunkLength;
-    int64_t chunkSize;
-    if (options.ChunkSize.HasValue())
-    {
-      chunkSize = options.ChunkSize.GetValue();
-    }
-    else
-    {
-      int64_t c_grainSize = 4 * 1024;
-      chunkSize = remainingSize / options.Concurrency;
-      chunkSize = (std::max(chunkSize, int64_t(1)) + c_grainSize - 1) / c_grainSize * c_grainSize;
-      chunkSize = std::min(chunkSize, c_defaultChunkSize);
-    }
-
-    Details::ConcurrentTransfer(
-        remainingOffset, remainingSize, chunkSize, options.Concurrency, downloadChunkFunc);
+    int64_t remainingOffset = firstChunkOffset + firstChunk.Length;
+    int64_t remainingSize = blobRangeSize - firstChunk.Length;
+    DownloadRemainingChunks(
+        options,
+        remainingOffset,
+        remainingSize,
+        GetBlobChunkSize(options, remainingSize, 1),
+        downloadChunkFunc);
     ret->ContentLength = blobRangeSize;
     return ret;
   }
@@ -288,93 +392,162 @@ namespace Azure { namespace Storage { namespace Blobs {
       const std::string& file,
       const DownloadBlobToFileOptions& options) const
   {
-    constexpr int64_t c_defaultChunkSize = 4 * 1024 * 1024;
-
-    // Just start downloading using an initial chunk. If it's a small blob, we'll get the whole
-    // thing in one shot. If it's a large blob, we'll get its full size in Content-Range and can
-    // keep downloading it in chunks.
+    // Keeps every chunk but the last one aligned for direct I/O.
+    const int64_t alignment = options.DirectIo ? Details::c_directIoAlignment : 1;
     int64_t firstChunkOffset = options.Offset.HasValue() ? options.Offset.GetValue() : 0;
-    int64_t firstChunkLength = c_defaultChunkSize;
-    if (options.InitialChunkSize.HasValue())
-    {
-      firstChunkLength = options.InitialChunkSize.GetValue();
-    }
-    if (options.Length.HasValue())
+
+    Details::FileWriterOptions fileWriterOptions;
+    // A resumed download keeps the chunks already in the file.
+    fileWriterOptions.Truncate = !options.CheckpointFile.HasValue();
+    fileWriterOptions.DirectIo = options.DirectIo;
+    if (options.WriteBackInterval.HasValue())
     {
-      firstChunkLength = std::min(firstChunkLength, options.Length.GetValue());
+      fileWriterOptions.WriteBackInterval = options.WriteBackInterval.GetValue();
     }
-
-    DownloadBlobOptions firstChunkOptions;
-    firstChunkOptions.Context = options.Context;
-    firstChunkOptions.Offset = options.Offset;
-    if (firstChunkOptions.Offset.HasValue())
+    Details::FileWriter fileWriter(file, fileWriterOptions);
+
+    // The journal records the first chunk like any other, so it's requested as a range.
+    auto firstChunk = DownloadFirstBlobChunk(
+        *this, options, options.CheckpointFile.HasValue(), alignment, c_maxTransferBufferSize);
+    const int64_t firstChunkLength = firstChunk.Length;
+    const int64_t blobRangeSize = firstChunk.RangeSize;
+
+    // The journal is only reused for the same range of the same version of the blob. The other
+    // chunks are requested on the ETag of the first one, so that a blob changed in between fails
+    // the download rather than mixing versions in the file.
+    const std::string eTag = firstChunk.Chunk->ETag;
+    std::unique_ptr<Details::TransferCheckpoint> checkpoint;
+    if (options.CheckpointFile.HasValue())
     {
-      firstChunkOptions.Length = firstChunkLength;
+      std::string blobUrl = m_blobUrl.ToString();
+      blobUrl = blobUrl.substr(0, blobUrl.find('?'));
+      checkpoint = std::make_unique<Details::TransferCheckpoint>(
+          options.CheckpointFile.GetValue(),
+          "download " + blobUrl + " " + eTag + " " + std::to_string(firstChunkOffset) + " "
+              + std::to_string(blobRangeSize));
+      fileWriter.SetFileSize(blobRangeSize);
     }
+    fileWriter.Preallocate(blobRangeSize);
+    auto recordChunk = [&](int64_t offset, int64_t length) {
+      if (checkpoint && length > 0)
+      {
+        Details::TransferCheckpoint::Chunk chunk;
+        chunk.Offset = offset;
+        chunk.Length = length;
+        checkpoint->Record(chunk);
+      }
+    };
 
-    Details::FileWriter fileWriter(file);
-
-    auto firstChunk = Download(firstChunkOptions);
+    // Transfer buffers come from the shared pool. They're acquired before a chunk is requested, so
+    // that a pool at its memory limit holds back new requests rather than open connections.
+    auto acquireTransferBuffer = [&](int64_t length) {
+      return Azure::Core::Http::BufferPool::Default().Acquire(
+          std::min(std::max(length, int64_t(1)), c_maxTransferBufferSize));
+    };
 
-    int64_t blobSize;
-    int64_t blobRangeSize;
-    if (firstChunkOptions.Offset.HasValue())
-    {
-      blobSize = std::stoll(firstChunk->ContentRange.GetValue().substr(
-          firstChunk->ContentRange.GetValue().find('/') + 1));
-      blobRangeSize = blobSize - firstChunkOffset;
-      if (options.Length.HasValue())
+    Details::FileIoEngine* fileIoEngine
+        = options.AsyncFileIo ? &Details::FileIoEngine::Default() : nullptr;
+    auto bodyStreamToFile = [fileIoEngine](
+                                Azure::Core::Http::BodyStream& stream,
+                                Details::FileWriter& fileWriter,
+                                Azure::Core::Http::PooledBuffer& buffer,
+                                int64_t offset,
+                                int64_t length,
+                                const Azure::Core::Context& context) {
+      if (fileIoEngine == nullptr)
       {
-        blobRangeSize = std::min(blobRangeSize, options.Length.GetValue());
+        while (length > 0)
+        {
+          int64_t readSize = std::min(buffer.Size(), length);
+          int64_t bytesRead = Azure::Core::Http::BodyStream::ReadToCount(
+              context, stream, buffer.Data(), readSize);
+          if (bytesRead != readSize)
+          {
+            throw std::runtime_error("error when reading body stream");
+          }
+          fileWriter.Write(buffer.Data(), bytesRead, offset);
+          length -= bytesRead;
+          offset += bytesRead;
+        }
+        return;
       }
-    }
-    else
-    {
-      blobSize = firstChunk->BodyStream->Length();
-      blobRangeSize = blobSize;
-    }
-    firstChunkLength = std::min(firstChunkLength, blobRangeSize);
-
-    auto bodyStreamToFile = [](Azure::Core::Http::BodyStream& stream,
-                               Details::FileWriter& fileWriter,
-                               int64_t offset,
-                               int64_t length,
-                               Azure::Core::Context& context) {
-      constexpr std::size_t bufferSize = 4 * 1024 * 1024;
-      std::vector<uint8_t> buffer(bufferSize);
-      while (length > 0)
+
+      // Each piece is written while the next one is received into the other buffer. The second
+      // buffer is only taken if the pool has memory to spare, otherwise pieces are written one at
+      // a time.
+      Azure::Core::Http::PooledBuffer secondBuffer;
+      struct PendingWrites
       {
-        int64_t readSize = std::min(static_cast<int64_t>(bufferSize), length);
-        int64_t bytesRead
-            = Azure::Core::Http::BodyStream::ReadToCount(context, stream, buffer.data(), readSize);
+        std::shared_ptr<Details::FileIoOperation> Writes[2];
+        ~PendingWrites()
+        {
+          // The buffers must outlive the writes still running after a failure.
+          for (auto& write : Writes)
+          {
+            if (write)
+            {
+              try
+              {
+                write->Wait();
+              }
+              catch (std::exception&)
+              {
+              }
+            }
+          }
+        }
+      } pending;
+      Azure::Core::Http::PooledBuffer* buffers[2] = {&buffer, &secondBuffer};
+      auto waitWrites = [&](const Azure::Core::Http::PooledBuffer* usingBuffer) {
+        for (int i = 0; i < 2; ++i)
+        {
+          if (pending.Writes[i] && (usingBuffer == nullptr || buffers[i] == usingBuffer))
+          {
+            fileWriter.WaitWrite(*pending.Writes[i]);
+            pending.Writes[i].reset();
+          }
+        }
+      };
+      for (int current = 0; length > 0; current ^= 1)
+      {
+        if (current == 1 && !secondBuffer && buffers[1] == &secondBuffer)
+        {
+          secondBuffer = Azure::Core::Http::BufferPool::Default().TryAcquire(buffer.Size());
+          if (!secondBuffer)
+          {
+            buffers[1] = &buffer;
+          }
+        }
+        auto& currentBuffer = *buffers[current];
+        waitWrites(&currentBuffer);
+        int64_t readSize = std::min(currentBuffer.Size(), length);
+        int64_t bytesRead = Azure::Core::Http::BodyStream::ReadToCount(
+            context, stream, currentBuffer.Data(), readSize);
         if (bytesRead != readSize)
         {
           throw std::runtime_error("error when reading body stream");
         }
-        fileWriter.Write(buffer.data(), bytesRead, offset);
+        pending.Writes[current]
+            = fileWriter.WriteAsync(*fileIoEngine, currentBuffer.Data(), bytesRead, offset);
         length -= bytesRead;
         offset += bytesRead;
       }
+      waitWrites(nullptr);
     };
 
     bodyStreamToFile(
-        *(firstChunk->BodyStream), fileWriter, 0, firstChunkLength, firstChunkOptions.Context);
-    firstChunk->BodyStream.reset();
-
-    auto returnTypeConverter = [](Azure::Core::Response<BlobDownloadResponse>& response) {
-      BlobDownloadInfo ret;
-      ret.ETag = std::move(response->ETag);
-      ret.LastModified = std::move(response->LastModified);
-      ret.HttpHeaders = std::move(response->HttpHeaders);
-      ret.Metadata = std::move(response->Metadata);
-      ret.BlobType = response->BlobType;
-      ret.ServerEncrypted = response->ServerEncrypted;
-      ret.EncryptionKeySha256 = std::move(response->EncryptionKeySha256);
-      return Azure::Core::Response<BlobDownloadInfo>(
-          std::move(ret),
-          std::make_unique<Azure::Core::Http::RawResponse>(std::move(response.GetRawResponse())));
-    };
-    auto ret = returnTypeConverter(firstChunk);
+        *(firstChunk.Chunk->BodyStream),
+        fileWriter,
+        firstChunk.Buffer,
+        0,
+        firstChunkLength,
+        options.Context);
+    firstChunk.Buffer.Release();
+    firstChunk.Chunk->BodyStream.reset();
+    firstChunk.Permit.Release();
+    recordChunk(firstChunkOffset, firstChunkLength);
+
+    auto ret = ToBlobDownloadInfo(firstChunk.Chunk);
 
     // Keep downloading the remaining in parallel
     auto downloadChunkFunc
@@ -383,37 +556,45 @@ namespace Azure { namespace Storage { namespace Blobs {
             chunkOptions.Context = options.Context;
             chunkOptions.Offset = offset;
             chunkOptions.Length = length;
+            chunkOptions.TransactionalHashAlgorithm = options.TransactionalHashAlgorithm;
+            if (checkpoint)
+            {
+              chunkOptions.AccessConditions.IfMatch = eTag;
+            }
+            auto buffer = acquireTransferBuffer(length);
             auto chunk = Download(chunkOptions);
             bodyStreamToFile(
                 *(chunk->BodyStream),
                 fileWriter,
+                buffer,
                 offset - firstChunkOffset,
                 chunkOptions.Length.GetValue(),
                 chunkOptions.Context);
+            recordChunk(offset, length);
 
             if (chunkId == numChunks - 1)
             {
-              ret = returnTypeConverter(chunk);
+              ret = ToBlobDownloadInfo(chunk);
             }
           };
 
     int64_t remainingOffset = firstChunkOffset + firstChunkLength;
     int64_t remainingSize = blobRangeSize - firstChunkLength;
-    int64_t chunkSize;
-    if (options.ChunkSize.HasValue())
+    int64_t chunkSize = GetBlobChunkSize(options, remainingSize, alignment);
+    if (checkpoint)
     {
-      chunkSize = options.ChunkSize.GetValue();
+      Details::ConcurrentTransfer(
+          Details::GetMissingChunks(
+              remainingOffset, remainingSize, chunkSize, checkpoint->GetCompletedChunks()),
+          options.Concurrency,
+          downloadChunkFunc);
+      checkpoint->Remove();
     }
     else
     {
-      int64_t c_grainSize = 4 * 1024;
-      chunkSize = remainingSize / options.Concurrency;
-      chunkSize = (std::max(chunkSize, int64_t(1)) + c_grainSize - 1) / c_grainSize * c_grainSize;
-      chunkSize = std::min(chunkSize, c_defaultChunkSize);
+      DownloadRemainingChunks(
+          options, remainingOffset, remainingSize, chunkSize, downloadChunkFunc);
     }
-
-    Details::ConcurrentTransfer(
-        remainingOffset, remainingSize, chunkSize, options.Concurrency, downloadChunkFunc);
     ret->ContentLength = blobRangeSize;
     return ret;
   }
@@ -506,6 +687,233 @@ namespace Azure { namespace Storage { namespace Blobs {
         options.Context, *m_pipeline, m_blobUrl.ToString(), protocolLayerOptions);
   }
 
+  Azure::Core::Response<BlobDownloadInfo> BlobClient::DownloadTo(
+      const std::function<void(const uint8_t* data, std::size_t length, int64_t offset)>& sink,
+      const DownloadBlobToOptions& options) const
+  {
+    // The polling interval of an in order chunk waiting for memory in a pool at its limit.
+    constexpr std::chrono::milliseconds c_bufferPollInterval(10);
+
+    // Transfer buffers are taken after the permit and before a chunk is requested, and chunks are
+    // passed to the sink in pieces of at most the buffer size as they're read. With a reorder
+    // window, chunks ahead of their turn are held whole until it comes instead.
+    int64_t firstChunkOffset = options.Offset.HasValue() ? options.Offset.GetValue() : 0;
+    auto firstChunk = DownloadFirstBlobChunk(*this, options, false, 1, c_maxTransferBufferSize);
+    const int64_t firstChunkLength = firstChunk.Length;
+    const int64_t blobRangeSize = firstChunk.RangeSize;
+
+    auto acquireTransferBuffer = [&](int64_t length) {
+      return Azure::Core::Http::BufferPool::Default().Acquire(
+          std::min(std::max(length, int64_t(1)), c_maxTransferBufferSize));
+    };
+    auto bodyStreamToSink = [&](Azure::Core::Http::BodyStream& stream,
+                                Azure::Core::Http::PooledBuffer& buffer,
+                                int64_t offset,
+                                int64_t length,
+                                const Azure::Core::Context& context) {
+      while (length > 0)
+      {
+        int64_t readSize = std::min(buffer.Size(), length);
+        int64_t bytesRead
+            = Azure::Core::Http::BodyStream::ReadToCount(context, stream, buffer.Data(), readSize);
+        if (bytesRead != readSize)
+        {
+          throw std::runtime_error("error when reading body stream");
+        }
+        sink(buffer.Data(), static_cast<std::size_t>(bytesRead), offset);
+        length -= bytesRead;
+        offset += bytesRead;
+      }
+    };
+
+    bodyStreamToSink(
+        *(firstChunk.Chunk->BodyStream), firstChunk.Buffer, 0, firstChunkLength, options.Context);
+    firstChunk.Buffer.Release();
+    firstChunk.Chunk->BodyStream.reset();
+    firstChunk.Permit.Release();
+
+    auto ret = ToBlobDownloadInfo(firstChunk.Chunk);
+
+    int64_t remainingOffset = firstChunkOffset + firstChunkLength;
+    int64_t remainingSize = blobRangeSize - firstChunkLength;
+
+    // State of in order delivery. Offsets are relative to the beginning of the blob range.
+    std::mutex reorderMutex;
+    std::condition_variable reorderCv;
+    int64_t deliveredOffset = firstChunkLength;
+    std::map<int64_t, std::pair<Azure::Core::Http::PooledBuffer, int64_t>> pendingChunks;
+    bool delivering = false;
+    bool failed = false;
+    // The chunk at the delivered offset is streamed to the sink through this buffer, taken before
+    // any chunk holds memory, so that it never waits for the chunks ahead of it to release theirs.
+    Azure::Core::Http::PooledBuffer streamingBuffer;
+    if (options.ReorderWindowSize.HasValue() && remainingSize > 0)
+    {
+      streamingBuffer = acquireTransferBuffer(remainingSize);
+    }
+
+    // Chunks wait for the window before they take a transfer permit, otherwise chunks out of the
+    // window could take every permit and leave none for the one at the delivered offset.
+    std::function<void(int64_t, int64_t)> waitForReorderWindow;
+    if (options.ReorderWindowSize.HasValue())
+    {
+      waitForReorderWindow = [&](int64_t offset, int64_t length) {
+        const int64_t window = options.ReorderWindowSize.GetValue();
+        offset -= firstChunkOffset;
+        std::unique_lock<std::mutex> guard(reorderMutex);
+        // The chunk at the delivered offset is always let through, so that the window can't
+        // stall the download.
+        reorderCv.wait(guard, [&]() {
+          return failed || offset == deliveredOffset
+              || offset + length - deliveredOffset <= window;
+        });
+        if (failed)
+        {
+          throw std::runtime_error("download was aborted");
+        }
+      };
+    }
+
+    // Delivers the pending chunks whose turn has come. Called with delivering set, which is
+    // cleared on return.
+    auto deliverPendingChunks = [&](std::unique_lock<std::mutex>& guard) {
+      while (!pendingChunks.empty() && pendingChunks.begin()->first == deliveredOffset)
+      {
+        auto chunk = std::move(pendingChunks.begin()->second);
+        pendingChunks.erase(pendingChunks.begin());
+        guard.unlock();
+        try
+        {
+          sink(chunk.first.Data(), static_cast<std::size_t>(chunk.second), deliveredOffset);
+        }
+        catch (...)
+        {
+          guard.lock();
+          delivering = false;
+          throw;
+        }
+        chunk.first.Release();
+        guard.lock();
+        deliveredOffset += chunk.second;
+        reorderCv.notify_all();
+      }
+      delivering = false;
+    };
+
+    auto downloadChunkInOrder = [&](const DownloadBlobOptions& chunkOptions,
+                                    int64_t offset,
+                                    int64_t length) {
+      // A chunk ahead of its turn needs a buffer for all of it, but it mustn't block on the pool:
+      // the memory may be held by the chunks after it, which wait for it to be delivered. It
+      // waits for deliveries instead, and once its turn has come it's streamed.
+      Azure::Core::Http::PooledBuffer buffer;
+      {
+        std::unique_lock<std::mutex> guard(reorderMutex);
+        while (true)
+        {
+          if (failed)
+          {
+            throw std::runtime_error("download was aborted");
+          }
+          if (offset == deliveredOffset)
+          {
+            break;
+          }
+          buffer = Azure::Core::Http::BufferPool::Default().TryAcquire(
+              std::max(length, int64_t(1)));
+          if (buffer)
+          {
+            break;
+          }
+          reorderCv.wait_for(guard, c_bufferPollInterval);
+        }
+      }
+
+      auto chunk = Download(chunkOptions);
+      if (!buffer)
+      {
+        bodyStreamToSink(
+            *(chunk->BodyStream), streamingBuffer, offset, length, chunkOptions.Context);
+        std::unique_lock<std::mutex> guard(reorderMutex);
+        deliveredOffset += length;
+        reorderCv.notify_all();
+        if (!delivering)
+        {
+          delivering = true;
+          deliverPendingChunks(guard);
+        }
+        return chunk;
+      }
+
+      int64_t bytesRead = Azure::Core::Http::BodyStream::ReadToCount(
+          chunkOptions.Context, *(chunk->BodyStream), buffer.Data(), length);
+      if (bytesRead != length)
+      {
+        throw std::runtime_error("error when reading body stream");
+      }
+      std::unique_lock<std::mutex> guard(reorderMutex);
+      pendingChunks.emplace(offset, std::make_pair(std::move(buffer), length));
+      if (delivering)
+      {
+        // The thread that is delivering picks this chunk up when its turn comes.
+        return chunk;
+      }
+      delivering = true;
+      deliverPendingChunks(guard);
+      return chunk;
+    };
+
+    // Keep downloading the remaining in parallel
+    auto downloadChunkFunc = [&](int64_t offset,
+                                 int64_t length,
+                                 int64_t chunkId,
+                                 int64_t numChunks) {
+      DownloadBlobOptions chunkOptions;
+      chunkOptions.Context = options.Context;
+      chunkOptions.Offset = offset;
+      chunkOptions.Length = length;
+      chunkOptions.TransactionalHashAlgorithm = options.TransactionalHashAlgorithm;
+      try
+      {
+        if (options.ReorderWindowSize.HasValue())
+        {
+          auto chunk = downloadChunkInOrder(chunkOptions, offset - firstChunkOffset, length);
+          if (chunkId == numChunks - 1)
+          {
+            ret = ToBlobDownloadInfo(chunk);
+          }
+          return;
+        }
+        auto buffer = acquireTransferBuffer(length);
+        auto chunk = Download(chunkOptions);
+        bodyStreamToSink(
+            *(chunk->BodyStream), buffer, offset - firstChunkOffset, length, chunkOptions.Context);
+        if (chunkId == numChunks - 1)
+        {
+          ret = ToBlobDownloadInfo(chunk);
+        }
+      }
+      catch (...)
+      {
+        // Chunks waiting for the window to move would otherwise wait for this one forever.
+        std::lock_guard<std::mutex> guard(reorderMutex);
+        failed = true;
+        reorderCv.notify_all();
+        throw;
+      }
+    };
+
+    DownloadRemainingChunks(
+        options,
+        remainingOffset,
+        remainingSize,
+        GetBlobChunkSize(options, remainingSize, 1),
+        downloadChunkFunc,
+        waitForReorderWindow);
+    ret->ContentLength = blobRangeSize;
+    return ret;
+  }
+
   Azure::Core::Response<BlobSnapshotInfo> BlobClient::CreateSnapshot(
       const CreateSnapshotOptions& options) const
   {
@@ -11,11 +11,142 @@
 #include "common/shared_key_policy.hpp"
 #include "common/storage_common.hpp"
 #include "common/storage_version.hpp"
+#include "common/transfer_executor.hpp"
 #include "credentials/policy/policies.hpp"
 #include "http/curl/curl.hpp"
 
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+
 namespace Azure { namespace Storage { namespace Blobs {
 
+  namespace {
+    // A part of a parallel listing, either the blobs under a shard prefix, or a run of blobs found
+    // while discovering the shards. Parts are ordered by their key, and so are their blobs.
+    struct ListingPart
+    {
+      std::string Key;
+      bool IsShard = false;
+      std::vector<std::vector<BlobItem>> PendingItems;
+      bool Done = false;
+    };
+
+    // Passes the blobs of the parts to the sink one call at a time. When sorted, the blobs of a
+    // part are held until all the parts before it are done.
+    //
+    // Parts are added while the shards are discovered, then Start orders them and the shards are
+    // listed.
+    class ListingMerger {
+    public:
+      ListingMerger(bool sorted, const std::function<void(std::vector<BlobItem>)>& sink)
+          : m_sorted(sorted), m_sink(sink)
+      {
+      }
+
+      // Adds blobs found while discovering the shards, all of them ordered between the same two
+      // shards. Unless sorted, they're passed to the sink right away.
+      void AddBlobs(std::vector<BlobItem> items)
+      {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        if (!m_sorted)
+        {
+          m_sink(std::move(items));
+          return;
+        }
+        ListingPart part;
+        part.Key = items.front().Name;
+        part.PendingItems.push_back(std::move(items));
+        part.Done = true;
+        m_parts.push_back(std::move(part));
+      }
+
+      void AddShard(std::string prefix)
+      {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        ListingPart part;
+        part.Key = std::move(prefix);
+        part.IsShard = true;
+        m_parts.push_back(std::move(part));
+      }
+
+      // Returns the indices of the shards, in order.
+      std::vector<std::size_t> Start()
+      {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        std::sort(
+            m_parts.begin(), m_parts.end(), [](const ListingPart& lhs, const ListingPart& rhs) {
+              return lhs.Key < rhs.Key;
+            });
+        std::vector<std::size_t> shards;
+        for (std::size_t i = 0; i < m_parts.size(); ++i)
+        {
+          if (m_parts[i].IsShard)
+          {
+            shards.push_back(i);
+          }
+        }
+        if (m_sorted)
+        {
+          Advance();
+        }
+        return shards;
+      }
+
+      const std::string& GetKey(std::size_t index) const { return m_parts[index].Key; }
+
+      void Add(std::size_t index, std::vector<BlobItem> items)
+      {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        if (m_sorted && index != m_next)
+        {
+          m_parts[index].PendingItems.push_back(std::move(items));
+          return;
+        }
+        m_sink(std::move(items));
+      }
+
+      void Complete(std::size_t index)
+      {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        m_parts[index].Done = true;
+        if (m_sorted)
+        {
+          Advance();
+        }
+      }
+
+    private:
+      void Deliver(ListingPart& part)
+      {
+        for (auto& items : part.PendingItems)
+        {
+          m_sink(std::move(items));
+        }
+        part.PendingItems.clear();
+      }
+
+      void Advance()
+      {
+        while (m_next < m_parts.size())
+        {
+          Deliver(m_parts[m_next]);
+          if (!m_parts[m_next].Done)
+          {
+            break;
+          }
+          ++m_next;
+        }
+      }
+
+      std::vector<ListingPart> m_parts;
+      bool m_sorted;
+      const std::function<void(std::vector<BlobItem>)>& m_sink;
+      std::mutex m_mutex;
+      std::size_t m_next = 0;
+    };
+  } // namespace
+
   BlobContainerClient BlobContainerClient::CreateFromConnectionString(
       const std::string& connectionString,
       const std::string& containerName,
@@ -190,6 +321,24 @@ namespace Azure { namespace Storage { namespace Blobs {
         options.Context, *m_pipeline, m_containerUrl.ToString(), protocolLayerOptions);
   }
 
+  Azure::Core::Response<CompactBlobsFlatSegment> BlobContainerClient::ListBlobsFlatCompact(
+      const ListBlobsOptions& options) const
+  {
+    BlobRestClient::Container::ListBlobsFlatOptions protocolLayerOptions;
+    protocolLayerOptions.Prefix = options.Prefix;
+    protocolLayerOptions.Marker = options.Marker;
+    protocolLayerOptions.MaxResults = options.MaxResults;
+    protocolLayerOptions.Include = options.Include;
+    auto pHttpResponse = BlobRestClient::Container::SendListBlobsFlat(
+        options.Context, *m_pipeline, m_containerUrl.ToString(), protocolLayerOptions);
+    const auto& httpResponseBody = pHttpResponse->GetBody();
+    XmlPullReader reader(
+        reinterpret_cast<const char*>(httpResponseBody.data()), httpResponseBody.size());
+    auto segment = Storage::Details::CompactBlobsFlatSegmentFromXml(reader);
+    return Azure::Core::Response<CompactBlobsFlatSegment>(
+        std::move(segment), std::move(pHttpResponse));
+  }
+
   Azure::Core::Response<BlobsHierarchySegment> BlobContainerClient::ListBlobsByHierarchy(
       const std::string& delimiter,
       const ListBlobsOptions& options) const
@@ -204,6 +353,168 @@ namespace Azure { namespace Storage { namespace Blobs {
         options.Context, *m_pipeline, m_containerUrl.ToString(), protocolLayerOptions);
   }
 
+  SegmentPager<BlobsFlatSegment> BlobContainerClient::ListBlobsFlatPages(
+      const ListBlobsOptions& options,
+      int prefetchDepth) const
+  {
+    BlobContainerClient client(*this);
+    ListBlobsOptions segmentOptions = options;
+    return SegmentPager<BlobsFlatSegment>(
+        [client, segmentOptions](const Azure::Core::Nullable<std::string>& marker) mutable {
+          segmentOptions.Marker = marker;
+          return client.ListBlobsFlat(segmentOptions).ExtractValue();
+        },
+        options.Marker,
+        prefetchDepth);
+  }
+
+  SegmentPager<BlobsHierarchySegment> BlobContainerClient::ListBlobsByHierarchyPages(
+      const std::string& delimiter,
+      const ListBlobsOptions& options,
+      int prefetchDepth) const
+  {
+    BlobContainerClient client(*this);
+    ListBlobsOptions segmentOptions = options;
+    return SegmentPager<BlobsHierarchySegment>(
+        [client, delimiter, segmentOptions](
+            const Azure::Core::Nullable<std::string>& marker) mutable {
+          segmentOptions.Marker = marker;
+          return client.ListBlobsByHierarchy(delimiter, segmentOptions).ExtractValue();
+        },
+        options.Marker,
+        prefetchDepth);
+  }
+
+  void BlobContainerClient::ListBlobsParallel(
+      const std::function<void(std::vector<BlobItem> items)>& sink,
+      const ListBlobsParallelOptions& options) const
+  {
+    // Shards are discovered a level of virtual directories at a time, until there are enough of
+    // them to keep every thread busy as they finish unevenly. A directory is only looked into
+    // with a single page, and becomes a shard when that page isn't all of it or has no
+    // subdirectories, so that discovery never lists a large flat directory on its own.
+    constexpr int c_maxDiscoveryLevels = 2;
+    constexpr std::size_t c_shardsPerThread = 4;
+    constexpr int32_t c_maxDiscoveryResults = 1000;
+
+    ListBlobsOptions listOptions;
+    listOptions.Context = options.Context;
+    listOptions.MaxResults = options.MaxResults;
+    listOptions.Include = options.Include;
+
+    ListingMerger merger(options.Sorted, sink);
+    if (!options.ShardPrefixes.empty())
+    {
+      std::vector<std::string> shardPrefixes = options.ShardPrefixes;
+      std::sort(shardPrefixes.begin(), shardPrefixes.end());
+      const std::string* lastPrefix = nullptr;
+      for (const auto& prefix : shardPrefixes)
+      {
+        // A prefix sorts right before the names it covers, so the shards it would duplicate follow
+        // it.
+        if (lastPrefix != nullptr && prefix.compare(0, lastPrefix->length(), *lastPrefix) == 0)
+        {
+          continue;
+        }
+        merger.AddShard(prefix);
+        lastPrefix = &prefix;
+      }
+    }
+    else
+    {
+      const std::size_t targetShards
+          = static_cast<std::size_t>(std::max(options.Concurrency, 1)) * c_shardsPerThread;
+      std::vector<std::string> frontier{
+          options.Prefix.HasValue() ? options.Prefix.GetValue() : std::string()};
+      for (int level = 0; level < c_maxDiscoveryLevels && options.Concurrency > 1
+           && !frontier.empty() && frontier.size() < targetShards;
+           ++level)
+      {
+        std::vector<std::string> nextFrontier;
+        std::mutex discoveryMutex;
+        std::atomic<std::size_t> nextPrefix{0};
+        TransferExecutor::Default().Run(options.Concurrency, [&]() {
+          std::size_t index = nextPrefix.fetch_add(1);
+          if (index >= frontier.size())
+          {
+            return false;
+          }
+          ListBlobsOptions hierarchyOptions = listOptions;
+          hierarchyOptions.Prefix = frontier[index];
+          hierarchyOptions.MaxResults = std::min(
+              options.MaxResults.HasValue() ? options.MaxResults.GetValue()
+                                            : c_maxDiscoveryResults,
+              c_maxDiscoveryResults);
+          auto segment = ListBlobsByHierarchy(options.Delimiter, hierarchyOptions);
+          if (!segment->NextMarker.empty() || segment->BlobPrefixes.empty())
+          {
+            merger.AddShard(std::move(frontier[index]));
+            return index + 1 < frontier.size();
+          }
+
+          // The blobs right under the prefix are kept, in runs between its subdirectories.
+          std::vector<BlobItem> run;
+          auto blobPrefix = segment->BlobPrefixes.begin();
+          for (auto& item : segment->Items)
+          {
+            if (blobPrefix != segment->BlobPrefixes.end() && blobPrefix->Name < item.Name)
+            {
+              if (!run.empty())
+              {
+                merger.AddBlobs(std::move(run));
+                run.clear();
+              }
+              while (blobPrefix != segment->BlobPrefixes.end() && blobPrefix->Name < item.Name)
+              {
+                ++blobPrefix;
+              }
+            }
+            run.push_back(std::move(item));
+          }
+          if (!run.empty())
+          {
+            merger.AddBlobs(std::move(run));
+          }
+          std::lock_guard<std::mutex> guard(discoveryMutex);
+          for (auto& subdirectory : segment->BlobPrefixes)
+          {
+            nextFrontier.push_back(std::move(subdirectory.Name));
+          }
+          return index + 1 < frontier.size();
+        });
+        frontier = std::move(nextFrontier);
+      }
+      for (auto& prefix : frontier)
+      {
+        merger.AddShard(std::move(prefix));
+      }
+    }
+
+    const std::vector<std::size_t> shards = merger.Start();
+    std::atomic<std::size_t> nextShard{0};
+    TransferExecutor::Default().Run(options.Concurrency, [&]() {
+      std::size_t index = nextShard.fetch_add(1);
+      if (index >= shards.size())
+      {
+        return false;
+      }
+      const std::size_t partIndex = shards[index];
+      ListBlobsOptions shardOptions = listOptions;
+      shardOptions.Prefix = merger.GetKey(partIndex);
+      do
+      {
+        auto segment = ListBlobsFlat(shardOptions);
+        shardOptions.Marker = segment->NextMarker;
+        if (!segment->Items.empty())
+        {
+          merger.Add(partIndex, std::move(segment->Items));
+        }
+      } while (!shardOptions.Marker.GetValue().empty());
+      merger.Complete(partIndex);
+      return index + 1 < shards.size();
+    });
+  }
+
   Azure::Core::Response<BlobContainerAccessPolicy> BlobContainerClient::GetAccessPolicy(
       const GetBlobContainerAccessPolicyOptions& options) const
   {
@@ -4,6 +4,12 @@
 #include "blobs/blob_sas_builder.hpp"
 #include "common/crypt.hpp"
 #include "common/storage_uri_builder.hpp"
+#include "common/transfer_executor.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <thread>
 
 namespace Azure { namespace Storage { namespace Blobs {
 
@@ -107,50 +113,127 @@ namespace Azure { namespace Storage { namespace Blobs {
     }
   }
 
-  std::string BlobSasBuilder::ToSasQueryParameters(const SharedKeyCredential& credential)
+  struct BlobSasBuilder::SasTemplate
   {
-    std::string canonicalName = "/blob/" + credential.AccountName + "/" + ContainerName;
-    if (Resource == BlobSasResource::Blob || Resource == BlobSasResource::BlobSnapshot)
+    // The string to sign is StringToSignPrefix, followed by the blob name if IncludesBlobName is
+    // true, followed by StringToSignSuffix.
+    std::string StringToSignPrefix;
+    std::string StringToSignSuffix;
+    bool IncludesBlobName = false;
+    // The query parameters are QueryPrefix, followed by the url encoded signature, followed by
+    // QuerySuffix.
+    std::string QueryPrefix;
+    std::string QuerySuffix;
+
+    std::string Sign(
+        const HmacSha256& key,
+        const std::string& blobName,
+        std::string& stringToSign) const
     {
-      canonicalName += "/" + BlobName;
+      stringToSign.assign(StringToSignPrefix);
+      if (IncludesBlobName)
+      {
+        stringToSign += blobName;
+      }
+      stringToSign += StringToSignSuffix;
+      const std::string signature = key.Sign(stringToSign);
+
+      char encoded[Details::Base64EncodedLength(64)];
+      std::size_t encodedLength = Details::Base64Encode(
+          reinterpret_cast<const uint8_t*>(signature.data()), signature.length(), encoded);
+      std::string query;
+      query.reserve(QueryPrefix.length() + encodedLength * 3 + QuerySuffix.length());
+      query += QueryPrefix;
+      // Same as UriBuilder, '/' is allowed in query values.
+      for (std::size_t i = 0; i < encodedLength; ++i)
+      {
+        if (encoded[i] == '+')
+        {
+          query += "%2B";
+        }
+        else if (encoded[i] == '=')
+        {
+          query += "%3D";
+        }
+        else
+        {
+          query += encoded[i];
+        }
+      }
+      query += QuerySuffix;
+      return query;
     }
+  };
+
+  BlobSasBuilder::SasTemplate BlobSasBuilder::GetSasTemplate(
+      const std::string& accountName,
+      const UserDelegationKey* userDelegationKey) const
+  {
     std::string protocol = SasProtocolToString(Protocol);
     std::string resource = BlobSasResourceToString(Resource);
 
-    std::string stringToSign = Permissions + "\n" + (StartsOn.HasValue() ? StartsOn.GetValue() : "")
-        + "\n" + ExpiresOn + "\n" + canonicalName + "\n" + Identifier + "\n"
-        + (IPRange.HasValue() ? IPRange.GetValue() : "") + "\n" + protocol + "\n" + Version + "\n"
-        + resource + "\n" + Snapshot + "\n" + CacheControl + "\n" + ContentDisposition + "\n"
-        + ContentEncoding + "\n" + ContentLanguage + "\n" + ContentType;
-
-    std::string signature
-        = Base64Encode(Hmac_Sha256(stringToSign, Base64Decode(credential.GetAccountKey())));
+    SasTemplate sasTemplate;
+    sasTemplate.StringToSignPrefix = Permissions + "\n"
+        + (StartsOn.HasValue() ? StartsOn.GetValue() : "") + "\n" + ExpiresOn + "\n" + "/blob/"
+        + accountName + "/" + ContainerName;
+    sasTemplate.IncludesBlobName
+        = Resource == BlobSasResource::Blob || Resource == BlobSasResource::BlobSnapshot;
+    if (sasTemplate.IncludesBlobName)
+    {
+      sasTemplate.StringToSignPrefix += "/";
+    }
 
     UriBuilder builder;
     builder.AppendQuery("sv", Version);
-    builder.AppendQuery("spr", protocol);
     if (StartsOn.HasValue())
     {
       builder.AppendQuery("st", StartsOn.GetValue());
     }
-    if (!ExpiresOn.empty())
-    {
-      builder.AppendQuery("se", ExpiresOn);
-    }
     if (IPRange.HasValue())
     {
       builder.AppendQuery("sip", IPRange.GetValue());
     }
-    if (!Identifier.empty())
+    builder.AppendQuery("spr", protocol);
+    builder.AppendQuery("sr", resource);
+    if (userDelegationKey == nullptr)
     {
-      builder.AppendQuery("si", Identifier);
+      sasTemplate.StringToSignSuffix = "\n" + Identifier + "\n"
+          + (IPRange.HasValue() ? IPRange.GetValue() : "") + "\n" + protocol + "\n" + Version
+          + "\n" + resource + "\n" + Snapshot + "\n" + CacheControl + "\n" + ContentDisposition
+          + "\n" + ContentEncoding + "\n" + ContentLanguage + "\n" + ContentType;
+
+      if (!ExpiresOn.empty())
+      {
+        builder.AppendQuery("se", ExpiresOn);
+      }
+      if (!Identifier.empty())
+      {
+        builder.AppendQuery("si", Identifier);
+      }
+      if (!Permissions.empty())
+      {
+        builder.AppendQuery("sp", Permissions);
+      }
     }
-    builder.AppendQuery("sr", resource);
-    if (!Permissions.empty())
+    else
     {
+      sasTemplate.StringToSignSuffix = "\n" + userDelegationKey->SignedObjectId + "\n"
+          + userDelegationKey->SignedTenantId + "\n" + userDelegationKey->SignedStartsOn + "\n"
+          + userDelegationKey->SignedExpiresOn + "\n" + userDelegationKey->SignedService + "\n"
+          + userDelegationKey->SignedVersion + "\n"
+          + (IPRange.HasValue() ? IPRange.GetValue() : "") + "\n" + protocol + "\n" + Version
+          + "\n" + resource + "\n" + Snapshot + "\n" + CacheControl + "\n" + ContentDisposition
+          + "\n" + ContentEncoding + "\n" + ContentLanguage + "\n" + ContentType;
+
+      builder.AppendQuery("se", ExpiresOn);
       builder.AppendQuery("sp", Permissions);
+      builder.AppendQuery("skoid", userDelegationKey->SignedObjectId);
+      builder.AppendQuery("sktid", userDelegationKey->SignedTenantId);
+      builder.AppendQuery("skt", userDelegationKey->SignedStartsOn);
+      builder.AppendQuery("ske", userDelegationKey->SignedExpiresOn);
+      builder.AppendQuery("sks", userDelegationKey->SignedService);
+      builder.AppendQuery("skv", userDelegationKey->SignedVersion);
     }
-    builder.AppendQuery("sig", signature, true);
     if (!CacheControl.empty())
     {
       builder.AppendQuery("rscc", CacheControl);
@@ -172,76 +255,103 @@ namespace Azure { namespace Storage { namespace Blobs {
       builder.AppendQuery("rsct", ContentType);
     }
 
-    return builder.ToString();
+    // Splits the query parameters around the signature, in the order UriBuilder::ToString writes
+    // them in.
+    const std::string signatureKey = "sig";
+    for (const auto& query : builder.GetQuery())
+    {
+      if (query.first < signatureKey)
+      {
+        sasTemplate.QueryPrefix += sasTemplate.QueryPrefix.empty() ? "?" : "&";
+        sasTemplate.QueryPrefix += query.first + "=" + query.second;
+      }
+      else
+      {
+        sasTemplate.QuerySuffix += "&" + query.first + "=" + query.second;
+      }
+    }
+    sasTemplate.QueryPrefix += sasTemplate.QueryPrefix.empty() ? "?" : "&";
+    sasTemplate.QueryPrefix += signatureKey + "=";
+    return sasTemplate;
+  }
+
+  std::string BlobSasBuilder::ToSasQueryParameters(const SharedKeyCredential& credential)
+  {
+    std::string stringToSign;
+    return GetSasTemplate(credential.AccountName, nullptr)
+        .Sign(*credential.GetSigningKey(), BlobName, stringToSign);
   }
 
   std::string BlobSasBuilder::ToSasQueryParameters(
       const UserDelegationKey& userDelegationKey,
       const std::string& accountName)
   {
-    std::string canonicalName = "/blob/" + accountName + "/" + ContainerName;
-    if (Resource == BlobSasResource::Blob || Resource == BlobSasResource::BlobSnapshot)
-    {
-      canonicalName += "/" + BlobName;
-    }
-    std::string protocol = SasProtocolToString(Protocol);
-    std::string resource = BlobSasResourceToString(Resource);
-
-    std::string stringToSign = Permissions + "\n" + (StartsOn.HasValue() ? StartsOn.GetValue() : "")
-        + "\n" + ExpiresOn + "\n" + canonicalName + "\n" + userDelegationKey.SignedObjectId + "\n"
-        + userDelegationKey.SignedTenantId + "\n" + userDelegationKey.SignedStartsOn + "\n"
-        + userDelegationKey.SignedExpiresOn + "\n" + userDelegationKey.SignedService + "\n"
-        + userDelegationKey.SignedVersion + "\n" + (IPRange.HasValue() ? IPRange.GetValue() : "")
-        + "\n" + protocol + "\n" + Version + "\n" + resource + "\n" + Snapshot + "\n" + CacheControl
-        + "\n" + ContentDisposition + "\n" + ContentEncoding + "\n" + ContentLanguage + "\n"
-        + ContentType;
-
-    std::string signature
-        = Base64Encode(Hmac_Sha256(stringToSign, Base64Decode(userDelegationKey.Value)));
+    std::string stringToSign;
+    return GetSasTemplate(accountName, &userDelegationKey)
+        .Sign(HmacSha256(Base64Decode(userDelegationKey.Value)), BlobName, stringToSign);
+  }
 
-    UriBuilder builder;
-    builder.AppendQuery("sv", Version);
-    builder.AppendQuery("sr", resource);
-    if (StartsOn.HasValue())
-    {
-      builder.AppendQuery("st", StartsOn.GetValue());
-    }
-    builder.AppendQuery("se", ExpiresOn);
-    builder.AppendQuery("sp", Permissions);
-    if (IPRange.HasValue())
-    {
-      builder.AppendQuery("sip", IPRange.GetValue());
-    }
-    builder.AppendQuery("spr", protocol);
-    builder.AppendQuery("skoid", userDelegationKey.SignedObjectId);
-    builder.AppendQuery("sktid", userDelegationKey.SignedTenantId);
-    builder.AppendQuery("skt", userDelegationKey.SignedStartsOn);
-    builder.AppendQuery("ske", userDelegationKey.SignedExpiresOn);
-    builder.AppendQuery("sks", userDelegationKey.SignedService);
-    builder.AppendQuery("skv", userDelegationKey.SignedVersion);
-    if (!CacheControl.empty())
-    {
-      builder.AppendQuery("rscc", CacheControl);
-    }
-    if (!ContentDisposition.empty())
-    {
-      builder.AppendQuery("rscd", ContentDisposition);
-    }
-    if (!ContentEncoding.empty())
+  namespace {
+    std::vector<std::string> SignInParallel(
+        const std::function<std::string(const std::string&, std::string&)>& sign,
+        const std::vector<std::string>& blobNames)
     {
-      builder.AppendQuery("rsce", ContentEncoding);
+      // Each call of the task signs this many blobs, so that the cost of picking up work is
+      // negligible next to the signing.
+      constexpr std::size_t c_batchSize = 256;
+
+      std::vector<std::string> queries(blobNames.size());
+      std::atomic<std::size_t> nextIndex(0);
+      int parallelism = static_cast<int>(std::min<std::size_t>(
+          std::max(std::thread::hardware_concurrency(), 1U),
+          (blobNames.size() + c_batchSize - 1) / c_batchSize));
+      TransferExecutor::Default().Run(std::max(parallelism, 1), [&]() {
+        std::size_t begin = nextIndex.fetch_add(c_batchSize);
+        std::size_t end = std::min(begin + c_batchSize, blobNames.size());
+        std::string stringToSign;
+        for (std::size_t i = begin; i < end; ++i)
+        {
+          queries[i] = sign(blobNames[i], stringToSign);
+        }
+        return end < blobNames.size();
+      });
+      return queries;
     }
-    if (!ContentLanguage.empty())
+  } // namespace
+
+  std::vector<std::string> BlobSasBuilder::ToSasQueryParameters(
+      const SharedKeyCredential& credential,
+      const std::vector<std::string>& blobNames) const
+  {
+    if (Resource != BlobSasResource::Blob && Resource != BlobSasResource::BlobSnapshot)
     {
-      builder.AppendQuery("rscl", ContentLanguage);
+      throw std::runtime_error("batch SAS generation requires a blob or blob snapshot resource");
     }
-    if (!ContentType.empty())
+    const SasTemplate sasTemplate = GetSasTemplate(credential.AccountName, nullptr);
+    const auto key = credential.GetSigningKey();
+    return SignInParallel(
+        [&](const std::string& blobName, std::string& stringToSign) {
+          return sasTemplate.Sign(*key, blobName, stringToSign);
+        },
+        blobNames);
+  }
+
+  std::vector<std::string> BlobSasBuilder::ToSasQueryParameters(
+      const UserDelegationKey& userDelegationKey,
+      const std::string& accountName,
+      const std::vector<std::string>& blobNames) const
+  {
+    if (Resource != BlobSasResource::Blob && Resource != BlobSasResource::BlobSnapshot)
     {
-      builder.AppendQuery("rsct", ContentType);
+      throw std::runtime_error("batch SAS generation requires a blob or blob snapshot resource");
     }
-    builder.AppendQuery("sig", signature, true);
-
-    return builder.ToString();
+    const SasTemplate sasTemplate = GetSasTemplate(accountName, &userDelegationKey);
+    const HmacSha256 key(Base64Decode(userDelegationKey.Value));
+    return SignInParallel(
+        [&](const std::string& blobName, std::string& stringToSign) {
+          return sasTemplate.Sign(key, blobName, stringToSign);
+        },
+        blobNames);
   }
 
 }}} // namespace Azure::Storage::Blobs
@@ -5,12 +5,39 @@
 
 #include "common/concurrent_transfer.hpp"
 #include "common/constants.hpp"
+#include "common/content_hash.hpp"
 #include "common/crypt.hpp"
 #include "common/file_io.hpp"
 #include "common/storage_common.hpp"
+#include "common/transfer_checkpoint.hpp"
+#include "http/buffer_pool.hpp"
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <mutex>
 
 namespace Azure { namespace Storage { namespace Blobs {
 
+  namespace {
+    // Block ids of parallel uploads are the base64 of the zero-padded block index.
+    std::string GetBlockId(int64_t id)
+    {
+      constexpr std::size_t c_blockIdLength = 64;
+      uint8_t blockId[c_blockIdLength];
+      std::size_t pos = c_blockIdLength;
+      do
+      {
+        blockId[--pos] = static_cast<uint8_t>('0' + id % 10);
+        id /= 10;
+      } while (id != 0 && pos != 0);
+      std::fill(blockId, blockId + pos, static_cast<uint8_t>('0'));
+
+      char encoded[Details::Base64EncodedLength(c_blockIdLength)];
+      return std::string(encoded, Details::Base64Encode(blockId, c_blockIdLength, encoded));
+    }
+  } // namespace
+
   BlockBlobClient BlockBlobClient::CreateFromConnectionString(
       const std::string& connectionString,
       const std::string& containerName,
@@ -102,30 +129,41 @@ namespace Azure { namespace Storage { namespace Blobs {
     }
 
     std::vector<std::pair<BlockType, std::string>> blockIds;
-    auto getBlockId = [](int64_t id) {
-      constexpr std::size_t c_blockIdLength = 64;
-      std::string blockId = std::to_string(id);
-      blockId = std::string(c_blockIdLength - blockId.length(), '0') + blockId;
-      return Base64Encode(blockId);
-    };
-
     auto uploadBlockFunc = [&](int64_t offset, int64_t length, int64_t chunkId, int64_t numChunks) {
       Azure::Core::Http::MemoryBodyStream contentStream(buffer + offset, length);
       StageBlockOptions chunkOptions;
       chunkOptions.Context = options.Context;
-      auto blockInfo = StageBlock(getBlockId(chunkId), &contentStream, chunkOptions);
+      if (options.TransactionalHashAlgorithm.HasValue())
+      {
+        Details::ContentHasher hasher(options.TransactionalHashAlgorithm.GetValue());
+        hasher.Update(buffer + offset, static_cast<std::size_t>(length));
+        Details::SetContentHash(
+            chunkOptions, options.TransactionalHashAlgorithm.GetValue(), hasher.Final());
+      }
+      auto blockInfo = StageBlock(GetBlockId(chunkId), &contentStream, chunkOptions);
       if (chunkId == numChunks - 1)
       {
         blockIds.resize(static_cast<std::size_t>(numChunks));
       }
     };
 
-    Details::ConcurrentTransfer(0, bufferSize, chunkSize, options.Concurrency, uploadBlockFunc);
+    if (options.AutoTune.HasValue())
+    {
+      auto tuningOptions = options.AutoTune.GetValue();
+      int64_t minBlockSize = (bufferSize + c_maximumNumberBlocks - 1) / c_maximumNumberBlocks;
+      tuningOptions.MinChunkSize = std::max(tuningOptions.MinChunkSize, minBlockSize);
+      TransferTuner tuner(tuningOptions);
+      Details::ConcurrentTransfer(0, bufferSize, tuner, uploadBlockFunc);
+    }
+    else
+    {
+      Details::ConcurrentTransfer(0, bufferSize, chunkSize, options.Concurrency, uploadBlockFunc);
+    }
 
     for (std::size_t i = 0; i < blockIds.size(); ++i)
     {
       blockIds[i].first = BlockType::Uncommitted;
-      blockIds[i].second = getBlockId(static_cast<int64_t>(i));
+      blockIds[i].second = GetBlockId(static_cast<int64_t>(i));
     }
     CommitBlockListOptions commitBlockListOptions;
     commitBlockListOptions.Context = options.Context;
@@ -161,32 +199,266 @@ namespace Azure { namespace Storage { namespace Blobs {
       chunkSize = (chunkSize + c_grainSize - 1) / c_grainSize * c_grainSize;
     }
 
-    std::vector<std::pair<BlockType, std::string>> blockIds;
-    auto getBlockId = [](int64_t id) {
-      constexpr std::size_t c_blockIdLength = 64;
-      std::string blockId = std::to_string(id);
-      blockId = std::string(c_blockIdLength - blockId.length(), '0') + blockId;
-      return Base64Encode(blockId);
+    // Blocks are read ahead in the order of the chunks of the transfer, so the index of a chunk is
+    // the index of its block there.
+    constexpr int64_t c_maxReadAheadBlockSize = 100 * 1024 * 1024;
+    const bool readAheadEnabled = options.AsyncFileIo && chunkSize <= c_maxReadAheadBlockSize;
+    std::unique_ptr<Details::FileReadAhead> readAhead;
+    auto startReadAhead = [&](std::vector<std::pair<int64_t, int64_t>> chunks) {
+      if (readAheadEnabled)
+      {
+        readAhead = std::make_unique<Details::FileReadAhead>(
+            Details::FileIoEngine::Default(),
+            fileReader.GetHandle(),
+            std::move(chunks),
+            options.AutoTune.HasValue() ? options.AutoTune.GetValue().MaxConcurrency
+                                        : options.Concurrency);
+      }
     };
 
-    auto uploadBlockFunc = [&](int64_t offset, int64_t length, int64_t chunkId, int64_t numChunks) {
+    // The read-ahead and the journal need the blocks split in advance, so with them AutoTune only
+    // tunes the number of blocks in flight.
+    auto transferBlocks = [&](const std::vector<std::pair<int64_t, int64_t>>& blocks,
+                              std::function<void(int64_t, int64_t, int64_t, int64_t)> func) {
+      if (options.AutoTune.HasValue())
+      {
+        auto tuningOptions = options.AutoTune.GetValue();
+        tuningOptions.MinChunkSize = chunkSize;
+        tuningOptions.MaxChunkSize = chunkSize;
+        TransferTuner tuner(tuningOptions);
+        Details::ConcurrentTransfer(blocks, tuner, func);
+      }
+      else
+      {
+        Details::ConcurrentTransfer(blocks, options.Concurrency, func);
+      }
+    };
+
+    auto stageBlockFunc = [&](int64_t offset,
+                              int64_t length,
+                              int64_t chunkId,
+                              const std::string& blockId) {
+      if (readAhead)
+      {
+        auto buffer = readAhead->Get(static_cast<std::size_t>(chunkId));
+        Azure::Core::Http::MemoryBodyStream contentStream(buffer.Data(), length);
+        StageBlockOptions chunkOptions;
+        chunkOptions.Context = options.Context;
+        if (options.TransactionalHashAlgorithm.HasValue())
+        {
+          Details::ContentHasher hasher(options.TransactionalHashAlgorithm.GetValue());
+          hasher.Update(buffer.Data(), static_cast<std::size_t>(length));
+          Details::SetContentHash(
+              chunkOptions, options.TransactionalHashAlgorithm.GetValue(), hasher.Final());
+        }
+        StageBlock(blockId, &contentStream, chunkOptions);
+        return;
+      }
       Azure::Core::Http::FileBodyStream contentStream(fileReader.GetHandle(), offset, length);
       StageBlockOptions chunkOptions;
       chunkOptions.Context = options.Context;
-      auto blockInfo = StageBlock(getBlockId(chunkId), &contentStream, chunkOptions);
+      // With a hash, StageBlock reads the block from the file into memory once.
+      chunkOptions.TransactionalHashAlgorithm = options.TransactionalHashAlgorithm;
+      StageBlock(blockId, &contentStream, chunkOptions);
+    };
+
+    auto commitBlocksFunc = [&](int64_t numBlocks) {
+      std::vector<std::pair<BlockType, std::string>> blockIds;
+      blockIds.reserve(static_cast<std::size_t>(numBlocks));
+      for (int64_t i = 0; i < numBlocks; ++i)
+      {
+        blockIds.emplace_back(BlockType::Uncommitted, GetBlockId(i));
+      }
+      CommitBlockListOptions commitBlockListOptions;
+      commitBlockListOptions.Context = options.Context;
+      commitBlockListOptions.HttpHeaders = options.HttpHeaders;
+      commitBlockListOptions.Metadata = options.Metadata;
+      commitBlockListOptions.Tier = options.Tier;
+      auto commitBlockListResponse = CommitBlockList(blockIds, commitBlockListOptions);
+      commitBlockListResponse->ContentCrc64.Reset();
+      commitBlockListResponse->ContentMd5.Reset();
+      return commitBlockListResponse;
+    };
+
+    if (options.CheckpointFile.HasValue())
+    {
+      const int64_t fileSize = fileReader.GetFileSize();
+      // Block ids follow from the offsets of the blocks, so the journal is only reused for the
+      // same content of the file split at the same block size.
+      std::string blobUrl = m_blobUrl.ToString();
+      blobUrl = blobUrl.substr(0, blobUrl.find('?'));
+      Details::TransferCheckpoint checkpoint(
+          options.CheckpointFile.GetValue(),
+          "upload " + blobUrl + " " + std::to_string(fileSize) + " "
+              + std::to_string(fileReader.GetLastModified()) + " " + std::to_string(chunkSize));
+
+      std::vector<Details::TransferCheckpoint::Chunk> stagedBlocks;
+      if (!checkpoint.GetCompletedChunks().empty())
+      {
+        // Uncommitted blocks expire, and are discarded when the blob is committed by someone else,
+        // so only the blocks the service still has are trusted.
+        std::map<std::string, int64_t> uncommittedBlocks;
+        try
+        {
+          GetBlockListOptions getBlockListOptions;
+          getBlockListOptions.Context = options.Context;
+          getBlockListOptions.ListType = BlockListTypeOption::Uncommitted;
+          auto blockList = GetBlockList(getBlockListOptions);
+          for (auto& block : blockList->UncommittedBlocks)
+          {
+            uncommittedBlocks.emplace(std::move(block.Name), block.Size);
+          }
+        }
+        catch (StorageError& e)
+        {
+          if (e.StatusCode != Azure::Core::Http::HttpStatusCode::NotFound)
+          {
+            throw;
+          }
+        }
+        for (const auto& chunk : checkpoint.GetCompletedChunks())
+        {
+          auto block = uncommittedBlocks.find(chunk.Id);
+          if (block != uncommittedBlocks.end() && block->second == chunk.Length
+              && chunk.Offset % chunkSize == 0 && chunk.Id == GetBlockId(chunk.Offset / chunkSize))
+          {
+            stagedBlocks.push_back(chunk);
+          }
+        }
+        checkpoint.Reset(stagedBlocks);
+      }
+
+      auto missingBlocks = Details::GetMissingChunks(0, fileSize, chunkSize, stagedBlocks);
+      startReadAhead(missingBlocks);
+      transferBlocks(
+          missingBlocks, [&](int64_t offset, int64_t length, int64_t chunkId, int64_t) {
+            Details::TransferCheckpoint::Chunk block;
+            block.Offset = offset;
+            block.Length = length;
+            block.Id = GetBlockId(offset / chunkSize);
+            stageBlockFunc(offset, length, chunkId, block.Id);
+            checkpoint.Record(block);
+          });
+
+      auto commitBlockListResponse = commitBlocksFunc((fileSize + chunkSize - 1) / chunkSize);
+      checkpoint.Remove();
+      return commitBlockListResponse;
+    }
+
+    int64_t numBlocks = 0;
+    auto uploadBlockFunc = [&](int64_t offset, int64_t length, int64_t chunkId, int64_t numChunks) {
+      stageBlockFunc(offset, length, chunkId, GetBlockId(chunkId));
       if (chunkId == numChunks - 1)
       {
-        blockIds.resize(static_cast<std::size_t>(numChunks));
+        numBlocks = numChunks;
       }
     };
 
-    Details::ConcurrentTransfer(
-        0, fileReader.GetFileSize(), chunkSize, options.Concurrency, uploadBlockFunc);
+    if (options.AutoTune.HasValue() && !readAheadEnabled)
+    {
+      auto tuningOptions = options.AutoTune.GetValue();
+      int64_t minBlockSize
+          = (fileReader.GetFileSize() + c_maximumNumberBlocks - 1) / c_maximumNumberBlocks;
+      tuningOptions.MinChunkSize = std::max(tuningOptions.MinChunkSize, minBlockSize);
+      TransferTuner tuner(tuningOptions);
+      Details::ConcurrentTransfer(0, fileReader.GetFileSize(), tuner, uploadBlockFunc);
+    }
+    else
+    {
+      auto blocks = Details::GetMissingChunks(0, fileReader.GetFileSize(), chunkSize, {});
+      startReadAhead(blocks);
+      transferBlocks(blocks, uploadBlockFunc);
+    }
 
-    for (std::size_t i = 0; i < blockIds.size(); ++i)
+    return commitBlocksFunc(numBlocks);
+  }
+
+  Azure::Core::Response<BlobContentInfo> BlockBlobClient::UploadFromStream(
+      Azure::Core::Http::BodyStream* content,
+      const UploadBlobOptions& options) const
+  {
+    constexpr int64_t c_defaultBlockSize = 8 * 1024 * 1024;
+    constexpr int64_t c_maximumBlockSize = 4000LL * 1024 * 1024;
+    constexpr int64_t c_maximumNumberBlocks = 50000;
+
+    // The size of the stream isn't known, so the block size can't be raised to fit it in the
+    // maximum number of blocks.
+    int64_t chunkSize = c_defaultBlockSize;
+    if (options.ChunkSize.HasValue())
     {
-      blockIds[i].first = BlockType::Uncommitted;
-      blockIds[i].second = getBlockId(static_cast<int64_t>(i));
+      chunkSize = options.ChunkSize.GetValue();
+      if (chunkSize <= 0 || chunkSize > c_maximumBlockSize)
+      {
+        throw std::runtime_error("chunk size must be positive and at most 4000MiB");
+      }
+    }
+
+    // The stream can only be read sequentially, so blocks are read one at a time under the mutex
+    // and staged in parallel. Every call holds at most one block, which bounds the memory to
+    // Concurrency blocks. The size of a block is only known once it's read, so the permit is for
+    // a full block, and it's taken before the buffer, like in every other transfer.
+    std::mutex readMutex;
+    bool endOfStream = false;
+    int64_t numBlocks = 0;
+
+    auto uploadBlockFunc = [&]() {
+      {
+        std::lock_guard<std::mutex> guard(readMutex);
+        if (endOfStream)
+        {
+          return false;
+        }
+      }
+      auto permit = TransferGovernor::Default().Acquire(chunkSize);
+      auto buffer = Azure::Core::Http::BufferPool::Default().Acquire(chunkSize);
+      int64_t blockId;
+      int64_t length;
+      {
+        std::lock_guard<std::mutex> guard(readMutex);
+        if (endOfStream)
+        {
+          return false;
+        }
+        length = Azure::Core::Http::BodyStream::ReadToCount(
+            options.Context, *content, buffer.Data(), chunkSize);
+        if (length < chunkSize)
+        {
+          endOfStream = true;
+        }
+        if (length == 0)
+        {
+          return false;
+        }
+        if (numBlocks == c_maximumNumberBlocks)
+        {
+          endOfStream = true;
+          throw std::runtime_error(
+              "stream is larger than 50000 blocks of " + std::to_string(chunkSize)
+              + " bytes, the maximum number of blocks in a blob");
+        }
+        blockId = numBlocks++;
+      }
+      Azure::Core::Http::MemoryBodyStream contentStream(buffer.Data(), length);
+      StageBlockOptions chunkOptions;
+      chunkOptions.Context = options.Context;
+      if (options.TransactionalHashAlgorithm.HasValue())
+      {
+        Details::ContentHasher hasher(options.TransactionalHashAlgorithm.GetValue());
+        hasher.Update(buffer.Data(), static_cast<std::size_t>(length));
+        Details::SetContentHash(
+            chunkOptions, options.TransactionalHashAlgorithm.GetValue(), hasher.Final());
+      }
+      StageBlock(GetBlockId(blockId), &contentStream, chunkOptions);
+      return true;
+    };
+
+    TransferExecutor::Default().Run(options.Concurrency, uploadBlockFunc);
+
+    std::vector<std::pair<BlockType, std::string>> blockIds;
+    blockIds.reserve(static_cast<std::size_t>(numBlocks));
+    for (int64_t i = 0; i < numBlocks; ++i)
+    {
+      blockIds.emplace_back(BlockType::Uncommitted, GetBlockId(i));
     }
     CommitBlockListOptions commitBlockListOptions;
     commitBlockListOptions.Context = options.Context;
@@ -209,6 +481,19 @@ namespace Azure { namespace Storage { namespace Blobs {
     protocolLayerOptions.ContentMd5 = options.ContentMd5;
     protocolLayerOptions.ContentCrc64 = options.ContentCrc64;
     protocolLayerOptions.LeaseId = options.AccessConditions.LeaseId;
+    std::unique_ptr<HashedBufferStream> hashedContent;
+    if (options.TransactionalHashAlgorithm.HasValue())
+    {
+      hashedContent = std::make_unique<HashedBufferStream>(
+          options.Context, *content, options.TransactionalHashAlgorithm.GetValue());
+      protocolLayerOptions.ContentMd5.Reset();
+      protocolLayerOptions.ContentCrc64.Reset();
+      Details::SetContentHash(
+          protocolLayerOptions,
+          options.TransactionalHashAlgorithm.GetValue(),
+          hashedContent->GetHash());
+      content = hashedContent.get();
+    }
     return BlobRestClient::BlockBlob::StageBlock(
         options.Context, *m_pipeline, m_blobUrl.ToString(), content, protocolLayerOptions);
   }
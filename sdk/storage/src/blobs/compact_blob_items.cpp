@@ -0,0 +1,402 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include "blobs/compact_blob_items.hpp"
+
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+namespace Azure { namespace Storage { namespace Blobs {
+
+  namespace {
+    constexpr std::size_t c_maximumInternedValues = 8;
+
+    constexpr uint8_t c_deletedFlag = 1;
+    constexpr uint8_t c_accessTierInferredFlag = 2;
+    constexpr uint8_t c_hasServerEncryptedFlag = 4;
+    constexpr uint8_t c_serverEncryptedFlag = 8;
+  } // namespace
+
+  CompactBlobItem CompactBlobItems::operator[](std::size_t index) const
+  {
+    CompactBlobItem item;
+    item.Name = GetString(m_names[index]);
+    item.Deleted = (m_flags[index] & c_deletedFlag) != 0;
+    item.Snapshot = GetString(m_snapshots[index]);
+    item.ContentType = GetString(m_contentTypes[index]);
+    item.ContentEncoding = GetString(m_contentEncodings[index]);
+    item.ContentLanguage = GetString(m_contentLanguages[index]);
+    item.ContentMd5 = GetString(m_contentMd5s[index]);
+    item.CacheControl = GetString(m_cacheControls[index]);
+    item.ContentDisposition = GetString(m_contentDispositions[index]);
+    item.CreationTime = GetString(m_creationTimes[index]);
+    item.LastModified = GetString(m_lastModifiedTimes[index]);
+    item.ETag = GetString(m_eTags[index]);
+    item.ContentLength = m_contentLengths[index];
+    item.BlobType = m_blobTypes[index];
+    item.Tier = m_tiers[index];
+    item.AccessTierInferred = (m_flags[index] & c_accessTierInferredFlag) != 0;
+    item.LeaseStatus = m_leaseStatuses[index];
+    item.LeaseState = m_leaseStates[index];
+    item.LeaseDuration = GetString(m_leaseDurations[index]);
+    if ((m_flags[index] & c_hasServerEncryptedFlag) != 0)
+    {
+      item.ServerEncrypted = (m_flags[index] & c_serverEncryptedFlag) != 0;
+    }
+    item.EncryptionKeySha256 = GetString(m_encryptionKeySha256s[index]);
+    return item;
+  }
+
+  std::vector<std::pair<const char*, const char*>> CompactBlobItems::GetMetadata(
+      std::size_t index) const
+  {
+    std::vector<std::pair<const char*, const char*>> metadata;
+    for (uint32_t i = m_metadataBegins[index]; i != m_metadataBegins[index + 1]; ++i)
+    {
+      metadata.emplace_back(GetString(m_metadata[i].first), GetString(m_metadata[i].second));
+    }
+    return metadata;
+  }
+
+  BlobItem CompactBlobItems::ToBlobItem(std::size_t index) const
+  {
+    CompactBlobItem item = (*this)[index];
+    BlobItem ret;
+    ret.Name = item.Name;
+    ret.Deleted = item.Deleted;
+    ret.Snapshot = item.Snapshot;
+    ret.HttpHeaders.ContentType = item.ContentType;
+    ret.HttpHeaders.ContentEncoding = item.ContentEncoding;
+    ret.HttpHeaders.ContentLanguage = item.ContentLanguage;
+    ret.HttpHeaders.ContentMd5 = item.ContentMd5;
+    ret.HttpHeaders.CacheControl = item.CacheControl;
+    ret.HttpHeaders.ContentDisposition = item.ContentDisposition;
+    for (const auto& pair : GetMetadata(index))
+    {
+      ret.Metadata.emplace(pair.first, pair.second);
+    }
+    ret.CreationTime = item.CreationTime;
+    ret.LastModified = item.LastModified;
+    ret.ETag = item.ETag;
+    ret.ContentLength = item.ContentLength;
+    ret.BlobType = item.BlobType;
+    ret.Tier = item.Tier;
+    ret.AccessTierInferred = item.AccessTierInferred;
+    ret.LeaseStatus = item.LeaseStatus;
+    ret.LeaseState = item.LeaseState;
+    if (*item.LeaseDuration != '\0')
+    {
+      ret.LeaseDuration = std::string(item.LeaseDuration);
+    }
+    ret.ServerEncrypted = item.ServerEncrypted;
+    if (*item.EncryptionKeySha256 != '\0')
+    {
+      ret.EncryptionKeySha256 = std::string(item.EncryptionKeySha256);
+    }
+    return ret;
+  }
+
+  uint32_t CompactBlobItems::Append(const XmlStringView& value)
+  {
+    if (value.Length == 0)
+    {
+      return 0;
+    }
+    if (m_strings.size() + value.Length + 1 > std::numeric_limits<uint32_t>::max())
+    {
+      throw std::runtime_error("list segment too big");
+    }
+    uint32_t offset = static_cast<uint32_t>(m_strings.size());
+    m_strings.append(value.Data, value.Length);
+    m_strings += '\0';
+    return offset;
+  }
+
+  uint32_t CompactBlobItems::Intern(const XmlStringView& value, InternedValues& values)
+  {
+    if (value.Length == 0)
+    {
+      return 0;
+    }
+    for (uint32_t offset : values.Offsets)
+    {
+      const char* interned = GetString(offset);
+      if (std::strncmp(interned, value.Data, value.Length) == 0 && interned[value.Length] == '\0')
+      {
+        return offset;
+      }
+    }
+    uint32_t offset = Append(value);
+    if (values.Offsets.size() < c_maximumInternedValues)
+    {
+      values.Offsets.push_back(offset);
+    }
+    else
+    {
+      values.Offsets[values.NextSlot] = offset;
+      values.NextSlot = (values.NextSlot + 1) % c_maximumInternedValues;
+    }
+    return offset;
+  }
+
+  // Appends the blobs of a segment as they're read.
+  struct CompactBlobItemsBuilder
+  {
+    CompactBlobItems& Items;
+
+    void BeginBlob()
+    {
+      Items.m_names.push_back(0);
+      Items.m_snapshots.push_back(0);
+      Items.m_contentTypes.push_back(0);
+      Items.m_contentEncodings.push_back(0);
+      Items.m_contentLanguages.push_back(0);
+      Items.m_contentMd5s.push_back(0);
+      Items.m_cacheControls.push_back(0);
+      Items.m_contentDispositions.push_back(0);
+      Items.m_creationTimes.push_back(0);
+      Items.m_lastModifiedTimes.push_back(0);
+      Items.m_eTags.push_back(0);
+      Items.m_leaseDurations.push_back(0);
+      Items.m_encryptionKeySha256s.push_back(0);
+      Items.m_contentLengths.push_back(0);
+      Items.m_blobTypes.push_back(BlobType::Unknown);
+      Items.m_tiers.push_back(AccessTier::Unknown);
+      Items.m_leaseStatuses.push_back(BlobLeaseStatus::Unlocked);
+      Items.m_leaseStates.push_back(BlobLeaseState::Available);
+      Items.m_flags.push_back(c_accessTierInferredFlag);
+    }
+
+    void EndBlob()
+    {
+      Items.m_metadataBegins.push_back(static_cast<uint32_t>(Items.m_metadata.size()));
+    }
+
+    void SetFlag(uint8_t flag, bool value)
+    {
+      if (value)
+      {
+        Items.m_flags.back() |= flag;
+      }
+      else
+      {
+        Items.m_flags.back() &= static_cast<uint8_t>(~flag);
+      }
+    }
+
+    void SetBlobField(const XmlStringView& name, const XmlStringView& value)
+    {
+      if (name == "Name")
+      {
+        Items.m_names.back() = Items.Append(value);
+      }
+      else if (name == "Deleted")
+      {
+        SetFlag(c_deletedFlag, value == "true");
+      }
+      else if (name == "Snapshot")
+      {
+        Items.m_snapshots.back() = Items.Append(value);
+      }
+    }
+
+    void SetProperty(const XmlStringView& name, const XmlStringView& value)
+    {
+      if (name == "Content-Type")
+      {
+        Items.m_contentTypes.back() = Items.Intern(value, Items.m_internedContentTypes);
+      }
+      else if (name == "Content-Encoding")
+      {
+        Items.m_contentEncodings.back() = Items.Intern(value, Items.m_internedContentEncodings);
+      }
+      else if (name == "Content-Language")
+      {
+        Items.m_contentLanguages.back() = Items.Intern(value, Items.m_internedContentLanguages);
+      }
+      else if (name == "Content-MD5")
+      {
+        Items.m_contentMd5s.back() = Items.Append(value);
+      }
+      else if (name == "Cache-Control")
+      {
+        Items.m_cacheControls.back() = Items.Intern(value, Items.m_internedCacheControls);
+      }
+      else if (name == "Content-Disposition")
+      {
+        Items.m_contentDispositions.back()
+            = Items.Intern(value, Items.m_internedContentDispositions);
+      }
+      else if (name == "Creation-Time")
+      {
+        Items.m_creationTimes.back() = Items.Append(value);
+      }
+      else if (name == "Last-Modified")
+      {
+        Items.m_lastModifiedTimes.back() = Items.Append(value);
+      }
+      else if (name == "Etag")
+      {
+        Items.m_eTags.back() = Items.Append(value);
+      }
+      else if (name == "Content-Length")
+      {
+        Items.m_contentLengths.back() = std::stoll(value.ToString());
+      }
+      else if (name == "BlobType")
+      {
+        Items.m_blobTypes.back() = BlobTypeFromString(value.ToString());
+      }
+      else if (name == "AccessTier")
+      {
+        Items.m_tiers.back() = AccessTierFromString(value.ToString());
+      }
+      else if (name == "AccessTierInferred")
+      {
+        SetFlag(c_accessTierInferredFlag, value == "true");
+      }
+      else if (name == "LeaseStatus")
+      {
+        Items.m_leaseStatuses.back() = BlobLeaseStatusFromString(value.ToString());
+      }
+      else if (name == "LeaseState")
+      {
+        Items.m_leaseStates.back() = BlobLeaseStateFromString(value.ToString());
+      }
+      else if (name == "LeaseDuration")
+      {
+        Items.m_leaseDurations.back() = Items.Intern(value, Items.m_internedLeaseDurations);
+      }
+      else if (name == "ServerEncrypted")
+      {
+        SetFlag(c_hasServerEncryptedFlag, true);
+        SetFlag(c_serverEncryptedFlag, value == "true");
+      }
+      else if (name == "EncryptionKeySHA256")
+      {
+        Items.m_encryptionKeySha256s.back() = Items.Append(value);
+      }
+    }
+
+    void AddMetadata(const XmlStringView& name, const XmlStringView& value)
+    {
+      uint32_t nameOffset = Items.Intern(name, Items.m_internedMetadataNames);
+      Items.m_metadata.emplace_back(nameOffset, Items.Append(value));
+    }
+
+    void Finish()
+    {
+      // The segment usually outlives the parsing, the spare capacity isn't kept.
+      Items.m_strings.shrink_to_fit();
+      Items.m_names.shrink_to_fit();
+      Items.m_snapshots.shrink_to_fit();
+      Items.m_contentTypes.shrink_to_fit();
+      Items.m_contentEncodings.shrink_to_fit();
+      Items.m_contentLanguages.shrink_to_fit();
+      Items.m_contentMd5s.shrink_to_fit();
+      Items.m_cacheControls.shrink_to_fit();
+      Items.m_contentDispositions.shrink_to_fit();
+      Items.m_creationTimes.shrink_to_fit();
+      Items.m_lastModifiedTimes.shrink_to_fit();
+      Items.m_eTags.shrink_to_fit();
+      Items.m_leaseDurations.shrink_to_fit();
+      Items.m_encryptionKeySha256s.shrink_to_fit();
+      Items.m_contentLengths.shrink_to_fit();
+      Items.m_blobTypes.shrink_to_fit();
+      Items.m_tiers.shrink_to_fit();
+      Items.m_leaseStatuses.shrink_to_fit();
+      Items.m_leaseStates.shrink_to_fit();
+      Items.m_flags.shrink_to_fit();
+      Items.m_metadataBegins.shrink_to_fit();
+      Items.m_metadata.shrink_to_fit();
+    }
+  };
+
+}}} // namespace Azure::Storage::Blobs
+
+namespace Azure { namespace Storage { namespace Details {
+
+  Blobs::CompactBlobsFlatSegment CompactBlobsFlatSegmentFromXml(XmlPullReader& reader)
+  {
+    // The same document as BlobsFlatSegment, with the blobs at EnumerationResults/Blobs/Blob.
+    Blobs::CompactBlobsFlatSegment ret;
+    Blobs::CompactBlobItemsBuilder builder{ret.Items};
+    std::vector<XmlStringView> path;
+    bool inBlob = false;
+    while (true)
+    {
+      auto node = reader.Read();
+      if (node.Type == XmlNodeType::End)
+      {
+        break;
+      }
+      else if (node.Type == XmlNodeType::StartTag)
+      {
+        path.push_back(node.Name);
+        if (path.size() == 3 && path[0] == "EnumerationResults" && path[1] == "Blobs"
+            && node.Name == "Blob")
+        {
+          builder.BeginBlob();
+          inBlob = true;
+        }
+      }
+      else if (node.Type == XmlNodeType::EndTag)
+      {
+        if (inBlob && path.size() == 3)
+        {
+          builder.EndBlob();
+          inBlob = false;
+        }
+        path.pop_back();
+      }
+      else if (node.Type == XmlNodeType::Text)
+      {
+        if (inBlob && path.size() == 4)
+        {
+          builder.SetBlobField(path[3], node.Value);
+        }
+        else if (inBlob && path.size() == 5 && path[3] == "Properties")
+        {
+          builder.SetProperty(path[4], node.Value);
+        }
+        else if (inBlob && path.size() == 5 && path[3] == "Metadata")
+        {
+          builder.AddMetadata(path[4], node.Value);
+        }
+        else if (path.size() == 2 && path[0] == "EnumerationResults")
+        {
+          if (path[1] == "Prefix")
+          {
+            ret.Prefix = node.Value.ToString();
+          }
+          else if (path[1] == "Marker")
+          {
+            ret.Marker = node.Value.ToString();
+          }
+          else if (path[1] == "NextMarker")
+          {
+            ret.NextMarker = node.Value.ToString();
+          }
+        }
+      }
+      else if (node.Type == XmlNodeType::Attribute)
+      {
+        if (path.size() == 1 && path[0] == "EnumerationResults")
+        {
+          if (node.Name == "ServiceEndpoint")
+          {
+            ret.ServiceEndpoint = node.Value.ToString();
+          }
+          else if (node.Name == "ContainerName")
+          {
+            ret.Container = node.Value.ToString();
+          }
+        }
+      }
+    }
+    builder.Finish();
+    return ret;
+  }
+
+}}} // namespace Azure::Storage::Details
@@ -3,11 +3,50 @@
 
 #include "blobs/page_blob_client.hpp"
 
+#include "common/concurrent_transfer.hpp"
 #include "common/constants.hpp"
+#include "common/content_hash.hpp"
+#include "common/file_io.hpp"
 #include "common/storage_common.hpp"
+#include "http/buffer_pool.hpp"
+
+#include <atomic>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define AZURE_STORAGE_ZERO_PAGE_SSE2
+#include <emmintrin.h>
+#endif
 
 namespace Azure { namespace Storage { namespace Blobs {
 
+  namespace {
+    constexpr int64_t c_pageSize = 512;
+
+    // SSE2 is part of x86-64, so there the page is tested 16 bytes per load.
+    bool IsZeroPage(const uint8_t* page)
+    {
+#if defined(AZURE_STORAGE_ZERO_PAGE_SSE2)
+      const __m128i* blocks = reinterpret_cast<const __m128i*>(page);
+      __m128i accumulated = _mm_setzero_si128();
+      for (int64_t i = 0; i < c_pageSize / 16; ++i)
+      {
+        accumulated = _mm_or_si128(accumulated, _mm_loadu_si128(blocks + i));
+      }
+      return _mm_movemask_epi8(_mm_cmpeq_epi8(accumulated, _mm_setzero_si128())) == 0xffff;
+#else
+      uint64_t accumulated = 0;
+      for (int64_t i = 0; i < c_pageSize; i += 8)
+      {
+        uint64_t word;
+        std::memcpy(&word, page + i, sizeof(word));
+        accumulated |= word;
+      }
+      return accumulated == 0;
+#endif
+    }
+  } // namespace
+
   PageBlobClient PageBlobClient::CreateFromConnectionString(
       const std::string& connectionString,
       const std::string& containerName,
@@ -89,10 +128,125 @@ namespace Azure { namespace Storage { namespace Blobs {
     protocolLayerOptions.IfUnmodifiedSince = options.AccessConditions.IfUnmodifiedSince;
     protocolLayerOptions.IfMatch = options.AccessConditions.IfMatch;
     protocolLayerOptions.IfNoneMatch = options.AccessConditions.IfNoneMatch;
+    std::unique_ptr<HashedBufferStream> hashedContent;
+    if (options.TransactionalHashAlgorithm.HasValue())
+    {
+      hashedContent = std::make_unique<HashedBufferStream>(
+          options.Context, *content, options.TransactionalHashAlgorithm.GetValue());
+      protocolLayerOptions.ContentMd5.Reset();
+      protocolLayerOptions.ContentCrc64.Reset();
+      Details::SetContentHash(
+          protocolLayerOptions,
+          options.TransactionalHashAlgorithm.GetValue(),
+          hashedContent->GetHash());
+      content = hashedContent.get();
+    }
     return BlobRestClient::PageBlob::UploadPages(
         options.Context, *m_pipeline, m_blobUrl.ToString(), content, protocolLayerOptions);
   }
 
+  Azure::Core::Response<BlobContentInfo> PageBlobClient::UploadFromFile(
+      const std::string& file,
+      const UploadPageBlobFromFileOptions& options)
+  {
+    constexpr int64_t c_maximumPageRangeSize = 4 * 1024 * 1024;
+    // Runs of zero pages shorter than this are uploaded along with the pages around them, a
+    // request costs more than sending them.
+    constexpr int64_t c_minimumSkippedLength = 64 * 1024;
+
+    int64_t chunkSize = c_maximumPageRangeSize;
+    if (options.ChunkSize.HasValue())
+    {
+      chunkSize = options.ChunkSize.GetValue();
+      if (chunkSize <= 0 || chunkSize % c_pageSize != 0 || chunkSize > c_maximumPageRangeSize)
+      {
+        throw std::runtime_error("chunk size must be a multiple of 512 and at most 4MiB");
+      }
+    }
+
+    Details::FileReader fileReader(file);
+    const int64_t fileSize = fileReader.GetFileSize();
+    if (fileSize % c_pageSize != 0)
+    {
+      throw std::runtime_error("file size must be a multiple of 512");
+    }
+
+    CreatePageBlobOptions createOptions;
+    createOptions.Context = options.Context;
+    createOptions.HttpHeaders = options.HttpHeaders;
+    createOptions.Metadata = options.Metadata;
+    createOptions.Tier = options.Tier;
+    auto createResponse = Create(fileSize, createOptions);
+
+    std::atomic<bool> pagesUploaded{false};
+    auto uploadPagesFunc = [&](int64_t offset, int64_t length, int64_t, int64_t) {
+      auto buffer = Azure::Core::Http::BufferPool::Default().Acquire(length);
+      Azure::Core::Http::FileBodyStream fileStream(fileReader.GetHandle(), offset, length);
+      if (Azure::Core::Http::BodyStream::ReadToCount(
+              options.Context, fileStream, buffer.Data(), length)
+          != length)
+      {
+        throw std::runtime_error("error when reading file");
+      }
+
+      auto uploadRange = [&](int64_t rangeStart, int64_t rangeEnd) {
+        Azure::Core::Http::MemoryBodyStream contentStream(
+            buffer.Data() + rangeStart, rangeEnd - rangeStart);
+        UploadPagesOptions uploadPagesOptions;
+        uploadPagesOptions.Context = options.Context;
+        // Hashed in place, UploadPages would copy the range into a second pooled buffer.
+        if (options.TransactionalHashAlgorithm.HasValue())
+        {
+          Details::ContentHasher hasher(options.TransactionalHashAlgorithm.GetValue());
+          hasher.Update(
+              buffer.Data() + rangeStart, static_cast<std::size_t>(rangeEnd - rangeStart));
+          Details::SetContentHash(
+              uploadPagesOptions, options.TransactionalHashAlgorithm.GetValue(), hasher.Final());
+        }
+        UploadPages(&contentStream, offset + rangeStart, uploadPagesOptions);
+        pagesUploaded = true;
+      };
+
+      // [rangeStart, rangeEnd) are the pages with data found so far and not uploaded yet.
+      int64_t rangeStart = -1;
+      int64_t rangeEnd = 0;
+      for (int64_t page = 0; page < length; page += c_pageSize)
+      {
+        if (IsZeroPage(buffer.Data() + page))
+        {
+          continue;
+        }
+        if (rangeStart != -1 && page - rangeEnd >= c_minimumSkippedLength)
+        {
+          uploadRange(rangeStart, rangeEnd);
+          rangeStart = -1;
+        }
+        if (rangeStart == -1)
+        {
+          rangeStart = page;
+        }
+        rangeEnd = page + c_pageSize;
+      }
+      if (rangeStart != -1)
+      {
+        uploadRange(rangeStart, rangeEnd);
+      }
+    };
+    Details::ConcurrentTransfer(0, fileSize, chunkSize, options.Concurrency, uploadPagesFunc);
+
+    // Page writes change the ETag of the blob, and with several in flight only the service knows
+    // which one was the last.
+    if (pagesUploaded)
+    {
+      GetBlobPropertiesOptions getPropertiesOptions;
+      getPropertiesOptions.Context = options.Context;
+      auto properties = GetProperties(getPropertiesOptions);
+      createResponse->ETag = std::move(properties->ETag);
+      createResponse->LastModified = std::move(properties->LastModified);
+    }
+    return createResponse;
+  }
+
   Azure::Core::Response<PageInfo> PageBlobClient::UploadPagesFromUri(
       std::string sourceUri,
       int64_t sourceOffset,
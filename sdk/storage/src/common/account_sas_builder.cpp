@@ -101,8 +101,7 @@ namespace Azure { namespace Storage {
         + "\n" + (IPRange.HasValue() ? IPRange.GetValue() : "") + "\n" + protocol + "\n" + Version
         + "\n";
 
-    std::string signature
-        = Base64Encode(Hmac_Sha256(stringToSign, Base64Decode(credential.GetAccountKey())));
+    std::string signature = Base64Encode(credential.GetSigningKey()->Sign(stringToSign));
 
     UriBuilder builder;
     builder.AppendQuery("sv", Version);
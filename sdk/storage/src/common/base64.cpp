@@ -0,0 +1,144 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include "common/crypt.hpp"
+
+#include <stdexcept>
+
+namespace Azure { namespace Storage {
+
+  namespace {
+    const char c_base64Alphabet[]
+        = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+    // Marks characters that are not in the alphabet in the decoding table.
+    constexpr uint8_t c_invalid = 0x80;
+
+    struct Base64Tables
+    {
+      // Encoding of every 12-bit value as two characters, so each 3-byte group takes two lookups.
+      char Encode[4096][2];
+      // Value of every character, or c_invalid.
+      uint8_t Decode[256];
+
+      Base64Tables()
+      {
+        for (int i = 0; i < 4096; ++i)
+        {
+          Encode[i][0] = c_base64Alphabet[i >> 6];
+          Encode[i][1] = c_base64Alphabet[i & 0x3f];
+        }
+        for (int i = 0; i < 256; ++i)
+        {
+          Decode[i] = c_invalid;
+        }
+        for (int i = 0; i < 64; ++i)
+        {
+          Decode[static_cast<uint8_t>(c_base64Alphabet[i])] = static_cast<uint8_t>(i);
+        }
+      }
+    };
+
+    const Base64Tables& GetTables()
+    {
+      static const Base64Tables tables;
+      return tables;
+    }
+  } // namespace
+
+  namespace Details {
+
+    std::size_t Base64Encode(const uint8_t* data, std::size_t length, char* output)
+    {
+      const auto& table = GetTables().Encode;
+      char* out = output;
+      for (; length >= 3; data += 3, length -= 3)
+      {
+        uint32_t group = (uint32_t(data[0]) << 16) | (uint32_t(data[1]) << 8) | data[2];
+        const char* high = table[group >> 12];
+        const char* low = table[group & 0xfff];
+        out[0] = high[0];
+        out[1] = high[1];
+        out[2] = low[0];
+        out[3] = low[1];
+        out += 4;
+      }
+      if (length != 0)
+      {
+        uint32_t group = uint32_t(data[0]) << 16;
+        if (length == 2)
+        {
+          group |= uint32_t(data[1]) << 8;
+        }
+        out[0] = c_base64Alphabet[group >> 18];
+        out[1] = c_base64Alphabet[(group >> 12) & 0x3f];
+        out[2] = length == 2 ? c_base64Alphabet[(group >> 6) & 0x3f] : '=';
+        out[3] = '=';
+        out += 4;
+      }
+      return static_cast<std::size_t>(out - output);
+    }
+
+    std::size_t Base64Decode(const char* text, std::size_t length, uint8_t* output)
+    {
+      const auto& table = GetTables().Decode;
+      if (length % 4 == 0 && length != 0 && text[length - 1] == '=')
+      {
+        length -= text[length - 2] == '=' ? 2 : 1;
+      }
+      if (length % 4 == 1)
+      {
+        throw std::runtime_error("invalid base64 encoded string");
+      }
+
+      const uint8_t* in = reinterpret_cast<const uint8_t*>(text);
+      uint8_t* out = output;
+      uint8_t invalid = 0;
+      for (; length >= 4; in += 4, length -= 4)
+      {
+        uint8_t a = table[in[0]], b = table[in[1]], c = table[in[2]], d = table[in[3]];
+        invalid |= a | b | c | d;
+        uint32_t group = (uint32_t(a) << 18) | (uint32_t(b) << 12) | (uint32_t(c) << 6) | d;
+        out[0] = static_cast<uint8_t>(group >> 16);
+        out[1] = static_cast<uint8_t>(group >> 8);
+        out[2] = static_cast<uint8_t>(group);
+        out += 3;
+      }
+      if (length != 0)
+      {
+        // 2 or 3 characters left, encoding 1 or 2 bytes
+        uint8_t a = table[in[0]], b = table[in[1]], c = length == 3 ? table[in[2]] : 0;
+        invalid |= a | b | c;
+        uint32_t group = (uint32_t(a) << 18) | (uint32_t(b) << 12) | (uint32_t(c) << 6);
+        *out++ = static_cast<uint8_t>(group >> 16);
+        if (length == 3)
+        {
+          *out++ = static_cast<uint8_t>(group >> 8);
+        }
+      }
+      if (invalid & c_invalid)
+      {
+        throw std::runtime_error("invalid base64 encoded string");
+      }
+      return static_cast<std::size_t>(out - output);
+    }
+
+  } // namespace Details
+
+  std::string Base64Encode(const std::string& text)
+  {
+    std::string encoded(Details::Base64EncodedLength(text.length()), '\0');
+    Details::Base64Encode(
+        reinterpret_cast<const uint8_t*>(text.data()), text.length(), &encoded[0]);
+    return encoded;
+  }
+
+  std::string Base64Decode(const std::string& text)
+  {
+    std::string decoded(Details::Base64DecodedMaxLength(text.length()), '\0');
+    decoded.resize(Details::Base64Decode(
+        text.data(), text.length(), reinterpret_cast<uint8_t*>(&decoded[0])));
+    return decoded;
+  }
+
+}} // namespace Azure::Storage
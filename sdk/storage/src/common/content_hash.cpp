@@ -0,0 +1,107 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include "common/content_hash.hpp"
+
+#include "common/storage_common.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace Azure { namespace Storage {
+
+  int64_t HashValidatingStream::Read(
+      Azure::Core::Context const& context,
+      uint8_t* buffer,
+      int64_t count)
+  {
+    int64_t bytesRead = this->m_inner->Read(context, buffer, count);
+    this->m_hasher.Update(buffer, static_cast<std::size_t>(bytesRead));
+    this->m_bytesRead += bytesRead;
+
+    int64_t length = this->m_inner->Length();
+    if ((bytesRead == 0 && count > 0) || (length >= 0 && this->m_bytesRead >= length))
+    {
+      Validate();
+    }
+    return bytesRead;
+  }
+
+  void HashValidatingStream::Validate()
+  {
+    if (this->m_validated)
+    {
+      return;
+    }
+    this->m_validated = true;
+
+    std::string hash = this->m_hasher.Final();
+    if (hash != this->m_expectedHash)
+    {
+      throw std::runtime_error(
+          "content hash mismatch, expected " + this->m_expectedHash + ", computed " + hash);
+    }
+  }
+
+  HashedBufferStream::HashedBufferStream(
+      Azure::Core::Context const& context,
+      Azure::Core::Http::BodyStream& inner,
+      HashAlgorithm algorithm)
+  {
+    constexpr int64_t c_hashPieceSize = 1024 * 1024;
+
+    // Hashing each piece right after it's copied finds it still in the cache.
+    Details::ContentHasher hasher(algorithm);
+    const int64_t length = inner.Length();
+    if (length < 0)
+    {
+      while (true)
+      {
+        this->m_growingBuffer.resize(static_cast<std::size_t>(this->m_length + c_hashPieceSize));
+        uint8_t* piece = this->m_growingBuffer.data() + this->m_length;
+        int64_t bytesRead
+            = Azure::Core::Http::BodyStream::ReadToCount(context, inner, piece, c_hashPieceSize);
+        hasher.Update(piece, static_cast<std::size_t>(bytesRead));
+        this->m_length += bytesRead;
+        if (bytesRead < c_hashPieceSize)
+        {
+          break;
+        }
+      }
+      this->m_growingBuffer.resize(static_cast<std::size_t>(this->m_length));
+      this->m_data = this->m_growingBuffer.data();
+      this->m_hash = hasher.Final();
+      return;
+    }
+
+    this->m_buffer = Azure::Core::Http::BufferPool::Default().Acquire(length);
+    while (this->m_length < length)
+    {
+      int64_t readSize = std::min(c_hashPieceSize, length - this->m_length);
+      int64_t bytesRead = Azure::Core::Http::BodyStream::ReadToCount(
+          context, inner, this->m_buffer.Data() + this->m_length, readSize);
+      if (bytesRead != readSize)
+      {
+        throw std::runtime_error("error when reading body stream");
+      }
+      hasher.Update(this->m_buffer.Data() + this->m_length, static_cast<std::size_t>(bytesRead));
+      this->m_length += bytesRead;
+    }
+    this->m_data = this->m_buffer.Data();
+    this->m_hash = hasher.Final();
+  }
+
+  int64_t HashedBufferStream::Read(
+      Azure::Core::Context const& context,
+      uint8_t* buffer,
+      int64_t count)
+  {
+    unused(context);
+    int64_t copySize = std::min(count, this->m_length - this->m_offset);
+    std::memcpy(buffer, this->m_data + this->m_offset, static_cast<std::size_t>(copySize));
+    this->m_offset += copySize;
+    return copySize;
+  }
+
+}} // namespace Azure::Storage
@@ -0,0 +1,266 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include "common/crypt.hpp"
+
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define AZURE_STORAGE_CRC64_PCLMUL
+#include <emmintrin.h>
+#include <wmmintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define AZURE_STORAGE_PCLMUL_TARGET
+#else
+#include <cpuid.h>
+#define AZURE_STORAGE_PCLMUL_TARGET __attribute__((target("pclmul,sse2")))
+#endif
+#endif
+
+namespace Azure { namespace Storage {
+
+  namespace {
+    // The reflected form of the polynomial used by storage services.
+    constexpr uint64_t c_crc64Polynomial = 0x9A6C9329AC4BC9B5ULL;
+
+    // Multiplies two polynomials modulo the CRC polynomial, all in the reflected representation,
+    // where the most significant bit is x^0.
+    uint64_t MultiplyModP(uint64_t a, uint64_t b)
+    {
+      uint64_t m = uint64_t(1) << 63;
+      uint64_t p = 0;
+      while (true)
+      {
+        if (a & m)
+        {
+          p ^= b;
+          if ((a & (m - 1)) == 0)
+          {
+            break;
+          }
+        }
+        m >>= 1;
+        b = b & 1 ? (b >> 1) ^ c_crc64Polynomial : b >> 1;
+      }
+      return p;
+    }
+
+    struct Crc64Tables
+    {
+      // Slicing-by-8 lookup tables.
+      uint64_t Slice[8][256];
+      // X2n[k] is x^(2^k) modulo the polynomial.
+      uint64_t X2n[64];
+      // Folding constants for 128-bit blocks that are 512 and 128 bits apart.
+      uint64_t Fold512[2];
+      uint64_t Fold128[2];
+      bool HasPclmul = false;
+
+      Crc64Tables()
+      {
+        for (uint64_t i = 0; i < 256; ++i)
+        {
+          uint64_t crc = i;
+          for (int j = 0; j < 8; ++j)
+          {
+            crc = crc & 1 ? (crc >> 1) ^ c_crc64Polynomial : crc >> 1;
+          }
+          Slice[0][i] = crc;
+        }
+        for (int k = 1; k < 8; ++k)
+        {
+          for (int i = 0; i < 256; ++i)
+          {
+            Slice[k][i] = (Slice[k - 1][i] >> 8) ^ Slice[0][Slice[k - 1][i] & 0xff];
+          }
+        }
+
+        uint64_t p = uint64_t(1) << 62;
+        X2n[0] = p;
+        for (int k = 1; k < 64; ++k)
+        {
+          p = MultiplyModP(p, p);
+          X2n[k] = p;
+        }
+
+        // A carry-less product of two reflected 64-bit values is one bit short of the reflected
+        // 128-bit result, so the constants carry one power of x less than the folding distance.
+        Fold512[0] = XPowModP(512 + 63);
+        Fold512[1] = XPowModP(512 - 1);
+        Fold128[0] = XPowModP(128 + 63);
+        Fold128[1] = XPowModP(128 - 1);
+
+#if defined(AZURE_STORAGE_CRC64_PCLMUL)
+#if defined(_MSC_VER)
+        int cpuInfo[4];
+        __cpuid(cpuInfo, 1);
+        HasPclmul = (cpuInfo[2] & (1 << 1)) != 0;
+#else
+        unsigned int eax, ebx, ecx, edx;
+        HasPclmul = __get_cpuid(1, &eax, &ebx, &ecx, &edx) && (ecx & bit_PCLMUL) != 0;
+#endif
+#endif
+      }
+
+      // Returns x^(n * 2^k) modulo the polynomial.
+      uint64_t XPowModP(uint64_t n, int k = 0) const
+      {
+        uint64_t p = uint64_t(1) << 63;
+        while (n)
+        {
+          if (n & 1)
+          {
+            p = MultiplyModP(X2n[k & 63], p);
+          }
+          n >>= 1;
+          ++k;
+        }
+        return p;
+      }
+    };
+
+    const Crc64Tables& GetTables()
+    {
+      static const Crc64Tables tables;
+      return tables;
+    }
+
+    // Works on the uninverted CRC register.
+    uint64_t Crc64SliceBy8(
+        const Crc64Tables& tables,
+        uint64_t crc,
+        const uint8_t* data,
+        std::size_t length)
+    {
+      const auto& t = tables.Slice;
+      while (length >= 8)
+      {
+        uint64_t word;
+        std::memcpy(&word, data, sizeof(word));
+        crc ^= word;
+        crc = t[7][crc & 0xff] ^ t[6][(crc >> 8) & 0xff] ^ t[5][(crc >> 16) & 0xff]
+            ^ t[4][(crc >> 24) & 0xff] ^ t[3][(crc >> 32) & 0xff] ^ t[2][(crc >> 40) & 0xff]
+            ^ t[1][(crc >> 48) & 0xff] ^ t[0][crc >> 56];
+        data += 8;
+        length -= 8;
+      }
+      while (length > 0)
+      {
+        crc = t[0][(crc ^ *data) & 0xff] ^ (crc >> 8);
+        ++data;
+        --length;
+      }
+      return crc;
+    }
+
+#if defined(AZURE_STORAGE_CRC64_PCLMUL)
+    AZURE_STORAGE_PCLMUL_TARGET inline __m128i Fold(__m128i block, __m128i constants)
+    {
+      return _mm_xor_si128(
+          _mm_clmulepi64_si128(block, constants, 0x00),
+          _mm_clmulepi64_si128(block, constants, 0x11));
+    }
+
+    // Folds 64 bytes per iteration in four independent lanes with carry-less multiplications,
+    // then reduces the remaining 128 bits with the tables. Requires at least 64 bytes.
+    AZURE_STORAGE_PCLMUL_TARGET uint64_t Crc64Pclmul(
+        const Crc64Tables& tables,
+        uint64_t crc,
+        const uint8_t* data,
+        std::size_t length)
+    {
+      const __m128i* blocks = reinterpret_cast<const __m128i*>(data);
+      __m128i x0 = _mm_loadu_si128(blocks + 0);
+      __m128i x1 = _mm_loadu_si128(blocks + 1);
+      __m128i x2 = _mm_loadu_si128(blocks + 2);
+      __m128i x3 = _mm_loadu_si128(blocks + 3);
+      x0 = _mm_xor_si128(x0, _mm_cvtsi64_si128(static_cast<long long>(crc)));
+      blocks += 4;
+      length -= 64;
+
+      const __m128i fold512 = _mm_set_epi64x(
+          static_cast<long long>(tables.Fold512[1]), static_cast<long long>(tables.Fold512[0]));
+      while (length >= 64)
+      {
+        x0 = _mm_xor_si128(Fold(x0, fold512), _mm_loadu_si128(blocks + 0));
+        x1 = _mm_xor_si128(Fold(x1, fold512), _mm_loadu_si128(blocks + 1));
+        x2 = _mm_xor_si128(Fold(x2, fold512), _mm_loadu_si128(blocks + 2));
+        x3 = _mm_xor_si128(Fold(x3, fold512), _mm_loadu_si128(blocks + 3));
+        blocks += 4;
+        length -= 64;
+      }
+
+      const __m128i fold128 = _mm_set_epi64x(
+          static_cast<long long>(tables.Fold128[1]), static_cast<long long>(tables.Fold128[0]));
+      __m128i x = _mm_xor_si128(Fold(x0, fold128), x1);
+      x = _mm_xor_si128(Fold(x, fold128), x2);
+      x = _mm_xor_si128(Fold(x, fold128), x3);
+      while (length >= 16)
+      {
+        x = _mm_xor_si128(Fold(x, fold128), _mm_loadu_si128(blocks));
+        ++blocks;
+        length -= 16;
+      }
+
+      alignas(16) uint8_t remainder[16];
+      _mm_store_si128(reinterpret_cast<__m128i*>(remainder), x);
+      crc = Crc64SliceBy8(tables, 0, remainder, sizeof(remainder));
+      return Crc64SliceBy8(tables, crc, reinterpret_cast<const uint8_t*>(blocks), length);
+    }
+#endif
+  } // namespace
+
+  namespace Details {
+
+    uint64_t Crc64Update(uint64_t crc, const uint8_t* data, std::size_t length)
+    {
+      const Crc64Tables& tables = GetTables();
+      crc = ~crc;
+#if defined(AZURE_STORAGE_CRC64_PCLMUL)
+      // Below this size, setting up the folding costs more than it saves.
+      constexpr std::size_t c_pclmulThreshold = 128;
+      if (tables.HasPclmul && length >= c_pclmulThreshold)
+      {
+        return ~Crc64Pclmul(tables, crc, data, length);
+      }
+#endif
+      return ~Crc64SliceBy8(tables, crc, data, length);
+    }
+
+    uint64_t Crc64Combine(uint64_t crc1, uint64_t crc2, int64_t length2)
+    {
+      if (length2 <= 0)
+      {
+        return crc1;
+      }
+      // Appending length2 bytes multiplies the CRC of the first part by x^(8 * length2).
+      return MultiplyModP(GetTables().XPowModP(static_cast<uint64_t>(length2), 3), crc1) ^ crc2;
+    }
+
+  } // namespace Details
+
+  void Crc64::Update(const uint8_t* data, std::size_t length)
+  {
+    m_value = Details::Crc64Update(m_value, data, length);
+    m_length += static_cast<int64_t>(length);
+  }
+
+  void Crc64::Concatenate(const Crc64& other)
+  {
+    m_value = Details::Crc64Combine(m_value, other.m_value, other.m_length);
+    m_length += other.m_length;
+  }
+
+  std::string Crc64::Final() const
+  {
+    uint8_t binary[sizeof(m_value)];
+    for (std::size_t i = 0; i < sizeof(m_value); ++i)
+    {
+      binary[i] = static_cast<uint8_t>((m_value >> (8 * i)) & 0xff);
+    }
+    char encoded[Details::Base64EncodedLength(sizeof(binary))];
+    return std::string(encoded, Details::Base64Encode(binary, sizeof(binary), encoded));
+  }
+
+}} // namespace Azure::Storage
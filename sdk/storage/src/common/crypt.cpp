@@ -9,10 +9,13 @@
 #include <Windows.h>
 #include <bcrypt.h>
 #else
-#include <openssl/bio.h>
-#include <openssl/buffer.h>
 #include <openssl/evp.h>
 #include <openssl/hmac.h>
+#include <openssl/opensslv.h>
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+#include <openssl/core_names.h>
+#include <openssl/params.h>
+#endif
 #endif
 
 #include <stdexcept>
@@ -20,18 +23,16 @@
 namespace Azure { namespace Storage {
 
 #ifdef _WIN32
-  std::string Hmac_Sha256(const std::string& text, const std::string& key)
-  {
+  namespace {
     struct AlgorithmProviderInstance
     {
       BCRYPT_ALG_HANDLE Handle;
       std::size_t ContextSize;
       std::size_t HashLength;
 
-      AlgorithmProviderInstance()
+      AlgorithmProviderInstance(LPCWSTR algorithm, ULONG flags)
       {
-        NTSTATUS status = BCryptOpenAlgorithmProvider(
-            &Handle, BCRYPT_SHA256_ALGORITHM, nullptr, BCRYPT_ALG_HANDLE_HMAC_FLAG);
+        NTSTATUS status = BCryptOpenAlgorithmProvider(&Handle, algorithm, nullptr, flags);
         if (!BCRYPT_SUCCESS(status))
         {
           throw std::runtime_error("BCryptOpenAlgorithmProvider failed");
@@ -67,137 +68,342 @@ namespace Azure { namespace Storage {
 
       ~AlgorithmProviderInstance() { BCryptCloseAlgorithmProvider(Handle, 0); }
     };
+  } // namespace
 
-    static AlgorithmProviderInstance AlgorithmProvider;
+  namespace {
+    AlgorithmProviderInstance& HmacSha256AlgorithmProvider()
+    {
+      static AlgorithmProviderInstance AlgorithmProvider(
+          BCRYPT_SHA256_ALGORITHM, BCRYPT_ALG_HANDLE_HMAC_FLAG);
+      return AlgorithmProvider;
+    }
+  } // namespace
 
-    std::string context;
-    context.resize(AlgorithmProvider.ContextSize);
+  struct HmacSha256::Context
+  {
+    std::string Object;
+    BCRYPT_HASH_HANDLE Handle = nullptr;
+  };
 
-    BCRYPT_HASH_HANDLE hashHandle;
+  HmacSha256::HmacSha256(const std::string& key) : m_context(std::make_unique<Context>())
+  {
+    auto& algorithmProvider = HmacSha256AlgorithmProvider();
+    m_context->Object.resize(algorithmProvider.ContextSize);
     NTSTATUS status = BCryptCreateHash(
-        AlgorithmProvider.Handle,
-        &hashHandle,
-        reinterpret_cast<PUCHAR>(&context[0]),
-        static_cast<ULONG>(context.size()),
-        reinterpret_cast<PUCHAR>(const_cast<char*>(&key[0])),
+        algorithmProvider.Handle,
+        &m_context->Handle,
+        reinterpret_cast<PUCHAR>(&m_context->Object[0]),
+        static_cast<ULONG>(m_context->Object.size()),
+        reinterpret_cast<PUCHAR>(const_cast<char*>(key.data())),
         static_cast<ULONG>(key.length()),
         0);
     if (!BCRYPT_SUCCESS(status))
     {
       throw std::runtime_error("BCryptCreateHash failed");
     }
+  }
+
+  HmacSha256::~HmacSha256()
+  {
+    if (m_context->Handle)
+    {
+      BCryptDestroyHash(m_context->Handle);
+    }
+  }
+
+  std::string HmacSha256::Sign(const char* text, std::size_t length) const
+  {
+    auto& algorithmProvider = HmacSha256AlgorithmProvider();
+
+    // The keyed context is never modified, every signature works on a duplicate of it.
+    thread_local std::string object;
+    object.resize(algorithmProvider.ContextSize);
+    BCRYPT_HASH_HANDLE hashHandle;
+    NTSTATUS status = BCryptDuplicateHash(
+        m_context->Handle,
+        &hashHandle,
+        reinterpret_cast<PUCHAR>(&object[0]),
+        static_cast<ULONG>(object.size()),
+        0);
+    if (!BCRYPT_SUCCESS(status))
+    {
+      throw std::runtime_error("BCryptDuplicateHash failed");
+    }
 
     status = BCryptHashData(
         hashHandle,
-        reinterpret_cast<PBYTE>(const_cast<char*>(&text[0])),
-        static_cast<ULONG>(text.length()),
+        reinterpret_cast<PUCHAR>(const_cast<char*>(text)),
+        static_cast<ULONG>(length),
         0);
     if (!BCRYPT_SUCCESS(status))
     {
+      BCryptDestroyHash(hashHandle);
       throw std::runtime_error("BCryptHashData failed");
     }
 
     std::string hash;
-    hash.resize(AlgorithmProvider.HashLength);
+    hash.resize(algorithmProvider.HashLength);
     status = BCryptFinishHash(
         hashHandle, reinterpret_cast<PUCHAR>(&hash[0]), static_cast<ULONG>(hash.length()), 0);
+    BCryptDestroyHash(hashHandle);
     if (!BCRYPT_SUCCESS(status))
     {
       throw std::runtime_error("BCryptFinishHash failed");
     }
+    return hash;
+  }
 
-    BCryptDestroyHash(hashHandle);
+  struct Md5::Context
+  {
+    std::string Object;
+    BCRYPT_HASH_HANDLE Handle = nullptr;
+  };
 
-    return hash;
+  namespace {
+    AlgorithmProviderInstance& Md5AlgorithmProvider()
+    {
+      static AlgorithmProviderInstance AlgorithmProvider(BCRYPT_MD5_ALGORITHM, 0);
+      return AlgorithmProvider;
+    }
+  } // namespace
+
+  Md5::Md5() : m_context(std::make_unique<Context>())
+  {
+    auto& algorithmProvider = Md5AlgorithmProvider();
+    m_context->Object.resize(algorithmProvider.ContextSize);
+    NTSTATUS status = BCryptCreateHash(
+        algorithmProvider.Handle,
+        &m_context->Handle,
+        reinterpret_cast<PUCHAR>(&m_context->Object[0]),
+        static_cast<ULONG>(m_context->Object.size()),
+        nullptr,
+        0,
+        0);
+    if (!BCRYPT_SUCCESS(status))
+    {
+      throw std::runtime_error("BCryptCreateHash failed");
+    }
   }
 
-  std::string Base64Encode(const std::string& text)
+  Md5::~Md5()
   {
-    std::string encoded;
-    // According to RFC 4648, the encoded length should be ceiling(n / 3) * 4
-    DWORD encodedLength = static_cast<DWORD>((text.length() + 2) / 3 * 4);
-    encoded.resize(encodedLength);
+    if (m_context && m_context->Handle)
+    {
+      BCryptDestroyHash(m_context->Handle);
+    }
+  }
 
-    CryptBinaryToStringA(
-        reinterpret_cast<const BYTE*>(text.data()),
-        static_cast<DWORD>(text.length()),
-        CRYPT_STRING_BASE64 | CRYPT_STRING_NOCRLF,
-        static_cast<LPSTR>(&encoded[0]),
-        &encodedLength);
+  void Md5::Update(const uint8_t* data, std::size_t length)
+  {
+    NTSTATUS status = BCryptHashData(
+        m_context->Handle, const_cast<PUCHAR>(data), static_cast<ULONG>(length), 0);
+    if (!BCRYPT_SUCCESS(status))
+    {
+      throw std::runtime_error("BCryptHashData failed");
+    }
+  }
 
-    return encoded;
+  std::string Md5::Final()
+  {
+    std::string hash;
+    hash.resize(Md5AlgorithmProvider().HashLength);
+    NTSTATUS status = BCryptFinishHash(
+        m_context->Handle,
+        reinterpret_cast<PUCHAR>(&hash[0]),
+        static_cast<ULONG>(hash.length()),
+        0);
+    if (!BCRYPT_SUCCESS(status))
+    {
+      throw std::runtime_error("BCryptFinishHash failed");
+    }
+    return Base64Encode(hash);
   }
 
-  std::string Base64Decode(const std::string& text)
+#else
+
+  struct HmacSha256::Context
   {
-    std::string decoded;
-    // According to RFC 4648, the encoded length should be ceiling(n / 3) * 4, so we can infer an
-    // upper bound here
-    DWORD decodedLength = DWORD(text.length() / 4 * 3);
-    decoded.resize(decodedLength);
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+    EVP_MAC* Mac = nullptr;
+    EVP_MAC_CTX* Handle = nullptr;
+#else
+    HMAC_CTX* Handle = nullptr;
+#endif
+  };
 
-    CryptStringToBinaryA(
-        text.data(),
-        static_cast<DWORD>(text.length()),
-        CRYPT_STRING_BASE64 | CRYPT_STRING_STRICT,
-        reinterpret_cast<BYTE*>(&decoded[0]),
-        &decodedLength,
-        nullptr,
-        nullptr);
-    decoded.resize(decodedLength);
-    return decoded;
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+  HmacSha256::HmacSha256(const std::string& key) : m_context(std::make_unique<Context>())
+  {
+    m_context->Mac = EVP_MAC_fetch(nullptr, "HMAC", nullptr);
+    if (m_context->Mac)
+    {
+      m_context->Handle = EVP_MAC_CTX_new(m_context->Mac);
+    }
+    OSSL_PARAM params[] = {
+        OSSL_PARAM_construct_utf8_string(OSSL_MAC_PARAM_DIGEST, const_cast<char*>("SHA256"), 0),
+        OSSL_PARAM_construct_end(),
+    };
+    if (m_context->Handle == nullptr
+        || EVP_MAC_init(
+               m_context->Handle,
+               reinterpret_cast<const unsigned char*>(key.data()),
+               key.length(),
+               params)
+            != 1)
+    {
+      EVP_MAC_CTX_free(m_context->Handle);
+      EVP_MAC_free(m_context->Mac);
+      throw std::runtime_error("EVP_MAC_init failed");
+    }
   }
 
+  HmacSha256::~HmacSha256()
+  {
+    EVP_MAC_CTX_free(m_context->Handle);
+    EVP_MAC_free(m_context->Mac);
+  }
+
+  std::string HmacSha256::Sign(const char* text, std::size_t length) const
+  {
+    // The keyed context is never modified, every signature works on a duplicate of it.
+    EVP_MAC_CTX* context = EVP_MAC_CTX_dup(m_context->Handle);
+    unsigned char hash[EVP_MAX_MD_SIZE];
+    std::size_t hashLength = 0;
+    bool succeeded = context != nullptr
+        && EVP_MAC_update(context, reinterpret_cast<const unsigned char*>(text), length) == 1
+        && EVP_MAC_final(context, hash, &hashLength, sizeof(hash)) == 1;
+    EVP_MAC_CTX_free(context);
+    if (!succeeded)
+    {
+      throw std::runtime_error("HMAC-SHA256 failed");
+    }
+    return std::string(reinterpret_cast<char*>(hash), hashLength);
+  }
 #else
+  HmacSha256::HmacSha256(const std::string& key) : m_context(std::make_unique<Context>())
+  {
+    m_context->Handle = HMAC_CTX_new();
+    if (m_context->Handle == nullptr
+        || HMAC_Init_ex(
+               m_context->Handle,
+               key.data(),
+               static_cast<int>(key.length()),
+               EVP_sha256(),
+               nullptr)
+            != 1)
+    {
+      HMAC_CTX_free(m_context->Handle);
+      throw std::runtime_error("HMAC_Init_ex failed");
+    }
+  }
 
-  std::string Hmac_Sha256(const std::string& text, const std::string& key)
+  HmacSha256::~HmacSha256() { HMAC_CTX_free(m_context->Handle); }
+
+  std::string HmacSha256::Sign(const char* text, std::size_t length) const
   {
-    char hash[EVP_MAX_MD_SIZE];
+    // The keyed context is never modified, every signature works on a copy of it.
+    thread_local std::unique_ptr<HMAC_CTX, void (*)(HMAC_CTX*)> context(
+        HMAC_CTX_new(), HMAC_CTX_free);
+    unsigned char hash[EVP_MAX_MD_SIZE];
     unsigned int hashLength = 0;
-    HMAC(
-        EVP_sha256(),
-        key.data(),
-        static_cast<int>(key.length()),
-        reinterpret_cast<const unsigned char*>(text.data()),
-        text.length(),
-        reinterpret_cast<unsigned char*>(&hash[0]),
-        &hashLength);
-
-    return std::string(hash, hashLength);
+    if (!context || HMAC_CTX_copy(context.get(), m_context->Handle) != 1
+        || HMAC_Update(context.get(), reinterpret_cast<const unsigned char*>(text), length) != 1
+        || HMAC_Final(context.get(), hash, &hashLength) != 1)
+    {
+      throw std::runtime_error("HMAC-SHA256 failed");
+    }
+    return std::string(reinterpret_cast<char*>(hash), hashLength);
   }
+#endif
 
-  std::string Base64Encode(const std::string& text)
+  struct Md5::Context
   {
-    BIO* bio = BIO_new(BIO_s_mem());
-    bio = BIO_push(BIO_new(BIO_f_base64()), bio);
-    BIO_set_flags(bio, BIO_FLAGS_BASE64_NO_NL);
-    BIO_write(bio, text.data(), static_cast<int>(text.length()));
-    BIO_flush(bio);
-    BUF_MEM* bufferPtr;
-    BIO_get_mem_ptr(bio, &bufferPtr);
-    BIO_set_close(bio, BIO_NOCLOSE);
-    BIO_free_all(bio);
+    EVP_MD_CTX* Handle = nullptr;
+  };
 
-    return std::string(bufferPtr->data, bufferPtr->length);
+  Md5::Md5() : m_context(std::make_unique<Context>())
+  {
+    m_context->Handle = EVP_MD_CTX_new();
+    if (m_context->Handle == nullptr
+        || EVP_DigestInit_ex(m_context->Handle, EVP_md5(), nullptr) != 1)
+    {
+      EVP_MD_CTX_free(m_context->Handle);
+      throw std::runtime_error("EVP_DigestInit_ex failed");
+    }
   }
 
-  std::string Base64Decode(const std::string& text)
+  Md5::~Md5()
   {
-    std::string decoded;
-    // According to RFC 4648, the encoded length should be ceiling(n / 3) * 4, so we can infer an
-    // upper bound here
-    std::size_t maxDecodedLength = text.length() / 4 * 3;
-    decoded.resize(maxDecodedLength);
+    if (m_context)
+    {
+      EVP_MD_CTX_free(m_context->Handle);
+    }
+  }
 
-    BIO* bio = BIO_new_mem_buf(text.data(), -1);
-    bio = BIO_push(BIO_new(BIO_f_base64()), bio);
-    BIO_set_flags(bio, BIO_FLAGS_BASE64_NO_NL);
-    int decodedLength = BIO_read(bio, &decoded[0], static_cast<int>(text.length()));
-    BIO_free_all(bio);
+  void Md5::Update(const uint8_t* data, std::size_t length)
+  {
+    if (EVP_DigestUpdate(m_context->Handle, data, length) != 1)
+    {
+      throw std::runtime_error("EVP_DigestUpdate failed");
+    }
+  }
 
-    decoded.resize(decodedLength);
-    return decoded;
+  std::string Md5::Final()
+  {
+    unsigned char hash[EVP_MAX_MD_SIZE];
+    unsigned int hashLength = 0;
+    if (EVP_DigestFinal_ex(m_context->Handle, hash, &hashLength) != 1)
+    {
+      throw std::runtime_error("EVP_DigestFinal_ex failed");
+    }
+    char encoded[Details::Base64EncodedLength(EVP_MAX_MD_SIZE)];
+    return std::string(encoded, Details::Base64Encode(hash, hashLength, encoded));
   }
 #endif
 
+  std::string Hmac_Sha256(const std::string& text, const std::string& key)
+  {
+    return HmacSha256(key).Sign(text);
+  }
+
+  Md5::Md5(Md5&& other) noexcept = default;
+  Md5& Md5::operator=(Md5&& other) noexcept = default;
+
+  namespace Details {
+
+    ContentHasher::ContentHasher(HashAlgorithm algorithm) : m_algorithm(algorithm)
+    {
+      if (m_algorithm == HashAlgorithm::Md5)
+      {
+        m_md5 = std::make_unique<Md5>();
+      }
+    }
+
+    void ContentHasher::Update(const uint8_t* data, std::size_t length)
+    {
+      switch (m_algorithm)
+      {
+        case HashAlgorithm::Md5:
+          m_md5->Update(data, length);
+          break;
+        case HashAlgorithm::Crc64:
+          m_crc64.Update(data, length);
+          break;
+      }
+    }
+
+    std::string ContentHasher::Final()
+    {
+      switch (m_algorithm)
+      {
+        case HashAlgorithm::Md5:
+          return m_md5->Final();
+        case HashAlgorithm::Crc64:
+          return m_crc64.Final();
+      }
+      return std::string();
+    }
+
+  } // namespace Details
+
 }} // namespace Azure::Storage
@@ -12,6 +12,7 @@
 
 #include <limits>
 #include <stdexcept>
+#include <vector>
 
 namespace Azure { namespace Storage { namespace Details {
 
@@ -43,14 +44,27 @@ namespace Azure { namespace Storage { namespace Details {
 
   FileReader::~FileReader() { CloseHandle(m_handle); }
 
-  FileWriter::FileWriter(const std::string& filename)
+  int64_t FileReader::GetLastModified() const
+  {
+    FILETIME lastWriteTime;
+    if (!GetFileTime(m_handle, nullptr, nullptr, &lastWriteTime))
+    {
+      throw std::runtime_error("failed to get last modified time of file");
+    }
+    return static_cast<int64_t>(
+        (static_cast<uint64_t>(lastWriteTime.dwHighDateTime) << 32)
+        | lastWriteTime.dwLowDateTime);
+  }
+
+  FileWriter::FileWriter(const std::string& filename, const FileWriterOptions& options)
+      : m_directHandle(INVALID_HANDLE_VALUE)
   {
     m_handle = CreateFile(
         filename.data(),
         GENERIC_WRITE,
         FILE_SHARE_READ | FILE_SHARE_WRITE,
         nullptr,
-        CREATE_ALWAYS,
+        options.Truncate ? CREATE_ALWAYS : OPEN_ALWAYS,
         FILE_ATTRIBUTE_NORMAL,
         NULL);
     if (m_handle == INVALID_HANDLE_VALUE)
@@ -80,7 +94,53 @@ namespace Azure { namespace Storage { namespace Details {
       throw std::runtime_error("failed to write file");
     }
   }
-#else
+
+  void FileWriter::SetFileSize(int64_t size)
+  {
+    FILE_END_OF_FILE_INFO endOfFileInfo;
+    endOfFileInfo.EndOfFile.QuadPart = size;
+    if (!SetFileInformationByHandle(
+            m_handle, FileEndOfFileInfo, &endOfFileInfo, sizeof(endOfFileInfo)))
+    {
+      throw std::runtime_error("failed to set size of file");
+    }
+  }
+
+  void FileWriter::Preallocate(int64_t size)
+  {
+    FILE_ALLOCATION_INFO allocationInfo;
+    allocationInfo.AllocationSize.QuadPart = size;
+    SetFileInformationByHandle(
+        m_handle, FileAllocationInfo, &allocationInfo, sizeof(allocationInfo));
+  }
+
+  FileHandle FileWriter::GetWriteHandle(const uint8_t*, int64_t, int64_t) const
+  {
+    return m_handle;
+  }
+
+  void FileWriter::WriteBack(int64_t, int64_t) {}
+#endif
+
+  std::shared_ptr<FileIoOperation> FileWriter::WriteAsync(
+      FileIoEngine& engine,
+      const uint8_t* buffer,
+      int64_t length,
+      int64_t offset)
+  {
+    return engine.Write(GetWriteHandle(buffer, length, offset), buffer, length, offset);
+  }
+
+  void FileWriter::WaitWrite(FileIoOperation& operation)
+  {
+    operation.Wait();
+    if (operation.GetHandle() == m_handle && m_writeBackInterval > 0)
+    {
+      WriteBack(operation.GetOffset(), operation.GetLength());
+    }
+  }
+
+#ifndef _WIN32
   FileReader::FileReader(const std::string& filename)
   {
     m_handle = open(filename.data(), O_RDONLY);
@@ -98,17 +158,51 @@ namespace Azure { namespace Storage { namespace Details {
 
   FileReader::~FileReader() { close(m_handle); }
 
-  FileWriter::FileWriter(const std::string& filename)
+  int64_t FileReader::GetLastModified() const
+  {
+    struct stat fileStatus;
+    if (fstat(m_handle, &fileStatus) != 0)
+    {
+      throw std::runtime_error("failed to get last modified time of file");
+    }
+#ifdef __APPLE__
+    const auto& lastModified = fileStatus.st_mtimespec;
+#else
+    const auto& lastModified = fileStatus.st_mtim;
+#endif
+    return static_cast<int64_t>(lastModified.tv_sec) * 1000000000 + lastModified.tv_nsec;
+  }
+
+  FileWriter::FileWriter(const std::string& filename, const FileWriterOptions& options)
+      : m_directHandle(-1), m_writeBackInterval(options.WriteBackInterval)
   {
     m_handle = open(
-        filename.data(), O_WRONLY | O_CREAT | O_TRUNC, S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
+        filename.data(),
+        O_WRONLY | O_CREAT | (options.Truncate ? O_TRUNC : 0),
+        S_IRUSR | S_IWUSR | S_IRGRP | S_IROTH);
     if (m_handle == -1)
     {
       throw std::runtime_error("failed to open file");
     }
+#ifdef __linux__
+    if (options.DirectIo)
+    {
+      // Some file systems, e.g. tmpfs, don't support direct I/O, all writes are buffered then.
+      m_directHandle = open(filename.data(), O_WRONLY | O_DIRECT);
+    }
+#else
+    m_writeBackInterval = 0;
+#endif
   }
 
-  FileWriter::~FileWriter() { close(m_handle); }
+  FileWriter::~FileWriter()
+  {
+    if (m_directHandle != -1)
+    {
+      close(m_directHandle);
+    }
+    close(m_handle);
+  }
 
   void FileWriter::Write(const uint8_t* buffer, int64_t length, int64_t offset)
   {
@@ -117,12 +211,82 @@ namespace Azure { namespace Storage { namespace Details {
     {
       throw std::runtime_error("failed to write file");
     }
+    const FileHandle handle = GetWriteHandle(buffer, length, offset);
     ssize_t bytesWritten
-        = pwrite(m_handle, buffer, static_cast<size_t>(length), static_cast<off_t>(offset));
+        = pwrite(handle, buffer, static_cast<size_t>(length), static_cast<off_t>(offset));
     if (bytesWritten != length)
     {
       throw std::runtime_error("failed to write file");
     }
+    if (handle == m_handle && m_writeBackInterval > 0)
+    {
+      WriteBack(offset, length);
+    }
+  }
+
+  FileHandle FileWriter::GetWriteHandle(const uint8_t* buffer, int64_t length, int64_t offset)
+      const
+  {
+    const bool aligned = reinterpret_cast<uintptr_t>(buffer) % c_directIoAlignment == 0
+        && offset % c_directIoAlignment == 0 && length % c_directIoAlignment == 0;
+    return m_directHandle != -1 && aligned ? m_directHandle : m_handle;
+  }
+
+  void FileWriter::WriteBack(int64_t offset, int64_t length)
+  {
+#ifdef __linux__
+    // Errors are ignored, this only limits the dirty pages. Failed writes surface when the file is
+    // closed or synced.
+    sync_file_range(m_handle, offset, length, SYNC_FILE_RANGE_WRITE);
+
+    std::vector<std::pair<int64_t, int64_t>> writtenBack;
+    {
+      std::lock_guard<std::mutex> guard(m_writeBackMutex);
+      m_pendingWriteBacks.emplace_back(offset, length);
+      m_pendingWriteBackBytes += length;
+      while (m_pendingWriteBackBytes > m_writeBackInterval)
+      {
+        writtenBack.push_back(m_pendingWriteBacks.front());
+        m_pendingWriteBackBytes -= m_pendingWriteBacks.front().second;
+        m_pendingWriteBacks.pop_front();
+      }
+    }
+    for (const auto& range : writtenBack)
+    {
+      sync_file_range(
+          m_handle,
+          range.first,
+          range.second,
+          SYNC_FILE_RANGE_WAIT_BEFORE | SYNC_FILE_RANGE_WRITE | SYNC_FILE_RANGE_WAIT_AFTER);
+      posix_fadvise(m_handle, range.first, range.second, POSIX_FADV_DONTNEED);
+    }
+#else
+    (void)offset;
+    (void)length;
+#endif
+  }
+
+  void FileWriter::SetFileSize(int64_t size)
+  {
+    if (size > static_cast<int64_t>(std::numeric_limits<off_t>::max())
+        || ftruncate(m_handle, static_cast<off_t>(size)) != 0)
+    {
+      throw std::runtime_error("failed to set size of file");
+    }
+  }
+
+  void FileWriter::Preallocate(int64_t size)
+  {
+#ifdef __linux__
+    if (size > 0 && size <= static_cast<int64_t>(std::numeric_limits<off_t>::max()))
+    {
+      // Fails with EOPNOTSUPP on file systems that can't preallocate, which is fine. Unlike
+      // posix_fallocate, this never falls back to writing zeros.
+      fallocate(m_handle, 0, 0, static_cast<off_t>(size));
+    }
+#else
+    (void)size;
+#endif
   }
 #endif
 
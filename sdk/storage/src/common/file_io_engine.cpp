@@ -0,0 +1,517 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include "common/file_io_engine.hpp"
+
+#ifdef __linux__
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#endif
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <thread>
+
+namespace Azure { namespace Storage { namespace Details {
+
+  namespace {
+    // io_uring reports the result of an operation in 32 bits, larger operations run synchronously.
+    constexpr int64_t c_maxAsyncLength = 1024 * 1024 * 1024;
+
+    // Transfers what's left of an operation synchronously. Returns the bytes transferred, or a
+    // negated errno.
+    int64_t TransferSync(
+        FileHandle handle,
+        uint8_t* buffer,
+        int64_t length,
+        int64_t offset,
+        bool isWrite)
+    {
+      int64_t transferred = 0;
+      while (transferred < length)
+      {
+#ifdef _WIN32
+        int64_t pieceLength = std::min<int64_t>(length - transferred, MAXDWORD);
+        OVERLAPPED overlapped;
+        std::memset(&overlapped, 0, sizeof(overlapped));
+        const uint64_t pieceOffset = static_cast<uint64_t>(offset + transferred);
+        overlapped.Offset = static_cast<DWORD>(pieceOffset);
+        overlapped.OffsetHigh = static_cast<DWORD>(pieceOffset >> 32);
+        DWORD bytes = 0;
+        BOOL ret = isWrite ? WriteFile(
+                       handle,
+                       buffer + transferred,
+                       static_cast<DWORD>(pieceLength),
+                       &bytes,
+                       &overlapped)
+                           : ReadFile(
+                               handle,
+                               buffer + transferred,
+                               static_cast<DWORD>(pieceLength),
+                               &bytes,
+                               &overlapped);
+        if (!ret)
+        {
+          return GetLastError() == ERROR_HANDLE_EOF ? transferred : -EIO;
+        }
+#else
+        auto bytes = isWrite ? pwrite(
+                         handle,
+                         buffer + transferred,
+                         static_cast<size_t>(length - transferred),
+                         static_cast<off_t>(offset + transferred))
+                             : pread(
+                                 handle,
+                                 buffer + transferred,
+                                 static_cast<size_t>(length - transferred),
+                                 static_cast<off_t>(offset + transferred));
+        if (bytes < 0)
+        {
+          if (errno == EINTR)
+          {
+            continue;
+          }
+          return -errno;
+        }
+#endif
+        if (bytes == 0)
+        {
+          break;
+        }
+        transferred += static_cast<int64_t>(bytes);
+      }
+      return transferred;
+    }
+  } // namespace
+
+  void FileIoOperation::Complete(int64_t result)
+  {
+    std::shared_ptr<FileIoOperation> self;
+    {
+      std::lock_guard<std::mutex> guard(m_mutex);
+      m_result = result;
+      m_completed = true;
+      self = std::move(m_self);
+    }
+    m_cv.notify_all();
+  }
+
+  void FileIoOperation::Wait()
+  {
+    int64_t result;
+    {
+      std::unique_lock<std::mutex> guard(m_mutex);
+      m_cv.wait(guard, [this]() { return m_completed; });
+      result = m_result;
+      if (result >= 0 && result < m_length && !m_waited)
+      {
+        // Short transfers are rare, e.g. interrupted by a signal.
+        int64_t remaining = TransferSync(
+            m_handle, m_buffer + result, m_length - result, m_offset + result, m_isWrite);
+        result = remaining < 0 ? remaining : result + remaining;
+        m_result = result;
+      }
+      m_waited = true;
+    }
+    if (result < 0)
+    {
+      throw std::runtime_error(
+          std::string(m_isWrite ? "failed to write file: " : "failed to read file: ")
+          + std::strerror(static_cast<int>(-result)));
+    }
+    if (result != m_length)
+    {
+      throw std::runtime_error(
+          m_isWrite ? "failed to write file" : "failed to read file: unexpected end of file");
+    }
+  }
+
+#ifdef __linux__
+  struct FileIoEngine::Ring
+  {
+    int Fd = -1;
+    unsigned Entries = 0;
+
+    void* SqRing = MAP_FAILED;
+    std::size_t SqRingSize = 0;
+    void* CqRing = MAP_FAILED;
+    std::size_t CqRingSize = 0;
+    io_uring_sqe* Sqes = static_cast<io_uring_sqe*>(MAP_FAILED);
+    std::size_t SqesSize = 0;
+
+    unsigned* SqHead = nullptr;
+    unsigned* SqTail = nullptr;
+    unsigned SqMask = 0;
+    unsigned* SqArray = nullptr;
+    unsigned* CqHead = nullptr;
+    unsigned* CqTail = nullptr;
+    unsigned CqMask = 0;
+    io_uring_cqe* Cqes = nullptr;
+
+    // Serializes submissions, and bounds the operations in flight to what the completion queue
+    // can hold.
+    std::mutex SubmitMutex;
+    std::condition_variable SubmitCv;
+    unsigned InFlight = 0;
+    std::thread CompletionThread;
+
+    ~Ring()
+    {
+      if (Sqes != MAP_FAILED)
+      {
+        munmap(Sqes, SqesSize);
+      }
+      if (CqRing != MAP_FAILED && CqRing != SqRing)
+      {
+        munmap(CqRing, CqRingSize);
+      }
+      if (SqRing != MAP_FAILED)
+      {
+        munmap(SqRing, SqRingSize);
+      }
+      if (Fd != -1)
+      {
+        close(Fd);
+      }
+    }
+
+    static unsigned* At(void* base, uint32_t offset)
+    {
+      return reinterpret_cast<unsigned*>(static_cast<uint8_t*>(base) + offset);
+    }
+
+    bool Setup(unsigned queueDepth)
+    {
+      io_uring_params params;
+      std::memset(&params, 0, sizeof(params));
+      Fd = static_cast<int>(syscall(__NR_io_uring_setup, queueDepth, &params));
+      if (Fd < 0)
+      {
+        // ENOSYS on old kernels, EPERM where it's disabled or filtered out
+        Fd = -1;
+        return false;
+      }
+      Entries = params.sq_entries;
+      SqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+      CqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+      const bool singleMap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+      if (singleMap)
+      {
+        SqRingSize = CqRingSize = std::max(SqRingSize, CqRingSize);
+      }
+      SqRing = mmap(
+          nullptr,
+          SqRingSize,
+          PROT_READ | PROT_WRITE,
+          MAP_SHARED | MAP_POPULATE,
+          Fd,
+          IORING_OFF_SQ_RING);
+      if (SqRing == MAP_FAILED)
+      {
+        return false;
+      }
+      CqRing = singleMap ? SqRing
+                         : mmap(
+                             nullptr,
+                             CqRingSize,
+                             PROT_READ | PROT_WRITE,
+                             MAP_SHARED | MAP_POPULATE,
+                             Fd,
+                             IORING_OFF_CQ_RING);
+      if (CqRing == MAP_FAILED)
+      {
+        return false;
+      }
+      SqesSize = params.sq_entries * sizeof(io_uring_sqe);
+      Sqes = static_cast<io_uring_sqe*>(mmap(
+          nullptr,
+          SqesSize,
+          PROT_READ | PROT_WRITE,
+          MAP_SHARED | MAP_POPULATE,
+          Fd,
+          IORING_OFF_SQES));
+      if (Sqes == MAP_FAILED)
+      {
+        return false;
+      }
+      SqHead = At(SqRing, params.sq_off.head);
+      SqTail = At(SqRing, params.sq_off.tail);
+      SqMask = *At(SqRing, params.sq_off.ring_mask);
+      SqArray = At(SqRing, params.sq_off.array);
+      CqHead = At(CqRing, params.cq_off.head);
+      CqTail = At(CqRing, params.cq_off.tail);
+      CqMask = *At(CqRing, params.cq_off.ring_mask);
+      Cqes = reinterpret_cast<io_uring_cqe*>(static_cast<uint8_t*>(CqRing) + params.cq_off.cqes);
+      return true;
+    }
+
+    // Queues one submission and hands it to the kernel. Called with SubmitMutex held.
+    bool Push(uint8_t opcode, FileIoOperation* operation, FileHandle handle, int64_t offset)
+    {
+      unsigned tail = *SqTail;
+      unsigned index = tail & SqMask;
+      io_uring_sqe& sqe = Sqes[index];
+      std::memset(&sqe, 0, sizeof(sqe));
+      sqe.opcode = opcode;
+      sqe.fd = handle;
+      sqe.off = static_cast<uint64_t>(offset);
+      sqe.user_data = reinterpret_cast<uint64_t>(operation);
+      if (operation != nullptr)
+      {
+        static_assert(
+            sizeof(FileIoOperation::IoVector) == sizeof(iovec)
+                && offsetof(FileIoOperation::IoVector, Length) == offsetof(iovec, iov_len),
+            "IoVector must have the layout of iovec");
+        sqe.addr = reinterpret_cast<uint64_t>(&operation->m_ioVector);
+        sqe.len = 1;
+      }
+      SqArray[index] = index;
+      __atomic_store_n(SqTail, tail + 1, __ATOMIC_RELEASE);
+      while (true)
+      {
+        long submitted = syscall(__NR_io_uring_enter, Fd, 1, 0, 0, nullptr, 0);
+        if (submitted >= 0 || errno != EINTR)
+        {
+          if (submitted == 1)
+          {
+            return true;
+          }
+          // Take the entry back, nothing else can have been queued behind it.
+          __atomic_store_n(SqTail, tail, __ATOMIC_RELEASE);
+          return false;
+        }
+      }
+    }
+  };
+#else
+  struct FileIoEngine::Ring
+  {
+  };
+#endif
+
+  FileIoEngine::FileIoEngine(bool useIoUring, unsigned queueDepth)
+  {
+#ifdef __linux__
+    if (useIoUring)
+    {
+      auto ring = std::make_unique<Ring>();
+      if (ring->Setup(queueDepth))
+      {
+        m_ring = std::move(ring);
+        m_ring->CompletionThread = std::thread(&FileIoEngine::ReapCompletions, this);
+      }
+    }
+#else
+    (void)useIoUring;
+    (void)queueDepth;
+#endif
+  }
+
+  FileIoEngine::~FileIoEngine()
+  {
+#ifdef __linux__
+    if (m_ring)
+    {
+      {
+        std::unique_lock<std::mutex> guard(m_ring->SubmitMutex);
+        // Everything submitted must have completed before the rings are unmapped.
+        m_ring->SubmitCv.wait(guard, [this]() { return m_ring->InFlight == 0; });
+        // A no-op without an operation wakes the completion thread up to exit.
+        m_ring->Push(IORING_OP_NOP, nullptr, -1, 0);
+      }
+      m_ring->CompletionThread.join();
+    }
+#endif
+  }
+
+  FileIoEngine& FileIoEngine::Default()
+  {
+    static FileIoEngine engine;
+    return engine;
+  }
+
+  std::shared_ptr<FileIoOperation> FileIoEngine::Read(
+      FileHandle handle,
+      uint8_t* buffer,
+      int64_t length,
+      int64_t offset)
+  {
+    return Submit(handle, buffer, length, offset, false);
+  }
+
+  std::shared_ptr<FileIoOperation> FileIoEngine::Write(
+      FileHandle handle,
+      const uint8_t* buffer,
+      int64_t length,
+      int64_t offset)
+  {
+    // The buffer is only read from.
+    return Submit(handle, const_cast<uint8_t*>(buffer), length, offset, true);
+  }
+
+  std::shared_ptr<FileIoOperation> FileIoEngine::Submit(
+      FileHandle handle,
+      uint8_t* buffer,
+      int64_t length,
+      int64_t offset,
+      bool isWrite)
+  {
+    if (length < 0 || offset < 0)
+    {
+      throw std::invalid_argument("invalid file range");
+    }
+    auto operation = std::make_shared<FileIoOperation>();
+    operation->m_handle = handle;
+    operation->m_buffer = buffer;
+    operation->m_length = length;
+    operation->m_offset = offset;
+    operation->m_isWrite = isWrite;
+    operation->m_ioVector.Base = buffer;
+    operation->m_ioVector.Length = static_cast<std::size_t>(length);
+
+#ifdef __linux__
+    if (m_ring && length > 0 && length <= c_maxAsyncLength)
+    {
+      std::unique_lock<std::mutex> guard(m_ring->SubmitMutex);
+      m_ring->SubmitCv.wait(guard, [this]() { return m_ring->InFlight < m_ring->Entries; });
+      operation->m_self = operation;
+      if (m_ring->Push(
+              isWrite ? IORING_OP_WRITEV : IORING_OP_READV, operation.get(), handle, offset))
+      {
+        ++m_ring->InFlight;
+        return operation;
+      }
+      operation->m_self.reset();
+    }
+#endif
+    operation->Complete(TransferSync(handle, buffer, length, offset, isWrite));
+    return operation;
+  }
+
+  void FileIoEngine::ReapCompletions()
+  {
+#ifdef __linux__
+    Ring& ring = *m_ring;
+    while (true)
+    {
+      unsigned head = *ring.CqHead;
+      unsigned tail = __atomic_load_n(ring.CqTail, __ATOMIC_ACQUIRE);
+      if (head == tail)
+      {
+        syscall(__NR_io_uring_enter, ring.Fd, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0);
+        continue;
+      }
+      bool stop = false;
+      unsigned completed = 0;
+      for (; head != tail; ++head)
+      {
+        const io_uring_cqe& cqe = ring.Cqes[head & ring.CqMask];
+        auto operation = reinterpret_cast<FileIoOperation*>(cqe.user_data);
+        int32_t result = cqe.res;
+        __atomic_store_n(ring.CqHead, head + 1, __ATOMIC_RELEASE);
+        if (operation == nullptr)
+        {
+          stop = true;
+          continue;
+        }
+        operation->Complete(result);
+        ++completed;
+      }
+      if (completed != 0)
+      {
+        {
+          std::lock_guard<std::mutex> guard(ring.SubmitMutex);
+          ring.InFlight -= completed;
+        }
+        ring.SubmitCv.notify_all();
+      }
+      if (stop)
+      {
+        return;
+      }
+    }
+#endif
+  }
+
+  FileReadAhead::FileReadAhead(
+      FileIoEngine& engine,
+      FileHandle handle,
+      std::vector<std::pair<int64_t, int64_t>> chunks,
+      int depth)
+      : m_engine(engine), m_handle(handle), m_chunks(std::move(chunks)),
+        m_depth(static_cast<std::size_t>(std::max(depth, 1))), m_slots(m_chunks.size())
+  {
+  }
+
+  FileReadAhead::~FileReadAhead()
+  {
+    // The kernel may still be writing into the buffers of chunks that were never requested.
+    for (auto& slot : m_slots)
+    {
+      if (slot.Operation)
+      {
+        try
+        {
+          slot.Operation->Wait();
+        }
+        catch (std::exception&)
+        {
+        }
+      }
+    }
+  }
+
+  Azure::Core::Http::PooledBuffer FileReadAhead::Get(std::size_t index)
+  {
+    std::shared_ptr<FileIoOperation> operation;
+    Azure::Core::Http::PooledBuffer buffer;
+    {
+      std::lock_guard<std::mutex> guard(m_mutex);
+      const std::size_t readAheadEnd = std::min(index + 1 + m_depth, m_chunks.size());
+      for (; m_nextRead < readAheadEnd; ++m_nextRead)
+      {
+        Slot& slot = m_slots[m_nextRead];
+        // Chunks ahead of the requested one never wait for memory, or they could hold back the
+        // chunks that would release it.
+        slot.Buffer = m_nextRead == index
+            ? Azure::Core::Http::PooledBuffer()
+            : Azure::Core::Http::BufferPool::Default().TryAcquire(m_chunks[m_nextRead].second);
+        if (!slot.Buffer && m_nextRead != index)
+        {
+          break;
+        }
+        if (slot.Buffer)
+        {
+          const auto& chunk = m_chunks[m_nextRead];
+          slot.Operation = m_engine.Read(m_handle, slot.Buffer.Data(), chunk.second, chunk.first);
+        }
+      }
+      operation = std::move(m_slots[index].Operation);
+      buffer = std::move(m_slots[index].Buffer);
+      if (index >= m_nextRead)
+      {
+        // The chunk wasn't reached by the read ahead, it's read below by the caller.
+        m_nextRead = std::max(m_nextRead, index + 1);
+      }
+    }
+    if (!operation)
+    {
+      const auto& chunk = m_chunks[index];
+      buffer = Azure::Core::Http::BufferPool::Default().Acquire(chunk.second);
+      operation = m_engine.Read(m_handle, buffer.Data(), chunk.second, chunk.first);
+    }
+    operation->Wait();
+    return buffer;
+  }
+
+}}} // namespace Azure::Storage::Details
@@ -4,35 +4,60 @@
 #include "common/shared_key_policy.hpp"
 
 #include "common/crypt.hpp"
-#include "common/storage_uri_builder.hpp"
 
 #include <algorithm>
 #include <cctype>
+#include <cstring>
+#include <utility>
+#include <vector>
 
 namespace Azure { namespace Storage {
+
+  namespace {
+    // Standard headers in the order they appear in the string to sign, lowercased like the keys
+    // of the request headers.
+    const char* const c_signedHeaders[] = {
+        "content-encoding",
+        "content-language",
+        "content-length",
+        "content-md5",
+        "content-type",
+        "date",
+        "if-modified-since",
+        "if-match",
+        "if-none-match",
+        "if-unmodified-since",
+        "range",
+    };
+
+    // Scratch space reused by all signatures on a thread, so that building the string to sign
+    // doesn't allocate once the buffers have grown to fit the typical request.
+    struct SignatureBuffers
+    {
+      std::string StringToSign;
+      // Lowercased query parameters. Only the first QueryCount entries are in use, the others
+      // keep their capacity for later requests.
+      std::vector<std::pair<std::string, std::string>> Query;
+      std::size_t QueryCount = 0;
+    };
+  } // namespace
+
   std::string SharedKeyPolicy::GetSignature(const Core::Http::Request& request) const
   {
-    std::string string_to_sign;
-    string_to_sign += Azure::Core::Http::HttpMethodToString(request.GetMethod()) + "\n";
+    thread_local SignatureBuffers buffers;
+    std::string& string_to_sign = buffers.StringToSign;
+    string_to_sign.clear();
+
+    string_to_sign += Azure::Core::Http::HttpMethodToString(request.GetMethod());
+    string_to_sign += '\n';
 
     const auto& headers = request.GetHeaders();
-    for (std::string headerName :
-         {"Content-Encoding",
-          "Content-Language",
-          "Content-Length",
-          "Content-MD5",
-          "Content-Type",
-          "Date",
-          "If-Modified-Since",
-          "If-Match",
-          "If-None-Match",
-          "If-Unmodified-Since",
-          "Range"})
+    for (const char* headerName : c_signedHeaders)
     {
-      auto ite = headers.find(Azure::Core::Details::ToLower(headerName));
+      auto ite = headers.find(headerName);
       if (ite != headers.end())
       {
-        if (headerName == "Content-Length" && ite->second == "0")
+        if (std::strcmp(headerName, "content-length") == 0 && ite->second == "0")
         {
           // do nothing
         }
@@ -41,49 +66,74 @@ namespace Azure { namespace Storage {
           string_to_sign += ite->second;
         }
       }
-      string_to_sign += "\n";
+      string_to_sign += '\n';
     }
 
-    // canonicalized headers
-    const std::string prefix = "x-ms-";
-    std::vector<std::pair<std::string, std::string>> ordered_kv;
+    // canonicalized headers, the keys of the request headers are already lowercased and sorted
+    const char prefix[] = "x-ms-";
+    const std::size_t prefixLength = sizeof(prefix) - 1;
     for (auto ite = headers.lower_bound(prefix);
-         ite != headers.end() && ite->first.substr(0, prefix.length()) == prefix;
+         ite != headers.end() && ite->first.compare(0, prefixLength, prefix) == 0;
          ++ite)
     {
-      std::string key = ite->first;
-      std::transform(key.begin(), key.end(), key.begin(), [](char c) {
-        return static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
-      });
-      ordered_kv.emplace_back(std::make_pair(std::move(key), ite->second));
+      string_to_sign += ite->first;
+      string_to_sign += ':';
+      string_to_sign += ite->second;
+      string_to_sign += '\n';
     }
-    std::sort(ordered_kv.begin(), ordered_kv.end());
-    for (const auto& p : ordered_kv)
+
+    // canonicalized resource, the url is split the same way as UriBuilder does
+    const std::string url = request.GetEncodedUrl();
+    std::size_t pos = url.find("://");
+    pos = pos == std::string::npos ? 0 : pos + 3;
+    pos = url.find_first_of("/?", pos);
+    std::size_t queryStart = pos == std::string::npos ? pos : url.find('?', pos);
+    string_to_sign += '/';
+    string_to_sign += m_credential->AccountName;
+    string_to_sign += '/';
+    if (pos != std::string::npos && url[pos] == '/')
     {
-      string_to_sign += p.first + ":" + p.second + "\n";
+      string_to_sign.append(
+          url, pos + 1, (queryStart == std::string::npos ? url.length() : queryStart) - pos - 1);
     }
-    ordered_kv.clear();
+    string_to_sign += '\n';
 
-    // canonicalized resource
-    UriBuilder resourceUrl(request.GetEncodedUrl());
-    string_to_sign += "/" + m_credential->AccountName + "/" + resourceUrl.GetPath() + "\n";
-    for (const auto& query : resourceUrl.GetQuery())
+    auto& query = buffers.Query;
+    buffers.QueryCount = 0;
+    if (queryStart != std::string::npos)
     {
-      std::string key = query.first;
-      std::transform(key.begin(), key.end(), key.begin(), [](char c) {
-        return static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
-      });
-      ordered_kv.emplace_back(std::make_pair(std::move(key), query.second));
+      std::size_t queryEnd = std::min(url.find('#', queryStart), url.length());
+      std::size_t cur = queryStart + 1;
+      while (cur < queryEnd)
+      {
+        std::size_t paramEnd = std::min(url.find('&', cur), queryEnd);
+        std::size_t keyEnd = std::min(url.find('=', cur), paramEnd);
+        std::size_t valueStart = std::min(keyEnd + 1, paramEnd);
+        if (buffers.QueryCount == query.size())
+        {
+          query.emplace_back();
+        }
+        auto& param = query[buffers.QueryCount++];
+        param.first.assign(url, cur, keyEnd - cur);
+        std::transform(param.first.begin(), param.first.end(), param.first.begin(), [](char c) {
+          return static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+        });
+        param.second.assign(url, valueStart, paramEnd - valueStart);
+        cur = paramEnd + 1;
+      }
     }
-    std::sort(ordered_kv.begin(), ordered_kv.end());
-    for (const auto& p : ordered_kv)
+    std::sort(query.begin(), query.begin() + buffers.QueryCount);
+    for (std::size_t i = 0; i < buffers.QueryCount; ++i)
     {
-      string_to_sign += p.first + ":" + p.second + "\n";
+      string_to_sign += query[i].first;
+      string_to_sign += ':';
+      string_to_sign += query[i].second;
+      string_to_sign += '\n';
     }
 
     // remove last linebreak
     string_to_sign.pop_back();
 
-    return Base64Encode(Hmac_Sha256(string_to_sign, Base64Decode(m_credential->GetAccountKey())));
+    return Base64Encode(m_credential->GetSigningKey()->Sign(string_to_sign));
   }
 }} // namespace Azure::Storage
@@ -0,0 +1,198 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include "common/transfer_checkpoint.hpp"
+
+#include <algorithm>
+#include <cinttypes>
+#include <stdexcept>
+
+namespace Azure { namespace Storage { namespace Details {
+
+  namespace {
+    const char c_journalSignature[] = "azure-storage-checkpoint/1 ";
+
+    std::string ReadFile(const std::string& path)
+    {
+      std::string content;
+      std::FILE* file = std::fopen(path.data(), "rb");
+      if (file == nullptr)
+      {
+        return content;
+      }
+      char buffer[4096];
+      std::size_t bytesRead;
+      while ((bytesRead = std::fread(buffer, 1, sizeof(buffer), file)) > 0)
+      {
+        content.append(buffer, bytesRead);
+      }
+      std::fclose(file);
+      return content;
+    }
+
+    // Parses "<offset> <length> <id>". Returns false if the line is malformed.
+    bool ParseChunk(const std::string& line, TransferCheckpoint::Chunk& chunk)
+    {
+      std::size_t lengthStart = line.find(' ');
+      std::size_t idStart
+          = lengthStart == std::string::npos ? lengthStart : line.find(' ', lengthStart + 1);
+      if (idStart == std::string::npos)
+      {
+        return false;
+      }
+      try
+      {
+        std::size_t parsed;
+        chunk.Offset = std::stoll(line.substr(0, lengthStart), &parsed);
+        if (parsed != lengthStart)
+        {
+          return false;
+        }
+        const std::size_t lengthSize = idStart - lengthStart - 1;
+        chunk.Length = std::stoll(line.substr(lengthStart + 1, lengthSize), &parsed);
+        if (parsed != lengthSize)
+        {
+          return false;
+        }
+      }
+      catch (std::exception&)
+      {
+        return false;
+      }
+      chunk.Id = line.substr(idStart + 1);
+      return chunk.Offset >= 0 && chunk.Length > 0;
+    }
+
+    bool WriteChunk(std::FILE* file, const TransferCheckpoint::Chunk& chunk)
+    {
+      return std::fprintf(
+                 file, "%" PRId64 " %" PRId64 " %s\n", chunk.Offset, chunk.Length, chunk.Id.data())
+          >= 0;
+    }
+  } // namespace
+
+  TransferCheckpoint::TransferCheckpoint(std::string path, std::string header)
+      : m_path(std::move(path)), m_header(c_journalSignature + std::move(header))
+  {
+    std::string content = ReadFile(m_path);
+    std::size_t lineEnd = content.find('\n');
+    if (lineEnd != std::string::npos && content.compare(0, lineEnd, m_header) == 0)
+    {
+      // Only complete lines are kept, a line cut short by a crash is ignored.
+      std::size_t lineStart = lineEnd + 1;
+      while ((lineEnd = content.find('\n', lineStart)) != std::string::npos)
+      {
+        Chunk chunk;
+        if (ParseChunk(content.substr(lineStart, lineEnd - lineStart), chunk))
+        {
+          m_completedChunks.push_back(std::move(chunk));
+        }
+        lineStart = lineEnd + 1;
+      }
+    }
+    Rewrite();
+  }
+
+  TransferCheckpoint::~TransferCheckpoint()
+  {
+    if (m_file != nullptr)
+    {
+      std::fclose(m_file);
+    }
+  }
+
+  void TransferCheckpoint::Reset(std::vector<Chunk> chunks)
+  {
+    m_completedChunks = std::move(chunks);
+    Rewrite();
+  }
+
+  void TransferCheckpoint::Rewrite()
+  {
+    if (m_file != nullptr)
+    {
+      std::fclose(m_file);
+    }
+    m_file = std::fopen(m_path.data(), "wb");
+    if (m_file == nullptr)
+    {
+      throw std::runtime_error("failed to open checkpoint file");
+    }
+    bool succeeded = std::fprintf(m_file, "%s\n", m_header.data()) >= 0;
+    for (const auto& chunk : m_completedChunks)
+    {
+      succeeded = succeeded && WriteChunk(m_file, chunk);
+    }
+    if (!succeeded || std::fflush(m_file) != 0)
+    {
+      throw std::runtime_error("failed to write checkpoint file");
+    }
+  }
+
+  void TransferCheckpoint::Record(const Chunk& chunk)
+  {
+    std::lock_guard<std::mutex> guard(m_mutex);
+    if (m_file == nullptr || !WriteChunk(m_file, chunk) || std::fflush(m_file) != 0)
+    {
+      throw std::runtime_error("failed to write checkpoint file");
+    }
+  }
+
+  void TransferCheckpoint::Remove()
+  {
+    std::lock_guard<std::mutex> guard(m_mutex);
+    if (m_file != nullptr)
+    {
+      std::fclose(m_file);
+      m_file = nullptr;
+    }
+    std::remove(m_path.data());
+  }
+
+  std::vector<std::pair<int64_t, int64_t>> GetMissingChunks(
+      int64_t offset,
+      int64_t length,
+      int64_t chunkSize,
+      const std::vector<TransferCheckpoint::Chunk>& completedChunks)
+  {
+    // the completed chunks merged into disjoint ranges of [start, end), in order
+    std::vector<std::pair<int64_t, int64_t>> covered;
+    covered.reserve(completedChunks.size());
+    for (const auto& chunk : completedChunks)
+    {
+      covered.emplace_back(chunk.Offset, chunk.Offset + chunk.Length);
+    }
+    std::sort(covered.begin(), covered.end());
+    std::size_t numCovered = 0;
+    for (const auto& range : covered)
+    {
+      if (numCovered != 0 && range.first <= covered[numCovered - 1].second)
+      {
+        covered[numCovered - 1].second = std::max(covered[numCovered - 1].second, range.second);
+      }
+      else
+      {
+        covered[numCovered++] = range;
+      }
+    }
+    covered.resize(numCovered);
+
+    std::vector<std::pair<int64_t, int64_t>> missingChunks;
+    const int64_t endOffset = offset + length;
+    auto range = covered.begin();
+    for (int64_t chunkOffset = offset; chunkOffset < endOffset; chunkOffset += chunkSize)
+    {
+      int64_t chunkEnd = std::min(chunkOffset + chunkSize, endOffset);
+      while (range != covered.end() && range->second <= chunkOffset)
+      {
+        ++range;
+      }
+      if (range == covered.end() || range->first > chunkOffset || range->second < chunkEnd)
+      {
+        missingChunks.emplace_back(chunkOffset, chunkEnd - chunkOffset);
+      }
+    }
+    return missingChunks;
+  }
+
+}}} // namespace Azure::Storage::Details
@@ -0,0 +1,187 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include "common/transfer_executor.hpp"
+
+#include <algorithm>
+#include <system_error>
+
+namespace Azure { namespace Storage {
+
+  namespace {
+    constexpr int c_defaultMaxConcurrency = 64;
+  }
+
+  TransferExecutor::TransferExecutor(int maxConcurrency)
+      : m_maxConcurrency(std::max(maxConcurrency, 1))
+  {
+  }
+
+  TransferExecutor::~TransferExecutor()
+  {
+    {
+      std::lock_guard<std::mutex> guard(m_mutex);
+      m_stop = true;
+    }
+    m_workerCv.notify_all();
+    for (auto& thread : m_threads)
+    {
+      thread.join();
+    }
+  }
+
+  TransferExecutor& TransferExecutor::Default()
+  {
+    static TransferExecutor executor(c_defaultMaxConcurrency);
+    return executor;
+  }
+
+  void TransferExecutor::SetMaxConcurrency(int maxConcurrency)
+  {
+    {
+      std::lock_guard<std::mutex> guard(m_mutex);
+      m_maxConcurrency = std::max(maxConcurrency, 1);
+    }
+    m_workerCv.notify_all();
+  }
+
+  int TransferExecutor::GetMaxConcurrency() const
+  {
+    std::lock_guard<std::mutex> guard(m_mutex);
+    return m_maxConcurrency;
+  }
+
+  std::shared_ptr<TransferExecutor::Job> TransferExecutor::PickJob()
+  {
+    if (m_runningWorkers >= m_maxConcurrency)
+    {
+      return nullptr;
+    }
+    // The first job with spare parallelism is served and moved to the back, so that operations
+    // take turns.
+    for (auto i = m_jobs.begin(); i != m_jobs.end(); ++i)
+    {
+      auto job = *i;
+      if (job->Active < job->Parallelism())
+      {
+        m_jobs.erase(i);
+        m_jobs.push_back(job);
+        return job;
+      }
+    }
+    return nullptr;
+  }
+
+  void TransferExecutor::Execute(std::unique_lock<std::mutex>& lock, Job& job)
+  {
+    ++job.Active;
+    lock.unlock();
+
+    bool hasMore = false;
+    std::exception_ptr error;
+    try
+    {
+      hasMore = job.Task();
+    }
+    catch (...)
+    {
+      error = std::current_exception();
+    }
+
+    lock.lock();
+    --job.Active;
+    if (hasMore && !error)
+    {
+      // The job may allow more parallelism now, give an idle worker the chance to check.
+      m_workerCv.notify_one();
+    }
+    if (error && !job.Error)
+    {
+      job.Error = error;
+    }
+    if ((!hasMore || error) && !job.Done)
+    {
+      job.Done = true;
+      m_jobs.erase(std::remove_if(
+                       m_jobs.begin(),
+                       m_jobs.end(),
+                       [&job](const std::shared_ptr<Job>& j) { return j.get() == &job; }),
+                   m_jobs.end());
+    }
+    m_jobCv.notify_all();
+  }
+
+  void TransferExecutor::WorkerLoop()
+  {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true)
+    {
+      auto job = PickJob();
+      if (!job)
+      {
+        if (m_stop)
+        {
+          break;
+        }
+        ++m_idleWorkers;
+        m_workerCv.wait(lock);
+        --m_idleWorkers;
+        continue;
+      }
+      ++m_runningWorkers;
+      Execute(lock, *job);
+      --m_runningWorkers;
+    }
+  }
+
+  void TransferExecutor::Run(int parallelism, std::function<bool()> task)
+  {
+    parallelism = std::max(parallelism, 1);
+    Run(parallelism, [parallelism]() { return parallelism; }, std::move(task));
+  }
+
+  void TransferExecutor::Run(
+      int maxParallelism,
+      std::function<int()> currentParallelism,
+      std::function<bool()> task)
+  {
+    auto job = std::make_shared<Job>();
+    job->Task = std::move(task);
+    // The calling thread counts towards the parallelism of its own job.
+    job->Parallelism = std::move(currentParallelism);
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    if (maxParallelism > 1)
+    {
+      m_jobs.push_back(job);
+      int wanted = std::min(maxParallelism - 1, m_maxConcurrency) - m_idleWorkers;
+      while (wanted > 0 && static_cast<int>(m_threads.size()) < m_maxConcurrency)
+      {
+        try
+        {
+          m_threads.emplace_back(&TransferExecutor::WorkerLoop, this);
+        }
+        catch (std::system_error&)
+        {
+          // Out of threads, the calling thread still makes progress on its own.
+          break;
+        }
+        --wanted;
+      }
+      m_workerCv.notify_all();
+    }
+
+    while (!job->Done)
+    {
+      Execute(lock, *job);
+    }
+    m_jobCv.wait(lock, [&job]() { return job->Active == 0; });
+    lock.unlock();
+
+    if (job->Error)
+    {
+      std::rethrow_exception(job->Error);
+    }
+  }
+
+}} // namespace Azure::Storage
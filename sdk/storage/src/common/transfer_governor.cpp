@@ -0,0 +1,121 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include "common/transfer_governor.hpp"
+
+#include <algorithm>
+#include <thread>
+
+namespace Azure { namespace Storage {
+
+  TransferGovernor::Permit& TransferGovernor::Permit::operator=(Permit&& other) noexcept
+  {
+    if (this != &other)
+    {
+      Release();
+      m_governor = other.m_governor;
+      m_bytes = other.m_bytes;
+      other.m_governor = nullptr;
+      other.m_bytes = 0;
+    }
+    return *this;
+  }
+
+  void TransferGovernor::Permit::Release()
+  {
+    if (m_governor != nullptr)
+    {
+      m_governor->Release(m_bytes);
+    }
+    m_governor = nullptr;
+    m_bytes = 0;
+  }
+
+  bool TransferGovernor::CanAdmit(int64_t bytes) const
+  {
+    if (m_inFlightRequests == 0)
+    {
+      return true;
+    }
+    return m_inFlightRequests < m_limits.MaxConcurrentRequests
+        && m_inFlightBytes + bytes <= m_limits.MaxBufferedBytes;
+  }
+
+  TransferGovernor::Permit TransferGovernor::Acquire(int64_t bytes)
+  {
+    bytes = std::max(bytes, int64_t(0));
+    std::chrono::steady_clock::time_point startTime;
+    {
+      std::unique_lock<std::mutex> guard(m_mutex);
+      m_cv.wait(guard, [this, bytes]() { return CanAdmit(bytes); });
+      ++m_inFlightRequests;
+      m_inFlightBytes += bytes;
+
+      // Each chunk reserves the time its bytes take at the configured rate, and starts once the
+      // chunks admitted before it have used up theirs.
+      auto now = std::chrono::steady_clock::now();
+      startTime = std::max(now, m_nextSlot);
+      if (m_limits.MaxBytesPerSecond > 0)
+      {
+        m_nextSlot = startTime
+            + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                         std::chrono::duration<double>(
+                             static_cast<double>(bytes) / m_limits.MaxBytesPerSecond));
+      }
+    }
+
+    Permit permit;
+    permit.m_governor = this;
+    permit.m_bytes = bytes;
+    std::this_thread::sleep_until(startTime);
+    return permit;
+  }
+
+  void TransferGovernor::Release(int64_t bytes)
+  {
+    {
+      std::lock_guard<std::mutex> guard(m_mutex);
+      --m_inFlightRequests;
+      m_inFlightBytes -= bytes;
+    }
+    m_cv.notify_all();
+  }
+
+  void TransferGovernor::SetLimits(const TransferLimits& limits)
+  {
+    {
+      std::lock_guard<std::mutex> guard(m_mutex);
+      m_limits = limits;
+      if (m_limits.MaxBytesPerSecond <= 0)
+      {
+        m_nextSlot = std::chrono::steady_clock::time_point();
+      }
+    }
+    m_cv.notify_all();
+  }
+
+  TransferLimits TransferGovernor::GetLimits() const
+  {
+    std::lock_guard<std::mutex> guard(m_mutex);
+    return m_limits;
+  }
+
+  int64_t TransferGovernor::GetInFlightRequests() const
+  {
+    std::lock_guard<std::mutex> guard(m_mutex);
+    return m_inFlightRequests;
+  }
+
+  int64_t TransferGovernor::GetInFlightBytes() const
+  {
+    std::lock_guard<std::mutex> guard(m_mutex);
+    return m_inFlightBytes;
+  }
+
+  TransferGovernor& TransferGovernor::Default()
+  {
+    static TransferGovernor governor;
+    return governor;
+  }
+
+}} // namespace Azure::Storage
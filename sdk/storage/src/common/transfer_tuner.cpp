@@ -0,0 +1,122 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include "common/transfer_tuner.hpp"
+
+#include <algorithm>
+
+namespace Azure { namespace Storage {
+
+  namespace {
+    // A round must improve on the best throughput by this factor to count as an improvement.
+    constexpr double c_improvementThreshold = 1.05;
+    // The tuner probes again once a round falls below this fraction of the best throughput.
+    constexpr double c_degradationThreshold = 0.7;
+    // Latency growth that, without matching throughput, is taken as congestion.
+    constexpr double c_congestionLatencyFactor = 2.0;
+  } // namespace
+
+  TransferTuner::TransferTuner(const TransferTuningOptions& options)
+      : m_options(options), m_roundStart(std::chrono::steady_clock::now())
+  {
+    m_options.MinChunkSize = std::max(m_options.MinChunkSize, int64_t(1));
+    m_options.MaxChunkSize = std::max(m_options.MaxChunkSize, m_options.MinChunkSize);
+    m_options.MaxConcurrency = std::max(m_options.MaxConcurrency, 1);
+    m_chunkSize = m_options.MinChunkSize;
+    m_bestChunkSize = m_chunkSize;
+  }
+
+  int64_t TransferTuner::GetChunkSize() const
+  {
+    std::lock_guard<std::mutex> guard(m_mutex);
+    return m_chunkSize;
+  }
+
+  int TransferTuner::GetConcurrency() const
+  {
+    std::lock_guard<std::mutex> guard(m_mutex);
+    return m_concurrency;
+  }
+
+  void TransferTuner::OnChunkCompleted(int64_t bytes, std::chrono::steady_clock::duration latency)
+  {
+    std::lock_guard<std::mutex> guard(m_mutex);
+    m_roundBytes += bytes;
+    m_roundLatency += std::chrono::duration<double>(latency).count();
+    ++m_roundChunks;
+
+    // A round lasts until every chunk slot has been used at least twice, which smooths out the
+    // chunks that were issued under the previous setting.
+    if (m_roundChunks < std::max(2, m_concurrency * 2))
+    {
+      return;
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    double seconds = std::chrono::duration<double>(now - m_roundStart).count();
+    double throughput = static_cast<double>(m_roundBytes) / std::max(seconds, 1e-6);
+    // Normalized per byte, so that rounds with different chunk sizes are comparable.
+    double averageLatency = m_roundLatency / static_cast<double>(std::max(m_roundBytes, int64_t(1)));
+
+    m_roundStart = now;
+    m_roundBytes = 0;
+    m_roundChunks = 0;
+    m_roundLatency = 0.0;
+
+    OnRoundCompleted(throughput, averageLatency);
+  }
+
+  void TransferTuner::OnRoundCompleted(double throughput, double averageLatency)
+  {
+    const bool improved = throughput > m_bestThroughput * c_improvementThreshold;
+    if (improved)
+    {
+      m_bestThroughput = throughput;
+      m_bestLatency = averageLatency;
+      m_bestChunkSize = m_chunkSize;
+      m_bestConcurrency = m_concurrency;
+    }
+
+    switch (m_phase)
+    {
+      case Phase::GrowConcurrency:
+        if (improved && m_concurrency < m_options.MaxConcurrency)
+        {
+          m_concurrency = std::min(m_concurrency * 2, m_options.MaxConcurrency);
+        }
+        else
+        {
+          m_concurrency = m_bestConcurrency;
+          m_phase = Phase::GrowChunkSize;
+        }
+        break;
+      case Phase::GrowChunkSize:
+        if (improved && m_chunkSize < m_options.MaxChunkSize)
+        {
+          m_chunkSize = std::min(m_chunkSize * 2, m_options.MaxChunkSize);
+        }
+        else
+        {
+          m_chunkSize = m_bestChunkSize;
+          m_phase = Phase::Steady;
+        }
+        break;
+      case Phase::Steady:
+        if (throughput < m_bestThroughput * c_degradationThreshold)
+        {
+          // Conditions changed. Forget the old optimum and probe again from the current setting,
+          // backing off first if the slowdown came with queueing.
+          if (averageLatency > m_bestLatency * c_congestionLatencyFactor)
+          {
+            m_concurrency = std::max(m_concurrency / 2, 1);
+          }
+          m_bestThroughput = 0.0;
+          m_bestConcurrency = m_concurrency;
+          m_bestChunkSize = m_chunkSize;
+          m_phase = Phase::GrowConcurrency;
+        }
+        break;
+    }
+  }
+
+}} // namespace Azure::Storage
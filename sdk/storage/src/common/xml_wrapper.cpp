@@ -6,6 +6,10 @@
 #include "libxml/xmlreader.h"
 #include "libxml/xmlwriter.h"
 
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
 #include <limits>
 #include <stdexcept>
 
@@ -39,77 +43,380 @@ namespace Azure { namespace Storage {
 
   XmlNode XmlReader::Read()
   {
-    if (m_readingAttributes)
+    // The names and values are owned by the reader and stay valid until the next read.
+    while (true)
     {
-      int ret = xmlTextReaderMoveToNextAttribute(m_reader);
-      if (ret == 1)
+      if (m_readingAttributes)
       {
-        const char* name = reinterpret_cast<const char*>(xmlTextReaderName(m_reader));
-        const char* value = reinterpret_cast<const char*>(xmlTextReaderValue(m_reader));
-        return XmlNode{XmlNodeType::Attribute, name, value};
+        int ret = xmlTextReaderMoveToNextAttribute(m_reader);
+        if (ret == 1)
+        {
+          const char* name = reinterpret_cast<const char*>(xmlTextReaderConstName(m_reader));
+          const char* value = reinterpret_cast<const char*>(xmlTextReaderConstValue(m_reader));
+          return XmlNode{XmlNodeType::Attribute, name, value};
+        }
+        else if (ret == 0)
+        {
+          m_readingAttributes = false;
+        }
+        else
+        {
+          throw std::runtime_error("failed to parse xml");
+        }
       }
-      else if (ret == 0)
+
+      int ret = xmlTextReaderRead(m_reader);
+      if (ret == 0)
       {
-        m_readingAttributes = false;
+        return XmlNode{XmlNodeType::End};
       }
-      else
+      if (ret != 1)
       {
         throw std::runtime_error("failed to parse xml");
       }
+
+      int type = xmlTextReaderNodeType(m_reader);
+      bool is_empty = xmlTextReaderIsEmptyElement(m_reader) == 1;
+      bool has_value = xmlTextReaderHasValue(m_reader) == 1;
+      bool has_attributes = xmlTextReaderHasAttributes(m_reader) == 1;
+
+      const char* name = reinterpret_cast<const char*>(xmlTextReaderConstName(m_reader));
+      const char* value = reinterpret_cast<const char*>(xmlTextReaderConstValue(m_reader));
+
+      if (has_attributes)
+      {
+        m_readingAttributes = true;
+      }
+
+      if (type == XML_READER_TYPE_ELEMENT && is_empty)
+      {
+        return XmlNode{XmlNodeType::SelfClosingTag, name};
+      }
+      else if (type == XML_READER_TYPE_ELEMENT)
+      {
+        return XmlNode{XmlNodeType::StartTag, name};
+      }
+      else if (type == XML_READER_TYPE_END_ELEMENT)
+      {
+        return XmlNode{XmlNodeType::EndTag, name};
+      }
+      else if (type == XML_READER_TYPE_TEXT)
+      {
+        if (has_value)
+        {
+          return XmlNode{XmlNodeType::Text, nullptr, value};
+        }
+      }
+      else if (
+          type == XML_READER_TYPE_SIGNIFICANT_WHITESPACE || type == XML_READER_TYPE_COMMENT)
+      {
+        // silently ignore
+      }
+      else
+      {
+        throw std::runtime_error("unknown type " + std::to_string(type) + " while parsing xml");
+      }
     }
+  }
+
+  namespace {
+    bool IsXmlWhitespace(char c) { return c == ' ' || c == '\t' || c == '\n' || c == '\r'; }
 
-    int ret = xmlTextReaderRead(m_reader);
-    if (ret == 0)
+    const char* SkipXmlWhitespace(const char* begin, const char* end)
     {
-      return XmlNode{XmlNodeType::End};
+      while (begin != end && IsXmlWhitespace(*begin))
+      {
+        ++begin;
+      }
+      return begin;
     }
-    if (ret != 1)
+
+    const char* FindXml(const char* begin, const char* end, const char* pattern)
     {
-      throw std::runtime_error("failed to parse xml");
+      const char* found = std::search(begin, end, pattern, pattern + std::strlen(pattern));
+      if (found == end)
+      {
+        throw std::runtime_error("failed to parse xml, unexpected end of document");
+      }
+      return found;
     }
 
-    int type = xmlTextReaderNodeType(m_reader);
-    bool is_empty = xmlTextReaderIsEmptyElement(m_reader) == 1;
-    bool has_value = xmlTextReaderHasValue(m_reader) == 1;
-    bool has_attributes = xmlTextReaderHasAttributes(m_reader) == 1;
+    bool StartsWith(const char* begin, const char* end, const char* prefix)
+    {
+      std::size_t length = std::strlen(prefix);
+      return static_cast<std::size_t>(end - begin) >= length
+          && std::memcmp(begin, prefix, length) == 0;
+    }
 
-    const char* name = reinterpret_cast<const char*>(xmlTextReaderName(m_reader));
-    const char* value = reinterpret_cast<const char*>(xmlTextReaderValue(m_reader));
+    void AppendUtf8(std::string& output, uint32_t codePoint)
+    {
+      if (codePoint < 0x80)
+      {
+        output += static_cast<char>(codePoint);
+      }
+      else if (codePoint < 0x800)
+      {
+        output += static_cast<char>(0xc0 | (codePoint >> 6));
+        output += static_cast<char>(0x80 | (codePoint & 0x3f));
+      }
+      else if (codePoint < 0x10000)
+      {
+        output += static_cast<char>(0xe0 | (codePoint >> 12));
+        output += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3f));
+        output += static_cast<char>(0x80 | (codePoint & 0x3f));
+      }
+      else if (codePoint < 0x110000)
+      {
+        output += static_cast<char>(0xf0 | (codePoint >> 18));
+        output += static_cast<char>(0x80 | ((codePoint >> 12) & 0x3f));
+        output += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3f));
+        output += static_cast<char>(0x80 | (codePoint & 0x3f));
+      }
+      else
+      {
+        throw std::runtime_error("failed to parse xml, invalid character reference");
+      }
+    }
+  } // namespace
 
-    if (has_attributes)
+  XmlPullNode XmlPullReader::Read()
+  {
+    if (m_attributeCursor)
     {
-      m_readingAttributes = true;
+      m_attributeCursor = SkipXmlWhitespace(m_attributeCursor, m_attributeEnd);
+      if (m_attributeCursor != m_attributeEnd)
+      {
+        return ReadAttribute();
+      }
+      m_attributeCursor = nullptr;
     }
 
-    if (type == XML_READER_TYPE_ELEMENT && is_empty)
+    while (true)
     {
-      return XmlNode{XmlNodeType::SelfClosingTag, name};
+      if (m_cursor == m_end)
+      {
+        if (!m_openTags.empty())
+        {
+          throw std::runtime_error("failed to parse xml, unexpected end of document");
+        }
+        return XmlPullNode{XmlNodeType::End, {}, {}};
+      }
+
+      if (*m_cursor != '<')
+      {
+        const char* textBegin = m_cursor;
+        const void* textEnd = std::memchr(m_cursor, '<', m_end - m_cursor);
+        m_cursor = textEnd ? static_cast<const char*>(textEnd) : m_end;
+        if (SkipXmlWhitespace(textBegin, m_cursor) == m_cursor)
+        {
+          continue;
+        }
+        if (m_openTags.empty())
+        {
+          throw std::runtime_error("failed to parse xml, text outside of the root element");
+        }
+        return XmlPullNode{XmlNodeType::Text, {}, Decode(textBegin, m_cursor)};
+      }
+
+      if (StartsWith(m_cursor, m_end, "<?"))
+      {
+        m_cursor = FindXml(m_cursor, m_end, "?>") + 2;
+        continue;
+      }
+      if (StartsWith(m_cursor, m_end, "<!--"))
+      {
+        m_cursor = FindXml(m_cursor, m_end, "-->") + 3;
+        continue;
+      }
+      if (StartsWith(m_cursor, m_end, "<![CDATA["))
+      {
+        const char* textBegin = m_cursor + 9;
+        const char* textEnd = FindXml(textBegin, m_end, "]]>");
+        m_cursor = textEnd + 3;
+        if (textBegin == textEnd)
+        {
+          continue;
+        }
+        return XmlPullNode{
+            XmlNodeType::Text, {}, {textBegin, static_cast<std::size_t>(textEnd - textBegin)}};
+      }
+      if (StartsWith(m_cursor, m_end, "<!"))
+      {
+        throw std::runtime_error("failed to parse xml, document type declarations not supported");
+      }
+
+      if (StartsWith(m_cursor, m_end, "</"))
+      {
+        const char* nameBegin = m_cursor + 2;
+        const char* tagEnd = FindXml(nameBegin, m_end, ">");
+        const char* nameEnd = tagEnd;
+        while (nameEnd != nameBegin && IsXmlWhitespace(nameEnd[-1]))
+        {
+          --nameEnd;
+        }
+        XmlStringView name{nameBegin, static_cast<std::size_t>(nameEnd - nameBegin)};
+        if (m_openTags.empty() || m_openTags.back().Length != name.Length
+            || std::memcmp(m_openTags.back().Data, name.Data, name.Length) != 0)
+        {
+          throw std::runtime_error("failed to parse xml, mismatched end tag");
+        }
+        m_openTags.pop_back();
+        m_cursor = tagEnd + 1;
+        return XmlPullNode{XmlNodeType::EndTag, name, {}};
+      }
+
+      const char* nameBegin = m_cursor + 1;
+      const char* nameEnd = nameBegin;
+      while (nameEnd != m_end && !IsXmlWhitespace(*nameEnd) && *nameEnd != '/'
+             && *nameEnd != '>')
+      {
+        ++nameEnd;
+      }
+      if (nameEnd == nameBegin)
+      {
+        throw std::runtime_error("failed to parse xml, invalid start tag");
+      }
+      // Attribute values may contain '>', so the end of the tag is looked for outside of them.
+      const char* tagEnd = nameEnd;
+      while (true)
+      {
+        if (tagEnd == m_end)
+        {
+          throw std::runtime_error("failed to parse xml, unexpected end of document");
+        }
+        if (*tagEnd == '"' || *tagEnd == '\'')
+        {
+          const char quote[] = {*tagEnd, '\0'};
+          tagEnd = FindXml(tagEnd + 1, m_end, quote);
+        }
+        else if (*tagEnd == '>')
+        {
+          break;
+        }
+        ++tagEnd;
+      }
+      m_cursor = tagEnd + 1;
+      bool selfClosing = tagEnd[-1] == '/' && tagEnd - 1 >= nameEnd;
+      const char* attributesEnd = selfClosing ? tagEnd - 1 : tagEnd;
+      if (SkipXmlWhitespace(nameEnd, attributesEnd) != attributesEnd)
+      {
+        m_attributeCursor = nameEnd;
+        m_attributeEnd = attributesEnd;
+      }
+      XmlStringView name{nameBegin, static_cast<std::size_t>(nameEnd - nameBegin)};
+      if (selfClosing)
+      {
+        return XmlPullNode{XmlNodeType::SelfClosingTag, name, {}};
+      }
+      m_openTags.push_back(name);
+      return XmlPullNode{XmlNodeType::StartTag, name, {}};
     }
-    else if (type == XML_READER_TYPE_ELEMENT)
+  }
+
+  XmlPullNode XmlPullReader::ReadAttribute()
+  {
+    const char* nameBegin = m_attributeCursor;
+    const char* nameEnd = nameBegin;
+    while (nameEnd != m_attributeEnd && !IsXmlWhitespace(*nameEnd) && *nameEnd != '=')
     {
-      return XmlNode{XmlNodeType::StartTag, name};
+      ++nameEnd;
     }
-    else if (type == XML_READER_TYPE_END_ELEMENT)
+    const char* valueBegin = SkipXmlWhitespace(nameEnd, m_attributeEnd);
+    if (nameEnd == nameBegin || valueBegin == m_attributeEnd || *valueBegin != '=')
     {
-      return XmlNode{XmlNodeType::EndTag, name};
+      throw std::runtime_error("failed to parse xml, invalid attribute");
     }
-    else if (type == XML_READER_TYPE_TEXT)
+    valueBegin = SkipXmlWhitespace(valueBegin + 1, m_attributeEnd);
+    if (valueBegin == m_attributeEnd || (*valueBegin != '"' && *valueBegin != '\''))
     {
-      if (has_value)
-      {
-        return XmlNode{XmlNodeType::Text, nullptr, value};
-      }
+      throw std::runtime_error("failed to parse xml, invalid attribute");
     }
-    else if (type == XML_READER_TYPE_SIGNIFICANT_WHITESPACE)
+    const char quote = *valueBegin++;
+    const char* valueEnd = std::find(valueBegin, m_attributeEnd, quote);
+    if (valueEnd == m_attributeEnd)
     {
-      // silently ignore
+      throw std::runtime_error("failed to parse xml, invalid attribute");
     }
-    else
+    m_attributeCursor = valueEnd + 1;
+    return XmlPullNode{XmlNodeType::Attribute,
+                       {nameBegin, static_cast<std::size_t>(nameEnd - nameBegin)},
+                       Decode(valueBegin, valueEnd)};
+  }
+
+  XmlStringView XmlPullReader::Decode(const char* begin, const char* end)
+  {
+    const char* special
+        = std::find_if(begin, end, [](char c) { return c == '&' || c == '\r'; });
+    if (special == end)
     {
-      throw std::runtime_error("unknown type " + std::to_string(type) + " while parsing xml");
+      return XmlStringView{begin, static_cast<std::size_t>(end - begin)};
     }
 
-    return Read();
+    m_decoded.assign(begin, special);
+    while (special != end)
+    {
+      if (*special == '\r')
+      {
+        // line breaks are normalized to \n
+        m_decoded += '\n';
+        ++special;
+        if (special != end && *special == '\n')
+        {
+          ++special;
+        }
+      }
+      else
+      {
+        const char* referenceEnd = std::find(special, end, ';');
+        if (referenceEnd == end)
+        {
+          throw std::runtime_error("failed to parse xml, invalid entity reference");
+        }
+        std::string reference(special + 1, referenceEnd);
+        if (reference == "lt")
+        {
+          m_decoded += '<';
+        }
+        else if (reference == "gt")
+        {
+          m_decoded += '>';
+        }
+        else if (reference == "amp")
+        {
+          m_decoded += '&';
+        }
+        else if (reference == "quot")
+        {
+          m_decoded += '"';
+        }
+        else if (reference == "apos")
+        {
+          m_decoded += '\'';
+        }
+        else if (reference.length() > 1 && reference[0] == '#')
+        {
+          bool hex = reference[1] == 'x';
+          const char* digits = reference.data() + (hex ? 2 : 1);
+          char* digitsEnd = nullptr;
+          unsigned long codePoint = std::strtoul(digits, &digitsEnd, hex ? 16 : 10);
+          if (*digits == '\0' || *digitsEnd != '\0' || codePoint == 0)
+          {
+            throw std::runtime_error("failed to parse xml, invalid character reference");
+          }
+          AppendUtf8(m_decoded, static_cast<uint32_t>(std::min(codePoint, 0x110000UL)));
+        }
+        else
+        {
+          throw std::runtime_error("failed to parse xml, unknown entity &" + reference + ";");
+        }
+        special = referenceEnd + 1;
+      }
+      const char* next
+          = std::find_if(special, end, [](char c) { return c == '&' || c == '\r'; });
+      m_decoded.append(special, next);
+      special = next;
+    }
+    return XmlStringView{m_decoded.data(), m_decoded.length()};
   }
 
   XmlWriter::XmlWriter()
@@ -100,4 +100,39 @@ namespace Azure { namespace Storage { namespace Files { namespace DataLake { nam
     }
     return std::string(begin, end);
   }
+
+  std::string DecodePath(const std::string& path)
+  {
+    auto hexValue = [](char c) {
+      if (c >= '0' && c <= '9')
+      {
+        return c - '0';
+      }
+      if (c >= 'a' && c <= 'f')
+      {
+        return c - 'a' + 10;
+      }
+      if (c >= 'A' && c <= 'F')
+      {
+        return c - 'A' + 10;
+      }
+      return -1;
+    };
+    std::string result;
+    result.reserve(path.length());
+    for (std::size_t i = 0; i < path.length(); ++i)
+    {
+      if (path[i] == '%' && i + 2 < path.length() && hexValue(path[i + 1]) >= 0
+          && hexValue(path[i + 2]) >= 0)
+      {
+        result += static_cast<char>(hexValue(path[i + 1]) * 16 + hexValue(path[i + 2]));
+        i += 2;
+      }
+      else
+      {
+        result += path[i];
+      }
+    }
+    return result;
+  }
 }}}}} // namespace Azure::Storage::Files::DataLake::Details
@@ -8,17 +8,146 @@
 #include "common/crypt.hpp"
 #include "common/shared_key_policy.hpp"
 #include "common/storage_common.hpp"
+#include "common/storage_error.hpp"
 #include "common/storage_version.hpp"
+#include "common/transfer_executor.hpp"
 #include "credentials/policy/policies.hpp"
 #include "datalake/datalake_utilities.hpp"
 #include "datalake/file_client.hpp"
 #include "http/curl/curl.hpp"
 
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
 #include <limits>
+#include <mutex>
+#include <thread>
 #include <utility> //std::pair
 
 namespace Azure { namespace Storage { namespace Files { namespace DataLake {
 
+  namespace {
+    // Shards are discovered a level of directories at a time, until there are enough of them to
+    // keep every request busy as they finish unevenly.
+    constexpr int c_maxDiscoveryLevels = 2;
+    constexpr std::size_t c_shardsPerThread = 4;
+    // A directory is only split into its children if it has at most this many, since every file
+    // among them becomes a request of its own.
+    constexpr int32_t c_maxSplitChildren = 256;
+    constexpr int c_maxAccessControlAttempts = 3;
+    constexpr std::chrono::milliseconds c_copyPollInterval(500);
+
+    bool HasContinuation(const Azure::Core::Nullable<std::string>& continuation)
+    {
+      return continuation.HasValue() && !continuation.GetValue().empty();
+    }
+
+    // Items of a crawl, which runs on up to concurrency threads until no item is left, as
+    // processing an item may push more. The parallelism of the crawl follows the number of items
+    // queued and in flight, so that the shared executor's workers never wait for items: one that
+    // finds the queue empty returns, and only the calling thread waits for the items in flight to
+    // push more or to finish.
+    template <class Item> class WorkQueue {
+    public:
+      explicit WorkQueue(std::deque<Item> items) : m_items(std::move(items)) {}
+
+      void Push(Item item)
+      {
+        {
+          std::lock_guard<std::mutex> guard(m_mutex);
+          m_items.push_back(std::move(item));
+        }
+        m_cv.notify_one();
+      }
+
+      void Run(int concurrency, const std::function<void(Item item)>& process)
+      {
+        concurrency = std::max(concurrency, 1);
+        const std::thread::id callingThread = std::this_thread::get_id();
+        auto finishItem = [&]() {
+          {
+            std::lock_guard<std::mutex> guard(m_mutex);
+            --m_inFlight;
+          }
+          m_cv.notify_all();
+        };
+        TransferExecutor::Default().Run(
+            concurrency,
+            [&]() {
+              std::lock_guard<std::mutex> guard(m_mutex);
+              const std::size_t pending = m_items.size() + static_cast<std::size_t>(m_inFlight);
+              return std::max(
+                  static_cast<int>(std::min(pending, static_cast<std::size_t>(concurrency))), 1);
+            },
+            [&]() {
+              Item item;
+              {
+                std::unique_lock<std::mutex> guard(m_mutex);
+                if (std::this_thread::get_id() == callingThread)
+                {
+                  m_cv.wait(guard, [&]() { return !m_items.empty() || m_inFlight == 0; });
+                }
+                if (m_items.empty())
+                {
+                  // The crawl is over once nothing is in flight either.
+                  return m_inFlight != 0;
+                }
+                item = std::move(m_items.front());
+                m_items.pop_front();
+                ++m_inFlight;
+              }
+              try
+              {
+                process(std::move(item));
+              }
+              catch (...)
+              {
+                finishItem();
+                throw;
+              }
+              finishItem();
+              return true;
+            });
+      }
+
+    private:
+      std::mutex m_mutex;
+      std::condition_variable m_cv;
+      std::deque<Item> m_items;
+      int m_inFlight = 0;
+    };
+
+    std::vector<Acl> ChangeAcls(
+        std::vector<Acl> acls,
+        const std::vector<Acl>& changes,
+        PathSetAccessControlRecursiveMode mode)
+    {
+      for (const auto& change : changes)
+      {
+        auto existing = std::find_if(acls.begin(), acls.end(), [&](const Acl& acl) {
+          return acl.Scope == change.Scope && acl.Type == change.Type && acl.Id == change.Id;
+        });
+        if (mode == PathSetAccessControlRecursiveMode::Remove)
+        {
+          if (existing != acls.end())
+          {
+            acls.erase(existing);
+          }
+        }
+        else if (existing != acls.end())
+        {
+          existing->Permissions = change.Permissions;
+        }
+        else
+        {
+          acls.push_back(change);
+        }
+      }
+      return acls;
+    }
+  } // namespace
+
   DirectoryClient DirectoryClient::CreateFromConnectionString(
       const std::string& connectionString,
       const std::string& fileSystemName,
@@ -181,4 +310,392 @@ namespace Azure { namespace Storage { namespace Files { namespace DataLake {
     return DataLakeRestClient::Path::Delete(
         m_dfsUri.ToString(), *m_pipeline, options.Context, protocolLayerOptions);
   }
+
+  Azure::Core::Response<DirectoryRenameInfo> DirectoryClient::MoveTo(
+      const std::string& destinationDirectoryPath,
+      const DirectoryRenameOptions& options) const
+  {
+    DirectoryRenameOptions renameOptions = options;
+    while (true)
+    {
+      auto result = Rename(destinationDirectoryPath, renameOptions);
+      if (!HasContinuation(result->Continuation))
+      {
+        return result;
+      }
+      renameOptions.Continuation = result->Continuation;
+    }
+  }
+
+  DirectoryCopyResult DirectoryClient::CopyTo(
+      const std::string& destinationDirectoryPath,
+      const DirectoryCopyOptions& options) const
+  {
+    struct CopyItem
+    {
+      std::string Path;
+      bool IsDirectory = true;
+      Azure::Core::Nullable<std::string> Continuation;
+    };
+
+    const auto& currentPath = m_dfsUri.GetPath();
+    std::string::const_iterator cur = currentPath.begin();
+    Details::GetSubstringTillDelimiter('/', currentPath, cur);
+    const std::string sourcePath = Details::DecodePath(std::string(cur, currentPath.end()));
+    auto getDestinationClient = [&](const std::string& path) {
+      return GetFileSystemPathClient(
+          destinationDirectoryPath + path.substr(std::min(sourcePath.length(), path.length())));
+    };
+
+    PathCreateOptions createOptions;
+    createOptions.Context = options.Context;
+    GetFileSystemPathClient(destinationDirectoryPath).Create(createOptions);
+
+    DirectoryCopyResult result;
+    result.DirectoriesCopied = 1;
+    std::mutex resultMutex;
+    // source paths of the files whose copy hasn't completed yet
+    std::vector<std::string> pendingCopies;
+    CopyItem root;
+    root.Path = sourcePath;
+    WorkQueue<CopyItem> queue(std::deque<CopyItem>(1, std::move(root)));
+    queue.Run(options.Concurrency, [&](CopyItem item) {
+      if (item.IsDirectory)
+      {
+        DataLakeRestClient::FileSystem::ListPathsOptions protocolLayerOptions;
+        protocolLayerOptions.Directory = item.Path;
+        protocolLayerOptions.Continuation = item.Continuation;
+        auto response = ListFileSystemPaths(protocolLayerOptions, options.Context);
+        if (HasContinuation(response->Continuation))
+        {
+          item.Continuation = response->Continuation;
+          queue.Push(item);
+        }
+        int64_t directoriesCopied = 0;
+        for (auto& path : response->Paths)
+        {
+          CopyItem child;
+          child.Path = std::move(path.Name);
+          child.IsDirectory = path.IsDirectory.HasValue() && path.IsDirectory.GetValue();
+          // A directory exists before anything beneath it is copied.
+          if (child.IsDirectory)
+          {
+            getDestinationClient(child.Path).Create(createOptions);
+            ++directoriesCopied;
+          }
+          queue.Push(std::move(child));
+        }
+        std::lock_guard<std::mutex> guard(resultMutex);
+        result.DirectoriesCopied += directoriesCopied;
+        return;
+      }
+
+      Blobs::StartCopyFromUriOptions copyOptions;
+      copyOptions.Context = options.Context;
+      auto copyStatus = getDestinationClient(item.Path)
+                            .m_blobClient
+                            .StartCopyFromUri(
+                                GetFileSystemPathClient(item.Path).m_blobClient.GetUri(),
+                                copyOptions)
+                            ->CopyStatus;
+      std::lock_guard<std::mutex> guard(resultMutex);
+      if (copyStatus == Blobs::CopyStatus::Pending)
+      {
+        pendingCopies.push_back(std::move(item.Path));
+        return;
+      }
+      if (copyStatus != Blobs::CopyStatus::Success)
+      {
+        throw std::runtime_error("failed to copy " + item.Path);
+      }
+      ++result.FilesCopied;
+    });
+
+    // The copies still pending are polled in rounds, and the calling thread waits between them,
+    // so that no worker of the shared executor sleeps.
+    Blobs::GetBlobPropertiesOptions getPropertiesOptions;
+    getPropertiesOptions.Context = options.Context;
+    while (!pendingCopies.empty())
+    {
+      std::this_thread::sleep_for(c_copyPollInterval);
+      WorkQueue<std::string> pollQueue(
+          std::deque<std::string>(pendingCopies.begin(), pendingCopies.end()));
+      pendingCopies.clear();
+      pollQueue.Run(options.Concurrency, [&](std::string path) {
+        auto properties
+            = getDestinationClient(path).m_blobClient.GetProperties(getPropertiesOptions);
+        auto copyStatus = properties->CopyStatus.HasValue() ? properties->CopyStatus.GetValue()
+                                                            : Blobs::CopyStatus::Success;
+        std::lock_guard<std::mutex> guard(resultMutex);
+        if (copyStatus == Blobs::CopyStatus::Pending)
+        {
+          pendingCopies.push_back(std::move(path));
+          return;
+        }
+        if (copyStatus != Blobs::CopyStatus::Success)
+        {
+          throw std::runtime_error("failed to copy " + path);
+        }
+        ++result.FilesCopied;
+      });
+    }
+    return result;
+  }
+
+  void DirectoryClient::ListPaths(
+      const std::function<void(std::vector<Path> paths)>& sink,
+      const DirectoryListPathsOptions& options) const
+  {
+    const auto& currentPath = m_dfsUri.GetPath();
+    std::string::const_iterator cur = currentPath.begin();
+    Details::GetSubstringTillDelimiter('/', currentPath, cur);
+
+    // Each directory is listed on its own, unless a single request at a time can be sent, which
+    // lists the whole tree at once.
+    DataLakeRestClient::FileSystem::ListPathsOptions rootOptions;
+    rootOptions.Upn = options.UserPrincipalName;
+    rootOptions.MaxResults = options.MaxResults;
+    rootOptions.Directory = Details::DecodePath(std::string(cur, currentPath.end()));
+    rootOptions.RecursiveRequired = options.Concurrency <= 1;
+
+    std::mutex sinkMutex;
+    using ListItem = DataLakeRestClient::FileSystem::ListPathsOptions;
+    WorkQueue<ListItem> queue(std::deque<ListItem>(1, rootOptions));
+    queue.Run(options.Concurrency, [&](ListItem protocolLayerOptions) {
+      auto response = ListFileSystemPaths(protocolLayerOptions, options.Context);
+      if (HasContinuation(response->Continuation))
+      {
+        ListItem next = protocolLayerOptions;
+        next.Continuation = response->Continuation;
+        queue.Push(std::move(next));
+      }
+      if (!protocolLayerOptions.RecursiveRequired)
+      {
+        for (const auto& path : response->Paths)
+        {
+          if (path.IsDirectory.HasValue() && path.IsDirectory.GetValue())
+          {
+            ListItem child = rootOptions;
+            child.Directory = path.Name;
+            queue.Push(std::move(child));
+          }
+        }
+      }
+      if (!response->Paths.empty())
+      {
+        std::lock_guard<std::mutex> guard(sinkMutex);
+        sink(std::move(response->Paths));
+      }
+    });
+  }
+
+  DirectorySetAccessControlRecursiveResult DirectoryClient::SetAccessControlRecursive(
+      PathSetAccessControlRecursiveMode mode,
+      std::vector<Acl> acls,
+      const DirectorySetAccessControlRecursiveOptions& options) const
+  {
+    const std::string aclString = Acl::SerializeAcls(acls);
+    std::vector<AccessControlRecursiveShard> shards = options.ResumeShards;
+    if (shards.empty())
+    {
+      shards = DiscoverAccessControlShards(options.Concurrency, options.Context);
+    }
+
+    // The access control of a directory split into shards is changed on its own, the way the
+    // service changes it for each path.
+    auto changeAccessControl = [&](const DirectoryClient& client) {
+      SetAccessControlOptions setOptions;
+      setOptions.Context = options.Context;
+      if (mode == PathSetAccessControlRecursiveMode::Set)
+      {
+        client.SetAccessControl(acls, setOptions);
+        return;
+      }
+      PathAccessControlOptions getOptions;
+      getOptions.Context = options.Context;
+      for (int attempt = 1;; ++attempt)
+      {
+        auto accessControl = client.GetAccessControls(getOptions);
+        setOptions.AccessConditions.IfMatch = accessControl->ETag;
+        try
+        {
+          client.SetAccessControl(ChangeAcls(accessControl->Acls, acls, mode), setOptions);
+          return;
+        }
+        catch (Azure::Storage::StorageError& e)
+        {
+          // Someone else changed it in between.
+          if (e.StatusCode != Azure::Core::Http::HttpStatusCode::PreconditionFailed
+              || attempt == c_maxAccessControlAttempts)
+          {
+            throw;
+          }
+        }
+      }
+    };
+
+    DirectorySetAccessControlRecursiveResult result;
+    std::mutex resultMutex;
+    WorkQueue<AccessControlRecursiveShard> queue(
+        std::deque<AccessControlRecursiveShard>(shards.begin(), shards.end()));
+    queue.Run(options.Concurrency, [&](AccessControlRecursiveShard shard) {
+      AccessControlRecursiveProgress progress;
+      progress.Shard = shard;
+      try
+      {
+        auto client = GetFileSystemPathClient(shard.Path);
+        if (shard.Recursive)
+        {
+          DataLakeRestClient::Path::SetAccessControlRecursiveOptions protocolLayerOptions;
+          protocolLayerOptions.Continuation = shard.Continuation;
+          protocolLayerOptions.Mode = mode;
+          protocolLayerOptions.MaxRecords = options.BatchSize;
+          protocolLayerOptions.Acl = aclString;
+          auto response = DataLakeRestClient::Path::SetAccessControlRecursive(
+              client.m_dfsUri.ToString(), *m_pipeline, options.Context, protocolLayerOptions);
+          progress.DirectoriesSuccessful = response->DirectoriesSuccessful;
+          progress.FilesSuccessful = response->FilesSuccessful;
+          progress.FailureCount = response->FailureCount;
+          progress.FailedEntries = std::move(response->FailedEntries);
+          progress.Shard.Continuation = HasContinuation(response->Continuation)
+              ? response->Continuation
+              : Azure::Core::Nullable<std::string>();
+        }
+        else
+        {
+          changeAccessControl(client);
+          progress.DirectoriesSuccessful = 1;
+        }
+      }
+      catch (std::exception& e)
+      {
+        std::lock_guard<std::mutex> guard(resultMutex);
+        if (result.ErrorMessage.empty())
+        {
+          result.ErrorMessage = e.what();
+        }
+        result.PendingShards.push_back(std::move(shard));
+        return;
+      }
+
+      // The next batch of the shard is queued behind the other shards.
+      if (progress.Shard.Continuation.HasValue())
+      {
+        queue.Push(progress.Shard);
+      }
+      std::lock_guard<std::mutex> guard(resultMutex);
+      result.DirectoriesSuccessful += progress.DirectoriesSuccessful;
+      result.FilesSuccessful += progress.FilesSuccessful;
+      result.FailureCount += progress.FailureCount;
+      result.FailedEntries.insert(
+          result.FailedEntries.end(), progress.FailedEntries.begin(), progress.FailedEntries.end());
+      // The rest of the tree beneath a failed path was changed, resuming only retries the path.
+      for (const auto& failedEntry : progress.FailedEntries)
+      {
+        AccessControlRecursiveShard failedShard;
+        failedShard.Path = failedEntry.Name;
+        failedShard.Recursive = false;
+        result.PendingShards.push_back(std::move(failedShard));
+      }
+      if (options.ProgressHandler)
+      {
+        options.ProgressHandler(progress);
+      }
+    });
+    return result;
+  }
+
+  DirectoryClient DirectoryClient::GetFileSystemPathClient(const std::string& path) const
+  {
+    const auto& currentPath = m_dfsUri.GetPath();
+    std::string::const_iterator cur = currentPath.begin();
+    const std::string fileSystemName = Details::GetSubstringTillDelimiter('/', currentPath, cur);
+    auto builder = m_dfsUri;
+    builder.SetPath(fileSystemName);
+    builder.AppendPath(path, true);
+    auto blobClient = m_blobClient;
+    blobClient.m_blobUrl.SetPath(fileSystemName);
+    blobClient.m_blobUrl.AppendPath(path, true);
+    return DirectoryClient(std::move(builder), std::move(blobClient), m_pipeline);
+  }
+
+  Azure::Core::Response<FileSystemListPathsResponse> DirectoryClient::ListFileSystemPaths(
+      DataLakeRestClient::FileSystem::ListPathsOptions protocolLayerOptions,
+      const Azure::Core::Context& context) const
+  {
+    const auto& currentPath = m_dfsUri.GetPath();
+    std::string::const_iterator cur = currentPath.begin();
+    auto fileSystemUri = m_dfsUri;
+    fileSystemUri.SetPath(Details::GetSubstringTillDelimiter('/', currentPath, cur));
+    return DataLakeRestClient::FileSystem::ListPaths(
+        fileSystemUri.ToString(), *m_pipeline, context, protocolLayerOptions);
+  }
+
+  std::vector<AccessControlRecursiveShard> DirectoryClient::DiscoverAccessControlShards(
+      int concurrency,
+      const Azure::Core::Context& context) const
+  {
+    const auto& currentPath = m_dfsUri.GetPath();
+    std::string::const_iterator cur = currentPath.begin();
+    Details::GetSubstringTillDelimiter('/', currentPath, cur);
+
+    const std::size_t targetShards
+        = static_cast<std::size_t>(std::max(concurrency, 1)) * c_shardsPerThread;
+    std::vector<AccessControlRecursiveShard> shards;
+    std::vector<std::string> frontier{Details::DecodePath(std::string(cur, currentPath.end()))};
+    for (int level = 0; level < c_maxDiscoveryLevels && concurrency > 1; ++level)
+    {
+      std::vector<std::string> nextFrontier;
+      for (std::size_t i = 0; i < frontier.size(); ++i)
+      {
+        if (shards.size() + nextFrontier.size() + frontier.size() - i >= targetShards)
+        {
+          nextFrontier.push_back(std::move(frontier[i]));
+          continue;
+        }
+        DataLakeRestClient::FileSystem::ListPathsOptions protocolLayerOptions;
+        protocolLayerOptions.Directory = frontier[i];
+        protocolLayerOptions.MaxResults = c_maxSplitChildren;
+        auto response = ListFileSystemPaths(protocolLayerOptions, context);
+        const bool hasSubdirectory = std::any_of(
+            response->Paths.begin(), response->Paths.end(), [](const Path& path) {
+              return path.IsDirectory.HasValue() && path.IsDirectory.GetValue();
+            });
+        if (HasContinuation(response->Continuation) || !hasSubdirectory)
+        {
+          nextFrontier.push_back(std::move(frontier[i]));
+          continue;
+        }
+        AccessControlRecursiveShard directoryShard;
+        directoryShard.Path = std::move(frontier[i]);
+        directoryShard.Recursive = false;
+        shards.push_back(std::move(directoryShard));
+        for (auto& path : response->Paths)
+        {
+          if (path.IsDirectory.HasValue() && path.IsDirectory.GetValue())
+          {
+            nextFrontier.push_back(std::move(path.Name));
+          }
+          else
+          {
+            AccessControlRecursiveShard fileShard;
+            fileShard.Path = std::move(path.Name);
+            shards.push_back(std::move(fileShard));
+          }
+        }
+      }
+      frontier = std::move(nextFrontier);
+    }
+
+    // The subtrees go first, they take the longest.
+    std::vector<AccessControlRecursiveShard> subtreeShards;
+    for (auto& path : frontier)
+    {
+      AccessControlRecursiveShard shard;
+      shard.Path = std::move(path);
+      subtreeShards.push_back(std::move(shard));
+    }
+    subtreeShards.insert(subtreeShards.end(), shards.begin(), shards.end());
+    return subtreeShards;
+  }
 }}}} // namespace Azure::Storage::Files::DataLake
@@ -4,8 +4,10 @@
 #include "datalake/file_client.hpp"
 
 #include "common/common_headers_request_policy.hpp"
+#include "common/concurrent_transfer.hpp"
 #include "common/constants.hpp"
 #include "common/crypt.hpp"
+#include "common/file_io.hpp"
 #include "common/shared_key_policy.hpp"
 #include "common/storage_common.hpp"
 #include "common/storage_version.hpp"
@@ -327,6 +329,17 @@ namespace Azure { namespace Storage { namespace Files { namespace DataLake {
       const std::string& file,
       const UploadFileOptions& options) const
   {
+    if (options.UseDfsEndpoint)
+    {
+      Azure::Storage::Details::FileReader fileReader(file);
+      return UploadThroughDfs(
+          fileReader.GetFileSize(),
+          [&](int64_t offset, int64_t length) {
+            return std::make_unique<Azure::Core::Http::FileBodyStream>(
+                fileReader.GetHandle(), offset, length);
+          },
+          options);
+    }
     Blobs::UploadBlobOptions blobOptions;
     blobOptions.Context = options.Context;
     blobOptions.ChunkSize = options.ChunkSize;
@@ -341,6 +354,16 @@ namespace Azure { namespace Storage { namespace Files { namespace DataLake {
       std::size_t bufferSize,
       const UploadFileOptions& options) const
   {
+    if (options.UseDfsEndpoint)
+    {
+      return UploadThroughDfs(
+          static_cast<int64_t>(bufferSize),
+          [&](int64_t offset, int64_t length) {
+            return std::make_unique<Azure::Core::Http::MemoryBodyStream>(
+                buffer + offset, static_cast<std::size_t>(length));
+          },
+          options);
+    }
     Blobs::UploadBlobOptions blobOptions;
     blobOptions.Context = options.Context;
     blobOptions.ChunkSize = options.ChunkSize;
@@ -350,6 +373,51 @@ namespace Azure { namespace Storage { namespace Files { namespace DataLake {
     return m_blockBlobClient.UploadFromBuffer(buffer, bufferSize, blobOptions);
   }
 
+  Azure::Core::Response<FileContentInfo> FileClient::UploadThroughDfs(
+      int64_t size,
+      const std::function<std::unique_ptr<Azure::Core::Http::BodyStream>(int64_t, int64_t)>&
+          getContent,
+      const UploadFileOptions& options) const
+  {
+    constexpr int64_t c_defaultChunkSize = 8 * 1024 * 1024;
+    constexpr int64_t c_maximumChunkSize = 100 * 1024 * 1024;
+
+    int64_t chunkSize
+        = options.ChunkSize.HasValue() ? options.ChunkSize.GetValue() : c_defaultChunkSize;
+    if (chunkSize <= 0 || chunkSize > c_maximumChunkSize)
+    {
+      throw std::runtime_error("chunk size must be positive and at most 100MiB");
+    }
+
+    FileCreateOptions createOptions;
+    createOptions.Context = options.Context;
+    createOptions.Metadata = options.Metadata;
+    Create(createOptions);
+
+    // Every chunk is appended at its own position, so they're accepted in any order, and one
+    // retried after the service got it is harmless.
+    PathAppendDataOptions appendOptions;
+    appendOptions.Context = options.Context;
+    auto appendChunkFunc = [&](int64_t offset, int64_t length, int64_t, int64_t) {
+      auto content = getContent(offset, length);
+      AppendData(content.get(), offset, appendOptions);
+    };
+    Azure::Storage::Details::ConcurrentTransfer(
+        0, size, chunkSize, options.Concurrency, appendChunkFunc);
+
+    // Headers that aren't flushed are cleared, so they're set by the flush rather than the create.
+    PathFlushDataOptions flushOptions;
+    flushOptions.Context = options.Context;
+    flushOptions.HttpHeaders = options.HttpHeaders;
+    flushOptions.Close = true;
+    auto flushResult = FlushData(size, flushOptions);
+    FileContentInfo ret;
+    ret.ETag = std::move(flushResult->ETag);
+    ret.LastModified = std::move(flushResult->LastModified);
+    return Azure::Core::Response<FileContentInfo>(
+        std::move(ret), flushResult.ExtractRawResponse());
+  }
+
   Azure::Core::Response<FileDownloadInfo> FileClient::DownloadToBuffer(
       uint8_t* buffer,
       std::size_t bufferSize,
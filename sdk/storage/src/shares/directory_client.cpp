@@ -0,0 +1,189 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include "shares/directory_client.hpp"
+
+#include "common/common_headers_request_policy.hpp"
+#include "common/constants.hpp"
+#include "common/shared_key_policy.hpp"
+#include "common/storage_common.hpp"
+#include "common/storage_version.hpp"
+#include "credentials/policy/policies.hpp"
+#include "http/curl/curl.hpp"
+
+namespace Azure { namespace Storage { namespace Files { namespace Shares {
+
+  namespace {
+    constexpr const char* c_directoryAttributes = "Directory";
+    constexpr const char* c_fileTimeNow = "now";
+    constexpr const char* c_filePermissionInherit = "inherit";
+  } // namespace
+
+  DirectoryClient DirectoryClient::CreateFromConnectionString(
+      const std::string& connectionString,
+      const std::string& shareName,
+      const std::string& directoryPath,
+      const DirectoryClientOptions& options)
+  {
+    auto parsedConnectionString = Azure::Storage::Details::ParseConnectionString(connectionString);
+    auto directoryUri = std::move(parsedConnectionString.FileServiceUri);
+    directoryUri.AppendPath(shareName, true);
+    directoryUri.AppendPath(directoryPath, true);
+
+    if (parsedConnectionString.KeyCredential)
+    {
+      return DirectoryClient(
+          directoryUri.ToString(), parsedConnectionString.KeyCredential, options);
+    }
+    else
+    {
+      return DirectoryClient(directoryUri.ToString(), options);
+    }
+  }
+
+  DirectoryClient::DirectoryClient(
+      const std::string& directoryUri,
+      std::shared_ptr<SharedKeyCredential> credential,
+      const DirectoryClientOptions& options)
+      : m_directoryUri(directoryUri)
+  {
+    std::vector<std::unique_ptr<Azure::Core::Http::HttpPolicy>> policies;
+    policies.emplace_back(std::make_unique<Azure::Core::Http::TelemetryPolicy>(
+        Azure::Storage::Details::c_FileServicePackageName, FileServiceVersion));
+    for (const auto& p : options.PerOperationPolicies)
+    {
+      policies.emplace_back(p->Clone());
+    }
+    policies.emplace_back(
+        std::make_unique<Azure::Core::Http::RetryPolicy>(Azure::Core::Http::RetryOptions()));
+    for (const auto& p : options.PerRetryPolicies)
+    {
+      policies.emplace_back(p->Clone());
+    }
+    policies.emplace_back(std::make_unique<CommonHeadersRequestPolicy>());
+    policies.emplace_back(std::make_unique<SharedKeyPolicy>(credential));
+    policies.emplace_back(std::make_unique<Azure::Core::Http::TransportPolicy>(
+        std::make_shared<Azure::Core::Http::CurlTransport>()));
+    m_pipeline = std::make_shared<Azure::Core::Http::HttpPipeline>(policies);
+  }
+
+  DirectoryClient::DirectoryClient(
+      const std::string& directoryUri,
+      std::shared_ptr<Core::Credentials::TokenCredential> credential,
+      const DirectoryClientOptions& options)
+      : m_directoryUri(directoryUri)
+  {
+    std::vector<std::unique_ptr<Azure::Core::Http::HttpPolicy>> policies;
+    policies.emplace_back(std::make_unique<Azure::Core::Http::TelemetryPolicy>(
+        Azure::Storage::Details::c_FileServicePackageName, FileServiceVersion));
+    for (const auto& p : options.PerOperationPolicies)
+    {
+      policies.emplace_back(p->Clone());
+    }
+    policies.emplace_back(
+        std::make_unique<Azure::Core::Http::RetryPolicy>(Azure::Core::Http::RetryOptions()));
+    for (const auto& p : options.PerRetryPolicies)
+    {
+      policies.emplace_back(p->Clone());
+    }
+    policies.emplace_back(std::make_unique<CommonHeadersRequestPolicy>());
+    policies.emplace_back(
+        std::make_unique<Core::Credentials::Policy::BearerTokenAuthenticationPolicy>(
+            credential, Azure::Storage::Details::c_StorageScope));
+    policies.emplace_back(std::make_unique<Azure::Core::Http::TransportPolicy>(
+        std::make_shared<Azure::Core::Http::CurlTransport>()));
+    m_pipeline = std::make_shared<Azure::Core::Http::HttpPipeline>(policies);
+  }
+
+  DirectoryClient::DirectoryClient(
+      const std::string& directoryUri,
+      const DirectoryClientOptions& options)
+      : m_directoryUri(directoryUri)
+  {
+    std::vector<std::unique_ptr<Azure::Core::Http::HttpPolicy>> policies;
+    policies.emplace_back(std::make_unique<Azure::Core::Http::TelemetryPolicy>(
+        Azure::Storage::Details::c_FileServicePackageName, FileServiceVersion));
+    for (const auto& p : options.PerOperationPolicies)
+    {
+      policies.emplace_back(p->Clone());
+    }
+    policies.emplace_back(
+        std::make_unique<Azure::Core::Http::RetryPolicy>(Azure::Core::Http::RetryOptions()));
+    for (const auto& p : options.PerRetryPolicies)
+    {
+      policies.emplace_back(p->Clone());
+    }
+    policies.emplace_back(std::make_unique<CommonHeadersRequestPolicy>());
+    policies.emplace_back(std::make_unique<Azure::Core::Http::TransportPolicy>(
+        std::make_shared<Azure::Core::Http::CurlTransport>()));
+    m_pipeline = std::make_shared<Azure::Core::Http::HttpPipeline>(policies);
+  }
+
+  DirectoryClient DirectoryClient::GetSubdirectoryClient(
+      const std::string& subdirectoryName) const
+  {
+    auto builder = m_directoryUri;
+    builder.AppendPath(subdirectoryName, true);
+    return DirectoryClient(std::move(builder), m_pipeline);
+  }
+
+  FileClient DirectoryClient::GetFileClient(const std::string& fileName) const
+  {
+    auto builder = m_directoryUri;
+    builder.AppendPath(fileName, true);
+    return FileClient(std::move(builder), m_pipeline);
+  }
+
+  Azure::Core::Response<DirectoryInfo> DirectoryClient::Create(
+      const CreateDirectoryOptions& options) const
+  {
+    auto protocolLayerOptions = ShareRestClient::Directory::CreateOptions();
+    protocolLayerOptions.Metadata = options.Metadata;
+    protocolLayerOptions.FilePermission = options.FilePermission.HasValue()
+        ? options.FilePermission.GetValue()
+        : std::string(c_filePermissionInherit);
+    protocolLayerOptions.FileAttributes = c_directoryAttributes;
+    protocolLayerOptions.FileCreationTime = c_fileTimeNow;
+    protocolLayerOptions.FileLastWriteTime = c_fileTimeNow;
+    return ShareRestClient::Directory::Create(
+        m_directoryUri.ToString(), *m_pipeline, options.Context, protocolLayerOptions);
+  }
+
+  Azure::Core::Response<DirectoryDeleteInfo> DirectoryClient::Delete(
+      const DeleteDirectoryOptions& options) const
+  {
+    auto protocolLayerOptions = ShareRestClient::Directory::DeleteOptions();
+    return ShareRestClient::Directory::Delete(
+        m_directoryUri.ToString(), *m_pipeline, options.Context, protocolLayerOptions);
+  }
+
+  Azure::Core::Response<ListFilesAndDirectoriesSegmentResult>
+  DirectoryClient::ListFilesAndDirectoriesSegment(
+      const ListFilesAndDirectoriesSegmentOptions& options) const
+  {
+    auto protocolLayerOptions
+        = ShareRestClient::Directory::ListFilesAndDirectoriesSegmentOptions();
+    protocolLayerOptions.Prefix = options.Prefix;
+    protocolLayerOptions.Marker = options.Marker;
+    protocolLayerOptions.MaxResults = options.MaxResults;
+    return ShareRestClient::Directory::ListFilesAndDirectoriesSegment(
+        m_directoryUri.ToString(), *m_pipeline, options.Context, protocolLayerOptions);
+  }
+
+  SegmentPager<ListFilesAndDirectoriesSegmentResult>
+  DirectoryClient::ListFilesAndDirectoriesPages(
+      const ListFilesAndDirectoriesSegmentOptions& options,
+      int prefetchDepth) const
+  {
+    DirectoryClient client(*this);
+    ListFilesAndDirectoriesSegmentOptions segmentOptions = options;
+    return SegmentPager<ListFilesAndDirectoriesSegmentResult>(
+        [client, segmentOptions](const Azure::Core::Nullable<std::string>& marker) mutable {
+          segmentOptions.Marker = marker;
+          return client.ListFilesAndDirectoriesSegment(segmentOptions).ExtractValue();
+        },
+        options.Marker,
+        prefetchDepth);
+  }
+
+}}}} // namespace Azure::Storage::Files::Shares
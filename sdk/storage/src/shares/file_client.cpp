@@ -0,0 +1,434 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include "shares/file_client.hpp"
+
+#include "common/chunked_download.hpp"
+#include "common/common_headers_request_policy.hpp"
+#include "common/concurrent_transfer.hpp"
+#include "common/constants.hpp"
+#include "common/file_io.hpp"
+#include "common/shared_key_policy.hpp"
+#include "common/storage_common.hpp"
+#include "common/storage_version.hpp"
+#include "common/transfer_governor.hpp"
+#include "credentials/policy/policies.hpp"
+#include "http/buffer_pool.hpp"
+#include "http/curl/curl.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace Azure { namespace Storage { namespace Files { namespace Shares {
+
+  namespace {
+    constexpr int64_t c_maximumRangeSize = 4 * 1024 * 1024;
+    constexpr const char* c_fileAttributesNone = "None";
+    constexpr const char* c_fileTimeNow = "now";
+    constexpr const char* c_filePermissionInherit = "inherit";
+
+    std::string RangeHeader(int64_t offset, int64_t length)
+    {
+      return "bytes=" + std::to_string(offset) + "-" + std::to_string(offset + length - 1);
+    }
+  } // namespace
+
+  FileClient FileClient::CreateFromConnectionString(
+      const std::string& connectionString,
+      const std::string& shareName,
+      const std::string& filePath,
+      const FileClientOptions& options)
+  {
+    auto parsedConnectionString = Azure::Storage::Details::ParseConnectionString(connectionString);
+    auto fileUri = std::move(parsedConnectionString.FileServiceUri);
+    fileUri.AppendPath(shareName, true);
+    fileUri.AppendPath(filePath, true);
+
+    if (parsedConnectionString.KeyCredential)
+    {
+      return FileClient(fileUri.ToString(), parsedConnectionString.KeyCredential, options);
+    }
+    else
+    {
+      return FileClient(fileUri.ToString(), options);
+    }
+  }
+
+  FileClient::FileClient(
+      const std::string& fileUri,
+      std::shared_ptr<SharedKeyCredential> credential,
+      const FileClientOptions& options)
+      : m_fileUri(fileUri)
+  {
+    std::vector<std::unique_ptr<Azure::Core::Http::HttpPolicy>> policies;
+    policies.emplace_back(std::make_unique<Azure::Core::Http::TelemetryPolicy>(
+        Azure::Storage::Details::c_FileServicePackageName, FileServiceVersion));
+    for (const auto& p : options.PerOperationPolicies)
+    {
+      policies.emplace_back(p->Clone());
+    }
+    policies.emplace_back(
+        std::make_unique<Azure::Core::Http::RetryPolicy>(Azure::Core::Http::RetryOptions()));
+    for (const auto& p : options.PerRetryPolicies)
+    {
+      policies.emplace_back(p->Clone());
+    }
+    policies.emplace_back(std::make_unique<CommonHeadersRequestPolicy>());
+    policies.emplace_back(std::make_unique<SharedKeyPolicy>(credential));
+    policies.emplace_back(std::make_unique<Azure::Core::Http::TransportPolicy>(
+        std::make_shared<Azure::Core::Http::CurlTransport>()));
+    m_pipeline = std::make_shared<Azure::Core::Http::HttpPipeline>(policies);
+  }
+
+  FileClient::FileClient(
+      const std::string& fileUri,
+      std::shared_ptr<Core::Credentials::TokenCredential> credential,
+      const FileClientOptions& options)
+      : m_fileUri(fileUri)
+  {
+    std::vector<std::unique_ptr<Azure::Core::Http::HttpPolicy>> policies;
+    policies.emplace_back(std::make_unique<Azure::Core::Http::TelemetryPolicy>(
+        Azure::Storage::Details::c_FileServicePackageName, FileServiceVersion));
+    for (const auto& p : options.PerOperationPolicies)
+    {
+      policies.emplace_back(p->Clone());
+    }
+    policies.emplace_back(
+        std::make_unique<Azure::Core::Http::RetryPolicy>(Azure::Core::Http::RetryOptions()));
+    for (const auto& p : options.PerRetryPolicies)
+    {
+      policies.emplace_back(p->Clone());
+    }
+    policies.emplace_back(std::make_unique<CommonHeadersRequestPolicy>());
+    policies.emplace_back(
+        std::make_unique<Core::Credentials::Policy::BearerTokenAuthenticationPolicy>(
+            credential, Azure::Storage::Details::c_StorageScope));
+    policies.emplace_back(std::make_unique<Azure::Core::Http::TransportPolicy>(
+        std::make_shared<Azure::Core::Http::CurlTransport>()));
+    m_pipeline = std::make_shared<Azure::Core::Http::HttpPipeline>(policies);
+  }
+
+  FileClient::FileClient(const std::string& fileUri, const FileClientOptions& options)
+      : m_fileUri(fileUri)
+  {
+    std::vector<std::unique_ptr<Azure::Core::Http::HttpPolicy>> policies;
+    policies.emplace_back(std::make_unique<Azure::Core::Http::TelemetryPolicy>(
+        Azure::Storage::Details::c_FileServicePackageName, FileServiceVersion));
+    for (const auto& p : options.PerOperationPolicies)
+    {
+      policies.emplace_back(p->Clone());
+    }
+    policies.emplace_back(
+        std::make_unique<Azure::Core::Http::RetryPolicy>(Azure::Core::Http::RetryOptions()));
+    for (const auto& p : options.PerRetryPolicies)
+    {
+      policies.emplace_back(p->Clone());
+    }
+    policies.emplace_back(std::make_unique<CommonHeadersRequestPolicy>());
+    policies.emplace_back(std::make_unique<Azure::Core::Http::TransportPolicy>(
+        std::make_shared<Azure::Core::Http::CurlTransport>()));
+    m_pipeline = std::make_shared<Azure::Core::Http::HttpPipeline>(policies);
+  }
+
+  Azure::Core::Response<FileInfo> FileClient::Create(
+      int64_t fileSize,
+      const CreateFileOptions& options) const
+  {
+    auto protocolLayerOptions = ShareRestClient::File::CreateOptions();
+    protocolLayerOptions.XMsContentLength = fileSize;
+    if (!options.HttpHeaders.ContentType.empty())
+    {
+      protocolLayerOptions.FileContentType = options.HttpHeaders.ContentType;
+    }
+    if (!options.HttpHeaders.ContentEncoding.empty())
+    {
+      protocolLayerOptions.FileContentEncoding = options.HttpHeaders.ContentEncoding;
+    }
+    if (!options.HttpHeaders.ContentLanguage.empty())
+    {
+      protocolLayerOptions.FileContentLanguage = options.HttpHeaders.ContentLanguage;
+    }
+    if (!options.HttpHeaders.CacheControl.empty())
+    {
+      protocolLayerOptions.FileCacheControl = options.HttpHeaders.CacheControl;
+    }
+    if (!options.HttpHeaders.ContentDisposition.empty())
+    {
+      protocolLayerOptions.FileContentDisposition = options.HttpHeaders.ContentDisposition;
+    }
+    protocolLayerOptions.Metadata = options.Metadata;
+    protocolLayerOptions.FilePermission = options.FilePermission.HasValue()
+        ? options.FilePermission.GetValue()
+        : std::string(c_filePermissionInherit);
+    protocolLayerOptions.FileAttributes = c_fileAttributesNone;
+    protocolLayerOptions.FileCreationTime = c_fileTimeNow;
+    protocolLayerOptions.FileLastWriteTime = c_fileTimeNow;
+    protocolLayerOptions.LeaseIdOptional = options.LeaseId;
+    return ShareRestClient::File::Create(
+        m_fileUri.ToString(), *m_pipeline, options.Context, protocolLayerOptions);
+  }
+
+  Azure::Core::Response<FileDeleteInfo> FileClient::Delete(const DeleteFileOptions& options) const
+  {
+    auto protocolLayerOptions = ShareRestClient::File::DeleteOptions();
+    protocolLayerOptions.LeaseIdOptional = options.LeaseId;
+    return ShareRestClient::File::Delete(
+        m_fileUri.ToString(), *m_pipeline, options.Context, protocolLayerOptions);
+  }
+
+  Azure::Core::Response<FileProperties> FileClient::GetProperties(
+      const GetFilePropertiesOptions& options) const
+  {
+    auto protocolLayerOptions = ShareRestClient::File::GetPropertiesOptions();
+    protocolLayerOptions.LeaseIdOptional = options.LeaseId;
+    return ShareRestClient::File::GetProperties(
+        m_fileUri.ToString(), *m_pipeline, options.Context, protocolLayerOptions);
+  }
+
+  Azure::Core::Response<FileDownloadResponse> FileClient::Download(
+      const DownloadFileOptions& options) const
+  {
+    auto protocolLayerOptions = ShareRestClient::File::DownloadOptions();
+    if (options.Offset.HasValue())
+    {
+      if (options.Length.HasValue())
+      {
+        protocolLayerOptions.Range
+            = RangeHeader(options.Offset.GetValue(), options.Length.GetValue());
+      }
+      else
+      {
+        protocolLayerOptions.Range = "bytes=" + std::to_string(options.Offset.GetValue()) + "-";
+      }
+    }
+    protocolLayerOptions.LeaseIdOptional = options.LeaseId;
+    return ShareRestClient::File::Download(
+        m_fileUri.ToString(), *m_pipeline, options.Context, protocolLayerOptions);
+  }
+
+  Azure::Core::Response<FileUploadRangeInfo> FileClient::UploadRange(
+      int64_t offset,
+      Azure::Core::Http::BodyStream* content,
+      const UploadFileRangeOptions& options) const
+  {
+    auto protocolLayerOptions = ShareRestClient::File::UploadRangeOptions();
+    protocolLayerOptions.XMsRange = RangeHeader(offset, content->Length());
+    protocolLayerOptions.XMsWrite = FileRangeWriteType::Update;
+    protocolLayerOptions.ContentLength = content->Length();
+    protocolLayerOptions.ContentMD5 = options.ContentMD5;
+    protocolLayerOptions.LeaseIdOptional = options.LeaseId;
+    return ShareRestClient::File::UploadRange(
+        m_fileUri.ToString(), *content, *m_pipeline, options.Context, protocolLayerOptions);
+  }
+
+  Azure::Core::Response<FileUploadInfo> FileClient::UploadFromBuffer(
+      const uint8_t* buffer,
+      std::size_t bufferSize,
+      const UploadFileOptions& options) const
+  {
+    return UploadRanges(
+        static_cast<int64_t>(bufferSize),
+        [&](int64_t offset, int64_t length) {
+          return std::make_unique<Azure::Core::Http::MemoryBodyStream>(
+              buffer + offset, static_cast<std::size_t>(length));
+        },
+        options);
+  }
+
+  Azure::Core::Response<FileUploadInfo> FileClient::UploadFromFile(
+      const std::string& file,
+      const UploadFileOptions& options) const
+  {
+    Azure::Storage::Details::FileReader fileReader(file);
+    return UploadRanges(
+        fileReader.GetFileSize(),
+        [&](int64_t offset, int64_t length) {
+          return std::make_unique<Azure::Core::Http::FileBodyStream>(
+              fileReader.GetHandle(), offset, length);
+        },
+        options);
+  }
+
+  Azure::Core::Response<FileUploadInfo> FileClient::UploadRanges(
+      int64_t size,
+      const std::function<std::unique_ptr<Azure::Core::Http::BodyStream>(int64_t, int64_t)>&
+          getContent,
+      const UploadFileOptions& options) const
+  {
+    int64_t chunkSize
+        = options.ChunkSize.HasValue() ? options.ChunkSize.GetValue() : c_maximumRangeSize;
+    if (chunkSize <= 0 || chunkSize > c_maximumRangeSize)
+    {
+      throw std::runtime_error("chunk size must be positive and at most 4MiB");
+    }
+
+    // A file is created with its final size, the ranges are then written in place in any order.
+    CreateFileOptions createOptions;
+    createOptions.Context = options.Context;
+    createOptions.HttpHeaders = options.HttpHeaders;
+    createOptions.Metadata = options.Metadata;
+    createOptions.FilePermission = options.FilePermission;
+    auto createResult = Create(size, createOptions);
+
+    UploadFileRangeOptions uploadRangeOptions;
+    uploadRangeOptions.Context = options.Context;
+    auto uploadRangeFunc = [&](int64_t offset, int64_t length, int64_t, int64_t) {
+      auto content = getContent(offset, length);
+      UploadRange(offset, content.get(), uploadRangeOptions);
+    };
+    Azure::Storage::Details::ConcurrentTransfer(
+        0, size, chunkSize, options.Concurrency, uploadRangeFunc);
+
+    FileUploadInfo ret;
+    ret.IsServerEncrypted = createResult->IsServerEncrypted;
+    return Azure::Core::Response<FileUploadInfo>(
+        std::move(ret), createResult.ExtractRawResponse());
+  }
+
+  Azure::Core::Response<FileDownloadInfo> FileClient::DownloadToBuffer(
+      uint8_t* buffer,
+      std::size_t bufferSize,
+      const DownloadFileToBufferOptions& options) const
+  {
+    int64_t firstChunkOffset = options.Offset.HasValue() ? options.Offset.GetValue() : 0;
+    return DownloadRanges(
+        [&](int64_t offset,
+            int64_t length,
+            Azure::Core::Http::BodyStream& content,
+            Azure::Core::Http::PooledBuffer&) {
+          int64_t bytesRead = Azure::Core::Http::BodyStream::ReadToCount(
+              options.Context, content, buffer + (offset - firstChunkOffset), length);
+          if (bytesRead != length)
+          {
+            throw std::runtime_error("error when reading body stream");
+          }
+        },
+        [&](int64_t rangeSize) {
+          if (static_cast<std::size_t>(rangeSize) > bufferSize)
+          {
+            throw std::runtime_error(
+                "buffer is not big enough, file range size is " + std::to_string(rangeSize));
+          }
+        },
+        false,
+        options);
+  }
+
+  Azure::Core::Response<FileDownloadInfo> FileClient::DownloadToFile(
+      const std::string& file,
+      const DownloadFileToFileOptions& options) const
+  {
+    Azure::Storage::Details::FileWriter fileWriter(file);
+    return DownloadRanges(
+        [&](int64_t offset,
+            int64_t length,
+            Azure::Core::Http::BodyStream& content,
+            Azure::Core::Http::PooledBuffer& buffer) {
+          // The offset is relative to the start of the downloaded range in the local file.
+          int64_t fileOffset = offset - (options.Offset.HasValue() ? options.Offset.GetValue() : 0);
+          while (length > 0)
+          {
+            int64_t readLength = std::min(length, buffer.Size());
+            int64_t bytesRead = Azure::Core::Http::BodyStream::ReadToCount(
+                options.Context, content, buffer.Data(), readLength);
+            if (bytesRead != readLength)
+            {
+              throw std::runtime_error("error when reading body stream");
+            }
+            fileWriter.Write(buffer.Data(), bytesRead, fileOffset);
+            fileOffset += bytesRead;
+            length -= bytesRead;
+          }
+        },
+        [&](int64_t rangeSize) { fileWriter.Preallocate(rangeSize); },
+        true,
+        options);
+  }
+
+  Azure::Core::Response<FileDownloadInfo> FileClient::DownloadRanges(
+      const std::function<void(
+          int64_t,
+          int64_t,
+          Azure::Core::Http::BodyStream&,
+          Azure::Core::Http::PooledBuffer&)>& sink,
+      const std::function<void(int64_t)>& checkSize,
+      bool bufferedSink,
+      const DownloadFileToBufferOptions& options) const
+  {
+    // Transfer buffers are taken after the permit and before a range is requested, the first one
+    // included, like in the other transfers, so that a pool at its memory limit holds back new
+    // requests rather than open connections.
+    auto acquireTransferBuffer = [bufferedSink](int64_t length) {
+      return bufferedSink ? Azure::Core::Http::BufferPool::Default().Acquire(
+                 std::min(std::max(length, int64_t(1)), c_maximumRangeSize))
+                          : Azure::Core::Http::PooledBuffer();
+    };
+
+    // The ranges are always requested explicitly, since only ranged responses tell the size of
+    // the file.
+    int64_t firstChunkOffset = options.Offset.HasValue() ? options.Offset.GetValue() : 0;
+    auto firstChunk = Azure::Storage::Details::DownloadFirstChunk<FileDownloadResponse>(
+        options.Offset,
+        options.Length,
+        options.InitialChunkSize.HasValue() ? options.InitialChunkSize.GetValue()
+                                            : Azure::Storage::Details::c_defaultDownloadChunkSize,
+        true,
+        [&](const Azure::Core::Nullable<int64_t>& offset,
+            const Azure::Core::Nullable<int64_t>& length) {
+          DownloadFileOptions chunkOptions;
+          chunkOptions.Context = options.Context;
+          chunkOptions.Offset = offset;
+          chunkOptions.Length = length;
+          return Download(chunkOptions);
+        },
+        [](const FileDownloadResponse& response, bool ranged) {
+          return ranged ? Azure::Storage::Details::GetSizeFromContentRange(response.ContentRange)
+                        : response.ContentLength;
+        },
+        bufferedSink ? c_maximumRangeSize : 0);
+    const int64_t fileRangeSize = firstChunk.RangeSize;
+    checkSize(fileRangeSize);
+
+    sink(firstChunkOffset, firstChunk.Length, *(firstChunk.Chunk->BodyStream), firstChunk.Buffer);
+    firstChunk.Buffer.Release();
+    firstChunk.Chunk->BodyStream.reset();
+    firstChunk.Permit.Release();
+
+    FileDownloadInfo ret;
+    ret.ETag = std::move(firstChunk.Chunk->ETag);
+    ret.LastModified = std::move(firstChunk.Chunk->LastModified);
+    ret.ContentLength = fileRangeSize;
+    ret.HttpHeaders = std::move(firstChunk.Chunk->HttpHeaders);
+    ret.IsServerEncrypted = firstChunk.Chunk->IsServerEncrypted;
+
+    // Keep downloading the remaining in parallel. Files have no conditional download, so a file
+    // changed in between is detected by its ETag instead, rather than mixing versions.
+    auto downloadChunkFunc = [&](int64_t offset, int64_t length, int64_t, int64_t) {
+      auto buffer = acquireTransferBuffer(length);
+      DownloadFileOptions chunkOptions;
+      chunkOptions.Context = options.Context;
+      chunkOptions.Offset = offset;
+      chunkOptions.Length = length;
+      auto chunk = Download(chunkOptions);
+      if (chunk->ETag != ret.ETag)
+      {
+        throw std::runtime_error("file was modified during the download");
+      }
+      sink(offset, length, *(chunk->BodyStream), buffer);
+    };
+
+    int64_t remainingOffset = firstChunkOffset + firstChunk.Length;
+    int64_t remainingSize = fileRangeSize - firstChunk.Length;
+    Azure::Storage::Details::ConcurrentTransfer(
+        remainingOffset,
+        remainingSize,
+        Azure::Storage::Details::GetDownloadChunkSize(
+            options.ChunkSize, remainingSize, options.Concurrency),
+        options.Concurrency,
+        downloadChunkFunc);
+
+    return Azure::Core::Response<FileDownloadInfo>(
+        std::move(ret), firstChunk.Chunk.ExtractRawResponse());
+  }
+
+}}}} // namespace Azure::Storage::Files::Shares
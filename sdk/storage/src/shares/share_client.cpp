@@ -110,6 +110,20 @@ namespace Azure { namespace Storage { namespace Files { namespace Shares {
     m_pipeline = std::make_shared<Azure::Core::Http::HttpPipeline>(policies);
   }
 
+  DirectoryClient ShareClient::GetDirectoryClient(const std::string& directoryPath) const
+  {
+    auto builder = m_shareUri;
+    builder.AppendPath(directoryPath, true);
+    return DirectoryClient(std::move(builder), m_pipeline);
+  }
+
+  FileClient ShareClient::GetFileClient(const std::string& filePath) const
+  {
+    auto builder = m_shareUri;
+    builder.AppendPath(filePath, true);
+    return FileClient(std::move(builder), m_pipeline);
+  }
+
   Azure::Core::Response<ShareInfo> ShareClient::Create(const CreateShareOptions& options) const
   {
     auto protocolLayerOptions = ShareRestClient::Share::CreateOptions();
@@ -0,0 +1,114 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include "blobs/blob.hpp"
+#include "mock_storage_server.hpp"
+#include "test_base.hpp"
+
+#include <thread>
+
+namespace Azure { namespace Storage { namespace Test {
+
+#ifndef _WIN32
+
+  TEST(AppendBlobWriterTest, BuffersWrites)
+  {
+    MockStorageServer server;
+    const std::string blobName = "AppendBlobWriter" + RandomString();
+    Blobs::AppendBlobClient appendBlobClient(server.GetBlobUrl(blobName));
+    appendBlobClient.Create();
+    const std::vector<uint8_t> header = RandomBuffer(100);
+    Azure::Core::Http::MemoryBodyStream headerStream(header.data(), header.size());
+    appendBlobClient.AppendBlock(&headerStream);
+
+    const std::vector<uint8_t> content = RandomBuffer(static_cast<std::size_t>(1_MB + 100));
+    Blobs::AppendBlobWriterOptions options;
+    options.BlockSize = 64_KB;
+    options.TransactionalHashAlgorithm = HashAlgorithm::Crc64;
+    {
+      Blobs::AppendBlobWriter writer(appendBlobClient, options);
+      const int64_t requestCount = server.GetRequestCount();
+      for (std::size_t offset = 0; offset < content.size(); offset += 1000)
+      {
+        writer.Write(content.data() + offset, std::min<std::size_t>(1000, content.size() - offset));
+      }
+      writer.Flush();
+      EXPECT_EQ(writer.GetPosition(), static_cast<int64_t>(header.size() + content.size()));
+      EXPECT_EQ(server.GetRequestCount() - requestCount, 17);
+    }
+    std::vector<uint8_t> expected = header;
+    expected.insert(expected.end(), content.begin(), content.end());
+    EXPECT_EQ(server.GetBlob(blobName), expected);
+
+    // a partial block is appended once the flush interval expires
+    options.FlushInterval = std::chrono::milliseconds(20);
+    Blobs::AppendBlobWriter writer(appendBlobClient, options);
+    writer.Write(content.data(), 10);
+    for (int i = 0; i < 100 && server.GetBlob(blobName).size() == expected.size(); ++i)
+    {
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    EXPECT_EQ(server.GetBlob(blobName).size(), expected.size() + 10);
+  }
+
+  TEST(AppendBlobWriterTest, ConcurrentAppends)
+  {
+    // With latency, the appends in flight reach the server in any order.
+    MockStorageServerOptions serverOptions;
+    serverOptions.Latency = std::chrono::milliseconds(5);
+    MockStorageServer server(serverOptions);
+    const std::string blobName = "AppendBlobWriter" + RandomString();
+    Blobs::AppendBlobClient appendBlobClient(server.GetBlobUrl(blobName));
+    appendBlobClient.Create();
+
+    const std::vector<uint8_t> content = RandomBuffer(static_cast<std::size_t>(512_KB + 3));
+    Blobs::AppendBlobWriterOptions options;
+    options.BlockSize = 16_KB;
+    options.Concurrency = 4;
+    Blobs::AppendBlobWriter writer(appendBlobClient, options);
+    for (std::size_t offset = 0; offset < content.size(); offset += 10_KB)
+    {
+      writer.Write(
+          content.data() + offset, std::min<std::size_t>(10_KB, content.size() - offset));
+    }
+    writer.Flush();
+    EXPECT_EQ(writer.GetPosition(), static_cast<int64_t>(content.size()));
+    EXPECT_EQ(server.GetBlob(blobName), content);
+  }
+
+  TEST(AppendBlobWriterTest, Conditions)
+  {
+    MockStorageServer server;
+    const std::string blobName = "AppendBlobWriter" + RandomString();
+    Blobs::AppendBlobClient appendBlobClient(server.GetBlobUrl(blobName));
+    appendBlobClient.Create();
+    const std::vector<uint8_t> content = RandomBuffer(static_cast<std::size_t>(100_KB));
+
+    // someone else appended to the blob
+    {
+      Blobs::AppendBlobWriter writer(appendBlobClient);
+      Azure::Core::Http::MemoryBodyStream contentStream(content.data(), 10);
+      appendBlobClient.AppendBlock(&contentStream);
+      writer.Write(content.data(), content.size());
+      EXPECT_THROW(writer.Flush(), StorageError);
+      EXPECT_THROW(writer.Write(content.data(), 1), StorageError);
+    }
+    EXPECT_EQ(server.GetBlob(blobName).size(), 10U);
+
+    Blobs::AppendBlobWriterOptions options;
+    options.BlockSize = 32_KB;
+    options.MaxSize = 50_KB;
+    Blobs::AppendBlobWriter writer(appendBlobClient, options);
+    // the write itself may fail, once the second block is rejected
+    EXPECT_THROW(
+        {
+          writer.Write(content.data(), content.size());
+          writer.Flush();
+        },
+        StorageError);
+    EXPECT_EQ(server.GetBlob(blobName).size(), 10 + 32_KB);
+  }
+
+#endif
+
+}}} // namespace Azure::Storage::Test
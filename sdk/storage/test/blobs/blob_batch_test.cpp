@@ -0,0 +1,72 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include "blobs/blob.hpp"
+#include "mock_storage_server.hpp"
+#include "test_base.hpp"
+
+namespace Azure { namespace Storage { namespace Test {
+
+#ifndef _WIN32
+
+  TEST(BlobBatchTest, DeleteAndSetTier)
+  {
+    MockStorageServer server;
+    const int numBlobs = 600;
+    for (int i = 0; i < numBlobs; ++i)
+    {
+      server.SetBlob("blob" + std::to_string(i), std::vector<uint8_t>(1, 'a'));
+    }
+    Blobs::BlobBatchClient batchClient(server.GetServiceUrl());
+
+    Blobs::BlobBatch batch;
+    for (int i = 0; i < numBlobs; ++i)
+    {
+      if (i % 3 == 0)
+      {
+        EXPECT_EQ(
+            static_cast<std::size_t>(i),
+            batch.SetBlobAccessTier(
+                "container", "blob" + std::to_string(i), Blobs::AccessTier::Cool));
+      }
+      else
+      {
+        EXPECT_EQ(
+            static_cast<std::size_t>(i), batch.DeleteBlob("container", "blob" + std::to_string(i)));
+      }
+    }
+    batch.DeleteBlob("container", "missing");
+
+    Blobs::SubmitBlobBatchOptions options;
+    options.Concurrency = 2;
+    auto result = batchClient.SubmitBatch(batch, options);
+    // at most 256 operations per request
+    EXPECT_EQ(server.GetRequestCount(), 3);
+    ASSERT_EQ(result.SubResponses.size(), static_cast<std::size_t>(numBlobs + 1));
+    for (int i = 0; i < numBlobs; ++i)
+    {
+      const auto& subResponse = result.SubResponses[static_cast<std::size_t>(i)];
+      const std::string blobName = "blob" + std::to_string(i);
+      if (i % 3 == 0)
+      {
+        EXPECT_EQ(subResponse.StatusCode, Azure::Core::Http::HttpStatusCode::Ok);
+        EXPECT_FALSE(server.GetBlob(blobName).empty());
+      }
+      else
+      {
+        EXPECT_EQ(subResponse.StatusCode, Azure::Core::Http::HttpStatusCode::Accepted);
+        EXPECT_TRUE(server.GetBlob(blobName).empty());
+      }
+      EXPECT_TRUE(subResponse.ErrorCode.empty());
+    }
+    EXPECT_EQ(result.SubResponses.back().StatusCode, Azure::Core::Http::HttpStatusCode::NotFound);
+    EXPECT_EQ(result.SubResponses.back().ErrorCode, "BlobNotFound");
+
+    // An empty batch sends nothing.
+    EXPECT_TRUE(batchClient.SubmitBatch(Blobs::BlobBatch()).SubResponses.empty());
+    EXPECT_EQ(server.GetRequestCount(), 3);
+  }
+
+#endif
+
+}}} // namespace Azure::Storage::Test
@@ -484,4 +484,74 @@ namespace Azure { namespace Storage { namespace Test {
     }
   }
 
+
+  TEST(BlobSasBuilderTest, BatchSas)
+  {
+    auto credential = std::make_shared<SharedKeyCredential>(
+        "account", Base64Encode("0123456789abcdef0123456789abcdef"));
+    Blobs::UserDelegationKey userDelegationKey;
+    userDelegationKey.SignedObjectId = "oid";
+    userDelegationKey.SignedTenantId = "tid";
+    userDelegationKey.SignedStartsOn = "2020-10-19T00:00:00Z";
+    userDelegationKey.SignedExpiresOn = "2020-10-20T00:00:00Z";
+    userDelegationKey.SignedService = "b";
+    userDelegationKey.SignedVersion = "2019-12-12";
+    userDelegationKey.Value = Base64Encode("delegation key");
+
+    Blobs::BlobSasBuilder builder;
+    builder.Protocol = SasProtocol::HttpsOnly;
+    builder.StartsOn = "2020-10-19T08:00:00Z";
+    builder.ExpiresOn = "2020-10-19T09:00:00Z";
+    builder.IPRange = "10.0.0.1-10.0.0.255";
+    builder.ContainerName = "container";
+    builder.BlobName = "dir/blob name";
+    builder.Resource = Blobs::BlobSasResource::Blob;
+    builder.ContentType = "text/plain";
+    builder.SetPermissions(Blobs::BlobSasPermissions::Read | Blobs::BlobSasPermissions::Write);
+
+    // Signatures computed before batch generation was added.
+    EXPECT_EQ(
+        builder.ToSasQueryParameters(*credential),
+        "?rsct=text/plain&se=2020-10-19T09:00:00Z&sig=IdlxU3UaCQSCutpWzU80xDOetH3o/"
+        "5P%2B2q%2By5b67jJM%3D&sip=10.0.0.1-10.0.0.255&sp=rw&spr=https&sr=b&st=2020-10-19T08:00:"
+        "00Z&sv=2019-12-12");
+    EXPECT_EQ(
+        builder.ToSasQueryParameters(userDelegationKey, "account"),
+        "?rsct=text/plain&se=2020-10-19T09:00:00Z&sig=UvrqMZ8EroVnGStjlLVKqZiXSv6g9jofCQAwyZAMzxo%"
+        "3D&sip=10.0.0.1-10.0.0.255&ske=2020-10-20T00:00:00Z&skoid=oid&sks=b&skt=2020-10-19T00:00:"
+        "00Z&sktid=tid&skv=2019-12-12&sp=rw&spr=https&sr=b&st=2020-10-19T08:00:00Z&sv=2019-12-12");
+    builder.Identifier = "policy";
+    builder.ContentType.clear();
+    EXPECT_EQ(
+        builder.ToSasQueryParameters(*credential),
+        "?se=2020-10-19T09:00:00Z&si=policy&sig=gMnlGLGr4rKGdXT4hfDTe6pGSc2fPmKSkE371zFHU30%3D&sip="
+        "10.0.0.1-10.0.0.255&sp=rw&spr=https&sr=b&st=2020-10-19T08:00:00Z&sv=2019-12-12");
+
+    std::vector<std::string> blobNames;
+    for (int i = 0; i < 1000; ++i)
+    {
+      blobNames.push_back("dir/blob" + std::to_string(i));
+    }
+    auto sharedKeySas = builder.ToSasQueryParameters(*credential, blobNames);
+    auto userDelegationSas = builder.ToSasQueryParameters(userDelegationKey, "account", blobNames);
+    ASSERT_EQ(sharedKeySas.size(), blobNames.size());
+    ASSERT_EQ(userDelegationSas.size(), blobNames.size());
+    for (std::size_t i = 0; i < blobNames.size(); i += 97)
+    {
+      builder.BlobName = blobNames[i];
+      EXPECT_EQ(sharedKeySas[i], builder.ToSasQueryParameters(*credential));
+      EXPECT_EQ(userDelegationSas[i], builder.ToSasQueryParameters(userDelegationKey, "account"));
+    }
+    EXPECT_NE(sharedKeySas[0], sharedKeySas[1]);
+    EXPECT_TRUE(builder.ToSasQueryParameters(*credential, std::vector<std::string>()).empty());
+
+    builder.Resource = Blobs::BlobSasResource::Container;
+    EXPECT_EQ(
+        builder.ToSasQueryParameters(*credential),
+        "?se=2020-10-19T09:00:00Z&si=policy&sig=5hnfJI3x1/JNJhgzwPmbS8njLmE6a2/"
+        "75t68TeQvoOU%3D&sip=10.0.0.1-10.0.0.255&sp=rw&spr=https&sr=c&st=2020-10-19T08:00:00Z&sv="
+        "2019-12-12");
+    EXPECT_THROW(builder.ToSasQueryParameters(*credential, blobNames), std::runtime_error);
+  }
+
 }}} // namespace Azure::Storage::Test
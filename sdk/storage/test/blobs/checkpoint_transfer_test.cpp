@@ -0,0 +1,158 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include "blobs/blob.hpp"
+#include "common/file_io.hpp"
+#include "common/transfer_checkpoint.hpp"
+#include "mock_storage_server.hpp"
+#include "test_base.hpp"
+
+#include <cstdio>
+
+namespace Azure { namespace Storage { namespace Test {
+
+  namespace {
+    bool FileExists(const std::string& filename)
+    {
+      std::FILE* file = std::fopen(filename.data(), "rb");
+      if (file != nullptr)
+      {
+        std::fclose(file);
+      }
+      return file != nullptr;
+    }
+  } // namespace
+
+  TEST(CheckpointTransferTest, MissingChunks)
+  {
+    std::vector<Details::TransferCheckpoint::Chunk> completedChunks(3);
+    completedChunks[0].Offset = 10;
+    completedChunks[0].Length = 10;
+    completedChunks[1].Offset = 20;
+    completedChunks[1].Length = 5;
+    completedChunks[2].Offset = 25;
+    completedChunks[2].Length = 15;
+    auto missingChunks = Details::GetMissingChunks(0, 45, 10, completedChunks);
+    std::vector<std::pair<int64_t, int64_t>> expected = {{0, 10}, {40, 5}};
+    EXPECT_EQ(missingChunks, expected);
+
+    // chunks only partially covered are transferred again
+    missingChunks = Details::GetMissingChunks(5, 40, 10, completedChunks);
+    expected = {{5, 10}, {35, 10}};
+    EXPECT_EQ(missingChunks, expected);
+  }
+
+  TEST(CheckpointTransferTest, Journal)
+  {
+    const std::string journalFile = RandomString();
+    {
+      Details::TransferCheckpoint checkpoint(journalFile, "transfer 1");
+      EXPECT_TRUE(checkpoint.GetCompletedChunks().empty());
+      Details::TransferCheckpoint::Chunk chunk;
+      chunk.Offset = 100;
+      chunk.Length = 50;
+      chunk.Id = "id1";
+      checkpoint.Record(chunk);
+    }
+    {
+      // a line cut short is ignored
+      std::FILE* file = std::fopen(journalFile.data(), "ab");
+      std::fputs("150 5", file);
+      std::fclose(file);
+    }
+    {
+      Details::TransferCheckpoint checkpoint(journalFile, "transfer 1");
+      ASSERT_EQ(checkpoint.GetCompletedChunks().size(), 1U);
+      EXPECT_EQ(checkpoint.GetCompletedChunks()[0].Offset, 100);
+      EXPECT_EQ(checkpoint.GetCompletedChunks()[0].Length, 50);
+      EXPECT_EQ(checkpoint.GetCompletedChunks()[0].Id, "id1");
+    }
+    {
+      Details::TransferCheckpoint checkpoint(journalFile, "transfer 2");
+      EXPECT_TRUE(checkpoint.GetCompletedChunks().empty());
+      checkpoint.Remove();
+    }
+    EXPECT_FALSE(FileExists(journalFile));
+  }
+
+#ifndef _WIN32
+
+  TEST(CheckpointTransferTest, ResumeUpload)
+  {
+    MockStorageServer server;
+    const std::string blobName = "CheckpointUpload" + RandomString();
+    Blobs::BlockBlobClient blockBlobClient(server.GetBlobUrl(blobName));
+
+    const std::vector<uint8_t> content = RandomBuffer(static_cast<std::size_t>(1_MB + 100));
+    const std::string file = RandomString();
+    {
+      Details::FileWriter fileWriter(file);
+      fileWriter.Write(content.data(), static_cast<int64_t>(content.size()), 0);
+    }
+    const int64_t numBlocks = 17;
+
+    Blobs::UploadBlobOptions options;
+    options.ChunkSize = 64_KB;
+    options.CheckpointFile = RandomString();
+    server.FailRequestsAfter(5);
+    EXPECT_THROW(blockBlobClient.UploadFromFile(file, options), StorageError);
+    EXPECT_TRUE(FileExists(options.CheckpointFile.GetValue()));
+    server.FailRequestsAfter(-1);
+
+    // Get Block List, the missing blocks and Put Block List, with blocks of the same size when
+    // tuned
+    const int64_t requestCount = server.GetRequestCount();
+    options.AutoTune = TransferTuningOptions();
+    blockBlobClient.UploadFromFile(file, options);
+    EXPECT_EQ(server.GetRequestCount() - requestCount, 1 + (numBlocks - 5) + 1);
+    EXPECT_EQ(server.GetBlob(blobName), content);
+    EXPECT_FALSE(FileExists(options.CheckpointFile.GetValue()));
+
+    DeleteFile(file);
+  }
+
+  TEST(CheckpointTransferTest, ResumeDownload)
+  {
+    MockStorageServer server;
+    const std::string blobName = "CheckpointDownload" + RandomString();
+    const std::vector<uint8_t> content = RandomBuffer(static_cast<std::size_t>(1_MB + 100));
+    server.SetBlob(blobName, content);
+    Blobs::BlobClient blobClient(server.GetBlobUrl(blobName));
+    const int64_t numChunks = 17;
+
+    const std::string file = RandomString();
+    Blobs::DownloadBlobToFileOptions options;
+    options.InitialChunkSize = 64_KB;
+    options.ChunkSize = 64_KB;
+    options.CheckpointFile = RandomString();
+    server.FailRequestsAfter(6);
+    EXPECT_THROW(blobClient.DownloadToFile(file, options), StorageError);
+    server.FailRequestsAfter(-1);
+
+    // the first chunk is always downloaded again, to get the ETag of the blob
+    int64_t requestCount = server.GetRequestCount();
+    options.Concurrency = 4;
+    auto res = blobClient.DownloadToFile(file, options);
+    EXPECT_EQ(server.GetRequestCount() - requestCount, 1 + (numChunks - 6));
+    EXPECT_EQ(res->ContentLength, static_cast<int64_t>(content.size()));
+    EXPECT_EQ(ReadFile(file), content);
+    EXPECT_FALSE(FileExists(options.CheckpointFile.GetValue()));
+
+    // a blob that changed is downloaded from the start
+    options.Concurrency = 1;
+    server.FailRequestsAfter(6);
+    EXPECT_THROW(blobClient.DownloadToFile(file, options), StorageError);
+    server.FailRequestsAfter(-1);
+    const std::vector<uint8_t> newContent = RandomBuffer(static_cast<std::size_t>(1_MB - 100));
+    server.SetBlob(blobName, newContent);
+    requestCount = server.GetRequestCount();
+    blobClient.DownloadToFile(file, options);
+    EXPECT_EQ(server.GetRequestCount() - requestCount, 16);
+    EXPECT_EQ(ReadFile(file), newContent);
+
+    DeleteFile(file);
+  }
+
+#endif
+
+}}} // namespace Azure::Storage::Test
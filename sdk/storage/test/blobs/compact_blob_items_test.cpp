@@ -0,0 +1,107 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include "blobs/blob.hpp"
+#include "mock_storage_server.hpp"
+#include "test_base.hpp"
+
+#include <cstring>
+
+namespace Azure { namespace Storage { namespace Test {
+
+  TEST(CompactBlobItemsTest, FromXml)
+  {
+    std::string document
+        = "<?xml version=\"1.0\" encoding=\"utf-8\"?>"
+          "<EnumerationResults ServiceEndpoint=\"https://a.blob.core.windows.net/\" "
+          "ContainerName=\"c\"><Prefix>b</Prefix><MaxResults>3</MaxResults><Blobs>";
+    for (int i = 0; i < 3; ++i)
+    {
+      document += "<Blob><Name>b&amp;" + std::to_string(i)
+          + "</Name><Properties><Creation-Time>Thu, 01 Oct 2020 00:00:00 GMT</Creation-Time>"
+            "<Last-Modified>Fri, 02 Oct 2020 00:00:00 GMT</Last-Modified><Etag>0x"
+          + std::to_string(i) + "</Etag><Content-Length>" + std::to_string(i * 1000)
+          + "</Content-Length><Content-Type>application/octet-stream</Content-Type>"
+            "<Content-Encoding /><Content-MD5>md5==</Content-MD5><BlobType>AppendBlob</BlobType>"
+            "<AccessTier>Cool</AccessTier><AccessTierInferred>false</AccessTierInferred>"
+            "<LeaseStatus>locked</LeaseStatus><LeaseState>leased</LeaseState>"
+            "<LeaseDuration>infinite</LeaseDuration><ServerEncrypted>true</ServerEncrypted>"
+            "</Properties><Metadata>"
+          + (i == 1 ? "<k1>v1</k1><k2>v2</k2>" : "") + "</Metadata></Blob>";
+    }
+    document += "</Blobs><NextMarker>next</NextMarker></EnumerationResults>";
+
+    XmlPullReader reader(document.data(), document.length());
+    auto segment = Details::CompactBlobsFlatSegmentFromXml(reader);
+    EXPECT_EQ(segment.ServiceEndpoint, "https://a.blob.core.windows.net/");
+    EXPECT_EQ(segment.Container, "c");
+    EXPECT_EQ(segment.Prefix, "b");
+    EXPECT_EQ(segment.NextMarker, "next");
+    ASSERT_EQ(segment.Items.Size(), 3U);
+
+    auto item = segment.Items[2];
+    EXPECT_STREQ(item.Name, "b&2");
+    EXPECT_STREQ(item.ETag, "0x2");
+    EXPECT_STREQ(item.ContentEncoding, "");
+    EXPECT_EQ(item.ContentLength, 2000);
+    EXPECT_EQ(item.BlobType, Blobs::BlobType::AppendBlob);
+    EXPECT_EQ(item.Tier, Blobs::AccessTier::Cool);
+    EXPECT_FALSE(item.AccessTierInferred);
+    EXPECT_EQ(item.LeaseStatus, Blobs::BlobLeaseStatus::Locked);
+    EXPECT_EQ(item.LeaseState, Blobs::BlobLeaseState::Leased);
+    EXPECT_TRUE(item.ServerEncrypted.GetValue());
+    // repeated values are stored once
+    EXPECT_EQ(item.ContentType, segment.Items[0].ContentType);
+    EXPECT_STREQ(item.ContentType, "application/octet-stream");
+
+    auto metadata = segment.Items.GetMetadata(1);
+    ASSERT_EQ(metadata.size(), 2U);
+    EXPECT_STREQ(metadata[1].first, "k2");
+    EXPECT_STREQ(metadata[1].second, "v2");
+    EXPECT_TRUE(segment.Items.GetMetadata(0).empty());
+
+    auto blobItem = segment.Items.ToBlobItem(1);
+    EXPECT_EQ(blobItem.Name, "b&1");
+    EXPECT_EQ(blobItem.HttpHeaders.ContentMd5, "md5==");
+    EXPECT_EQ(blobItem.LeaseDuration.GetValue(), "infinite");
+    EXPECT_FALSE(blobItem.EncryptionKeySha256.HasValue());
+    EXPECT_EQ(blobItem.Metadata, (std::map<std::string, std::string>{{"k1", "v1"}, {"k2", "v2"}}));
+  }
+
+#ifndef _WIN32
+
+  TEST(CompactBlobItemsTest, ListBlobsFlatCompact)
+  {
+    MockStorageServer server;
+    for (int i = 0; i < 10; ++i)
+    {
+      server.SetBlob("blob" + std::to_string(i), std::vector<uint8_t>(static_cast<std::size_t>(i)));
+    }
+    Blobs::BlobContainerClient containerClient(server.GetContainerUrl());
+
+    Blobs::ListBlobsOptions options;
+    options.MaxResults = 4;
+    std::vector<std::string> names;
+    do
+    {
+      auto segment = containerClient.ListBlobsFlatCompact(options).ExtractValue();
+      auto expected = containerClient.ListBlobsFlat(options).ExtractValue();
+      ASSERT_EQ(segment.Items.Size(), expected.Items.size());
+      for (std::size_t i = 0; i < segment.Items.Size(); ++i)
+      {
+        auto item = segment.Items.ToBlobItem(i);
+        EXPECT_EQ(item.Name, expected.Items[i].Name);
+        EXPECT_EQ(item.ContentLength, expected.Items[i].ContentLength);
+        EXPECT_EQ(item.CreationTime, expected.Items[i].CreationTime);
+        EXPECT_EQ(item.BlobType, expected.Items[i].BlobType);
+        names.push_back(item.Name);
+      }
+      EXPECT_EQ(segment.NextMarker, expected.NextMarker);
+      options.Marker = segment.NextMarker;
+    } while (!options.Marker.GetValue().empty());
+    EXPECT_EQ(names.size(), 10U);
+  }
+
+#endif
+
+}}} // namespace Azure::Storage::Test
@@ -0,0 +1,178 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include "blobs/blob.hpp"
+#include "common/transfer_governor.hpp"
+#include "http/buffer_pool.hpp"
+#include "mock_storage_server.hpp"
+#include "test_base.hpp"
+
+#include <atomic>
+#include <cstring>
+
+namespace Azure { namespace Storage { namespace Test {
+
+#ifndef _WIN32
+
+  TEST(DownloadToSinkTest, OutOfOrder)
+  {
+    MockStorageServer server;
+    const std::string blobName = "DownloadToSink" + RandomString();
+    std::vector<uint8_t> content = RandomBuffer(static_cast<std::size_t>(3_MB + 123));
+    server.SetBlob(blobName, content);
+    Blobs::BlobClient blobClient(server.GetBlobUrl(blobName));
+
+    for (int64_t offset : {int64_t(0), int64_t(1_MB + 5)})
+    {
+      std::vector<uint8_t> downloaded(content.size() - static_cast<std::size_t>(offset));
+      std::atomic<int64_t> bytesReceived{0};
+      Blobs::DownloadBlobToOptions options;
+      options.Offset = offset;
+      options.InitialChunkSize = 64_KB;
+      options.ChunkSize = 100_KB;
+      options.Concurrency = 8;
+      auto res = blobClient.DownloadTo(
+          [&](const uint8_t* data, std::size_t length, int64_t dataOffset) {
+            std::memcpy(downloaded.data() + dataOffset, data, length);
+            bytesReceived += static_cast<int64_t>(length);
+          },
+          options);
+      EXPECT_EQ(res->ContentLength, static_cast<int64_t>(downloaded.size()));
+      EXPECT_EQ(bytesReceived.load(), static_cast<int64_t>(downloaded.size()));
+      EXPECT_TRUE(std::equal(downloaded.begin(), downloaded.end(), content.begin() + offset));
+    }
+  }
+
+  TEST(DownloadToSinkTest, InOrder)
+  {
+    MockStorageServer server;
+    const std::string blobName = "DownloadToSink" + RandomString();
+    Blobs::BlobClient blobClient(server.GetBlobUrl(blobName));
+
+    for (std::size_t size : {std::size_t(0), std::size_t(1), std::size_t(2_MB + 77)})
+    {
+      std::vector<uint8_t> content = RandomBuffer(size);
+      server.SetBlob(blobName, content);
+
+      std::vector<uint8_t> downloaded;
+      std::atomic<bool> inSink{false};
+      Blobs::DownloadBlobToOptions options;
+      options.InitialChunkSize = 64_KB;
+      options.ChunkSize = 64_KB;
+      options.Concurrency = 8;
+      options.ReorderWindowSize = 256_KB;
+      blobClient.DownloadTo(
+          [&](const uint8_t* data, std::size_t length, int64_t offset) {
+            EXPECT_FALSE(inSink.exchange(true));
+            EXPECT_EQ(offset, static_cast<int64_t>(downloaded.size()));
+            downloaded.insert(downloaded.end(), data, data + length);
+            inSink = false;
+          },
+          options);
+      EXPECT_EQ(downloaded, content);
+    }
+  }
+
+  TEST(DownloadToSinkTest, InOrderWithRequestLimit)
+  {
+    MockStorageServer server;
+    const std::string blobName = "DownloadToSink" + RandomString();
+    std::vector<uint8_t> content = RandomBuffer(static_cast<std::size_t>(1_MB + 9));
+    server.SetBlob(blobName, content);
+    Blobs::BlobClient blobClient(server.GetBlobUrl(blobName));
+
+    // Chunks waiting for the window must not hold the permits the next chunk to deliver needs.
+    TransferLimits limits;
+    limits.MaxConcurrentRequests = 2;
+    TransferGovernor::Default().SetLimits(limits);
+    std::vector<uint8_t> downloaded;
+    Blobs::DownloadBlobToOptions options;
+    options.InitialChunkSize = 16_KB;
+    options.ChunkSize = 16_KB;
+    options.Concurrency = 16;
+    options.ReorderWindowSize = 64_KB;
+    try
+    {
+      blobClient.DownloadTo(
+          [&](const uint8_t* data, std::size_t length, int64_t) {
+            downloaded.insert(downloaded.end(), data, data + length);
+          },
+          options);
+    }
+    catch (...)
+    {
+      TransferGovernor::Default().SetLimits(TransferLimits());
+      throw;
+    }
+    TransferGovernor::Default().SetLimits(TransferLimits());
+    EXPECT_EQ(downloaded, content);
+  }
+
+  TEST(DownloadToSinkTest, InOrderWithMemoryLimit)
+  {
+    MockStorageServer server;
+    const std::string blobName = "DownloadToSink" + RandomString();
+    std::vector<uint8_t> content = RandomBuffer(static_cast<std::size_t>(1_MB + 9));
+    server.SetBlob(blobName, content);
+    Blobs::BlobClient blobClient(server.GetBlobUrl(blobName));
+
+    // Chunks ahead of their turn must not hold the memory the next chunk to deliver needs.
+    auto& pool = Azure::Core::Http::BufferPool::Default();
+    const int64_t memoryLimit = pool.GetMemoryLimit();
+    pool.SetMemoryLimit(64_KB);
+    std::vector<uint8_t> downloaded;
+    Blobs::DownloadBlobToOptions options;
+    options.InitialChunkSize = 16_KB;
+    options.ChunkSize = 16_KB;
+    options.Concurrency = 16;
+    options.ReorderWindowSize = 256_KB;
+    try
+    {
+      blobClient.DownloadTo(
+          [&](const uint8_t* data, std::size_t length, int64_t) {
+            downloaded.insert(downloaded.end(), data, data + length);
+          },
+          options);
+    }
+    catch (...)
+    {
+      pool.SetMemoryLimit(memoryLimit);
+      throw;
+    }
+    pool.SetMemoryLimit(memoryLimit);
+    EXPECT_EQ(downloaded, content);
+  }
+
+  TEST(DownloadToSinkTest, SinkFailure)
+  {
+    MockStorageServer server;
+    const std::string blobName = "DownloadToSink" + RandomString();
+    server.SetBlob(blobName, RandomBuffer(static_cast<std::size_t>(1_MB)));
+    Blobs::BlobClient blobClient(server.GetBlobUrl(blobName));
+
+    for (bool inOrder : {false, true})
+    {
+      Blobs::DownloadBlobToOptions options;
+      options.InitialChunkSize = 16_KB;
+      options.ChunkSize = 16_KB;
+      options.Concurrency = 4;
+      if (inOrder)
+      {
+        options.ReorderWindowSize = 64_KB;
+      }
+      EXPECT_THROW(
+          blobClient.DownloadTo(
+              [&](const uint8_t*, std::size_t, int64_t offset) {
+                if (offset >= static_cast<int64_t>(256_KB))
+                {
+                  throw std::runtime_error("sink failure");
+                }
+              },
+              options),
+          std::runtime_error);
+    }
+  }
+
+#endif
+
+}}} // namespace Azure::Storage::Test
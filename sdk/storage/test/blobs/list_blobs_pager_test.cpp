@@ -0,0 +1,104 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include "blobs/blob.hpp"
+#include "mock_storage_server.hpp"
+#include "test_base.hpp"
+
+#include <thread>
+
+namespace Azure { namespace Storage { namespace Test {
+
+#ifndef _WIN32
+
+  namespace {
+    void WaitForRequests(const MockStorageServer& server, int64_t requestCount)
+    {
+      for (int i = 0; i < 500 && server.GetRequestCount() < requestCount; ++i)
+      {
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+      }
+    }
+  } // namespace
+
+  TEST(ListBlobsPagerTest, Flat)
+  {
+    MockStorageServer server;
+    std::vector<std::string> blobNames;
+    for (int i = 0; i < 25; ++i)
+    {
+      blobNames.push_back("blob" + std::to_string(100 + i));
+      server.SetBlob(blobNames.back(), std::vector<uint8_t>(static_cast<std::size_t>(i)));
+    }
+    server.SetBlob("other", {});
+    Blobs::BlobContainerClient containerClient(server.GetContainerUrl());
+
+    Blobs::ListBlobsOptions options;
+    options.Prefix = "blob";
+    options.MaxResults = 4;
+    auto pager = containerClient.ListBlobsFlatPages(options, 2);
+    std::vector<std::string> listedNames;
+    auto segment = pager.NextSegment();
+    // the next two segments are fetched while this one is held, and no more
+    WaitForRequests(server, 3);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_EQ(server.GetRequestCount(), 3);
+    while (true)
+    {
+      for (const auto& item : segment.Items)
+      {
+        EXPECT_EQ(item.Name, blobNames[listedNames.size()]);
+        EXPECT_EQ(item.ContentLength, static_cast<int64_t>(listedNames.size()));
+        listedNames.push_back(item.Name);
+      }
+      if (!pager.HasMoreSegments())
+      {
+        break;
+      }
+      segment = pager.NextSegment();
+    }
+    EXPECT_EQ(listedNames, blobNames);
+    EXPECT_EQ(server.GetRequestCount(), 7);
+    EXPECT_THROW(pager.NextSegment(), std::out_of_range);
+
+    // resumes from a marker, and surfaces errors
+    options.Marker = "blob120";
+    server.FailRequestsAfter(1);
+    auto resumedPager = containerClient.ListBlobsFlatPages(options);
+    EXPECT_EQ(resumedPager.NextSegment().Items.front().Name, "blob120");
+    EXPECT_TRUE(resumedPager.HasMoreSegments());
+    EXPECT_THROW(resumedPager.NextSegment(), StorageError);
+  }
+
+  TEST(ListBlobsPagerTest, ByHierarchy)
+  {
+    MockStorageServer server;
+    for (const std::string name : {"a/1", "a/2", "b", "c/d/1", "e"})
+    {
+      server.SetBlob(name, {});
+    }
+    Blobs::BlobContainerClient containerClient(server.GetContainerUrl());
+
+    Blobs::ListBlobsOptions options;
+    options.MaxResults = 2;
+    auto pager = containerClient.ListBlobsByHierarchyPages("/", options);
+    std::vector<std::string> names;
+    while (pager.HasMoreSegments())
+    {
+      auto segment = pager.NextSegment();
+      for (const auto& prefix : segment.BlobPrefixes)
+      {
+        names.push_back(prefix.Name);
+      }
+      for (const auto& item : segment.Items)
+      {
+        names.push_back(item.Name);
+      }
+    }
+    std::sort(names.begin(), names.end());
+    EXPECT_EQ(names, std::vector<std::string>({"a/", "b", "c/", "e"}));
+  }
+
+#endif
+
+}}} // namespace Azure::Storage::Test
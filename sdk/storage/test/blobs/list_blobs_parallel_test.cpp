@@ -0,0 +1,151 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include "blobs/blob.hpp"
+#include "mock_storage_server.hpp"
+#include "test_base.hpp"
+
+namespace Azure { namespace Storage { namespace Test {
+
+#ifndef _WIN32
+
+  TEST(ListBlobsParallelTest, DiscoveredShards)
+  {
+    MockStorageServer server;
+    std::vector<std::string> blobNames;
+    for (const std::string directory : {"a/", "b/x/", "b/y/", "c/"})
+    {
+      for (int i = 0; i < 7; ++i)
+      {
+        blobNames.push_back(directory + std::to_string(i));
+      }
+    }
+    blobNames.push_back("a.txt");
+    blobNames.push_back("b/z");
+    blobNames.push_back("d");
+    std::sort(blobNames.begin(), blobNames.end());
+    for (const auto& name : blobNames)
+    {
+      server.SetBlob(name, {});
+    }
+    Blobs::BlobContainerClient containerClient(server.GetContainerUrl());
+
+    Blobs::ListBlobsParallelOptions options;
+    options.Concurrency = 3;
+    // the root and "b/" fit in a page and are split further, the other directories are shards
+    options.MaxResults = 5;
+    options.Sorted = true;
+    std::vector<std::string> listedNames;
+    containerClient.ListBlobsParallel(
+        [&](std::vector<Blobs::BlobItem> items) {
+          for (const auto& item : items)
+          {
+            listedNames.push_back(item.Name);
+          }
+        },
+        options);
+    EXPECT_EQ(listedNames, blobNames);
+
+    options.Sorted = false;
+    listedNames.clear();
+    containerClient.ListBlobsParallel(
+        [&](std::vector<Blobs::BlobItem> items) {
+          for (const auto& item : items)
+          {
+            listedNames.push_back(item.Name);
+          }
+        },
+        options);
+    std::sort(listedNames.begin(), listedNames.end());
+    EXPECT_EQ(listedNames, blobNames);
+
+    // a single shard without concurrency
+    options.Concurrency = 1;
+    options.Prefix = "b/";
+    options.Sorted = true;
+    listedNames.clear();
+    containerClient.ListBlobsParallel(
+        [&](std::vector<Blobs::BlobItem> items) {
+          for (const auto& item : items)
+          {
+            listedNames.push_back(item.Name);
+          }
+        },
+        options);
+    std::vector<std::string> expectedNames;
+    std::copy_if(
+        blobNames.begin(),
+        blobNames.end(),
+        std::back_inserter(expectedNames),
+        [](const std::string& name) { return name.compare(0, 2, "b/") == 0; });
+    EXPECT_EQ(listedNames, expectedNames);
+  }
+
+  TEST(ListBlobsParallelTest, FlatContainer)
+  {
+    MockStorageServer server;
+    std::vector<std::string> blobNames;
+    for (int i = 0; i < 100; ++i)
+    {
+      blobNames.push_back("blob" + std::to_string(i));
+    }
+    std::sort(blobNames.begin(), blobNames.end());
+    for (const auto& name : blobNames)
+    {
+      server.SetBlob(name, {});
+    }
+    Blobs::BlobContainerClient containerClient(server.GetContainerUrl());
+
+    // Discovery looks at a single page before listing the container as one shard.
+    Blobs::ListBlobsParallelOptions options;
+    options.Concurrency = 4;
+    options.MaxResults = 10;
+    options.Sorted = true;
+    std::vector<std::string> listedNames;
+    containerClient.ListBlobsParallel(
+        [&](std::vector<Blobs::BlobItem> items) {
+          for (const auto& item : items)
+          {
+            listedNames.push_back(item.Name);
+          }
+        },
+        options);
+    EXPECT_EQ(listedNames, blobNames);
+    EXPECT_EQ(server.GetRequestCount(), 1 + 10);
+  }
+
+  TEST(ListBlobsParallelTest, ShardPrefixes)
+  {
+    MockStorageServer server;
+    for (const std::string name : {"k1", "k10", "k2", "k3", "m1", "z"})
+    {
+      server.SetBlob(name, {});
+    }
+    Blobs::BlobContainerClient containerClient(server.GetContainerUrl());
+
+    Blobs::ListBlobsParallelOptions options;
+    // "k1" is covered by "k" and listed once
+    options.ShardPrefixes = {"m", "k1", "k"};
+    options.Concurrency = 2;
+    options.MaxResults = 1;
+    options.Sorted = true;
+    std::vector<std::string> listedNames;
+    containerClient.ListBlobsParallel(
+        [&](std::vector<Blobs::BlobItem> items) {
+          for (const auto& item : items)
+          {
+            listedNames.push_back(item.Name);
+          }
+        },
+        options);
+    EXPECT_EQ(listedNames, std::vector<std::string>({"k1", "k10", "k2", "k3", "m1"}));
+
+    server.FailRequestsAfter(2);
+    EXPECT_THROW(
+        containerClient.ListBlobsParallel([](std::vector<Blobs::BlobItem>) {}, options),
+        StorageError);
+  }
+
+#endif
+
+}}} // namespace Azure::Storage::Test
@@ -0,0 +1,69 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include "blobs/blob.hpp"
+#include "common/file_io.hpp"
+#include "mock_storage_server.hpp"
+#include "test_base.hpp"
+
+namespace Azure { namespace Storage { namespace Test {
+
+#ifndef _WIN32
+
+  namespace {
+    void WriteFile(const std::string& file, const std::vector<uint8_t>& content)
+    {
+      Details::FileWriter fileWriter(file);
+      fileWriter.Write(content.data(), static_cast<int64_t>(content.size()), 0);
+    }
+  } // namespace
+
+  TEST(PageBlobUploadTest, SkipsZeroPages)
+  {
+    MockStorageServer server;
+    const std::string blobName = "PageBlobUpload" + RandomString();
+    Blobs::PageBlobClient pageBlobClient(server.GetBlobUrl(blobName));
+
+    std::vector<uint8_t> content(static_cast<std::size_t>(10_MB), 0);
+    auto fill = [&](int64_t offset, int64_t length) {
+      auto data = RandomBuffer(static_cast<std::size_t>(length));
+      std::copy(data.begin(), data.end(), content.begin() + offset);
+    };
+    // the first chunk of 4MiB: a range, a page with a short gap to the next page, which is sent
+    // along with them, and a range that ends the chunk
+    fill(0, 4_KB);
+    fill(1_MB + 512, 512);
+    fill(1_MB + 8_KB, 100);
+    fill(4_MB - 1_KB, 1_KB);
+    // the second chunk
+    fill(4_MB, 1_KB);
+    fill(6_MB, 200_KB);
+    // the third chunk, a page holding a single byte
+    content.back() = 1;
+    const std::string file = RandomString();
+    WriteFile(file, content);
+
+    Blobs::UploadPageBlobFromFileOptions options;
+    options.Concurrency = 4;
+    options.TransactionalHashAlgorithm = HashAlgorithm::Crc64;
+    auto res = pageBlobClient.UploadFromFile(file, options);
+    EXPECT_FALSE(res->ETag.empty());
+    EXPECT_EQ(server.GetBlob(blobName), content);
+    // Create, the 6 ranges with data and Get Properties
+    EXPECT_EQ(server.GetRequestCount(), 1 + 6 + 1);
+
+    // an empty disk only creates the blob
+    WriteFile(file, std::vector<uint8_t>(static_cast<std::size_t>(1_MB), 0));
+    int64_t requestCount = server.GetRequestCount();
+    pageBlobClient.UploadFromFile(file, options);
+    EXPECT_EQ(server.GetRequestCount() - requestCount, 1);
+    EXPECT_EQ(server.GetBlob(blobName), std::vector<uint8_t>(static_cast<std::size_t>(1_MB), 0));
+
+    WriteFile(file, std::vector<uint8_t>(1000, 1));
+    EXPECT_THROW(pageBlobClient.UploadFromFile(file, options), std::runtime_error);
+    DeleteFile(file);
+  }
+
+#endif
+
+}}} // namespace Azure::Storage::Test
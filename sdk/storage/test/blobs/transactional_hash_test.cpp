@@ -0,0 +1,113 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include "blobs/blob.hpp"
+#include "mock_storage_server.hpp"
+#include "test_base.hpp"
+
+namespace Azure { namespace Storage { namespace Test {
+
+#ifndef _WIN32
+
+  namespace {
+    // A stream that doesn't know its length.
+    class UnknownLengthBodyStream : public Azure::Core::Http::MemoryBodyStream {
+    public:
+      using MemoryBodyStream::MemoryBodyStream;
+
+      int64_t Length() const override { return -1; }
+    };
+  } // namespace
+
+  TEST(TransactionalHashTest, ParallelTransfers)
+  {
+    MockStorageServer server;
+
+    for (auto algorithm : {HashAlgorithm::Md5, HashAlgorithm::Crc64})
+    {
+      for (std::size_t size : {std::size_t(0), std::size_t(1), std::size_t(1_MB + 17)})
+      {
+        const std::string blobName = "TransactionalHash" + RandomString();
+        Blobs::BlockBlobClient blockBlobClient(server.GetBlobUrl(blobName));
+        std::vector<uint8_t> content = RandomBuffer(size);
+
+        Blobs::UploadBlobOptions uploadOptions;
+        uploadOptions.ChunkSize = 256_KB;
+        uploadOptions.Concurrency = 4;
+        uploadOptions.TransactionalHashAlgorithm = algorithm;
+        blockBlobClient.UploadFromBuffer(content.data(), content.size(), uploadOptions);
+        EXPECT_EQ(server.GetBlob(blobName), content);
+
+        std::vector<uint8_t> downloaded(content.size());
+        Blobs::DownloadBlobToBufferOptions downloadOptions;
+        downloadOptions.InitialChunkSize = 100_KB;
+        downloadOptions.ChunkSize = 300_KB;
+        downloadOptions.Concurrency = 4;
+        downloadOptions.TransactionalHashAlgorithm = algorithm;
+        auto res = blockBlobClient.DownloadToBuffer(
+            downloaded.data(), downloaded.size(), downloadOptions);
+        EXPECT_EQ(res->ContentLength, static_cast<int64_t>(content.size()));
+        EXPECT_EQ(downloaded, content);
+
+        const std::string tempFilename = RandomString();
+        blockBlobClient.DownloadToFile(tempFilename, downloadOptions);
+        const std::string copyName = blobName + "Copy";
+        Blobs::BlockBlobClient copyClient(server.GetBlobUrl(copyName));
+        copyClient.UploadFromFile(tempFilename, uploadOptions);
+        EXPECT_EQ(server.GetBlob(copyName), content);
+        DeleteFile(tempFilename);
+      }
+    }
+  }
+
+  TEST(TransactionalHashTest, SingleRequests)
+  {
+    MockStorageServer server;
+
+    for (auto algorithm : {HashAlgorithm::Md5, HashAlgorithm::Crc64})
+    {
+      const std::string blobName = "TransactionalHash" + RandomString();
+      Blobs::BlockBlobClient blockBlobClient(server.GetBlobUrl(blobName));
+      std::vector<uint8_t> content = RandomBuffer(static_cast<std::size_t>(10_KB));
+
+      Azure::Core::Http::MemoryBodyStream blockContent(content.data(), content.size());
+      Blobs::StageBlockOptions stageBlockOptions;
+      // A wrong hash supplied by the caller is replaced.
+      stageBlockOptions.ContentMd5 = "AAAAAAAAAAAAAAAAAAAAAA==";
+      stageBlockOptions.TransactionalHashAlgorithm = algorithm;
+      const std::string blockId = Base64Encode("0");
+      blockBlobClient.StageBlock(blockId, &blockContent, stageBlockOptions);
+      blockBlobClient.CommitBlockList({{Blobs::BlockType::Uncommitted, blockId}});
+      EXPECT_EQ(server.GetBlob(blobName), content);
+
+      Blobs::DownloadBlobOptions downloadOptions;
+      downloadOptions.Offset = 1_KB;
+      downloadOptions.Length = 2_KB;
+      downloadOptions.TransactionalHashAlgorithm = algorithm;
+      auto res = blockBlobClient.Download(downloadOptions);
+      auto downloaded = Azure::Core::Http::BodyStream::ReadToEnd(
+          Azure::Core::Context(), *res->BodyStream);
+      EXPECT_EQ(
+          downloaded,
+          std::vector<uint8_t>(
+              content.begin() + static_cast<std::ptrdiff_t>(1_KB),
+              content.begin() + static_cast<std::ptrdiff_t>(3_KB)));
+
+      // The service only hashes explicit ranges of at most 4MiB.
+      downloadOptions.Length.Reset();
+      EXPECT_THROW(blockBlobClient.Download(downloadOptions), std::runtime_error);
+      downloadOptions.Length = 4_MB + 1;
+      EXPECT_THROW(blockBlobClient.Download(downloadOptions), std::runtime_error);
+
+      // A block of unknown length is read to its end before it's hashed.
+      std::vector<uint8_t> largeContent = RandomBuffer(static_cast<std::size_t>(2_MB + 3));
+      UnknownLengthBodyStream unknownLengthContent(largeContent.data(), largeContent.size());
+      blockBlobClient.StageBlock(blockId, &unknownLengthContent, stageBlockOptions);
+      blockBlobClient.CommitBlockList({{Blobs::BlockType::Uncommitted, blockId}});
+      EXPECT_EQ(server.GetBlob(blobName), largeContent);
+    }
+  }
+
+#endif
+
+}}} // namespace Azure::Storage::Test
@@ -0,0 +1,104 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include "blobs/blob.hpp"
+#include "mock_storage_server.hpp"
+#include "test_base.hpp"
+
+#include <chrono>
+#include <functional>
+
+namespace Azure { namespace Storage { namespace Test {
+
+#ifndef _WIN32
+
+  TEST(TransferTuningTest, AutoTunedTransfersWithMockServer)
+  {
+    MockStorageServerOptions serverOptions;
+    serverOptions.Latency = std::chrono::milliseconds(1);
+    MockStorageServer server(serverOptions);
+    const std::string blobName = "AutoTune" + RandomString();
+    Blobs::BlockBlobClient blockBlobClient(server.GetBlobUrl(blobName));
+
+    TransferTuningOptions tuningOptions;
+    tuningOptions.MinChunkSize = 64_KB;
+    tuningOptions.MaxChunkSize = 1_MB;
+    tuningOptions.MaxConcurrency = 8;
+
+    std::vector<uint8_t> content = RandomBuffer(static_cast<std::size_t>(10_MB + 123));
+    Blobs::UploadBlobOptions uploadOptions;
+    uploadOptions.AutoTune = tuningOptions;
+    blockBlobClient.UploadFromBuffer(content.data(), content.size(), uploadOptions);
+    EXPECT_EQ(server.GetBlob(blobName), content);
+
+    std::vector<uint8_t> downloaded(content.size());
+    Blobs::DownloadBlobToBufferOptions downloadOptions;
+    downloadOptions.Offset = 0;
+    downloadOptions.InitialChunkSize = 64_KB;
+    downloadOptions.AutoTune = tuningOptions;
+    auto res = blockBlobClient.DownloadToBuffer(
+        downloaded.data(), downloaded.size(), downloadOptions);
+    EXPECT_EQ(res->ContentLength, static_cast<int64_t>(content.size()));
+    EXPECT_EQ(downloaded, content);
+  }
+
+  TEST(TransferTuningTest, DISABLED_AutoTuneBenchmark)
+  {
+    // A link with a high round trip time and limited bandwidth, where a single connection is
+    // latency bound.
+    MockStorageServerOptions serverOptions;
+    serverOptions.Latency = std::chrono::milliseconds(30);
+    serverOptions.BytesPerSecond = static_cast<int64_t>(400_MB);
+    MockStorageServer server(serverOptions);
+
+    constexpr std::size_t bufferSize = static_cast<std::size_t>(256_MB);
+    std::vector<uint8_t> buffer = RandomBuffer(bufferSize);
+
+    auto measure = [&](const std::string& name, std::function<void()> transfer) {
+      auto timer_start = std::chrono::steady_clock::now();
+      transfer();
+      auto timer_end = std::chrono::steady_clock::now();
+      double speed = static_cast<double>(bufferSize) / 1_MB
+          / std::chrono::duration_cast<std::chrono::milliseconds>(timer_end - timer_start).count()
+          * 1000;
+      std::cout << name << ": " << speed << "MiB/s" << std::endl;
+    };
+
+    Blobs::BlockBlobClient blockBlobClient(server.GetBlobUrl("AutoTuneBenchmark"));
+    for (int concurrency : {1, 4, 16})
+    {
+      Blobs::UploadBlobOptions options;
+      options.Concurrency = concurrency;
+      measure("Upload, concurrency " + std::to_string(concurrency), [&]() {
+        blockBlobClient.UploadFromBuffer(buffer.data(), buffer.size(), options);
+      });
+    }
+    {
+      Blobs::UploadBlobOptions options;
+      options.AutoTune = TransferTuningOptions();
+      measure("Upload, auto-tuned", [&]() {
+        blockBlobClient.UploadFromBuffer(buffer.data(), buffer.size(), options);
+      });
+    }
+    for (int concurrency : {1, 4, 16})
+    {
+      Blobs::DownloadBlobToBufferOptions options;
+      options.Offset = 0;
+      options.Concurrency = concurrency;
+      measure("Download, concurrency " + std::to_string(concurrency), [&]() {
+        blockBlobClient.DownloadToBuffer(buffer.data(), buffer.size(), options);
+      });
+    }
+    {
+      Blobs::DownloadBlobToBufferOptions options;
+      options.Offset = 0;
+      options.AutoTune = TransferTuningOptions();
+      measure("Download, auto-tuned", [&]() {
+        blockBlobClient.DownloadToBuffer(buffer.data(), buffer.size(), options);
+      });
+    }
+  }
+
+#endif
+
+}}} // namespace Azure::Storage::Test
@@ -0,0 +1,73 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include "blobs/blob.hpp"
+#include "mock_storage_server.hpp"
+#include "test_base.hpp"
+
+#include <algorithm>
+
+namespace Azure { namespace Storage { namespace Test {
+
+#ifndef _WIN32
+
+  namespace {
+    // A stream that can only be read once, in small pieces, and doesn't know its length.
+    class ForwardOnlyBodyStream : public Azure::Core::Http::BodyStream {
+    public:
+      explicit ForwardOnlyBodyStream(const std::vector<uint8_t>& content) : m_content(content) {}
+
+      int64_t Length() const override { return -1; }
+
+      void Rewind() override { throw std::runtime_error("stream is not rewindable"); }
+
+      int64_t Read(Azure::Core::Context const& context, uint8_t* buffer, int64_t count) override
+      {
+        (void)context;
+        int64_t length = std::min(
+            {count,
+             static_cast<int64_t>(1_KB) + 7,
+             static_cast<int64_t>(m_content.size()) - m_offset});
+        std::copy(m_content.begin() + m_offset, m_content.begin() + m_offset + length, buffer);
+        m_offset += length;
+        return length;
+      }
+
+    private:
+      const std::vector<uint8_t>& m_content;
+      int64_t m_offset = 0;
+    };
+  } // namespace
+
+  TEST(UploadFromStreamTest, UploadForwardOnlyStream)
+  {
+    MockStorageServer server;
+
+    for (std::size_t size :
+         {std::size_t(0), std::size_t(1), std::size_t(64_KB), std::size_t(300_KB + 5)})
+    {
+      const std::string blobName = "UploadFromStream" + RandomString();
+      Blobs::BlockBlobClient blockBlobClient(server.GetBlobUrl(blobName));
+      std::vector<uint8_t> content = RandomBuffer(size);
+      ForwardOnlyBodyStream stream(content);
+
+      Blobs::UploadBlobOptions options;
+      options.ChunkSize = 64_KB;
+      options.Concurrency = 4;
+      blockBlobClient.UploadFromStream(&stream, options);
+      EXPECT_EQ(server.GetBlob(blobName), content);
+    }
+
+    std::vector<uint8_t> content(1);
+    ForwardOnlyBodyStream stream(content);
+    Blobs::BlockBlobClient blockBlobClient(server.GetBlobUrl("UploadFromStream"));
+    Blobs::UploadBlobOptions options;
+    options.ChunkSize = 0;
+    EXPECT_THROW(blockBlobClient.UploadFromStream(&stream, options), std::runtime_error);
+    options.ChunkSize = 4001_MB;
+    EXPECT_THROW(blockBlobClient.UploadFromStream(&stream, options), std::runtime_error);
+  }
+
+#endif
+
+}}} // namespace Azure::Storage::Test
@@ -0,0 +1,176 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include "common/concurrent_transfer.hpp"
+#include "test_base.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+namespace Azure { namespace Storage { namespace Test {
+
+  TEST(ConcurrentTransferTest, AllChunksTransferred)
+  {
+    for (int concurrency : {1, 2, 4, 16})
+    {
+      for (int64_t length : {0, 1, 999, 1000, 1001, 12345})
+      {
+        constexpr int64_t chunkSize = 100;
+        std::vector<std::atomic<int>> transferred(static_cast<std::size_t>(length));
+        std::atomic<int64_t> numChunksSeen{-1};
+        Details::ConcurrentTransfer(
+            10,
+            length,
+            chunkSize,
+            concurrency,
+            [&](int64_t offset, int64_t chunkLength, int64_t chunkId, int64_t numChunks) {
+              EXPECT_EQ(offset, 10 + chunkId * chunkSize);
+              numChunksSeen = numChunks;
+              for (int64_t i = offset - 10; i < offset - 10 + chunkLength; ++i)
+              {
+                ++transferred[static_cast<std::size_t>(i)];
+              }
+            });
+        for (auto& t : transferred)
+        {
+          EXPECT_EQ(t, 1);
+        }
+        if (length != 0)
+        {
+          EXPECT_EQ(numChunksSeen, (length + chunkSize - 1) / chunkSize);
+        }
+      }
+    }
+  }
+
+  TEST(ConcurrentTransferTest, ExceptionPropagated)
+  {
+    std::atomic<int> numCalls{0};
+    EXPECT_THROW(
+        Details::ConcurrentTransfer(
+            0,
+            1000,
+            1,
+            8,
+            [&](int64_t, int64_t, int64_t chunkId, int64_t) {
+              ++numCalls;
+              if (chunkId == 10)
+              {
+                throw std::runtime_error("chunk failed");
+              }
+              std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }),
+        std::runtime_error);
+    EXPECT_LT(numCalls, 1000);
+  }
+
+  TEST(ConcurrentTransferTest, ExecutorLimitsConcurrency)
+  {
+    TransferExecutor executor(3);
+    std::mutex mutex;
+    int running = 0;
+    int maxRunning = 0;
+    int runningOnWorkers = 0;
+    int maxRunningOnWorkers = 0;
+    std::set<std::thread::id> workers;
+
+    auto runOperation = [&]() {
+      const auto caller = std::this_thread::get_id();
+      std::atomic<int> remaining{20};
+      executor.Run(8, [&]() {
+        if (remaining.fetch_sub(1) <= 0)
+        {
+          return false;
+        }
+        const bool onWorker = std::this_thread::get_id() != caller;
+        {
+          std::lock_guard<std::mutex> guard(mutex);
+          maxRunning = std::max(maxRunning, ++running);
+          if (onWorker)
+          {
+            workers.insert(std::this_thread::get_id());
+            maxRunningOnWorkers = std::max(maxRunningOnWorkers, ++runningOnWorkers);
+          }
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        std::lock_guard<std::mutex> guard(mutex);
+        --running;
+        if (onWorker)
+        {
+          --runningOnWorkers;
+        }
+        return true;
+      });
+    };
+
+    // A single call runs on its thread and up to 3 workers.
+    runOperation();
+    EXPECT_GT(maxRunning, 1);
+    EXPECT_LE(maxRunning, 3 + 1);
+
+    // Concurrent calls share the same 3 workers, and also run on each of the 4 calling threads.
+    maxRunning = 0;
+    std::vector<std::future<void>> operations;
+    for (int i = 0; i < 4; ++i)
+    {
+      operations.emplace_back(std::async(std::launch::async, runOperation));
+    }
+    for (auto& f : operations)
+    {
+      f.get();
+    }
+    EXPECT_GT(maxRunning, 1);
+    EXPECT_LE(maxRunning, 3 + 4);
+    EXPECT_GT(maxRunningOnWorkers, 0);
+    EXPECT_LE(maxRunningOnWorkers, 3);
+    EXPECT_LE(workers.size(), 3U);
+    EXPECT_EQ(running, 0);
+  }
+
+  TEST(ConcurrentTransferTest, GovernorLimits)
+  {
+    TransferLimits limits;
+    limits.MaxConcurrentRequests = 2;
+    limits.MaxBufferedBytes = 1000;
+    TransferGovernor governor(limits);
+
+    auto first = governor.Acquire(600);
+    EXPECT_EQ(governor.GetInFlightRequests(), 1);
+    EXPECT_EQ(governor.GetInFlightBytes(), 600);
+
+    std::atomic<bool> admitted{false};
+    std::thread waiter([&]() {
+      auto second = governor.Acquire(600);
+      admitted = true;
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_FALSE(admitted);
+    first.Release();
+    waiter.join();
+    EXPECT_TRUE(admitted);
+    EXPECT_EQ(governor.GetInFlightRequests(), 0);
+    EXPECT_EQ(governor.GetInFlightBytes(), 0);
+
+    // A chunk above the byte limit is admitted when nothing else is in flight.
+    auto oversized = governor.Acquire(5000);
+    oversized.Release();
+
+    limits.MaxBytesPerSecond = 100000;
+    governor.SetLimits(limits);
+    auto timerStart = std::chrono::steady_clock::now();
+    for (int i = 0; i < 5; ++i)
+    {
+      governor.Acquire(10000);
+    }
+    auto elapsed = std::chrono::steady_clock::now() - timerStart;
+    // The first chunk starts immediately, the remaining four take 0.1s each.
+    EXPECT_GE(elapsed, std::chrono::milliseconds(390));
+  }
+
+}}} // namespace Azure::Storage::Test
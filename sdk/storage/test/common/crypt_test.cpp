@@ -0,0 +1,299 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include "common/crypt.hpp"
+#include "common/content_hash.hpp"
+#include "test_base.hpp"
+
+#include <chrono>
+#include <functional>
+#include <vector>
+
+#ifndef _WIN32
+#include <openssl/bio.h>
+#include <openssl/buffer.h>
+#include <openssl/evp.h>
+#endif
+
+namespace Azure { namespace Storage { namespace Test {
+
+  namespace {
+    uint64_t BitwiseCrc64(const uint8_t* data, std::size_t length)
+    {
+      uint64_t crc = ~uint64_t(0);
+      for (std::size_t i = 0; i < length; ++i)
+      {
+        crc ^= data[i];
+        for (int j = 0; j < 8; ++j)
+        {
+          crc = crc & 1 ? (crc >> 1) ^ 0x9A6C9329AC4BC9B5ULL : crc >> 1;
+        }
+      }
+      return ~crc;
+    }
+
+#ifndef _WIN32
+    // The codec used before the table-driven one, kept to compare their speed.
+    std::string OpenSslBase64Encode(const std::string& text)
+    {
+      BIO* bio = BIO_new(BIO_s_mem());
+      bio = BIO_push(BIO_new(BIO_f_base64()), bio);
+      BIO_set_flags(bio, BIO_FLAGS_BASE64_NO_NL);
+      BIO_write(bio, text.data(), static_cast<int>(text.length()));
+      BIO_flush(bio);
+      BUF_MEM* bufferPtr;
+      BIO_get_mem_ptr(bio, &bufferPtr);
+      std::string encoded(bufferPtr->data, bufferPtr->length);
+      BIO_free_all(bio);
+      return encoded;
+    }
+
+    std::string OpenSslBase64Decode(const std::string& text)
+    {
+      std::string decoded(text.length() / 4 * 3, '\0');
+      BIO* bio = BIO_new_mem_buf(text.data(), static_cast<int>(text.length()));
+      bio = BIO_push(BIO_new(BIO_f_base64()), bio);
+      BIO_set_flags(bio, BIO_FLAGS_BASE64_NO_NL);
+      int decodedLength = BIO_read(bio, &decoded[0], static_cast<int>(text.length()));
+      BIO_free_all(bio);
+      decoded.resize(decodedLength);
+      return decoded;
+    }
+#endif
+  } // namespace
+
+  TEST(CryptTest, Base64KnownValues)
+  {
+    // RFC 4648, section 10
+    const std::vector<std::pair<std::string, std::string>> vectors = {
+        {"", ""},
+        {"f", "Zg=="},
+        {"fo", "Zm8="},
+        {"foo", "Zm9v"},
+        {"foob", "Zm9vYg=="},
+        {"fooba", "Zm9vYmE="},
+        {"foobar", "Zm9vYmFy"},
+    };
+    for (const auto& p : vectors)
+    {
+      EXPECT_EQ(Base64Encode(p.first), p.second);
+      EXPECT_EQ(Base64Decode(p.second), p.first);
+    }
+    EXPECT_EQ(Base64Decode("Zm9vYg"), "foob");
+    EXPECT_EQ(Base64Decode("Zm9vYmE"), "fooba");
+    EXPECT_EQ(Base64Encode(std::string("\xfb\xff\x00", 3)), "+/8A");
+
+    EXPECT_THROW(Base64Decode("Zm9vY"), std::runtime_error);
+    EXPECT_THROW(Base64Decode("Zm9v\nYmFy"), std::runtime_error);
+    EXPECT_THROW(Base64Decode("Zg==Zg=="), std::runtime_error);
+    EXPECT_THROW(Base64Decode("===="), std::runtime_error);
+  }
+
+  TEST(CryptTest, Base64RoundTrip)
+  {
+    for (std::size_t length = 0; length < 100; ++length)
+    {
+      std::vector<uint8_t> content = RandomBuffer(length);
+      const std::string text(content.begin(), content.end());
+      const std::string encoded = Base64Encode(text);
+      EXPECT_EQ(encoded.length(), Details::Base64EncodedLength(length));
+#ifndef _WIN32
+      EXPECT_EQ(encoded, OpenSslBase64Encode(text));
+#endif
+      EXPECT_EQ(Base64Decode(encoded), text);
+    }
+  }
+
+  TEST(CryptTest, Crc64KnownValues)
+  {
+    const std::string text = "123456789";
+    Crc64 crc64;
+    EXPECT_EQ(crc64.Final(), "AAAAAAAAAAA=");
+    crc64.Update(reinterpret_cast<const uint8_t*>(text.data()), text.length());
+    EXPECT_EQ(crc64.GetValue(), 0xAE8B14860A799888ULL);
+    EXPECT_EQ(crc64.GetLength(), 9);
+    EXPECT_EQ(crc64.Final(), "iJh5CoYUi64=");
+  }
+
+  TEST(CryptTest, Md5KnownValues)
+  {
+    EXPECT_EQ(Md5().Final(), "1B2M2Y8AsgTpgAmY7PhCfg==");
+
+    const std::string text = "123456789";
+    Md5 md5;
+    md5.Update(reinterpret_cast<const uint8_t*>(text.data()), 4);
+    md5.Update(reinterpret_cast<const uint8_t*>(text.data()) + 4, text.length() - 4);
+    EXPECT_EQ(md5.Final(), "JfnnlDI7RTiF9RgfG2JNCw==");
+
+    Details::ContentHasher hasher(HashAlgorithm::Md5);
+    hasher.Update(reinterpret_cast<const uint8_t*>(text.data()), text.length());
+    EXPECT_EQ(hasher.Final(), "JfnnlDI7RTiF9RgfG2JNCw==");
+  }
+
+  TEST(CryptTest, HmacSha256KnownValues)
+  {
+    // RFC 4231, test case 2
+    const std::string expected = "W9zBRr9gdU5qBCQmCJV1x1oAPwidJzmDnexYuWTsOEM=";
+    const std::string text = "what do ya want for nothing?";
+    EXPECT_EQ(Base64Encode(Hmac_Sha256(text, "Jefe")), expected);
+
+    HmacSha256 hmac("Jefe");
+    EXPECT_EQ(Base64Encode(hmac.Sign(text)), expected);
+    // The key is still set up after signing.
+    EXPECT_EQ(Base64Encode(hmac.Sign(text)), expected);
+    EXPECT_NE(hmac.Sign(""), hmac.Sign(text));
+  }
+
+  TEST(CryptTest, Crc64MatchesBitwise)
+  {
+    std::vector<uint8_t> buffer = RandomBuffer(static_cast<std::size_t>(64_KB));
+    for (std::size_t offset : {0, 1, 7, 15})
+    {
+      for (std::size_t length :
+           {0, 1, 8, 15, 16, 63, 64, 127, 128, 129, 191, 192, 200, 1000, 4096, 65000})
+      {
+        EXPECT_EQ(
+            Details::Crc64Update(0, buffer.data() + offset, length),
+            BitwiseCrc64(buffer.data() + offset, length));
+      }
+    }
+  }
+
+  TEST(CryptTest, Crc64Concatenate)
+  {
+    std::vector<uint8_t> buffer = RandomBuffer(static_cast<std::size_t>(100_KB));
+    Crc64 whole;
+    whole.Update(buffer.data(), buffer.size());
+
+    for (std::size_t split :
+         {std::size_t(0), std::size_t(1), std::size_t(4_KB + 3), buffer.size()})
+    {
+      Crc64 first;
+      first.Update(buffer.data(), split);
+      Crc64 second;
+      second.Update(buffer.data() + split, buffer.size() - split);
+      first.Concatenate(second);
+      EXPECT_EQ(first.GetValue(), whole.GetValue());
+      EXPECT_EQ(first.GetLength(), whole.GetLength());
+      EXPECT_EQ(first.Final(), whole.Final());
+    }
+
+    Crc64 incremental;
+    for (std::size_t offset = 0; offset < buffer.size(); offset += 1000)
+    {
+      incremental.Update(
+          buffer.data() + offset, std::min<std::size_t>(1000, buffer.size() - offset));
+    }
+    EXPECT_EQ(incremental.GetValue(), whole.GetValue());
+  }
+
+  TEST(CryptTest, HashValidatingStream)
+  {
+    for (auto algorithm : {HashAlgorithm::Md5, HashAlgorithm::Crc64})
+    {
+      std::vector<uint8_t> content = RandomBuffer(static_cast<std::size_t>(10_KB));
+      Details::ContentHasher hasher(algorithm);
+      hasher.Update(content.data(), content.size());
+      const std::string hash = hasher.Final();
+
+      auto validatingStream = [&]() {
+        return HashValidatingStream(
+            std::make_unique<Azure::Core::Http::MemoryBodyStream>(content.data(), content.size()),
+            algorithm,
+            hash);
+      };
+
+      auto stream = validatingStream();
+      EXPECT_EQ(Azure::Core::Http::BodyStream::ReadToEnd(Azure::Core::Context(), stream), content);
+
+      content[100] ^= 1;
+      auto corruptedStream = validatingStream();
+      EXPECT_THROW(
+          Azure::Core::Http::BodyStream::ReadToEnd(Azure::Core::Context(), corruptedStream),
+          std::runtime_error);
+    }
+  }
+
+  TEST(CryptTest, HashedBufferStream)
+  {
+    std::vector<uint8_t> content = RandomBuffer(static_cast<std::size_t>(3_MB + 5));
+    Azure::Core::Http::MemoryBodyStream source(content.data(), content.size());
+    HashedBufferStream stream(Azure::Core::Context(), source, HashAlgorithm::Md5);
+
+    Md5 md5;
+    md5.Update(content.data(), content.size());
+    EXPECT_EQ(stream.GetHash(), md5.Final());
+    EXPECT_EQ(stream.Length(), static_cast<int64_t>(content.size()));
+    EXPECT_EQ(Azure::Core::Http::BodyStream::ReadToEnd(Azure::Core::Context(), stream), content);
+    stream.Rewind();
+    EXPECT_EQ(Azure::Core::Http::BodyStream::ReadToEnd(Azure::Core::Context(), stream), content);
+  }
+
+  TEST(CryptTest, DISABLED_Crc64Throughput)
+  {
+    constexpr std::size_t bufferSize = static_cast<std::size_t>(256_MB);
+    std::vector<uint8_t> buffer = RandomBuffer(bufferSize);
+    constexpr int rounds = 8;
+
+    auto timer_start = std::chrono::steady_clock::now();
+    uint64_t crc = 0;
+    for (int i = 0; i < rounds; ++i)
+    {
+      crc = Details::Crc64Update(crc, buffer.data(), buffer.size());
+    }
+    auto timer_end = std::chrono::steady_clock::now();
+
+    double seconds = std::chrono::duration<double>(timer_end - timer_start).count();
+    double speed = static_cast<double>(bufferSize) * rounds / 1_GB / seconds;
+    std::cout << "CRC64 speed: " << speed << "GiB/s (" << crc << ")" << std::endl;
+  }
+
+  TEST(CryptTest, DISABLED_Base64Throughput)
+  {
+    constexpr int rounds = 1000000;
+    auto measure = [&](const std::string& name, std::function<std::size_t()> round) {
+      std::size_t checksum = 0;
+      auto timer_start = std::chrono::steady_clock::now();
+      for (int i = 0; i < rounds; ++i)
+      {
+        checksum += round();
+      }
+      auto timer_end = std::chrono::steady_clock::now();
+      double nanoseconds
+          = std::chrono::duration<double, std::nano>(timer_end - timer_start).count() / rounds;
+      std::cout << name << ": " << nanoseconds << "ns (" << checksum << ")" << std::endl;
+    };
+
+    // A block id of parallel uploads, and a signature.
+    const std::string blockId(64, '0');
+    const std::vector<uint8_t> hmacBuffer = RandomBuffer(32);
+    const std::string hmac(hmacBuffer.begin(), hmacBuffer.end());
+    const std::string encodedBlockId = Base64Encode(blockId);
+    const std::string encodedHmac = Base64Encode(hmac);
+
+    measure("Encode 64-byte block id", [&]() { return Base64Encode(blockId).length(); });
+    measure("Encode 64-byte block id to buffer", [&]() {
+      char encoded[Details::Base64EncodedLength(64)];
+      return Details::Base64Encode(
+          reinterpret_cast<const uint8_t*>(blockId.data()), blockId.length(), encoded);
+    });
+    measure("Encode 32-byte HMAC", [&]() { return Base64Encode(hmac).length(); });
+    measure("Decode 64-byte block id", [&]() { return Base64Decode(encodedBlockId).length(); });
+    measure("Decode 32-byte HMAC", [&]() { return Base64Decode(encodedHmac).length(); });
+#ifndef _WIN32
+    measure("OpenSSL BIO encode 64-byte block id", [&]() {
+      return OpenSslBase64Encode(blockId).length();
+    });
+    measure("OpenSSL BIO encode 32-byte HMAC", [&]() {
+      return OpenSslBase64Encode(hmac).length();
+    });
+    measure("OpenSSL BIO decode 64-byte block id", [&]() {
+      return OpenSslBase64Decode(encodedBlockId).length();
+    });
+    measure("OpenSSL BIO decode 32-byte HMAC", [&]() {
+      return OpenSslBase64Decode(encodedHmac).length();
+    });
+#endif
+  }
+
+}}} // namespace Azure::Storage::Test
@@ -0,0 +1,170 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include "blobs/blob.hpp"
+#include "common/file_io.hpp"
+#include "http/buffer_pool.hpp"
+#include "mock_storage_server.hpp"
+#include "test_base.hpp"
+
+#include <cstring>
+
+namespace Azure { namespace Storage { namespace Test {
+
+  TEST(FileIoTest, WriterOptions)
+  {
+    const std::vector<uint8_t> content = RandomBuffer(static_cast<std::size_t>(1_MB + 100));
+    const std::string file = RandomString();
+
+    Details::FileWriterOptions options;
+    options.DirectIo = true;
+    options.WriteBackInterval = 64_KB;
+    {
+      Details::FileWriter fileWriter(file, options);
+      fileWriter.Preallocate(static_cast<int64_t>(content.size()));
+      // Pooled buffers are aligned, so every chunk but the tail can be written directly.
+      auto buffer = Azure::Core::Http::BufferPool::Default().Acquire(32_KB);
+      for (std::size_t offset = 0; offset < content.size(); offset += 32_KB)
+      {
+        std::size_t length = std::min(content.size() - offset, std::size_t(32_KB));
+        std::memcpy(buffer.Data(), content.data() + offset, length);
+        fileWriter.Write(buffer.Data(), static_cast<int64_t>(length), static_cast<int64_t>(offset));
+      }
+      // unaligned memory
+      fileWriter.Write(content.data() + 1, 100, 1);
+    }
+    EXPECT_EQ(ReadFile(file), content);
+
+    // a preallocated file is not truncated by later writes
+    options.Truncate = false;
+    {
+      Details::FileWriter fileWriter(file, options);
+      fileWriter.Preallocate(static_cast<int64_t>(content.size()));
+      fileWriter.Write(content.data(), 10, 0);
+    }
+    EXPECT_EQ(ReadFile(file), content);
+    DeleteFile(file);
+  }
+
+  TEST(FileIoTest, Engine)
+  {
+    const std::vector<uint8_t> content = RandomBuffer(static_cast<std::size_t>(4_MB + 100));
+    constexpr int64_t c_pieceSize = 64_KB;
+
+    for (bool useIoUring : {true, false})
+    {
+      Details::FileIoEngine engine(useIoUring, 8);
+      const std::string file = RandomString();
+      {
+        Details::FileWriter fileWriter(file);
+        std::vector<std::shared_ptr<Details::FileIoOperation>> writes;
+        for (int64_t offset = 0; offset < static_cast<int64_t>(content.size());
+             offset += c_pieceSize)
+        {
+          int64_t length = std::min(static_cast<int64_t>(content.size()) - offset, c_pieceSize);
+          writes.push_back(fileWriter.WriteAsync(engine, content.data() + offset, length, offset));
+        }
+        for (auto& write : writes)
+        {
+          fileWriter.WaitWrite(*write);
+        }
+      }
+      EXPECT_EQ(ReadFile(file), content);
+
+      Details::FileReader fileReader(file);
+      std::vector<uint8_t> buffer(content.size() + 1);
+      auto read = engine.Read(
+          fileReader.GetHandle(), buffer.data(), static_cast<int64_t>(content.size()), 0);
+      read->Wait();
+      buffer.pop_back();
+      EXPECT_EQ(buffer, content);
+      // past the end of the file
+      read = engine.Read(fileReader.GetHandle(), buffer.data(), 200, content.size() - 100);
+      EXPECT_THROW(read->Wait(), std::runtime_error);
+
+      // chunks requested out of order, and some never requested
+      std::vector<std::pair<int64_t, int64_t>> chunks;
+      for (int64_t offset = 0; offset < static_cast<int64_t>(content.size()); offset += 1_MB)
+      {
+        chunks.emplace_back(offset, std::min<int64_t>(content.size() - offset, 1_MB));
+      }
+      Details::FileReadAhead readAhead(engine, fileReader.GetHandle(), chunks, 2);
+      for (std::size_t index : {1, 0, 2, 4})
+      {
+        auto chunk = readAhead.Get(index);
+        EXPECT_TRUE(std::equal(
+            chunk.Data(),
+            chunk.Data() + chunks[index].second,
+            content.begin() + chunks[index].first));
+      }
+      DeleteFile(file);
+    }
+  }
+
+#ifndef _WIN32
+
+  TEST(FileIoTest, AsyncFileIoTransfers)
+  {
+    MockStorageServer server;
+    const std::string blobName = "AsyncFileIo" + RandomString();
+    Blobs::BlockBlobClient blockBlobClient(server.GetBlobUrl(blobName));
+    const std::vector<uint8_t> content = RandomBuffer(static_cast<std::size_t>(3_MB + 7));
+    const std::string file = RandomString();
+    {
+      Details::FileWriter fileWriter(file);
+      fileWriter.Write(content.data(), static_cast<int64_t>(content.size()), 0);
+    }
+
+    Blobs::UploadBlobOptions uploadOptions;
+    uploadOptions.ChunkSize = 256_KB;
+    uploadOptions.Concurrency = 4;
+    uploadOptions.AsyncFileIo = true;
+    uploadOptions.TransactionalHashAlgorithm = HashAlgorithm::Crc64;
+    blockBlobClient.UploadFromFile(file, uploadOptions);
+    EXPECT_EQ(server.GetBlob(blobName), content);
+
+    const std::string tunedBlobName = blobName + "Tuned";
+    uploadOptions.AutoTune = TransferTuningOptions();
+    Blobs::BlockBlobClient(server.GetBlobUrl(tunedBlobName)).UploadFromFile(file, uploadOptions);
+    EXPECT_EQ(server.GetBlob(tunedBlobName), content);
+
+    Blobs::DownloadBlobToFileOptions downloadOptions;
+    downloadOptions.InitialChunkSize = 100_KB;
+    downloadOptions.ChunkSize = 1_MB;
+    downloadOptions.Concurrency = 4;
+    downloadOptions.AsyncFileIo = true;
+    blockBlobClient.DownloadToFile(file, downloadOptions);
+    EXPECT_EQ(ReadFile(file), content);
+    DeleteFile(file);
+  }
+
+  TEST(FileIoTest, DownloadToFileDirectIo)
+  {
+    MockStorageServer server;
+    const std::string blobName = "DirectIo" + RandomString();
+    const std::vector<uint8_t> content = RandomBuffer(static_cast<std::size_t>(2_MB + 7));
+    server.SetBlob(blobName, content);
+    Blobs::BlobClient blobClient(server.GetBlobUrl(blobName));
+
+    const std::string file = RandomString();
+    Blobs::DownloadBlobToFileOptions options;
+    options.InitialChunkSize = 100_KB;
+    options.ChunkSize = 100_KB;
+    options.Concurrency = 4;
+    options.DirectIo = true;
+    auto res = blobClient.DownloadToFile(file, options);
+    EXPECT_EQ(res->ContentLength, static_cast<int64_t>(content.size()));
+    EXPECT_EQ(ReadFile(file), content);
+
+    options.DirectIo = false;
+    options.WriteBackInterval = 256_KB;
+    options.Offset = 1_MB + 3;
+    blobClient.DownloadToFile(file, options);
+    EXPECT_EQ(
+        ReadFile(file), std::vector<uint8_t>(content.begin() + 1_MB + 3, content.end()));
+    DeleteFile(file);
+  }
+
+#endif
+
+}}} // namespace Azure::Storage::Test
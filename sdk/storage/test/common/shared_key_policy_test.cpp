@@ -0,0 +1,78 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include "common/crypt.hpp"
+#include "common/shared_key_policy.hpp"
+#include "test_base.hpp"
+
+#include <vector>
+
+namespace Azure { namespace Storage { namespace Test {
+
+  namespace {
+    class CaptureAuthorizationPolicy : public Core::Http::HttpPolicy {
+    public:
+      explicit CaptureAuthorizationPolicy(std::string* authorization)
+          : m_authorization(authorization)
+      {
+      }
+
+      std::unique_ptr<HttpPolicy> Clone() const override
+      {
+        return std::make_unique<CaptureAuthorizationPolicy>(m_authorization);
+      }
+
+      std::unique_ptr<Core::Http::RawResponse> Send(
+          Core::Context const&,
+          Core::Http::Request& request,
+          Core::Http::NextHttpPolicy) const override
+      {
+        *m_authorization = request.GetHeaders().at("authorization");
+        return nullptr;
+      }
+
+    private:
+      std::string* m_authorization;
+    };
+
+    std::string GetAuthorization(
+        std::shared_ptr<SharedKeyCredential> credential,
+        Core::Http::Request request)
+    {
+      std::string authorization;
+      std::vector<std::unique_ptr<Core::Http::HttpPolicy>> policies;
+      policies.emplace_back(std::make_unique<SharedKeyPolicy>(credential));
+      policies.emplace_back(std::make_unique<CaptureAuthorizationPolicy>(&authorization));
+      policies[0]->Send(
+          Core::GetApplicationContext(), request, Core::Http::NextHttpPolicy(0, &policies));
+      return authorization;
+    }
+  } // namespace
+
+  TEST(SharedKeyPolicyTest, Signature)
+  {
+    auto credential = std::make_shared<SharedKeyCredential>(
+        "account", Base64Encode("0123456789abcdef0123456789abcdef"));
+
+    Core::Http::Request request(
+        Core::Http::HttpMethod::Put,
+        "https://account.blob.core.windows.net:443/container/dir/blob%20name?comp=block&blockid="
+        "YWJj%3D&Timeout=30");
+    request.AddHeader("Content-Length", "5");
+    request.AddHeader("Content-Type", "application/octet-stream");
+    request.AddHeader("If-Match", "\"0x8D0\"");
+    request.AddHeader("x-ms-version", "2019-12-12");
+    request.AddHeader("x-ms-date", "Mon, 19 Oct 2020 08:00:00 GMT");
+    request.AddHeader("X-Ms-Meta-Key", "value");
+    EXPECT_EQ(GetAuthorization(credential, request), "SharedKey account:bszw00G2kDxkOlOnaAb93dt4IDgDoJFLZFTg/EGMFSE=");
+
+    Core::Http::Request emptyRequest(
+        Core::Http::HttpMethod::Get, "https://account.blob.core.windows.net");
+    emptyRequest.AddHeader("Content-Length", "0");
+    EXPECT_EQ(GetAuthorization(credential, emptyRequest), "SharedKey account:WnMiv4J2uNw8GVivFNEytykiy1WZK8/rDjDEhSsfNWg=");
+
+    credential->SetAccountKey(Base64Encode("another key"));
+    EXPECT_EQ(GetAuthorization(credential, request), "SharedKey account:bMEIsrXM7GN/a+quDiYrieLVtmuHe7YuuOfMcimXtoc=");
+  }
+
+}}} // namespace Azure::Storage::Test
@@ -0,0 +1,95 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include "common/xml_wrapper.hpp"
+#include "test_base.hpp"
+
+namespace Azure { namespace Storage { namespace Test {
+
+  namespace {
+    std::string Describe(XmlNodeType type, const std::string& name, const std::string& value)
+    {
+      return std::to_string(static_cast<int>(type)) + "|" + name + "|" + value;
+    }
+
+    std::vector<std::string> ReadAll(const std::string& document)
+    {
+      std::vector<std::string> nodes;
+      XmlReader reader(document.data(), document.length());
+      XmlNodeType lastTagType = XmlNodeType::End;
+      while (true)
+      {
+        auto node = reader.Read();
+        if (node.Type != XmlNodeType::Attribute)
+        {
+          lastTagType = node.Type;
+        }
+        else if (lastTagType == XmlNodeType::EndTag)
+        {
+          // libxml reports the attributes of an element again at its end tag
+          continue;
+        }
+        nodes.push_back(Describe(
+            node.Type, node.Name ? node.Name : std::string(), node.Value ? node.Value : ""));
+        if (node.Type == XmlNodeType::End)
+        {
+          break;
+        }
+      }
+      return nodes;
+    }
+
+    std::vector<std::string> PullAll(const std::string& document)
+    {
+      std::vector<std::string> nodes;
+      XmlPullReader reader(document.data(), document.length());
+      while (true)
+      {
+        auto node = reader.Read();
+        nodes.push_back(Describe(node.Type, node.Name.ToString(), node.Value.ToString()));
+        if (node.Type == XmlNodeType::End)
+        {
+          break;
+        }
+      }
+      return nodes;
+    }
+  } // namespace
+
+  TEST(XmlTest, PullReaderMatchesReader)
+  {
+    const std::string document = "<?xml version=\"1.0\" encoding=\"utf-8\"?>\r\n"
+                                 "<EnumerationResults ServiceEndpoint=\"https://a.b/?x=1&amp;y=>\" "
+                                 "ContainerName='c'>\n"
+                                 "  <!-- comment -->\n"
+                                 "  <Prefix />\n"
+                                 "  <Blobs>\n"
+                                 "    <Blob><Name>a &lt;&#x4E2D;&#25991;&gt; &quot;b&apos;</Name>"
+                                 "<Deleted>true</Deleted><Metadata></Metadata></Blob>\n"
+                                 "    <Blob><Name>line\r\nbreak</Name><Metadata><k>v</k></Metadata>"
+                                 "</Blob>\n"
+                                 "  </Blobs>\n"
+                                 "  <NextMarker/>\n"
+                                 "</EnumerationResults>\n";
+    auto nodes = PullAll(document);
+    EXPECT_EQ(nodes, ReadAll(document));
+    EXPECT_EQ(
+        nodes[1], Describe(XmlNodeType::Attribute, "ServiceEndpoint", "https://a.b/?x=1&y=>"));
+    EXPECT_EQ(nodes[7], Describe(XmlNodeType::Text, "", "a <\xe4\xb8\xad\xe6\x96\x87> \"b'"));
+
+    // the service prefixes its responses with a byte order mark, which libxml skips
+    const std::string documentWithBom = "\xEF\xBB\xBF" + document;
+    EXPECT_EQ(PullAll(documentWithBom), nodes);
+    EXPECT_EQ(ReadAll(documentWithBom), nodes);
+
+    EXPECT_EQ(
+        PullAll("<a><![CDATA[<b>&amp;]]></a>")[1], Describe(XmlNodeType::Text, "", "<b>&amp;"));
+
+    for (const std::string malformed :
+         {"<a>", "<a></b>", "<a>&unknown;</a>", "<a b></a>", "text", "<!DOCTYPE a><a/>"})
+    {
+      EXPECT_THROW(PullAll(malformed), std::runtime_error);
+    }
+  }
+
+}}} // namespace Azure::Storage::Test
@@ -295,4 +295,101 @@ namespace Azure { namespace Storage { namespace Test {
     }
   }
 
+  TEST_F(DataLakeDirectoryClientTest, RecursiveOperations)
+  {
+    const std::string rootName = LowercaseRandomString();
+    auto rootClient = m_fileSystemClient->GetDirectoryClient(rootName);
+    rootClient.Create();
+    std::vector<std::string> fileNames;
+    for (int32_t i = 0; i < 3; ++i)
+    {
+      const std::string directoryName = rootName + "/" + LowercaseRandomString();
+      m_fileSystemClient->GetDirectoryClient(directoryName).Create();
+      for (int32_t j = 0; j < 2; ++j)
+      {
+        fileNames.push_back(directoryName + "/" + LowercaseRandomString());
+        m_fileSystemClient->GetFileClient(fileNames.back()).Create();
+      }
+    }
+    fileNames.push_back(rootName + "/" + LowercaseRandomString());
+    m_fileSystemClient->GetFileClient(fileNames.back()).Create();
+
+    {
+      // Every path is listed once.
+      std::vector<std::string> listedFiles;
+      std::size_t listedDirectories = 0;
+      Files::DataLake::DirectoryListPathsOptions options;
+      options.Concurrency = 4;
+      options.MaxResults = 2;
+      rootClient.ListPaths(
+          [&](std::vector<Files::DataLake::Path> paths) {
+            for (const auto& path : paths)
+            {
+              if (path.IsDirectory.HasValue() && path.IsDirectory.GetValue())
+              {
+                ++listedDirectories;
+              }
+              else
+              {
+                listedFiles.push_back(path.Name);
+              }
+            }
+          },
+          options);
+      std::sort(listedFiles.begin(), listedFiles.end());
+      std::sort(fileNames.begin(), fileNames.end());
+      EXPECT_EQ(fileNames, listedFiles);
+      EXPECT_EQ(3U, listedDirectories);
+    }
+
+    {
+      // The access control of every path is changed, a batch at a time.
+      Files::DataLake::Acl acl;
+      acl.Scope = "default";
+      acl.Type = "user";
+      acl.Id = "72a3f86f-271f-439e-b031-25678907d381";
+      acl.Permissions = "rwx";
+      Files::DataLake::DirectorySetAccessControlRecursiveOptions options;
+      options.Concurrency = 4;
+      options.BatchSize = 2;
+      int64_t progressFiles = 0;
+      options.ProgressHandler
+          = [&](const Files::DataLake::AccessControlRecursiveProgress& progress) {
+              progressFiles += progress.FilesSuccessful;
+            };
+      auto result = rootClient.SetAccessControlRecursive(
+          Files::DataLake::PathSetAccessControlRecursiveMode::Modify, {acl}, options);
+      EXPECT_TRUE(result.PendingShards.empty());
+      EXPECT_EQ(0, result.FailureCount);
+      EXPECT_EQ(4, result.DirectoriesSuccessful);
+      EXPECT_EQ(static_cast<int64_t>(fileNames.size()), result.FilesSuccessful);
+      EXPECT_EQ(result.FilesSuccessful, progressFiles);
+      const std::string directoryName = fileNames[0].substr(0, fileNames[0].rfind('/'));
+      auto acls = m_fileSystemClient->GetDirectoryClient(directoryName).GetAccessControls()->Acls;
+      EXPECT_TRUE(std::any_of(acls.begin(), acls.end(), [&](const Files::DataLake::Acl& a) {
+        return a.Scope == acl.Scope && a.Id == acl.Id && a.Permissions == acl.Permissions;
+      }));
+    }
+
+    {
+      // The tree is copied, then moved.
+      const std::string copyName = LowercaseRandomString();
+      Files::DataLake::DirectoryCopyOptions copyOptions;
+      copyOptions.Concurrency = 4;
+      auto copyResult = rootClient.CopyTo(copyName, copyOptions);
+      EXPECT_EQ(4, copyResult.DirectoriesCopied);
+      EXPECT_EQ(static_cast<int64_t>(fileNames.size()), copyResult.FilesCopied);
+      const std::string copiedFileName = copyName + fileNames.back().substr(rootName.length());
+      EXPECT_NO_THROW(m_fileSystemClient->GetFileClient(copiedFileName).GetProperties());
+
+      const std::string moveName = LowercaseRandomString();
+      EXPECT_NO_THROW(m_fileSystemClient->GetDirectoryClient(copyName).MoveTo(moveName));
+      EXPECT_THROW(
+          m_fileSystemClient->GetFileClient(copiedFileName).GetProperties(), StorageError);
+      auto movedClient = m_fileSystemClient->GetDirectoryClient(moveName);
+      EXPECT_NO_THROW(movedClient.Delete(true));
+    }
+    EXPECT_NO_THROW(rootClient.Delete(true));
+  }
+
 }}} // namespace Azure::Storage::Test
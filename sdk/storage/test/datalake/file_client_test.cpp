@@ -3,6 +3,8 @@
 
 #include "file_client_test.hpp"
 
+#include "common/file_io.hpp"
+
 #include <algorithm>
 
 namespace Azure { namespace Storage { namespace Test {
@@ -379,4 +381,37 @@ namespace Azure { namespace Storage { namespace Test {
     }
   }
 
+  TEST_F(DataLakeFileClientTest, UploadThroughDfs)
+  {
+    const int32_t bufferSize = 1 * 1024 * 1024 + 123;
+    auto buffer = RandomBuffer(bufferSize);
+    auto newFileClient = m_fileSystemClient->GetFileClient(LowercaseRandomString(10));
+
+    Files::DataLake::UploadFileOptions options;
+    options.UseDfsEndpoint = true;
+    options.ChunkSize = 256 * 1024;
+    options.Concurrency = 4;
+    options.Metadata = RandomMetadata();
+    options.HttpHeaders.ContentType = "application/x-binary";
+    auto uploadResult = newFileClient.UploadFromBuffer(buffer.data(), buffer.size(), options);
+
+    auto properties = newFileClient.GetProperties();
+    EXPECT_EQ(uploadResult->ETag, properties->ETag);
+    EXPECT_EQ(options.Metadata, properties->Metadata);
+    EXPECT_EQ(options.HttpHeaders.ContentType, properties->HttpHeaders.ContentType);
+    auto result = newFileClient.Read();
+    EXPECT_EQ(buffer, ReadBodyStream(result->Body));
+
+    const std::string tempFilename = RandomString();
+    {
+      Azure::Storage::Details::FileWriter fileWriter(tempFilename);
+      fileWriter.Write(buffer.data(), buffer.size(), 0);
+    }
+    newFileClient.UploadFromFile(tempFilename, options);
+    DeleteFile(tempFilename);
+    result = newFileClient.Read();
+    EXPECT_EQ(buffer, ReadBodyStream(result->Body));
+    newFileClient.Delete();
+  }
+
 }}} // namespace Azure::Storage::Test
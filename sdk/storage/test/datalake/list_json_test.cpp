@@ -0,0 +1,69 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include "datalake/protocol/datalake_rest_client.hpp"
+#include "test_base.hpp"
+
+namespace Azure { namespace Storage { namespace Test {
+
+  namespace {
+    std::vector<uint8_t> ToBuffer(const std::string& json)
+    {
+      return std::vector<uint8_t>(json.begin(), json.end());
+    }
+  } // namespace
+
+  TEST(DataLakeListJsonTest, PathList)
+  {
+    const std::string json
+        = R"({"paths":[)"
+          R"({"name":"dir","isDirectory":"true","lastModified":"lm","etag":"e1",)"
+          R"("owner":"o","group":"g","permissions":"rwx------","extra":{"nested":["x"]}},)"
+          R"({"name":"dir/f\u00e9","lastModified":"lm2","etag":"e2","contentLength":"1234",)"
+          R"("owner":"o","group":"g","permissions":"rw-r-----"}]})";
+    auto expected = Files::DataLake::PathList::CreateFromJson(nlohmann::json::parse(json));
+    auto pathList = Files::DataLake::PathList::CreateFromJson(ToBuffer(json));
+    ASSERT_EQ(pathList.Paths.size(), 2U);
+    for (std::size_t i = 0; i < pathList.Paths.size(); ++i)
+    {
+      const auto& path = pathList.Paths[i];
+      EXPECT_EQ(path.Name, expected.Paths[i].Name);
+      EXPECT_EQ(path.IsDirectory.HasValue(), expected.Paths[i].IsDirectory.HasValue());
+      EXPECT_EQ(path.LastModified, expected.Paths[i].LastModified);
+      EXPECT_EQ(path.ETag, expected.Paths[i].ETag);
+      EXPECT_EQ(path.ContentLength.HasValue(), expected.Paths[i].ContentLength.HasValue());
+      EXPECT_EQ(path.Owner, expected.Paths[i].Owner);
+      EXPECT_EQ(path.Group, expected.Paths[i].Group);
+      EXPECT_EQ(path.Permissions, expected.Paths[i].Permissions);
+    }
+    EXPECT_TRUE(pathList.Paths[0].IsDirectory.GetValue());
+    EXPECT_EQ(pathList.Paths[1].Name, "dir/f\xc3\xa9");
+    EXPECT_EQ(pathList.Paths[1].ContentLength.GetValue(), 1234);
+
+    EXPECT_THROW(
+        Files::DataLake::PathList::CreateFromJson(ToBuffer(R"({"paths":[{"name":)")),
+        nlohmann::json::parse_error);
+  }
+
+  TEST(DataLakeListJsonTest, FileSystemListAndAclResponse)
+  {
+    auto fileSystemList = Files::DataLake::FileSystemList::CreateFromJson(ToBuffer(
+        R"({"filesystems":[{"name":"a","lastModified":"lm","etag":"e"},{"name":"b"}]})"));
+    ASSERT_EQ(fileSystemList.Filesystems.size(), 2U);
+    EXPECT_EQ(fileSystemList.Filesystems[0].ETag, "e");
+    EXPECT_EQ(fileSystemList.Filesystems[1].Name, "b");
+
+    // counts may be numbers or strings
+    auto aclResponse = Files::DataLake::SetAccessControlRecursiveResponse::CreateFromJson(
+        ToBuffer(R"({"directoriesSuccessful":2,"filesSuccessful":"3","failureCount":1,)"
+                 R"("failedEntries":[{"errorMessage":"denied","name":"d/f","type":"FILE"}]})"));
+    EXPECT_EQ(aclResponse.DirectoriesSuccessful, 2);
+    EXPECT_EQ(aclResponse.FilesSuccessful, 3);
+    EXPECT_EQ(aclResponse.FailureCount, 1);
+    ASSERT_EQ(aclResponse.FailedEntries.size(), 1U);
+    EXPECT_EQ(aclResponse.FailedEntries[0].Name, "d/f");
+    EXPECT_EQ(aclResponse.FailedEntries[0].Type, "FILE");
+    EXPECT_EQ(aclResponse.FailedEntries[0].ErrorMessage, "denied");
+  }
+
+}}} // namespace Azure::Storage::Test
@@ -0,0 +1,821 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#include "mock_storage_server.hpp"
+
+#include "common/crypt.hpp"
+
+#ifndef _WIN32
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <stdexcept>
+
+namespace Azure { namespace Storage { namespace Test {
+
+  namespace {
+    constexpr std::size_t c_ioPieceSize = 64 * 1024;
+
+    std::string ToLower(std::string s)
+    {
+      std::transform(s.begin(), s.end(), s.begin(), [](unsigned char c) {
+        return static_cast<char>(std::tolower(c));
+      });
+      return s;
+    }
+
+    std::string UrlDecode(const std::string& s)
+    {
+      std::string decoded;
+      for (std::size_t i = 0; i < s.length(); ++i)
+      {
+        if (s[i] == '%' && i + 2 < s.length())
+        {
+          decoded += static_cast<char>(std::stoi(s.substr(i + 1, 2), nullptr, 16));
+          i += 2;
+        }
+        else
+        {
+          decoded += s[i];
+        }
+      }
+      return decoded;
+    }
+
+    bool SendAll(int socket, const uint8_t* data, std::size_t length)
+    {
+      while (length > 0)
+      {
+        auto sent = send(socket, data, length, MSG_NOSIGNAL);
+        if (sent <= 0)
+        {
+          return false;
+        }
+        data += sent;
+        length -= static_cast<std::size_t>(sent);
+      }
+      return true;
+    }
+
+    const char* ReasonPhrase(int statusCode)
+    {
+      switch (statusCode)
+      {
+        case 100:
+          return "Continue";
+        case 200:
+          return "OK";
+        case 201:
+          return "Created";
+        case 202:
+          return "Accepted";
+        case 206:
+          return "Partial Content";
+        case 403:
+          return "Forbidden";
+        case 404:
+          return "Not Found";
+        case 412:
+          return "Precondition Failed";
+        case 416:
+          return "Range Not Satisfiable";
+        default:
+          return "Bad Request";
+      }
+    }
+
+    // The body of an error response, which the client reads the error code from.
+    std::string ErrorBody(const std::string& errorCode)
+    {
+      return "<?xml version=\"1.0\" encoding=\"utf-8\"?><Error><Code>" + errorCode
+          + "</Code><Message>mock error</Message></Error>";
+    }
+  } // namespace
+
+  MockStorageServer::MockStorageServer(MockStorageServerOptions options) : m_options(options)
+  {
+    m_listenSocket = socket(AF_INET, SOCK_STREAM, 0);
+    if (m_listenSocket == -1)
+    {
+      throw std::runtime_error("failed to create socket");
+    }
+    int reuse = 1;
+    setsockopt(m_listenSocket, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    sockaddr_in address;
+    std::memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = 0;
+    socklen_t addressLength = sizeof(address);
+    if (bind(m_listenSocket, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0
+        || listen(m_listenSocket, 128) != 0
+        || getsockname(m_listenSocket, reinterpret_cast<sockaddr*>(&address), &addressLength)
+            != 0)
+    {
+      close(m_listenSocket);
+      throw std::runtime_error("failed to listen on loopback");
+    }
+    m_port = ntohs(address.sin_port);
+    m_acceptThread = std::thread(&MockStorageServer::AcceptLoop, this);
+  }
+
+  MockStorageServer::~MockStorageServer()
+  {
+    m_stop = true;
+    shutdown(m_listenSocket, SHUT_RDWR);
+    close(m_listenSocket);
+    m_acceptThread.join();
+
+    std::vector<std::thread> threads;
+    {
+      std::lock_guard<std::mutex> guard(m_mutex);
+      for (int s : m_connectionSockets)
+      {
+        shutdown(s, SHUT_RDWR);
+      }
+      threads.swap(m_connectionThreads);
+    }
+    for (auto& t : threads)
+    {
+      t.join();
+    }
+  }
+
+  std::string MockStorageServer::GetServiceUrl() const
+  {
+    return "http://127.0.0.1:" + std::to_string(m_port);
+  }
+
+  std::string MockStorageServer::GetContainerUrl() const { return GetServiceUrl() + "/container"; }
+
+  std::string MockStorageServer::GetBlobUrl(const std::string& blobName) const
+  {
+    return GetContainerUrl() + "/" + blobName;
+  }
+
+  void MockStorageServer::SetBlob(const std::string& blobName, std::vector<uint8_t> content)
+  {
+    std::lock_guard<std::mutex> guard(m_mutex);
+    m_blobs["/container/" + blobName] = std::move(content);
+    ++m_etagCounter;
+  }
+
+  std::vector<uint8_t> MockStorageServer::GetBlob(const std::string& blobName) const
+  {
+    std::lock_guard<std::mutex> guard(m_mutex);
+    auto i = m_blobs.find("/container/" + blobName);
+    return i == m_blobs.end() ? std::vector<uint8_t>() : i->second;
+  }
+
+  void MockStorageServer::FailRequestsAfter(int64_t numRequests)
+  {
+    std::lock_guard<std::mutex> guard(m_mutex);
+    m_requestsBeforeFailure = numRequests;
+  }
+
+  void MockStorageServer::AcceptLoop()
+  {
+    while (!m_stop)
+    {
+      int connection = accept(m_listenSocket, nullptr, nullptr);
+      if (connection == -1)
+      {
+        continue;
+      }
+      // A response is sent as its head and then its body, which mustn't wait for the client to
+      // acknowledge the head.
+      int noDelay = 1;
+      setsockopt(connection, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+      std::lock_guard<std::mutex> guard(m_mutex);
+      if (m_stop)
+      {
+        close(connection);
+        break;
+      }
+      m_connectionSockets.push_back(connection);
+      m_connectionThreads.emplace_back(&MockStorageServer::ServeConnection, this, connection);
+    }
+  }
+
+  void MockStorageServer::ServeConnection(int socket)
+  {
+    std::string buffer;
+    Request request;
+    while (!m_stop && ReadRequest(socket, buffer, request))
+    {
+      ++m_requestCount;
+      HandleRequest(socket, request);
+    }
+    std::lock_guard<std::mutex> guard(m_mutex);
+    m_connectionSockets.erase(
+        std::remove(m_connectionSockets.begin(), m_connectionSockets.end(), socket),
+        m_connectionSockets.end());
+    close(socket);
+  }
+
+  void MockStorageServer::Throttle(int64_t bytes)
+  {
+    if (m_options.BytesPerSecond <= 0)
+    {
+      return;
+    }
+    std::chrono::steady_clock::time_point startTime;
+    {
+      std::lock_guard<std::mutex> guard(m_mutex);
+      auto now = std::chrono::steady_clock::now();
+      startTime = std::max(now, m_nextSlot);
+      m_nextSlot = startTime
+          + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                       std::chrono::duration<double>(
+                           static_cast<double>(bytes) / m_options.BytesPerSecond));
+    }
+    std::this_thread::sleep_until(startTime);
+  }
+
+  bool MockStorageServer::ReadRequest(int socket, std::string& buffer, Request& request)
+  {
+    char readBuffer[c_ioPieceSize];
+    std::size_t headerEnd;
+    while ((headerEnd = buffer.find("\r\n\r\n")) == std::string::npos)
+    {
+      auto received = recv(socket, readBuffer, sizeof(readBuffer), 0);
+      if (received <= 0)
+      {
+        return false;
+      }
+      buffer.append(readBuffer, static_cast<std::size_t>(received));
+    }
+
+    request = Request();
+    std::string head = buffer.substr(0, headerEnd);
+    buffer.erase(0, headerEnd + 4);
+
+    std::size_t lineEnd = head.find("\r\n");
+    std::string requestLine = head.substr(0, lineEnd);
+    std::size_t methodEnd = requestLine.find(' ');
+    std::size_t targetEnd = requestLine.find(' ', methodEnd + 1);
+    request.Method = requestLine.substr(0, methodEnd);
+    std::string target = requestLine.substr(methodEnd + 1, targetEnd - methodEnd - 1);
+    std::size_t queryStart = target.find('?');
+    request.Path = UrlDecode(target.substr(0, queryStart));
+    if (queryStart != std::string::npos)
+    {
+      std::string query = target.substr(queryStart + 1);
+      std::size_t pos = 0;
+      while (pos < query.length())
+      {
+        std::size_t ampersand = query.find('&', pos);
+        std::string pair = query.substr(pos, ampersand - pos);
+        std::size_t equal = pair.find('=');
+        request.Query[pair.substr(0, equal)]
+            = equal == std::string::npos ? std::string() : UrlDecode(pair.substr(equal + 1));
+        pos = ampersand == std::string::npos ? query.length() : ampersand + 1;
+      }
+    }
+
+    while (lineEnd != std::string::npos)
+    {
+      std::size_t nextLineEnd = head.find("\r\n", lineEnd + 2);
+      std::string line = head.substr(lineEnd + 2, nextLineEnd - lineEnd - 2);
+      std::size_t colon = line.find(':');
+      if (colon != std::string::npos)
+      {
+        std::size_t valueStart = line.find_first_not_of(' ', colon + 1);
+        request.Headers[ToLower(line.substr(0, colon))]
+            = valueStart == std::string::npos ? std::string() : line.substr(valueStart);
+      }
+      lineEnd = nextLineEnd;
+    }
+
+    std::size_t contentLength = 0;
+    auto contentLengthHeader = request.Headers.find("content-length");
+    if (contentLengthHeader != request.Headers.end())
+    {
+      contentLength = static_cast<std::size_t>(std::stoull(contentLengthHeader->second));
+    }
+
+    // Like the service, there's no interim response for a request without a body, such as Create
+    // Page Blob, the final response comes right away.
+    auto expect = request.Headers.find("expect");
+    if (contentLength != 0 && expect != request.Headers.end()
+        && ToLower(expect->second) == "100-continue")
+    {
+      SendResponse(socket, 100, {}, nullptr, 0);
+    }
+    std::size_t buffered = std::min(buffer.size(), contentLength);
+    request.Body.assign(buffer.begin(), buffer.begin() + buffered);
+    buffer.erase(0, buffered);
+    request.Body.resize(contentLength);
+    while (buffered < contentLength)
+    {
+      auto received = recv(
+          socket,
+          request.Body.data() + buffered,
+          std::min(c_ioPieceSize, contentLength - buffered),
+          0);
+      if (received <= 0)
+      {
+        return false;
+      }
+      Throttle(received);
+      buffered += static_cast<std::size_t>(received);
+    }
+    return true;
+  }
+
+  void MockStorageServer::HandleRequest(int socket, const Request& request)
+  {
+    std::this_thread::sleep_for(m_options.Latency);
+
+    std::map<std::string, std::string> headers;
+    headers["x-ms-request-id"] = std::to_string(m_requestCount);
+    headers["x-ms-version"] = "2019-12-12";
+    headers["Last-Modified"] = "Thu, 01 Oct 2020 00:00:00 GMT";
+
+    bool injectFailure = false;
+    {
+      std::lock_guard<std::mutex> guard(m_mutex);
+      if (m_requestsBeforeFailure == 0)
+      {
+        injectFailure = true;
+      }
+      else if (m_requestsBeforeFailure > 0)
+      {
+        --m_requestsBeforeFailure;
+      }
+    }
+    if (injectFailure)
+    {
+      headers["x-ms-error-code"] = "AuthorizationFailure";
+      SendResponse(socket, 403, headers, nullptr, 0);
+      return;
+    }
+
+    if (request.Method == "PUT")
+    {
+      for (auto algorithm : {HashAlgorithm::Md5, HashAlgorithm::Crc64})
+      {
+        const std::string headerName
+            = algorithm == HashAlgorithm::Md5 ? "content-md5" : "x-ms-content-crc64";
+        auto contentHash = request.Headers.find(headerName);
+        if (contentHash == request.Headers.end())
+        {
+          continue;
+        }
+        Details::ContentHasher hasher(algorithm);
+        hasher.Update(request.Body.data(), request.Body.size());
+        if (hasher.Final() != contentHash->second)
+        {
+          headers["x-ms-error-code"]
+              = algorithm == HashAlgorithm::Md5 ? "Md5Mismatch" : "Crc64Mismatch";
+          SendResponse(socket, 400, headers, nullptr, 0);
+          return;
+        }
+        headers[headerName] = contentHash->second;
+      }
+    }
+
+    auto comp = request.Query.find("comp");
+    if (request.Method == "POST" && comp != request.Query.end() && comp->second == "batch")
+    {
+      // multipart/mixed; boundary=<boundary>, every part is an operation
+      const std::string& contentType = request.Headers.at("content-type");
+      std::string boundary = contentType.substr(contentType.find("boundary=") + 9);
+      std::string body(request.Body.begin(), request.Body.end());
+      const std::string delimiter = "--" + boundary;
+      const std::string responseBoundary = "batchresponse_" + boundary;
+      std::string responseBody;
+      std::size_t pos = body.find(delimiter);
+      while (pos != std::string::npos && body.compare(pos + delimiter.length(), 2, "--") != 0)
+      {
+        pos += delimiter.length();
+        std::size_t partEnd = body.find(delimiter, pos);
+        std::string part = body.substr(pos, partEnd - pos);
+        pos = partEnd;
+
+        std::string lowercasePart = ToLower(part);
+        std::size_t contentIdStart = lowercasePart.find("content-id: ") + 12;
+        std::string contentId
+            = part.substr(contentIdStart, part.find("\r\n", contentIdStart) - contentIdStart);
+        std::size_t requestLineStart = part.find("\r\n\r\n") + 4;
+        std::string requestLine = part.substr(
+            requestLineStart, part.find("\r\n", requestLineStart) - requestLineStart);
+        std::size_t methodEnd = requestLine.find(' ');
+        std::string method = requestLine.substr(0, methodEnd);
+        std::size_t targetEnd = requestLine.find(' ', methodEnd + 1);
+        std::string target = requestLine.substr(methodEnd + 1, targetEnd - methodEnd - 1);
+        std::string path = UrlDecode(target.substr(0, target.find('?')));
+
+        int statusCode = 400;
+        std::string errorCode = "InvalidInput";
+        if (lowercasePart.find("\r\nx-ms-date: ") == std::string::npos)
+        {
+          errorCode = "MissingRequiredHeader";
+        }
+        else
+        {
+          std::lock_guard<std::mutex> guard(m_mutex);
+          auto i = m_blobs.find(path);
+          if (i == m_blobs.end())
+          {
+            statusCode = 404;
+            errorCode = "BlobNotFound";
+          }
+          else if (method == "DELETE")
+          {
+            m_blobs.erase(i);
+            statusCode = 202;
+            errorCode.clear();
+          }
+          else if (method == "PUT" && target.find("comp=tier") != std::string::npos)
+          {
+            statusCode = 200;
+            errorCode.clear();
+          }
+        }
+
+        responseBody += "--" + responseBoundary + "\r\nContent-Type: application/http\r\n"
+            + "Content-ID: " + contentId + "\r\n\r\nHTTP/1.1 " + std::to_string(statusCode) + " "
+            + ReasonPhrase(statusCode) + "\r\n";
+        if (!errorCode.empty())
+        {
+          responseBody += "x-ms-error-code: " + errorCode + "\r\n";
+        }
+        responseBody += "\r\n";
+      }
+      responseBody += "--" + responseBoundary + "--\r\n";
+      headers["Content-Type"] = "multipart/mixed; boundary=" + responseBoundary;
+      SendResponse(
+          socket,
+          202,
+          headers,
+          reinterpret_cast<const uint8_t*>(responseBody.data()),
+          responseBody.length());
+      return;
+    }
+    if (request.Method == "PUT" && comp != request.Query.end() && comp->second == "block")
+    {
+      std::lock_guard<std::mutex> guard(m_mutex);
+      m_uncommittedBlocks[request.Path][request.Query.at("blockid")] = request.Body;
+      SendResponse(socket, 201, headers, nullptr, 0);
+      return;
+    }
+    if (request.Method == "PUT" && comp != request.Query.end() && comp->second == "blocklist")
+    {
+      std::string body(request.Body.begin(), request.Body.end());
+      std::vector<uint8_t> blob;
+      bool valid = true;
+      {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        auto& blocks = m_uncommittedBlocks[request.Path];
+        std::size_t pos = 0;
+        while ((pos = body.find('<', pos)) != std::string::npos)
+        {
+          std::size_t tagEnd = body.find('>', pos);
+          std::string tag = body.substr(pos + 1, tagEnd - pos - 1);
+          pos = tagEnd + 1;
+          if (tag != "Latest" && tag != "Uncommitted" && tag != "Committed")
+          {
+            continue;
+          }
+          std::size_t valueEnd = body.find('<', pos);
+          auto block = blocks.find(body.substr(pos, valueEnd - pos));
+          if (block == blocks.end())
+          {
+            valid = false;
+            break;
+          }
+          blob.insert(blob.end(), block->second.begin(), block->second.end());
+          pos = valueEnd;
+        }
+        if (valid)
+        {
+          blocks.clear();
+          m_blobs[request.Path] = std::move(blob);
+          headers["ETag"] = "\"0x" + std::to_string(++m_etagCounter) + "\"";
+        }
+      }
+      SendResponse(socket, valid ? 201 : 400, headers, nullptr, 0);
+      return;
+    }
+    if (request.Method == "PUT" && comp != request.Query.end() && comp->second == "page")
+    {
+      // bytes=start-end
+      const std::string rangeValue = request.Headers.at("x-ms-range").substr(6);
+      const std::size_t dash = rangeValue.find('-');
+      const int64_t start = std::stoll(rangeValue.substr(0, dash));
+      const int64_t end = std::stoll(rangeValue.substr(dash + 1));
+      std::lock_guard<std::mutex> guard(m_mutex);
+      auto& blob = m_blobs[request.Path];
+      if (end - start + 1 != static_cast<int64_t>(request.Body.size())
+          || end >= static_cast<int64_t>(blob.size()))
+      {
+        headers["x-ms-error-code"] = "InvalidPageRange";
+        SendResponse(socket, 416, headers, nullptr, 0);
+        return;
+      }
+      std::copy(request.Body.begin(), request.Body.end(), blob.begin() + start);
+      headers["ETag"] = "\"0x" + std::to_string(++m_etagCounter) + "\"";
+      headers["x-ms-blob-sequence-number"] = "0";
+      SendResponse(socket, 201, headers, nullptr, 0);
+      return;
+    }
+    if (request.Method == "PUT" && comp != request.Query.end() && comp->second == "appendblock")
+    {
+      std::lock_guard<std::mutex> guard(m_mutex);
+      auto& blob = m_blobs[request.Path];
+      const int64_t blobSize = static_cast<int64_t>(blob.size());
+      auto appendPosition = request.Headers.find("x-ms-blob-condition-appendpos");
+      auto maxSize = request.Headers.find("x-ms-blob-condition-maxsize");
+      std::string errorCode;
+      if (appendPosition != request.Headers.end() && std::stoll(appendPosition->second) != blobSize)
+      {
+        errorCode = "AppendPositionConditionNotMet";
+      }
+      else if (
+          maxSize != request.Headers.end()
+          && blobSize + static_cast<int64_t>(request.Body.size()) > std::stoll(maxSize->second))
+      {
+        errorCode = "MaxBlobSizeConditionNotMet";
+      }
+      if (!errorCode.empty())
+      {
+        headers["x-ms-error-code"] = errorCode;
+        headers["Content-Type"] = "application/xml";
+        const std::string body = ErrorBody(errorCode);
+        SendResponse(
+            socket, 412, headers, reinterpret_cast<const uint8_t*>(body.data()), body.length());
+        return;
+      }
+      blob.insert(blob.end(), request.Body.begin(), request.Body.end());
+      headers["ETag"] = "\"0x" + std::to_string(++m_etagCounter) + "\"";
+      headers["x-ms-blob-append-offset"] = std::to_string(blobSize);
+      headers["x-ms-blob-committed-block-count"]
+          = std::to_string(++m_committedBlockCounts[request.Path]);
+      SendResponse(socket, 201, headers, nullptr, 0);
+      return;
+    }
+    if (request.Method == "PUT")
+    {
+      std::lock_guard<std::mutex> guard(m_mutex);
+      m_committedBlockCounts.erase(request.Path);
+      auto blobType = request.Headers.find("x-ms-blob-type");
+      if (blobType != request.Headers.end() && blobType->second == "PageBlob")
+      {
+        m_blobs[request.Path].assign(
+            static_cast<std::size_t>(std::stoll(request.Headers.at("x-ms-blob-content-length"))),
+            0);
+      }
+      else
+      {
+        m_blobs[request.Path] = request.Body;
+      }
+      headers["ETag"] = "\"0x" + std::to_string(++m_etagCounter) + "\"";
+      SendResponse(socket, 201, headers, nullptr, 0);
+      return;
+    }
+    if (request.Method == "GET" && comp != request.Query.end() && comp->second == "blocklist")
+    {
+      // Only uncommitted blocks are kept, committed blocks are merged into the blob.
+      std::string body = "<?xml version=\"1.0\" encoding=\"utf-8\"?><BlockList>"
+                         "<CommittedBlocks></CommittedBlocks><UncommittedBlocks>";
+      {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        auto blocks = m_uncommittedBlocks.find(request.Path);
+        auto blob = m_blobs.find(request.Path);
+        if ((blocks == m_uncommittedBlocks.end() || blocks->second.empty())
+            && blob == m_blobs.end())
+        {
+          headers["x-ms-error-code"] = "BlobNotFound";
+          SendResponse(socket, 404, headers, nullptr, 0);
+          return;
+        }
+        if (blocks != m_uncommittedBlocks.end())
+        {
+          for (const auto& block : blocks->second)
+          {
+            body += "<Block><Name>" + block.first + "</Name><Size>"
+                + std::to_string(block.second.size()) + "</Size></Block>";
+          }
+        }
+        headers["x-ms-blob-content-length"]
+            = std::to_string(blob == m_blobs.end() ? 0 : blob->second.size());
+        headers["ETag"] = "\"0x" + std::to_string(m_etagCounter) + "\"";
+      }
+      body += "</UncommittedBlocks></BlockList>";
+      headers["Content-Type"] = "application/xml";
+      SendResponse(
+          socket, 200, headers, reinterpret_cast<const uint8_t*>(body.data()), body.length());
+      return;
+    }
+    if (request.Method == "GET" && comp != request.Query.end() && comp->second == "list")
+    {
+      auto queryValue = [&](const std::string& name) {
+        auto i = request.Query.find(name);
+        return i == request.Query.end() ? std::string() : i->second;
+      };
+      const std::string prefix = queryValue("prefix");
+      const std::string delimiter = queryValue("delimiter");
+      const std::string marker = queryValue("marker");
+      const std::string maxResults = queryValue("maxresults");
+      const std::size_t pageSize
+          = maxResults.empty() ? 5000 : static_cast<std::size_t>(std::stoul(maxResults));
+
+      // names of blobs, and of virtual directories ending with the delimiter, in order
+      std::map<std::string, int64_t> entries;
+      {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        const std::string containerPath = request.Path + "/";
+        for (auto i = m_blobs.lower_bound(containerPath + prefix);
+             i != m_blobs.end() && i->first.compare(0, containerPath.length(), containerPath) == 0;
+             ++i)
+        {
+          std::string name = i->first.substr(containerPath.length());
+          if (name.compare(0, prefix.length(), prefix) != 0)
+          {
+            break;
+          }
+          std::size_t delimiterPos
+              = delimiter.empty() ? std::string::npos : name.find(delimiter, prefix.length());
+          if (delimiterPos != std::string::npos)
+          {
+            entries.emplace(name.substr(0, delimiterPos + delimiter.length()), -1);
+          }
+          else
+          {
+            entries.emplace(name, static_cast<int64_t>(i->second.size()));
+          }
+        }
+      }
+
+      // Like the service, prefix the document with a UTF-8 byte order mark.
+      std::string body = "\xEF\xBB\xBF"
+                         "<?xml version=\"1.0\" encoding=\"utf-8\"?><EnumerationResults "
+                         "ServiceEndpoint=\"http://127.0.0.1/\" ContainerName=\"container\">"
+                         "<Prefix>"
+          + prefix + "</Prefix><Marker>" + marker + "</Marker><Delimiter>" + delimiter
+          + "</Delimiter><Blobs>";
+      auto entry = entries.lower_bound(marker);
+      for (std::size_t count = 0; entry != entries.end() && count < pageSize; ++entry, ++count)
+      {
+        if (entry->second < 0)
+        {
+          body += "<BlobPrefix><Name>" + entry->first + "</Name></BlobPrefix>";
+          continue;
+        }
+        body += "<Blob><Name>" + entry->first
+            + "</Name><Properties><Creation-Time>Thu, 01 Oct 2020 00:00:00 GMT</Creation-Time>"
+              "<Last-Modified>Thu, 01 Oct 2020 00:00:00 GMT</Last-Modified><Etag>0x1</Etag>"
+              "<Content-Length>"
+            + std::to_string(entry->second)
+            + "</Content-Length><BlobType>BlockBlob</BlobType></Properties></Blob>";
+      }
+      body += "</Blobs><NextMarker>" + (entry == entries.end() ? std::string() : entry->first)
+          + "</NextMarker></EnumerationResults>";
+      headers["Content-Type"] = "application/xml";
+      SendResponse(
+          socket, 200, headers, reinterpret_cast<const uint8_t*>(body.data()), body.length());
+      return;
+    }
+    if (request.Method == "HEAD")
+    {
+      std::lock_guard<std::mutex> guard(m_mutex);
+      auto i = m_blobs.find(request.Path);
+      if (i == m_blobs.end())
+      {
+        SendResponse(socket, 404, headers, nullptr, 0);
+        return;
+      }
+      headers["ETag"] = "\"0x" + std::to_string(m_etagCounter) + "\"";
+      headers["x-ms-creation-time"] = headers["Last-Modified"];
+      headers["x-ms-blob-type"] = "BlockBlob";
+      headers["Content-Length"] = std::to_string(i->second.size());
+      SendResponse(socket, 200, headers, nullptr, 0);
+      return;
+    }
+    if (request.Method == "GET")
+    {
+      std::vector<uint8_t> content;
+      int64_t blobSize = 0;
+      int64_t start = 0;
+      int64_t end = -1;
+      auto range = request.Headers.find("x-ms-range");
+      {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        auto i = m_blobs.find(request.Path);
+        if (i == m_blobs.end())
+        {
+          headers["x-ms-error-code"] = "BlobNotFound";
+          SendResponse(socket, 404, headers, nullptr, 0);
+          return;
+        }
+        const std::string eTag = "\"0x" + std::to_string(m_etagCounter) + "\"";
+        auto ifMatch = request.Headers.find("if-match");
+        if (ifMatch != request.Headers.end() && ifMatch->second != eTag)
+        {
+          headers["x-ms-error-code"] = "ConditionNotMet";
+          SendResponse(socket, 412, headers, nullptr, 0);
+          return;
+        }
+        blobSize = static_cast<int64_t>(i->second.size());
+        end = blobSize - 1;
+        if (range != request.Headers.end())
+        {
+          // bytes=start-[end]
+          std::string rangeValue = range->second.substr(6);
+          std::size_t dash = rangeValue.find('-');
+          start = std::stoll(rangeValue.substr(0, dash));
+          if (dash + 1 < rangeValue.length())
+          {
+            end = std::min(end, static_cast<int64_t>(std::stoll(rangeValue.substr(dash + 1))));
+          }
+        }
+        if (start < blobSize)
+        {
+          // Only the requested range is copied, so that concurrent ranged reads of a large blob
+          // stay cheap.
+          content.assign(i->second.begin() + start, i->second.begin() + end + 1);
+        }
+        headers["ETag"] = eTag;
+      }
+      headers["x-ms-blob-type"] = "BlockBlob";
+
+      if (range == request.Headers.end())
+      {
+        SendResponse(socket, 200, headers, content.data(), content.size());
+        return;
+      }
+      if (start >= blobSize)
+      {
+        headers["x-ms-error-code"] = "InvalidRange";
+        SendResponse(socket, 416, headers, nullptr, 0);
+        return;
+      }
+      headers["Content-Range"] = "bytes " + std::to_string(start) + "-" + std::to_string(end)
+          + "/" + std::to_string(blobSize);
+      for (auto algorithm : {HashAlgorithm::Md5, HashAlgorithm::Crc64})
+      {
+        auto rangeGetContentHash = request.Headers.find(
+            algorithm == HashAlgorithm::Md5 ? "x-ms-range-get-content-md5"
+                                            : "x-ms-range-get-content-crc64");
+        if (rangeGetContentHash != request.Headers.end() && rangeGetContentHash->second == "true")
+        {
+          Details::ContentHasher hasher(algorithm);
+          hasher.Update(content.data(), content.size());
+          headers[algorithm == HashAlgorithm::Md5 ? "Content-MD5" : "x-ms-content-crc64"]
+              = hasher.Final();
+        }
+      }
+      SendResponse(socket, 206, headers, content.data(), content.size());
+      return;
+    }
+    SendResponse(socket, 400, headers, nullptr, 0);
+  }
+
+  void MockStorageServer::SendResponse(
+      int socket,
+      int statusCode,
+      const std::map<std::string, std::string>& headers,
+      const uint8_t* body,
+      std::size_t bodyLength)
+  {
+    std::string head
+        = "HTTP/1.1 " + std::to_string(statusCode) + " " + ReasonPhrase(statusCode) + "\r\n";
+    for (const auto& header : headers)
+    {
+      head += header.first + ": " + header.second + "\r\n";
+    }
+    // HEAD responses carry the length of the content they leave out.
+    if (statusCode != 100 && headers.find("Content-Length") == headers.end())
+    {
+      head += "Content-Length: " + std::to_string(bodyLength) + "\r\n";
+    }
+    head += "\r\n";
+    if (!SendAll(socket, reinterpret_cast<const uint8_t*>(head.data()), head.length()))
+    {
+      return;
+    }
+    while (bodyLength > 0)
+    {
+      std::size_t piece = std::min(bodyLength, c_ioPieceSize);
+      Throttle(static_cast<int64_t>(piece));
+      if (!SendAll(socket, body, piece))
+      {
+        return;
+      }
+      body += piece;
+      bodyLength -= piece;
+    }
+  }
+
+}}} // namespace Azure::Storage::Test
+
+#endif
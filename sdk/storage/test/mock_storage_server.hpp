@@ -0,0 +1,111 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: MIT
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace Azure { namespace Storage { namespace Test {
+
+  struct MockStorageServerOptions
+  {
+    /**
+     * @brief Delay added before every response, simulating the round trip to the service.
+     */
+    std::chrono::milliseconds Latency{0};
+
+    /**
+     * @brief Bandwidth shared by all connections, in bytes per second. 0 means unlimited.
+     */
+    int64_t BytesPerSecond = 0;
+  };
+
+  /**
+   * @brief A minimal in-process HTTP server emulating the blob operations used by parallel
+   * transfers, listings and batches: Put Blob, Put Block, Put Block List, Get Block List, Put
+   * Page, Append Block, ranged Get Blob, Get Blob Properties, List Blobs, and Blob Batch of Delete
+   * Blob and Set Blob Tier, including transactional hash validation and If-Match. Used to exercise
+   * and benchmark the client code without a storage account.
+   */
+  class MockStorageServer {
+  public:
+    explicit MockStorageServer(MockStorageServerOptions options = MockStorageServerOptions());
+    ~MockStorageServer();
+
+    MockStorageServer(const MockStorageServer&) = delete;
+    MockStorageServer& operator=(const MockStorageServer&) = delete;
+
+    /**
+     * @brief Returns an anonymous url of the blob service of this server.
+     */
+    std::string GetServiceUrl() const;
+
+    /**
+     * @brief Returns an anonymous url of the container holding the blobs of this server.
+     */
+    std::string GetContainerUrl() const;
+
+    /**
+     * @brief Returns an anonymous url of a blob hosted by this server.
+     */
+    std::string GetBlobUrl(const std::string& blobName) const;
+
+    void SetBlob(const std::string& blobName, std::vector<uint8_t> content);
+    std::vector<uint8_t> GetBlob(const std::string& blobName) const;
+
+    int64_t GetRequestCount() const { return m_requestCount; }
+
+    /**
+     * @brief Fails every request with 403 once numRequests more requests have been served,
+     * simulating a transfer that breaks halfway. A negative number stops failing requests.
+     */
+    void FailRequestsAfter(int64_t numRequests);
+
+  private:
+    struct Request
+    {
+      std::string Method;
+      std::string Path;
+      std::map<std::string, std::string> Query;
+      std::map<std::string, std::string> Headers;
+      std::vector<uint8_t> Body;
+    };
+
+    void AcceptLoop();
+    void ServeConnection(int socket);
+    bool ReadRequest(int socket, std::string& buffer, Request& request);
+    void HandleRequest(int socket, const Request& request);
+    void SendResponse(
+        int socket,
+        int statusCode,
+        const std::map<std::string, std::string>& headers,
+        const uint8_t* body,
+        std::size_t bodyLength);
+    void Throttle(int64_t bytes);
+
+    MockStorageServerOptions m_options;
+    int m_listenSocket = -1;
+    int m_port = 0;
+    std::thread m_acceptThread;
+    std::atomic<bool> m_stop{false};
+    std::atomic<int64_t> m_requestCount{0};
+
+    mutable std::mutex m_mutex;
+    std::vector<std::thread> m_connectionThreads;
+    std::vector<int> m_connectionSockets;
+    std::map<std::string, std::vector<uint8_t>> m_blobs;
+    std::map<std::string, std::map<std::string, std::vector<uint8_t>>> m_uncommittedBlocks;
+    std::map<std::string, int64_t> m_committedBlockCounts;
+    int64_t m_etagCounter = 0;
+    int64_t m_requestsBeforeFailure = -1;
+    std::chrono::steady_clock::time_point m_nextSlot;
+  };
+
+}}} // namespace Azure::Storage::Test
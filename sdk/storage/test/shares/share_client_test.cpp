@@ -3,6 +3,8 @@
 
 #include "share_client_test.hpp"
 
+#include "common/file_io.hpp"
+
 #include <algorithm>
 
 namespace Azure { namespace Storage { namespace Test {
@@ -54,4 +56,63 @@ namespace Azure { namespace Storage { namespace Test {
     }
   }
 
+  TEST_F(FileShareClientTest, FileRangeTransfers)
+  {
+    auto directoryClient = m_shareClient->GetDirectoryClient(LowercaseRandomString());
+    directoryClient.Create();
+
+    const std::size_t bufferSize = 9 * 1024 * 1024 + 123;
+    auto buffer = RandomBuffer(bufferSize);
+    auto fileClient = directoryClient.GetFileClient(LowercaseRandomString());
+    Files::Shares::UploadFileOptions uploadOptions;
+    uploadOptions.Concurrency = 4;
+    uploadOptions.HttpHeaders = GetInterestingHttpHeaders();
+    fileClient.UploadFromBuffer(buffer.data(), buffer.size(), uploadOptions);
+    EXPECT_EQ(static_cast<int64_t>(bufferSize), fileClient.GetProperties()->ContentLength);
+
+    Files::Shares::DownloadFileToBufferOptions downloadOptions;
+    downloadOptions.InitialChunkSize = 1024 * 1024;
+    downloadOptions.ChunkSize = 1024 * 1024;
+    downloadOptions.Concurrency = 4;
+    std::vector<uint8_t> downloadBuffer(bufferSize);
+    auto downloadResult = fileClient.DownloadToBuffer(
+        downloadBuffer.data(), downloadBuffer.size(), downloadOptions);
+    EXPECT_EQ(static_cast<int64_t>(bufferSize), downloadResult->ContentLength);
+    EXPECT_EQ(buffer, downloadBuffer);
+
+    const std::string tempFilename = RandomString();
+    downloadOptions.Offset = 1234;
+    downloadOptions.Length = 3 * 1024 * 1024;
+    fileClient.DownloadToFile(tempFilename, downloadOptions);
+    EXPECT_EQ(
+        std::vector<uint8_t>(buffer.begin() + 1234, buffer.begin() + 1234 + 3 * 1024 * 1024),
+        ReadFile(tempFilename));
+
+    auto emptyFileClient = directoryClient.GetFileClient(LowercaseRandomString());
+    {
+      Azure::Storage::Details::FileWriter fileWriter(tempFilename);
+    }
+    emptyFileClient.UploadFromFile(tempFilename, uploadOptions);
+    downloadOptions.Offset.Reset();
+    downloadOptions.Length.Reset();
+    EXPECT_EQ(0, emptyFileClient.DownloadToFile(tempFilename, downloadOptions)->ContentLength);
+    EXPECT_TRUE(ReadFile(tempFilename).empty());
+    DeleteFile(tempFilename);
+
+    std::vector<std::string> fileNames;
+    auto pager = directoryClient.ListFilesAndDirectoriesPages();
+    while (pager.HasMoreSegments())
+    {
+      for (const auto& item : pager.NextSegment().Segment.FileItems)
+      {
+        fileNames.push_back(item.Name);
+      }
+    }
+    EXPECT_EQ(2U, fileNames.size());
+
+    fileClient.Delete();
+    emptyFileClient.Delete();
+    directoryClient.Delete();
+  }
+
 }}} // namespace Azure::Storage::Test